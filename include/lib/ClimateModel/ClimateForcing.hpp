@@ -0,0 +1,85 @@
+#pragma once
+
+using namespace EvoEngine;
+namespace EcoSysLab {
+	/**
+	 * \brief One climate variable resampled to a uniform time step.
+	 * The sample index follows from the time directly, so lookups take constant time.
+	 */
+	class ClimateTimeSeries {
+		float m_startTime = 0.0f;
+		float m_timeStep = 1.0f;
+		float m_inverseTimeStep = 1.0f;
+		std::vector<float> m_values;
+	public:
+		/**
+		 * Resample by linear interpolation.
+		 * @param times Sample times in ascending order. For equal times the last sample wins.
+		 * @param values Sample values, same size as times.
+		 * @param timeStep Step of the resampled series. A non-positive step uses the smallest gap between two samples.
+		 * The step is shrunk to divide the time span evenly, so the last sample is at the last time.
+		 * @param maxSampleSize The step is widened if the series would get more samples than this. At least two samples are kept.
+		 */
+		void Resample(const std::vector<float>& times, const std::vector<float>& values, float timeStep = 0.0f, size_t maxSampleSize = 1 << 24);
+		void Set(float startTime, float timeStep, const std::vector<float>& values);
+		/**
+		 * Turn angles in degrees into a continuous sequence so that interpolating across 360 to 0 goes the short way.
+		 */
+		static void UnwrapDegrees(std::vector<float>& values);
+
+		/**
+		 * Linear interpolation, times outside the series are clamped to the first and last sample.
+		 */
+		[[nodiscard]] float Sample(float time) const;
+		/**
+		 * Sample many times at once, written as a branch free loop.
+		 */
+		void Sample(const float* times, float* results, size_t size) const;
+
+		[[nodiscard]] float GetStartTime() const;
+		[[nodiscard]] float GetEndTime() const;
+		[[nodiscard]] float GetTimeStep() const;
+		[[nodiscard]] const std::vector<float>& PeekValues() const;
+		[[nodiscard]] bool Empty() const;
+	};
+
+	/**
+	 * \brief Columnar set of named climate time series such as temperature, illuminance or precipitation.
+	 * Look up the variable index once and sample by index in hot loops.
+	 */
+	class ClimateForcing {
+		std::vector<std::string> m_variableNames;
+		std::vector<ClimateTimeSeries> m_variables;
+	public:
+		/**
+		 * Read a comma separated file with a header line one line at a time. Empty or invalid fields become NaN.
+		 * @return False if the file can't be opened or has no header.
+		 */
+		static bool ReadCSV(const std::filesystem::path& path, std::vector<std::string>& columnNames, std::vector<std::vector<float>>& columns);
+		/**
+		 * Replace all variables with the columns of the file, resampled against the time column.
+		 * Rows don't need to be ordered by time and NaN values are skipped per variable.
+		 */
+		bool ImportCSV(const std::filesystem::path& path, const std::string& timeColumnName = "Time", float timeStep = 0.0f);
+		/**
+		 * Add or replace a variable.
+		 * @return The index of the variable.
+		 */
+		int SetVariable(const std::string& name, const std::vector<float>& times, const std::vector<float>& values, float timeStep = 0.0f);
+		void Clear();
+
+		/**
+		 * @return -1 if no variable has the name.
+		 */
+		[[nodiscard]] int GetVariableIndex(const std::string& name) const;
+		[[nodiscard]] const std::vector<std::string>& GetVariableNames() const;
+		[[nodiscard]] const ClimateTimeSeries& PeekVariable(int variableIndex) const;
+		[[nodiscard]] float Sample(int variableIndex, float time) const;
+		void Sample(int variableIndex, const std::vector<float>& times, std::vector<float>& results) const;
+		[[nodiscard]] bool Empty() const;
+
+		void Serialize(const std::string& name, YAML::Emitter& out) const;
+		void Deserialize(const std::string& name, const YAML::Node& in);
+		void OnInspect();
+	};
+}
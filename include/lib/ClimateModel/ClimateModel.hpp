@@ -1,20 +1,42 @@
 #pragma once
 #include "EnvironmentGrid.hpp"
+#include "ClimateForcing.hpp"
 
 using namespace EvoEngine;
 namespace EcoSysLab {
 	class ClimateParameters {
 	public:
-
+		/**
+		 * \brief Measured time series with times in days. Variables named "Temperature" and "Precipitation" drive the model.
+		 */
+		ClimateForcing m_forcing;
 	};
 	class ClimateModel {
+		ClimateForcing m_forcing;
+		int m_temperatureIndex = -1;
+		int m_precipitationIndex = -1;
 	public:
 		float m_monthAvgTemp[12] = { 38, 42, 46, 54, 61, 68, 77, 83, 77, 67, 55, 43 };
+		/**
+		 * \brief Time in years.
+		 */
 		float m_time = 0.0f;
 		EnvironmentGrid m_environmentGrid{};
+		/**
+		 * \brief Temperature from the forcing if it has one, otherwise interpolated from the monthly averages.
+		 */
 		[[nodiscard]] float GetTemperature(const glm::vec3& position) const;
+		/**
+		 * \brief Precipitation from the forcing, 0 if it has none.
+		 */
+		[[nodiscard]] float GetPrecipitation(const glm::vec3& position) const;
 		[[nodiscard]] float GetEnvironmentalLight(const glm::vec3& position, glm::vec3& lightDirection) const;
 
 		void Initialize(const ClimateParameters& climateParameters);
+		/**
+		 * \brief Replace the forcing and look up the indices of the variables the model uses.
+		 */
+		void SetForcing(const ClimateForcing& forcing);
+		[[nodiscard]] const ClimateForcing& PeekForcing() const;
 	};
 }
@@ -0,0 +1,187 @@
+#pragma once
+#include "TreeModel.hpp"
+#include "TreeMeshGenerator.hpp"
+#include "SimulationSettings.hpp"
+
+using namespace EvoEngine;
+namespace EcoSysLab {
+	struct TreeDatasetTask
+	{
+		std::filesystem::path m_treeDescriptorPath;
+		int m_seed = 0;
+		/**
+		 * \brief Unique name of the sample. Used as the file stem of the outputs and as the key in the manifest.
+		 */
+		std::string m_name;
+	};
+
+	struct TreeDatasetSettings
+	{
+		float m_deltaTime = 0.08220f;
+		int m_maxIterations = 999;
+		int m_maxTreeNodeCount = 50000;
+		/**
+		 * \brief Number of trees grown at the same time. 0 grows one tree per worker.
+		 */
+		int m_concurrency = 0;
+		/**
+		 * \brief Number of samples written into the same shard folder.
+		 */
+		int m_shardSize = 1000;
+
+		/**
+		 * \brief Outputs of the Generate overload without sinks. Ignored when sinks are given.
+		 */
+		bool m_exportTreeMesh = true;
+		bool m_exportTrunkMesh = false;
+		bool m_exportTreeInfo = false;
+		TreeMeshGeneratorSettings m_meshGeneratorSettings{};
+		SimulationSettings m_simulationSettings{};
+	};
+
+	/**
+	 * \brief Meshes the engine generates for a wave when at least one sink asks for them.
+	 */
+	struct TreeDatasetSinkRequirements
+	{
+		bool m_branchMesh = false;
+		bool m_foliageMesh = false;
+		bool m_trunkMesh = false;
+	};
+
+	/**
+	 * \brief A finished sample as seen by the sinks. Meshes nobody asked for are empty.
+	 */
+	struct TreeDatasetSampleOutput
+	{
+		const TreeDatasetTask* m_task = nullptr;
+		std::filesystem::path m_shardPath;
+		const TreeModel* m_treeModel = nullptr;
+		const std::vector<Vertex>* m_branchVertices = nullptr;
+		const std::vector<unsigned int>* m_branchIndices = nullptr;
+		const std::vector<Vertex>* m_foliageVertices = nullptr;
+		const std::vector<unsigned int>* m_foliageIndices = nullptr;
+		const std::vector<Vertex>* m_trunkVertices = nullptr;
+		const std::vector<unsigned int>* m_trunkIndices = nullptr;
+		/**
+		 * @return The path of an output file of this sample, e.g. GetOutputPath("_trunk.obj").
+		 */
+		[[nodiscard]] std::filesystem::path GetOutputPath(const std::string& suffix) const;
+	};
+
+	/**
+	 * \brief Receives every finished sample. Write is called once per sample, one sample after another.
+	 */
+	class ITreeDatasetSink
+	{
+	public:
+		virtual ~ITreeDatasetSink() = default;
+		virtual void CollectRequirements(TreeDatasetSinkRequirements& requirements) const {}
+		virtual void Write(const TreeDatasetSampleOutput& output) = 0;
+	};
+
+	/**
+	 * \brief Branch and foliage mesh as one OBJ file.
+	 */
+	class TreeDatasetMeshSink : public ITreeDatasetSink
+	{
+	public:
+		bool m_foliage = true;
+		void CollectRequirements(TreeDatasetSinkRequirements& requirements) const override;
+		void Write(const TreeDatasetSampleOutput& output) override;
+	};
+
+	/**
+	 * \brief The trunk up to the first branching as an OBJ file.
+	 */
+	class TreeDatasetTrunkMeshSink : public ITreeDatasetSink
+	{
+	public:
+		void CollectRequirements(TreeDatasetSinkRequirements& requirements) const override;
+		void Write(const TreeDatasetSampleOutput& output) override;
+	};
+
+	/**
+	 * \brief Trunk and bounding box measurements as a text file.
+	 */
+	class TreeDatasetInfoSink : public ITreeDatasetSink
+	{
+	public:
+		void Write(const TreeDatasetSampleOutput& output) override;
+	};
+
+	/**
+	 * \brief The shoot skeleton as a binary archive (.esb) that Tree::LoadBinary reads.
+	 */
+	class TreeDatasetSkeletonSink : public ITreeDatasetSink
+	{
+	public:
+		bool m_compress = false;
+		void Write(const TreeDatasetSampleOutput& output) override;
+	};
+
+	/**
+	 * \brief Points sampled uniformly by area on the branch and foliage surfaces, written as PLY with a type index (0 branch, 1 foliage).
+	 * Needs no ray tracer, so occluded surfaces are sampled as well.
+	 */
+	class TreeDatasetPointCloudSink : public ITreeDatasetSink
+	{
+	public:
+		int m_pointCount = 100000;
+		/**
+		 * \brief Standard deviation of the gaussian noise added to each point, 0 for none.
+		 */
+		float m_deviation = 0.0f;
+		bool m_foliage = true;
+		void CollectRequirements(TreeDatasetSinkRequirements& requirements) const override;
+		void Write(const TreeDatasetSampleOutput& output) override;
+	};
+
+	/**
+	 * \brief Wall clock seconds spent in each stage, summed over the waves.
+	 */
+	struct TreeDatasetTimings
+	{
+		double m_setup = 0.0;
+		double m_environment = 0.0;
+		double m_growth = 0.0;
+		double m_meshing = 0.0;
+		double m_output = 0.0;
+		size_t m_sampleCount = 0;
+		[[nodiscard]] std::string ToString() const;
+	};
+
+	/**
+	 * \brief Append-only record of finished samples, so an interrupted run can be restarted without regenerating finished samples.
+	 * Each line holds the sample name and the shard folder it was written to.
+	 */
+	class TreeDatasetManifest
+	{
+		std::filesystem::path m_path;
+		std::unordered_set<std::string> m_completed;
+		std::ofstream m_output;
+		std::mutex m_mutex;
+	public:
+		explicit TreeDatasetManifest(const std::filesystem::path& path);
+		[[nodiscard]] bool IsCompleted(const std::string& name) const;
+		void MarkCompleted(const std::string& name, const std::string& shardName);
+		[[nodiscard]] size_t GetCompletedCount() const;
+	};
+
+	/**
+	 * \brief Grows many independent trees at the same time without creating entities. Each tree owns its TreeModel and ClimateModel,
+	 * outputs are written into shard folders under the output root and recorded in the manifest.
+	 */
+	class TreeDatasetEngine
+	{
+	public:
+		/**
+		 * \brief Write the outputs enabled in the settings.
+		 */
+		static TreeDatasetTimings Generate(const std::vector<TreeDatasetTask>& tasks, const TreeDatasetSettings& settings, const std::filesystem::path& outputRoot);
+		static TreeDatasetTimings Generate(const std::vector<TreeDatasetTask>& tasks, const TreeDatasetSettings& settings, const std::filesystem::path& outputRoot,
+			const std::vector<std::shared_ptr<ITreeDatasetSink>>& sinks);
+
+		[[nodiscard]] static std::string GetShardName(size_t taskIndex, int shardSize);
+	};
+}
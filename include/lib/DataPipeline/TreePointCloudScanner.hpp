@@ -66,9 +66,29 @@ namespace EcoSysLab {
         bool SampleFilter(const PointCloudSample& sample) override;
     };
 
+    /**
+     * \brief Captured points with one entry per point in each label list the point settings enable.
+     */
+    struct TreePointCloud {
+        std::vector<glm::vec3> m_points;
+        std::vector<int> m_typeIndex;
+        std::vector<int> m_instanceIndex;
+        std::vector<int> m_branchIndex;
+        std::vector<int> m_internodeIndex;
+        std::vector<int> m_lineIndex;
+        std::vector<int> m_treePartIndex;
+        std::vector<int> m_treePartTypeIndex;
+        void Clear();
+    };
+
 	class TreePointCloudScanner : public IPrivateComponent{
 	public:
         TreePointCloudPointSettings m_pointSettings;
+        /**
+         * \brief Scan the trees in the scene into memory.
+         * @return False if nothing can be scanned, or the build has no ray tracer.
+         */
+        bool Capture(const std::shared_ptr<PointCloudCaptureSettings>& captureSettings, TreePointCloud& pointCloud) const;
         void Capture(const TreeMeshGeneratorSettings& meshGeneratorSettings, const std::filesystem::path& savePath, const std::shared_ptr<PointCloudCaptureSettings>& captureSettings) const;
 		bool OnInspect(const std::shared_ptr<EditorLayer>& editorLayer) override;
 
@@ -27,20 +27,191 @@ namespace EcoSysLab {
 		int m_step = 1;
 	};
 
+	/**
+	 * \brief One frame of scan data. Storage is reserved once for the maximum frame size and reused for every frame.
+	 */
+	struct JoeScanFrame
+	{
+		bool m_hasEncoderValue = false;
+		float m_encoderValue = 0.f;
+		size_t m_pointCount = 0;
+		std::vector<glm::vec2> m_points;
+		std::vector<int> m_brightness;
+
+		void Reserve(size_t maxPointCount);
+		void Clear();
+		bool PushPoint(const glm::vec2& point, int brightness);
+	};
+
+	/**
+	 * \brief Single producer, single consumer ring of preallocated frames. The scan thread writes, the record thread reads.
+	 */
+	class JoeScanFrameRing
+	{
+		std::vector<JoeScanFrame> m_frames;
+		std::atomic<size_t> m_head = 0;
+		std::atomic<size_t> m_tail = 0;
+		std::atomic<size_t> m_droppedFrameCount = 0;
+	public:
+		void Allocate(size_t frameCount, size_t maxPointCount);
+		void Reset();
+		/**
+		 * Acquire the next free slot for writing.
+		 * @return Slot to fill, nullptr if the consumer has not caught up.
+		 */
+		[[nodiscard]] JoeScanFrame* BeginWrite();
+		void EndWrite();
+		/**
+		 * Acquire the oldest published frame.
+		 * @return Frame to read, nullptr if the ring is empty.
+		 */
+		[[nodiscard]] const JoeScanFrame* BeginRead();
+		void EndRead();
+		void DropFrame();
+		[[nodiscard]] size_t GetDroppedFrameCount() const;
+		[[nodiscard]] size_t GetCapacity() const;
+		[[nodiscard]] size_t GetProducedFrameCount() const;
+		[[nodiscard]] size_t GetConsumedFrameCount() const;
+	};
+
+	/**
+	 * \brief Profiles kept by the recorder, one per encoder bin. Profiles and the bin table are allocated up front and reused,
+	 * so recording a frame only copies its points unless the scan outgrows the expected profile count.
+	 */
+	class JoeScanProfilePool
+	{
+		std::vector<JoeScanProfile> m_profiles;
+		size_t m_profileCount = 0;
+		size_t m_maxPointCount = 0;
+		/**
+		 * Index into m_profiles for every bin from m_firstBin on, -1 for bins without a profile.
+		 */
+		std::vector<int> m_binProfileIndices;
+		int m_firstBin = 0;
+	public:
+		void Allocate(size_t profileCount, size_t maxPointCount);
+		void Clear();
+		/**
+		 * Get the profile of a bin, taking a free one from the pool if the bin is new.
+		 */
+		[[nodiscard]] JoeScanProfile& Acquire(int bin);
+		/**
+		 * Append the profiles in the order of their bins.
+		 */
+		void CopyProfiles(std::vector<JoeScanProfile>& profiles) const;
+	};
+
+	/**
+	 * \brief Producer side of the scan pipeline.
+	 */
+	class JoeScanFrameSource
+	{
+	public:
+		virtual ~JoeScanFrameSource() = default;
+		/**
+		 * Upper bound of points a single frame of this source may contain, used to preallocate the ring.
+		 */
+		[[nodiscard]] virtual size_t GetMaxPointCount() const = 0;
+		/**
+		 * Whether the source keeps producing regardless of the consumer. Frames of a real-time source are dropped when the ring is full, otherwise the producer waits.
+		 */
+		[[nodiscard]] virtual bool IsRealTime() const = 0;
+		/**
+		 * Block until the next frame is available and write it into the frame.
+		 * @return 1 if the frame is filled, 0 on timeout, negative on error or when the source is exhausted.
+		 */
+		virtual int ReadFrame(JoeScanFrame& frame) = 0;
+	};
+
+	/**
+	 * \brief Reads frames from the connected scan heads. Profile buffer is allocated once on construction.
+	 */
+	class JoeScanHeadSource : public JoeScanFrameSource
+	{
+		jsScanSystem m_scanSystem = 0;
+		std::vector<jsProfile> m_profiles;
+	public:
+		explicit JoeScanHeadSource(jsScanSystem scanSystem);
+		[[nodiscard]] size_t GetMaxPointCount() const override;
+		[[nodiscard]] bool IsRealTime() const override;
+		int ReadFrame(JoeScanFrame& frame) override;
+	};
+
+	/**
+	 * \brief Replays recorded profiles at a fixed line rate, so the pipeline can be exercised without a scan head.
+	 */
+	class JoeScanReplaySource : public JoeScanFrameSource
+	{
+		std::vector<JoeScanProfile> m_profiles;
+		size_t m_nextProfileIndex = 0;
+		size_t m_maxPointCount = 0;
+		float m_lineRate = 0.f;
+		bool m_started = false;
+		std::chrono::steady_clock::time_point m_nextFrameTime;
+		bool m_loop = false;
+	public:
+		/**
+		 * @param profiles Recorded profiles to replay, one profile per frame.
+		 * @param lineRate Profiles per second. 0 replays as fast as the pipeline consumes.
+		 * @param loop Restart from the first profile when the recording ends.
+		 */
+		JoeScanReplaySource(const std::vector<JoeScanProfile>& profiles, float lineRate, bool loop);
+		[[nodiscard]] size_t GetMaxPointCount() const override;
+		[[nodiscard]] bool IsRealTime() const override;
+		int ReadFrame(JoeScanFrame& frame) override;
+	};
+
+	struct JoeScanPipelineStatistics
+	{
+		size_t m_producedFrameCount = 0;
+		size_t m_consumedFrameCount = 0;
+		size_t m_droppedFrameCount = 0;
+		double m_elapsedSeconds = 0.0;
+	};
+
 	class JoeScanScanner : public IPrivateComponent {
 		std::shared_ptr<std::mutex> m_scannerMutex;
+		std::shared_ptr<JoeScanFrameRing> m_frameRing;
+		std::shared_ptr<JoeScanFrameSource> m_frameSource;
+		std::shared_ptr<std::atomic<bool>> m_producerFinished;
 		bool m_scanEnabled = false;
+		bool m_replaying = false;
+		std::chrono::steady_clock::time_point m_pipelineStartTime;
 		JobHandle m_scannerJob{};
+		JobHandle m_recorderJob{};
 		float m_scanTimeStep = 0.5f;
 
-		std::unordered_map<int, JoeScanProfile> m_preservedProfiles;
+		JoeScanProfilePool m_preservedProfiles;
 
 		std::vector<glm::vec2> m_points;
+		JoeScanPipelineStatistics m_statistics{};
+
+		void StartPipeline(const std::shared_ptr<JoeScanFrameSource>& source, size_t expectedProfileCount, const JoeScanScannerSettings& settings);
+		void RecordFrame(const JoeScanFrame& frame, const JoeScanScannerSettings& settings);
+		/**
+		 * Stop the pipeline once its source has run out, so the recording is stored and the controls reset.
+		 */
+		void StopFinishedPipeline();
 	public:
 		AssetRef m_config;
 		AssetRef m_joeScan;
+		/**
+		 * Number of frames the ring between the scan thread and the record thread can hold.
+		 */
+		int m_ringFrameCount = 256;
+		/**
+		 * Number of profiles preallocated for a scan. A replay preallocates at least the profiles it replays.
+		 */
+		int m_expectedProfileCount = 1024;
+		float m_replayLineRate = 2000.f;
+		bool m_replayLoop = false;
 		void StopScanningProcess();
 		void StartScanProcess(const JoeScanScannerSettings& settings);
+		/**
+		 * Feed the profiles of the attached JoeScan through the same pipeline as the scan heads.
+		 */
+		void StartReplayProcess(const JoeScanScannerSettings& settings);
+		[[nodiscard]] const JoeScanPipelineStatistics& GetStatistics() const;
 		JoeScanScanner();
 		static bool InitializeScanSystem(const std::shared_ptr<Json>& json, jsScanSystem& scanSystem, std::vector<jsScanHead>& scanHeads);
 		static void FreeScanSystem(jsScanSystem& scanSystem, std::vector<jsScanHead>& scanHeads);
@@ -6,6 +6,8 @@
 #include "PointCloud.hpp"
 #include "SorghumField.hpp"
 #include "SorghumState.hpp"
+#include "SorghumGeometryCache.hpp"
+#include "SorghumIlluminationEstimator.hpp"
 using namespace EvoEngine;
 namespace EcoSysLab {
 	class SorghumLayer : public ILayer {
@@ -31,6 +33,10 @@ namespace EcoSysLab {
 #pragma endregion
 #endif
 		SorghumMeshGeneratorSettings m_sorghumMeshGeneratorSettings;
+		SorghumGeometryCache m_geometryCache;
+		SorghumIlluminationEstimator m_illuminationEstimator;
+		AssetRef m_skyIlluminance;
+		float m_illuminationTime = 0.0f;
 		bool m_autoRefreshSorghums = true;
 		
 		AssetRef m_panicleMaterial;
@@ -51,6 +57,14 @@ namespace EcoSysLab {
 
 		void OnCreate() override;
 		void GenerateMeshForAllSorghums(const SorghumMeshGeneratorSettings& sorghumMeshGeneratorSettings) const;
+		/**
+		 * \brief Builds the buffers of all given plants in parallel, then creates their meshes and entities.
+		 */
+		void GenerateMeshForSorghums(const std::vector<Entity>& sorghumEntities, const SorghumMeshGeneratorSettings& sorghumMeshGeneratorSettings) const;
+		/**
+		 * \brief Collect the whole field and estimate its illumination on the CPU under the sky illuminance at the given time.
+		 */
+		void EstimateIllumination(float time);
 		void OnInspect(const std::shared_ptr<EditorLayer>& editorLayer) override;
 		void Update() override;
 		void LateUpdate() override;
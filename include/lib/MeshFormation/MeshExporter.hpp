@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Vertex.hpp"
+using namespace EvoEngine;
+namespace EcoSysLab {
+	/**
+	 * \brief One object of an exported file. The chunk only points to the geometry, the caller keeps it alive until the export returns.
+	 */
+	struct MeshExportChunk
+	{
+		std::string m_name;
+		const std::vector<Vertex>* m_vertices = nullptr;
+		/**
+		 * Faces, either as triangles or as a flat index list. Set exactly one of them.
+		 */
+		const std::vector<glm::uvec3>* m_triangles = nullptr;
+		const std::vector<unsigned int>* m_indices = nullptr;
+		/**
+		 * Optional texture coordinates stored apart from the vertices, faces then reference them through (vertex, texCoord) index pairs.
+		 * When not set, the texture coordinates of the vertices are used.
+		 * PLY and GLB hold one texture coordinate per vertex, there each distinct (vertex, texCoord) pair of the faces is written as its own vertex.
+		 */
+		const std::vector<glm::vec2>* m_texCoords = nullptr;
+		const std::vector<std::pair<unsigned int, unsigned int>>* m_vertexTexCoordIndices = nullptr;
+
+		bool m_transformed = false;
+		glm::mat4 m_transform = glm::mat4(1.0f);
+
+		[[nodiscard]] size_t GetVertexCount() const;
+		[[nodiscard]] size_t GetTexCoordCount() const;
+		[[nodiscard]] size_t GetTriangleCount() const;
+		[[nodiscard]] bool IsEmpty() const;
+		[[nodiscard]] glm::vec3 GetPosition(size_t vertexIndex) const;
+		[[nodiscard]] glm::vec2 GetTexCoord(size_t texCoordIndex) const;
+		/**
+		 * @param triangleIndex Index of the triangle.
+		 * @param vertexIndices Vertex indices of the triangle, local to this chunk.
+		 * @param texCoordIndices Texture coordinate indices of the triangle, local to this chunk.
+		 */
+		void GetTriangle(size_t triangleIndex, glm::uvec3& vertexIndices, glm::uvec3& texCoordIndices) const;
+	};
+
+	/**
+	 * \brief Writes meshes as text OBJ, binary PLY or binary glTF (.glb). Chunks are formatted in parallel into reusable buffers and written in order.
+	 */
+	class MeshExporter
+	{
+	public:
+		/**
+		 * Pick the format by the extension of the path.
+		 * @return False if the extension is not supported or the file can't be written.
+		 */
+		static bool Export(const std::filesystem::path& path, const std::vector<MeshExportChunk>& chunks);
+		static bool ExportOBJ(const std::filesystem::path& path, const std::vector<MeshExportChunk>& chunks);
+		static bool ExportPLY(const std::filesystem::path& path, const std::vector<MeshExportChunk>& chunks);
+		static bool ExportGLB(const std::filesystem::path& path, const std::vector<MeshExportChunk>& chunks);
+		[[nodiscard]] static bool IsSupported(const std::filesystem::path& path);
+	};
+}
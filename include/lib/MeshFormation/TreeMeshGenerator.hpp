@@ -127,12 +127,10 @@ namespace EcoSysLab {
 		std::vector<std::vector<RingSegment>> ringsList;
 		std::vector<bool> mainChildStatus;
 
-		std::unordered_map<SkeletonNodeHandle, int> steps{};
+		std::vector<int> steps(skeleton.PeekRawNodes().size(), 0);
 		ringsList.resize(sortedInternodeList.size());
 		mainChildStatus.resize(sortedInternodeList.size());
 		std::vector<std::shared_future<void>> results;
-		std::vector<std::vector<std::pair<SkeletonNodeHandle, int>>> tempSteps{};
-		tempSteps.resize(Jobs::GetWorkerSize());
 
 		Jobs::RunParallelFor(sortedInternodeList.size(), [&](unsigned internodeIndex, unsigned threadIndex) {
 			auto internodeHandle = sortedInternodeList[internodeIndex];
@@ -189,7 +187,7 @@ namespace EcoSysLab {
 			if (step % 2 != 0)
 				++step;
 
-			tempSteps[threadIndex].emplace_back(internodeHandle, step);
+			steps[internodeHandle] = step;
 			int amount = glm::max(1, static_cast<int>(glm::distance(positionStart, positionEnd) / (internodeInfo.m_thickness >= settings.m_trunkThickness ? settings.m_trunkYSubdivision : settings.m_branchYSubdivision)));
 			if (amount % 2 != 0)
 				++amount;
@@ -227,26 +225,38 @@ namespace EcoSysLab {
 #pragma endregion
 			});
 
-		for (const auto& list : tempSteps)
+		//Every node gets its vertex range and an upper bound of its index range in one serial pass,
+		//then the vertices and triangles are written into the preallocated buffers in parallel.
+		struct NodeMeshInfo
 		{
-			for (const auto& element : list)
-			{
-				steps[element.first] = element.second;
-			}
-		}
-
-		std::unordered_map<SkeletonNodeHandle, int> vertexLastRingStartVertexIndex{};
+			bool m_emit = false;
+			bool m_needStitching = false;
+			int m_step = 0;
+			int m_pStep = 0;
+			size_t m_vertexOffset = 0;
+			size_t m_scratchIndexOffset = 0;
+			size_t m_indexOffset = 0;
+			size_t m_indexCount = 0;
+			glm::vec3 m_up = glm::vec3(0, 1, 0);
+			glm::vec3 m_parentUp = glm::vec3(0, 1, 0);
+			Vertex m_archetype;
+		};
+		std::vector<NodeMeshInfo> nodeMeshInfos(sortedInternodeList.size());
+		std::vector<size_t> vertexLastRingStartVertexIndex(skeleton.PeekRawNodes().size(), 0);
 
 		int nextTreePartIndex = 0;
 		int nextLineIndex = 0;
-		std::unordered_map<SkeletonNodeHandle, TreePartInfo> treePartInfos{};
+		std::vector<TreePartInfo> treePartInfos(skeleton.PeekRawNodes().size());
 
+		size_t vertexCount = vertices.size();
+		size_t maxIndexCount = 0;
 		for (int internodeIndex = 0; internodeIndex < sortedInternodeList.size(); internodeIndex++) {
 			auto internodeHandle = sortedInternodeList[internodeIndex];
 			const auto& internode = skeleton.PeekNode(internodeHandle);
 			const auto& internodeInfo = internode.m_info;
 			auto parentInternodeHandle = internode.GetParentHandle();
-			Vertex archetype;
+			auto& nodeMeshInfo = nodeMeshInfos[internodeIndex];
+			auto& archetype = nodeMeshInfo.m_archetype;
 			const auto flowHandle = internode.GetFlowHandle();
 			if (settings.m_vertexColorMode == static_cast<unsigned>(TreeMeshGeneratorSettings::VertexColorMode::Junction)) {
 #pragma region TreePart
@@ -410,12 +420,11 @@ namespace EcoSysLab {
 					}
 				}
 			}
-
 			if (internode.m_info.m_length == 0.0f) {
 				//TODO: Model possible knots and wound here.
 				continue;
 			}
-			auto& rings = ringsList[internodeIndex];
+			const auto& rings = ringsList[internodeIndex];
 			if (rings.empty()) {
 				continue;
 			}
@@ -426,254 +435,161 @@ namespace EcoSysLab {
 			{
 				pStep = steps[parentInternodeHandle];
 			}
-			float angleStep = 360.0f / static_cast<float>(step);
-			float pAngleStep = 360.0f / static_cast<float>(pStep);
-			int vertexIndex = vertices.size();
-
-
 			archetype.m_vertexInfo1 = internodeHandle + 1;
 			archetype.m_vertexInfo2 = flowHandle + 1;
+			if (settings.m_vertexColorMode == static_cast<unsigned>(TreeMeshGeneratorSettings::VertexColorMode::InternodeColor)) archetype.m_color = internodeInfo.m_color;
+
+			const int ringSize = rings.size();
+			nodeMeshInfo.m_emit = true;
+			nodeMeshInfo.m_needStitching = needStitching;
+			nodeMeshInfo.m_step = step;
+			nodeMeshInfo.m_pStep = pStep;
+			nodeMeshInfo.m_up = up;
+			nodeMeshInfo.m_parentUp = parentUp;
+			nodeMeshInfo.m_vertexOffset = vertexCount;
+			vertexCount += (needStitching ? 0 : pStep) + ringSize * step;
+			vertexLastRingStartVertexIndex[internodeHandle] = vertexCount - step;
+			nodeMeshInfo.m_scratchIndexOffset = maxIndexCount;
+			maxIndexCount += 3 * (2 * pStep + 2 * step * (ringSize - 1));
+		}
 
-			if (!needStitching) {
-				int parentLastRingStartVertexIndex = parentInternodeHandle == -1 ? -1 : vertexLastRingStartVertexIndex[parentInternodeHandle];
-				for (int p = 0; p < pStep; p++) {
-					if (parentInternodeHandle != -1) vertices.push_back(vertices.at(parentLastRingStartVertexIndex + p));
-					else {
+		vertices.resize(vertexCount);
+		Jobs::RunParallelFor(sortedInternodeList.size(), [&](unsigned internodeIndex, unsigned threadIndex) {
+			const auto& nodeMeshInfo = nodeMeshInfos[internodeIndex];
+			if (!nodeMeshInfo.m_emit) return;
+			const auto& internode = skeleton.PeekNode(sortedInternodeList[internodeIndex]);
+			const auto& rings = ringsList[internodeIndex];
+			const int step = nodeMeshInfo.m_step;
+			const int pStep = nodeMeshInfo.m_pStep;
+			const float angleStep = 360.0f / static_cast<float>(step);
+			const float pAngleStep = 360.0f / static_cast<float>(pStep);
+			Vertex archetype = nodeMeshInfo.m_archetype;
+			size_t vertexIndex = nodeMeshInfo.m_vertexOffset;
+			if (!nodeMeshInfo.m_needStitching) {
+				//Copies of the parent ring are filled in afterwards.
+				if (internode.GetParentHandle() == -1) {
+					for (int p = 0; p < pStep; p++) {
 						float xFactor = static_cast<float>(p) / pStep;
 						const auto& ring = rings.at(0);
 						float yFactor = ring.m_startDistanceToRoot;
-						auto direction = ring.GetDirection(parentUp, pAngleStep * p, true);
+						auto direction = ring.GetDirection(nodeMeshInfo.m_parentUp, pAngleStep * p, true);
 						archetype.m_position = ring.m_startPosition + direction * ring.m_startRadius;
 						vertexPositionModifier(archetype.m_position, direction * ring.m_startRadius, xFactor, yFactor);
 						assert(!glm::any(glm::isnan(archetype.m_position)));
 						archetype.m_texCoord = glm::vec2(xFactor, yFactor);
 						texCoordsModifier(archetype.m_texCoord, xFactor, yFactor);
-						if (settings.m_vertexColorMode == static_cast<unsigned>(TreeMeshGeneratorSettings::VertexColorMode::InternodeColor)) archetype.m_color = internodeInfo.m_color;
-						vertices.push_back(archetype);
-					}
-				}
-			}
-			std::vector<float> angles;
-			angles.resize(step);
-			std::vector<float> pAngles;
-			pAngles.resize(pStep);
-
-			for (auto p = 0; p < pStep; p++) {
-				pAngles[p] = pAngleStep * p;
-			}
-			for (auto s = 0; s < step; s++) {
-				angles[s] = angleStep * s;
-			}
-
-			std::vector<unsigned> pTarget;
-			std::vector<unsigned> target;
-			pTarget.resize(pStep);
-			target.resize(step);
-			for (int p = 0; p < pStep; p++) {
-				// First we allocate nearest vertices for parent.
-				auto minAngleDiff = 360.0f;
-				for (auto j = 0; j < step; j++) {
-					const float diff = glm::abs(pAngles[p] - angles[j]);
-					if (diff < minAngleDiff) {
-						minAngleDiff = diff;
-						pTarget[p] = j;
+						vertices[vertexIndex + p] = archetype;
 					}
 				}
+				vertexIndex += pStep;
 			}
-			for (int s = 0; s < step; s++) {
-				// Second we allocate nearest vertices for child
-				float minAngleDiff = 360.0f;
-				for (int j = 0; j < pStep; j++) {
-					const float diff = glm::abs(angles[s] - pAngles[j]);
-					if (diff < minAngleDiff) {
-						minAngleDiff = diff;
-						target[s] = j;
-					}
-				}
-			}
-
-			int ringSize = rings.size();
-			for (auto ringIndex = 0; ringIndex < ringSize; ringIndex++) {
-				for (auto s = 0; s < step; s++) {
+			for (int ringIndex = 0; ringIndex < rings.size(); ringIndex++) {
+				const auto& ring = rings[ringIndex];
+				for (int s = 0; s < step; s++) {
 					float xFactor = static_cast<float>(glm::min(s, step - s)) / step;
-					auto& ring = rings.at(ringIndex);
 					float yFactor = ring.m_endDistanceToRoot;
 					auto direction = ring.GetDirection(
-						up, angleStep * s, false);
+						nodeMeshInfo.m_up, angleStep * s, false);
 					archetype.m_position = ring.m_endPosition + direction * ring.m_endRadius;
 					vertexPositionModifier(archetype.m_position, direction * ring.m_endRadius, xFactor, yFactor);
 					assert(!glm::any(glm::isnan(archetype.m_position)));
 					archetype.m_texCoord = glm::vec2(xFactor, yFactor);
 					texCoordsModifier(archetype.m_texCoord, xFactor, yFactor);
-					if (settings.m_vertexColorMode == static_cast<unsigned>(TreeMeshGeneratorSettings::VertexColorMode::InternodeColor)) archetype.m_color = internodeInfo.m_color;
-					vertices.push_back(archetype);
+					vertices[vertexIndex + ringIndex * step + s] = archetype;
 				}
-				if (ringIndex == 0)
-				{
-					if (needStitching) {
-						int parentLastRingStartVertexIndex = vertexLastRingStartVertexIndex[parentInternodeHandle];
-						for (int p = 0; p < pStep; p++) {
-							if (pTarget[p] == pTarget[p == pStep - 1 ? 0 : p + 1]) {
-								auto a = parentLastRingStartVertexIndex + p;
-								auto b = parentLastRingStartVertexIndex + (p == pStep - 1 ? 0 : p + 1);
-								auto c = vertexIndex + pTarget[p];
-								if (vertices[a].m_position != vertices[b].m_position
-									&& vertices[b].m_position != vertices[c].m_position
-									&& vertices[a].m_position != vertices[c].m_position
-									&& !glm::any(glm::isnan(vertices[a].m_position))
-									&& !glm::any(glm::isnan(vertices[b].m_position))
-									&& !glm::any(glm::isnan(vertices[c].m_position))) {
-									indices.push_back(a);
-									indices.push_back(b);
-									indices.push_back(c);
-								}
-							}
-							else {
-								auto a = parentLastRingStartVertexIndex + p;
-								auto b = parentLastRingStartVertexIndex + (p == pStep - 1 ? 0 : p + 1);
-								auto c = vertexIndex + pTarget[p];
-								if (vertices[a].m_position != vertices[b].m_position
-									&& vertices[b].m_position != vertices[c].m_position
-									&& vertices[a].m_position != vertices[c].m_position
-									&& !glm::any(glm::isnan(vertices[a].m_position))
-									&& !glm::any(glm::isnan(vertices[b].m_position))
-									&& !glm::any(glm::isnan(vertices[c].m_position))) {
-									indices.push_back(a);
-									indices.push_back(b);
-									indices.push_back(c);
-								}
-								a = vertexIndex + pTarget[p == pStep - 1 ? 0 : p + 1];
-								b = vertexIndex + pTarget[p];
-								c = parentLastRingStartVertexIndex + (p == pStep - 1 ? 0 : p + 1);
-								if (vertices[a].m_position != vertices[b].m_position
-									&& vertices[b].m_position != vertices[c].m_position
-									&& vertices[a].m_position != vertices[c].m_position
-									&& !glm::any(glm::isnan(vertices[a].m_position))
-									&& !glm::any(glm::isnan(vertices[b].m_position))
-									&& !glm::any(glm::isnan(vertices[c].m_position))) {
-									indices.push_back(a);
-									indices.push_back(b);
-									indices.push_back(c);
-								}
-							}
-						}
-					}
-					else
-					{
-						for (int p = 0; p < pStep; p++) {
-							if (pTarget[p] == pTarget[p == pStep - 1 ? 0 : p + 1]) {
-								auto a = vertexIndex + p;
-								auto b = vertexIndex + (p == pStep - 1 ? 0 : p + 1);
-								auto c = vertexIndex + pStep + pTarget[p];
-								if (vertices[a].m_position != vertices[b].m_position
-									&& vertices[b].m_position != vertices[c].m_position
-									&& vertices[a].m_position != vertices[c].m_position
-									&& !glm::any(glm::isnan(vertices[a].m_position))
-									&& !glm::any(glm::isnan(vertices[b].m_position))
-									&& !glm::any(glm::isnan(vertices[c].m_position))) {
-									indices.push_back(a);
-									indices.push_back(b);
-									indices.push_back(c);
-								}
-							}
-							else {
-								auto a = vertexIndex + p;
-								auto b = vertexIndex + (p == pStep - 1 ? 0 : p + 1);
-								auto c = vertexIndex + pStep + pTarget[p];
-								if (vertices[a].m_position != vertices[b].m_position
-									&& vertices[b].m_position != vertices[c].m_position
-									&& vertices[a].m_position != vertices[c].m_position
-									&& !glm::any(glm::isnan(vertices[a].m_position))
-									&& !glm::any(glm::isnan(vertices[b].m_position))
-									&& !glm::any(glm::isnan(vertices[c].m_position))) {
-									indices.push_back(a);
-									indices.push_back(b);
-									indices.push_back(c);
-								}
-								a = vertexIndex + pStep + pTarget[p == pStep - 1 ? 0 : p + 1];
-								b = vertexIndex + pStep + pTarget[p];
-								c = vertexIndex + (p == pStep - 1 ? 0 : p + 1);
-
-								if (vertices[a].m_position != vertices[b].m_position
-									&& vertices[b].m_position != vertices[c].m_position
-									&& vertices[a].m_position != vertices[c].m_position
-									&& !glm::any(glm::isnan(vertices[a].m_position))
-									&& !glm::any(glm::isnan(vertices[b].m_position))
-									&& !glm::any(glm::isnan(vertices[c].m_position))) {
-									indices.push_back(a);
-									indices.push_back(b);
-									indices.push_back(c);
-								}
-							}
-						}
-					}
-					if (!needStitching) vertexIndex += pStep;
-				}
-				else {
-					for (int s = 0; s < step - 1; s++) {
-						// Down triangle
-						auto a = vertexIndex + (ringIndex - 1) * step + s;
-						auto b = vertexIndex + (ringIndex - 1) * step + s + 1;
-						auto c = vertexIndex + ringIndex * step + s;
-						if (vertices[a].m_position != vertices[b].m_position
-							&& vertices[b].m_position != vertices[c].m_position
-							&& vertices[a].m_position != vertices[c].m_position
-							&& !glm::any(glm::isnan(vertices[a].m_position))
-							&& !glm::any(glm::isnan(vertices[b].m_position))
-							&& !glm::any(glm::isnan(vertices[c].m_position))) {
-							indices.push_back(a);
-							indices.push_back(b);
-							indices.push_back(c);
-						}
-
+			}
+			}
+		);
+		//Plain copies, done in order since a parent without geometry falls back to the first vertex.
+		for (int internodeIndex = 0; internodeIndex < sortedInternodeList.size(); internodeIndex++) {
+			const auto& nodeMeshInfo = nodeMeshInfos[internodeIndex];
+			if (!nodeMeshInfo.m_emit || nodeMeshInfo.m_needStitching) continue;
+			const auto parentInternodeHandle = skeleton.PeekNode(sortedInternodeList[internodeIndex]).GetParentHandle();
+			if (parentInternodeHandle == -1) continue;
+			const auto parentLastRingStartVertexIndex = vertexLastRingStartVertexIndex[parentInternodeHandle];
+			for (int p = 0; p < nodeMeshInfo.m_pStep; p++) {
+				vertices.at(nodeMeshInfo.m_vertexOffset + p) = vertices.at(parentLastRingStartVertexIndex + p);
+			}
+		}
 
-						// Up triangle
-						a = vertexIndex + ringIndex * step + s + 1;
-						b = vertexIndex + ringIndex * step + s;
-						c = vertexIndex + (ringIndex - 1) * step + s + 1;
-						if (vertices[a].m_position != vertices[b].m_position
-							&& vertices[b].m_position != vertices[c].m_position
-							&& vertices[a].m_position != vertices[c].m_position
-							&& !glm::any(glm::isnan(vertices[a].m_position))
-							&& !glm::any(glm::isnan(vertices[b].m_position))
-							&& !glm::any(glm::isnan(vertices[c].m_position))) {
-							indices.push_back(a);
-							indices.push_back(b);
-							indices.push_back(c);
-						}
-					}
-					// Down triangle
-					auto a = vertexIndex + (ringIndex - 1) * step + step - 1;
-					auto b = vertexIndex + (ringIndex - 1) * step;
-					auto c = vertexIndex + ringIndex * step + step - 1;
+		std::vector<unsigned> nodeIndices(maxIndexCount);
+		Jobs::RunParallelFor(sortedInternodeList.size(), [&](unsigned internodeIndex, unsigned threadIndex) {
+			auto& nodeMeshInfo = nodeMeshInfos[internodeIndex];
+			if (!nodeMeshInfo.m_emit) return;
+			const auto& internode = skeleton.PeekNode(sortedInternodeList[internodeIndex]);
+			const int ringSize = ringsList[internodeIndex].size();
+			const int step = nodeMeshInfo.m_step;
+			const int pStep = nodeMeshInfo.m_pStep;
+			const float angleStep = 360.0f / static_cast<float>(step);
+			const float pAngleStep = 360.0f / static_cast<float>(pStep);
+			unsigned* nodeIndexList = nodeIndices.data() + nodeMeshInfo.m_scratchIndexOffset;
+			size_t indexCount = 0;
+			const auto emitTriangle = [&](const unsigned a, const unsigned b, const unsigned c)
+				{
 					if (vertices[a].m_position != vertices[b].m_position
 						&& vertices[b].m_position != vertices[c].m_position
 						&& vertices[a].m_position != vertices[c].m_position
 						&& !glm::any(glm::isnan(vertices[a].m_position))
 						&& !glm::any(glm::isnan(vertices[b].m_position))
 						&& !glm::any(glm::isnan(vertices[c].m_position))) {
-						indices.push_back(a);
-						indices.push_back(b);
-						indices.push_back(c);
+						nodeIndexList[indexCount] = a;
+						nodeIndexList[indexCount + 1] = b;
+						nodeIndexList[indexCount + 2] = c;
+						indexCount += 3;
 					}
-					// Up triangle
-					a = vertexIndex + ringIndex * step;
-					b = vertexIndex + ringIndex * step + step - 1;
-					c = vertexIndex + (ringIndex - 1) * step;
-					if (vertices[a].m_position != vertices[b].m_position
-						&& vertices[b].m_position != vertices[c].m_position
-						&& vertices[a].m_position != vertices[c].m_position
-						&& !glm::any(glm::isnan(vertices[a].m_position))
-						&& !glm::any(glm::isnan(vertices[b].m_position))
-						&& !glm::any(glm::isnan(vertices[c].m_position))) {
-						indices.push_back(a);
-						indices.push_back(b);
-						indices.push_back(c);
+				};
+
+			std::vector<unsigned> pTarget;
+			pTarget.resize(pStep);
+			for (int p = 0; p < pStep; p++) {
+				// Allocate nearest vertices for parent.
+				auto minAngleDiff = 360.0f;
+				for (auto j = 0; j < step; j++) {
+					const float diff = glm::abs(pAngleStep * p - angleStep * j);
+					if (diff < minAngleDiff) {
+						minAngleDiff = diff;
+						pTarget[p] = j;
 					}
 				}
 			}
-			vertexLastRingStartVertexIndex[internodeHandle] = vertices.size() - step;
+			//The first ring is connected either to the last ring of the parent or to its own copy of it.
+			const unsigned parentRingStart = nodeMeshInfo.m_needStitching ? vertexLastRingStartVertexIndex[internode.GetParentHandle()] : nodeMeshInfo.m_vertexOffset;
+			const unsigned vertexIndex = nodeMeshInfo.m_needStitching ? nodeMeshInfo.m_vertexOffset : nodeMeshInfo.m_vertexOffset + pStep;
+			for (int p = 0; p < pStep; p++) {
+				const int nextP = p == pStep - 1 ? 0 : p + 1;
+				emitTriangle(parentRingStart + p, parentRingStart + nextP, vertexIndex + pTarget[p]);
+				if (pTarget[p] != pTarget[nextP]) {
+					emitTriangle(vertexIndex + pTarget[nextP], vertexIndex + pTarget[p], parentRingStart + nextP);
+				}
+			}
+			for (int ringIndex = 1; ringIndex < ringSize; ringIndex++) {
+				const unsigned lastRingStart = vertexIndex + (ringIndex - 1) * step;
+				const unsigned ringStart = vertexIndex + ringIndex * step;
+				for (int s = 0; s < step; s++) {
+					const int nextS = s == step - 1 ? 0 : s + 1;
+					// Down triangle
+					emitTriangle(lastRingStart + s, lastRingStart + nextS, ringStart + s);
+					// Up triangle
+					emitTriangle(ringStart + nextS, ringStart + s, lastRingStart + nextS);
+				}
+			}
+			nodeMeshInfo.m_indexCount = indexCount;
+			}
+		);
+
+		size_t indexOffset = indices.size();
+		for (auto& nodeMeshInfo : nodeMeshInfos)
+		{
+			nodeMeshInfo.m_indexOffset = indexOffset;
+			indexOffset += nodeMeshInfo.m_indexCount;
 		}
+		indices.resize(indexOffset);
+		Jobs::RunParallelFor(sortedInternodeList.size(), [&](unsigned internodeIndex, unsigned threadIndex) {
+			const auto& nodeMeshInfo = nodeMeshInfos[internodeIndex];
+			if (nodeMeshInfo.m_indexCount == 0) return;
+			std::memcpy(indices.data() + nodeMeshInfo.m_indexOffset, nodeIndices.data() + nodeMeshInfo.m_scratchIndexOffset, nodeMeshInfo.m_indexCount * sizeof(unsigned));
+			}
+		);
 	}
 
 	template <typename SkeletonData, typename FlowData, typename NodeData>
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "VoxelGrid.hpp"
+#include "PackedVoxelGrid.hpp"
 #include "Skeleton.hpp"
 #include "TreeMeshGenerator.hpp"
 #include "Curve.hpp"
@@ -196,11 +197,11 @@ namespace EcoSysLab {
 	class TreeStructor : public IPrivateComponent {
 		bool DirectConnectionCheck(const BezierCurve& parentCurve, const BezierCurve& childCurve, bool reverse);
 
-		static void FindPoints(const glm::vec3& position, VoxelGrid<std::vector<PointData>>& pointVoxelGrid, float radius,
-		                       const std::function<void(const PointData& voxel)>& func);
-		static bool HasPoints(const glm::vec3& position, VoxelGrid<std::vector<PointData>>& pointVoxelGrid, float radius);
-		static void ForEachBranchEnd(const glm::vec3& position, VoxelGrid<std::vector<BranchEndData>>& branchEndsVoxelGrid, float radius,
-		                             const std::function<void(const BranchEndData& voxel)>& func);
+		template<typename Func>
+		static void FindPoints(const glm::vec3& position, PackedVoxelGrid<PointData>& pointVoxelGrid, float radius, Func&& func);
+		static bool HasPoints(const glm::vec3& position, const PackedVoxelGrid<PointData>& pointVoxelGrid, float radius);
+		template<typename Func>
+		static void ForEachBranchEnd(const glm::vec3& position, PackedVoxelGrid<BranchEndData>& branchEndsVoxelGrid, float radius, Func&& func);
 
 		void CalculateNodeTransforms(ReconstructionSkeleton& skeleton);
 
@@ -265,10 +266,10 @@ namespace EcoSysLab {
 		bool m_debugSelectedBranchConnections = true;
 		bool m_debugSelectedBranches = true;
 
-		VoxelGrid<std::vector<PointData>> m_scatterPointsVoxelGrid;
-		VoxelGrid<std::vector<PointData>> m_allocatedPointsVoxelGrid;
-		VoxelGrid<std::vector<PointData>> m_spaceColonizationVoxelGrid;
-		VoxelGrid<std::vector<BranchEndData>> m_branchEndsVoxelGrid;
+		PackedVoxelGrid<PointData> m_scatterPointsVoxelGrid;
+		PackedVoxelGrid<PointData> m_allocatedPointsVoxelGrid;
+		PackedVoxelGrid<PointData> m_spaceColonizationVoxelGrid;
+		PackedVoxelGrid<BranchEndData> m_branchEndsVoxelGrid;
 
 		ReconstructionSettings m_reconstructionSettings{};
 		ConnectivityGraphSettings m_connectivityGraphSettings{};
@@ -313,4 +314,16 @@ namespace EcoSysLab {
 		void Deserialize(const YAML::Node& in) override;
 		void CollectAssetRef(std::vector<AssetRef>& list) override;
 	};
+
+	template <typename Func>
+	void TreeStructor::FindPoints(const glm::vec3& position, PackedVoxelGrid<PointData>& pointVoxelGrid, const float radius, Func&& func)
+	{
+		pointVoxelGrid.ForEach(position, radius, [&](const PointData& voxel) { func(voxel); });
+	}
+
+	template <typename Func>
+	void TreeStructor::ForEachBranchEnd(const glm::vec3& position, PackedVoxelGrid<BranchEndData>& branchEndsVoxelGrid, const float radius, Func&& func)
+	{
+		branchEndsVoxelGrid.ForEach(position, radius, [&](const BranchEndData& branchEnd) { func(branchEnd); });
+	}
 }
\ No newline at end of file
@@ -91,6 +91,12 @@ namespace EcoSysLab
 		void CollectAssetRef(std::vector<AssetRef>& list) override;
 
 		Entity GenerateMesh(float xDepth = 0.0f, float zDepth = 0.0f);
+		/**
+		 * Mesh the ground from tiles whose resolution drops with the distance to viewPosition, given in the soil's local space.
+		 * Only tiles that are dirty or changed their level of detail are rebuilt.
+		 * @param rebuild Lay out the tiles again and rebuild all of them, needed after the height field or the tile settings changed.
+		 */
+		Entity GenerateTiledMesh(const glm::vec3& viewPosition, bool rebuild);
 
 		void InitializeSoilModel();
 
@@ -103,6 +109,15 @@ namespace EcoSysLab
 		Entity GenerateCutOut(float xDepth, float zDepth, float waterFactor, float nutrientFactor, bool groundSurface);
 		Entity GenerateFullBox(float waterFactor, float nutrientFactor, bool groundSurface);
 	private:
+		Entity GenerateSurfaceQuad(const VoxelSoilModel::SoilTextureSlice& slice);
+		/**
+		 * Replace the "Ground Mesh" child with a new one holding the given mesh.
+		 */
+		Entity SetGroundMesh(const std::vector<Vertex>& vertices, const std::vector<glm::uvec3>& triangles);
+		/**
+		 * Render the textures of all slices in one pass and create a quad for each, parented to the given entity.
+		 */
+		void GenerateSurfaceQuads(std::vector<VoxelSoilModel::SoilTextureSlice>& slices, float waterFactor, float nutrientFactor, Entity parent);
 		// member variables to avoid static variables (in case of multiple Soil instances?)
 		bool m_autoStep = false;
 		bool m_irrigation = true;
@@ -112,5 +127,12 @@ namespace EcoSysLab
 		glm::vec3 m_sourcePosition = glm::vec3(0, 0, 0);
 		float m_sourceAmount = 50.f;
 		float m_sourceWidth = 1.0f;
+		// tiled ground mesh:
+		HeightFieldTileGrid m_groundTiles;
+		float m_groundTileSize = 2.0f;
+		int m_groundTileResolution = 32;
+		float m_groundLodDistance = 5.0f;
+		int m_groundMaxLod = 3;
+		bool m_groundLodFollowCamera = false;
 	};
 }
\ No newline at end of file
@@ -14,11 +14,76 @@ namespace EcoSysLab
 	public:
 		Noise2D m_noises2D;
 		int m_precisionLevel = 2;
-		[[nodiscard]] float GetValue(const glm::vec2& position);
+		[[nodiscard]] float GetValue(const glm::vec2& position) const;
+		/**
+		 * Sample many positions at once, same result as GetValue per position.
+		 */
+		void GetValues(const std::vector<glm::vec2>& positions, std::vector<float>& values) const;
 		void RandomOffset(float min, float max);
 		bool OnInspect(const std::shared_ptr<EditorLayer>& editorLayer) override;
 		void Serialize(YAML::Emitter& out) const override;
 		void Deserialize(const YAML::Node& in) override;
-		void GenerateMesh(const glm::vec2& start, const glm::uvec2& resolution, float unitSize, std::vector<Vertex>& vertices, std::vector<glm::uvec3>& triangles, float xDepth = 1.0f, float zDepth = 1.0f);
+		void GenerateMesh(const glm::vec2& start, const glm::uvec2& resolution, float unitSize, std::vector<Vertex>& vertices, std::vector<glm::uvec3>& triangles, float xDepth = 1.0f, float zDepth = 1.0f) const;
+		/**
+		 * Mesh a square tile of the field. Normals come from central differences, so the heights one step outside the tile are sampled as well.
+		 * @param segmentCount Quads along each side of the tile.
+		 * @param skirtDepth Edge vertices are repeated this far below the surface so that neighbours with a different resolution don't show cracks. 0 for no skirt.
+		 * @param uvStart Texture coordinate mapping is (position - uvStart) / uvSize.
+		 */
+		void GenerateTileMesh(const glm::vec2& tileStart, float tileSize, unsigned segmentCount, float skirtDepth,
+			const glm::vec2& uvStart, const glm::vec2& uvSize, std::vector<Vertex>& vertices, std::vector<glm::uvec3>& triangles) const;
 	};
-}
\ No newline at end of file
+
+	struct HeightFieldTile
+	{
+		std::vector<Vertex> m_vertices;
+		std::vector<glm::uvec3> m_triangles;
+		unsigned m_lod = 0;
+		bool m_dirty = true;
+	};
+
+	/**
+	 * \brief A terrain split into square tiles that are meshed independently.
+	 * Each level of detail halves the tile resolution. Only tiles marked dirty are rebuilt, in parallel.
+	 * Soil::GenerateTiledMesh uses it for the ground surface.
+	 */
+	class HeightFieldTileGrid
+	{
+		glm::vec2 m_start = glm::vec2(0.0f);
+		glm::ivec2 m_tileCount = glm::ivec2(0);
+		float m_tileSize = 1.0f;
+		unsigned m_tileResolution = 32;
+		std::vector<HeightFieldTile> m_tiles;
+	public:
+		float m_skirtDepth = 0.5f;
+		/**
+		 * @param tileResolution Quads along each side of a tile at the finest level of detail.
+		 */
+		void Initialize(const glm::vec2& start, const glm::ivec2& tileCount, float tileSize, unsigned tileResolution);
+		/**
+		 * Pick the level of detail of each tile from its distance to the viewer, one level per lodDistance.
+		 * Tiles whose level changes are marked dirty.
+		 */
+		void UpdateLod(const glm::vec3& viewPosition, float lodDistance, unsigned maxLod);
+		void SetLod(const glm::ivec2& tileCoordinate, unsigned lod);
+		/**
+		 * Mark every tile touching the area as dirty. Tiles next to the area are included since their normals sample across the border.
+		 */
+		void MarkDirty(const glm::vec2& min, const glm::vec2& max);
+		void MarkAllDirty();
+		/**
+		 * Rebuild the dirty tiles.
+		 * @return The number of rebuilt tiles.
+		 */
+		size_t Update(const HeightField& heightField);
+
+		[[nodiscard]] glm::ivec2 GetTileCount() const;
+		[[nodiscard]] glm::ivec2 GetTileCoordinate(const glm::vec2& position) const;
+		[[nodiscard]] const HeightFieldTile& PeekTile(const glm::ivec2& tileCoordinate) const;
+		[[nodiscard]] const std::vector<HeightFieldTile>& PeekTiles() const;
+		/**
+		 * Merge all tiles into one mesh.
+		 */
+		void GetMesh(std::vector<Vertex>& vertices, std::vector<glm::uvec3>& triangles) const;
+	};
+}
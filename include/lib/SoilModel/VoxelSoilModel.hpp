@@ -131,9 +131,35 @@ namespace EcoSysLab {
 			float &roughness,
 			float &metallic, float waterFactor, float nutrientFactor);
 
+		struct SoilTextureSlice
+		{
+			// true: slice at x = m_depth, the texture spans z and y. false: slice at z = m_depth, the texture spans x and y.
+			bool m_alongX = false;
+			bool m_backFacing = false;
+			float m_depth = 0.0f;
+			glm::vec2 m_min = glm::vec2(0.0f);
+			glm::vec2 m_max = glm::vec2(1.0f);
+
+			std::vector<glm::vec4> m_albedoData;
+			std::vector<glm::vec3> m_normalData;
+			std::vector<float> m_roughnessData;
+			std::vector<float> m_metallicData;
+			glm::ivec2 m_outputResolution = glm::ivec2(0);
+		};
+		// renders several slices (e.g. all faces of a cut-out) in one parallel pass over their rows, same texels as GetSoilTextureSlideX/Z.
+		void GetSoilTextureSlides(std::vector<SoilTextureSlice>& slices, float waterFactor, float nutrientFactor, float blur_width = 1) const;
+
 
 		int m_version = 0; // TODO: what does this do?
 	protected:
+		// material blending of GetSoilTextureColorForPosition without allocations.
+		// materialWeights needs one zeroed entry per soil layer and is left zeroed, materialIds is scratch space.
+		void BlendSoilTexture(const glm::vec3& position, int texture_idx, float blur_kernel_width,
+			glm::vec4& albedo,
+			glm::vec3& normal,
+			float& roughness,
+			float& metallic, float waterFactor, float nutrientFactor, std::vector<float>& materialWeights, std::vector<int>& materialIds) const;
+
 		void BuildFromLayers(); // helper function called inside initialize to set up soil layers
 		void SetVoxel(const glm::ivec3& coordinate, const SoilPhysicalMaterial& material);
 
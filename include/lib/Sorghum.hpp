@@ -1,5 +1,6 @@
 #pragma once
 #include "SorghumState.hpp"
+#include "SorghumMeshBuilder.hpp"
 using namespace EvoEngine;
 namespace EcoSysLab
 {
@@ -11,6 +12,11 @@ namespace EcoSysLab
 		AssetRef m_sorghumState;
 		void ClearGeometryEntities();
 		void GenerateGeometryEntities(const SorghumMeshGeneratorSettings& sorghumMeshGeneratorSettings);
+		/**
+		 * \brief Creates the organ entities from buffers built by SorghumMeshBuilder. Must run on the main thread.
+		 */
+		void CreateGeometryEntities(const std::shared_ptr<SorghumState>& sorghumState, const SorghumGeometryBuffers& geometryBuffers,
+			const SorghumMeshGeneratorSettings& sorghumMeshGeneratorSettings);
 
 		void Serialize(YAML::Emitter& out) const override;
 		void Deserialize(const YAML::Node& in) override;
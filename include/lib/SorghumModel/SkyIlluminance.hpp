@@ -1,4 +1,5 @@
 #pragma once
+#include "ClimateForcing.hpp"
 
 using namespace EvoEngine;
 namespace EcoSysLab {
@@ -10,11 +11,23 @@ struct SkyIlluminanceSnapshot {
   [[nodiscard]] float GetSunIntensity();
 };
 class SkyIlluminance : public IAsset {
+  /**
+   * \brief Uniformly resampled copy of the snapshots for constant time lookup, rebuilt whenever the snapshots are loaded.
+   */
+  ClimateForcing m_forcing;
 public:
   std::map<float, SkyIlluminanceSnapshot> m_snapshots;
   float m_minTime;
   float m_maxTime;
+  /**
+   * \brief Rebuild the lookup tables after changing the snapshots.
+   */
+  void UpdateForcing();
   [[nodiscard]] SkyIlluminanceSnapshot Get(float time);
+  /**
+   * \brief Look up many times at once.
+   */
+  void Get(const std::vector<float>& times, std::vector<SkyIlluminanceSnapshot>& snapshots);
   void ImportCSV(const std::filesystem::path &path);
   bool OnInspect(const std::shared_ptr<EditorLayer>& editorLayer) override;
   void Serialize(YAML::Emitter &out) const override;
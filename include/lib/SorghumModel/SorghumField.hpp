@@ -16,8 +16,13 @@ namespace EcoSysLab {
 	public:
 		int m_sizeLimit = 2000;
 		float m_sorghumSize = 1.0f;
+		/**
+		 * \brief Draw the plants as instances of the shared prototypes of the geometry cache instead of one entity per plant.
+		 */
+		bool m_instanced = false;
 		std::vector<std::pair<AssetRef, glm::mat4>> m_matrices;
 		Entity InstantiateField() const;
+		Entity InstantiateInstancedField() const;
 		bool OnInspect(const std::shared_ptr<EditorLayer>& editorLayer) override;
 		void Serialize(YAML::Emitter& out) const override;
 		void Deserialize(const YAML::Node& in) override;
@@ -0,0 +1,80 @@
+#pragma once
+#include "SorghumState.hpp"
+using namespace EvoEngine;
+namespace EcoSysLab
+{
+	class SorghumStateGenerator;
+	struct SorghumGeometryCacheSettings
+	{
+		/**
+		 * \brief Number of shape variants generated per descriptor. Every plant of an instanced field uses one of them.
+		 */
+		int m_variantCount = 16;
+		/**
+		 * \brief Number of levels of detail. Every level doubles the vertical subdivision length and halves the horizontal subdivision.
+		 */
+		int m_lodCount = 3;
+		/**
+		 * \brief Distance at which level 1 starts. Every following level starts at twice the distance of the previous one.
+		 */
+		float m_lodDistance = 10.0f;
+		glm::vec3 m_lodCenter = glm::vec3(0.0f);
+		bool OnInspect(const std::shared_ptr<EditorLayer>& editorLayer);
+		[[nodiscard]] int GetLod(float distance) const;
+	};
+
+	struct SorghumPrototypeLod
+	{
+		std::shared_ptr<Mesh> m_stemMesh;
+		std::shared_ptr<Mesh> m_leafMesh;
+	};
+
+	struct SorghumPrototype
+	{
+		std::shared_ptr<SorghumState> m_sorghumState;
+		std::shared_ptr<Mesh> m_panicleMesh;
+		std::vector<SorghumPrototypeLod> m_lods;
+	};
+
+	struct SorghumPrototypeSet
+	{
+		/**
+		 * \brief SorghumStateGenerator::GetParameterVersion of the descriptor when the prototypes were built.
+		 */
+		unsigned m_parameterVersion = 0;
+		std::vector<SorghumPrototype> m_prototypes;
+	};
+
+	/**
+	 * \brief Shared meshes and materials for many sorghum plants. Meshes are built once per descriptor, variant and level of detail.
+	 */
+	class SorghumGeometryCache
+	{
+		std::unordered_map<Handle, SorghumPrototypeSet> m_prototypes;
+		SorghumMeshGeneratorSettings m_builtMeshGeneratorSettings{};
+		int m_builtVariantCount = 0;
+		int m_builtLodCount = 0;
+		float m_builtVerticalSubdivisionLength = 0.0f;
+		int m_builtHorizontalSubdivisionStep = 0;
+		std::shared_ptr<Material> m_stemMaterial;
+		std::shared_ptr<Material> m_untexturedLeafMaterial;
+	public:
+		SorghumGeometryCacheSettings m_settings{};
+		/**
+		 * \brief Returns the variants of the descriptor and builds them on first use. Changed settings invalidate the cache,
+		 * edits to the descriptor rebuild its variants.
+		 */
+		const std::vector<SorghumPrototype>& GetPrototypes(const std::shared_ptr<SorghumStateGenerator>& sorghumStateGenerator,
+			const SorghumMeshGeneratorSettings& sorghumMeshGeneratorSettings);
+		/**
+		 * \brief Material shared by all stems, following the properties of the leaf material of the layer.
+		 */
+		[[nodiscard]] std::shared_ptr<Material> GetStemMaterial();
+		/**
+		 * \brief Material shared by all separated leaves, following the properties of the leaf material of the layer.
+		 */
+		[[nodiscard]] std::shared_ptr<Material> GetUntexturedLeafMaterial();
+		void Clear();
+		[[nodiscard]] size_t GetPrototypeSize() const;
+	};
+}
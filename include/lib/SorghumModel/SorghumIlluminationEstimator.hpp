@@ -0,0 +1,84 @@
+#pragma once
+#include "SkyIlluminance.hpp"
+#include "TriangleBVH.hpp"
+using namespace EvoEngine;
+namespace EcoSysLab
+{
+	struct SorghumIlluminationSettings
+	{
+		/**
+		 * \brief Samples are taken in batches, each batch is one stratified set over the triangle and the hemisphere.
+		 * Rounded down to a square number.
+		 */
+		int m_batchSize = 16;
+		int m_minBatches = 2;
+		int m_maxBatches = 32;
+		/**
+		 * \brief A triangle stops sampling once the standard error of its mean is below this fraction of the mean.
+		 */
+		float m_convergenceThreshold = 0.02f;
+		/**
+		 * \brief Number of diffuse interreflections between leaves after the first hit.
+		 */
+		int m_bounces = 1;
+		float m_leafReflectance = 0.1f;
+		float m_groundReflectance = 0.15f;
+		/**
+		 * \brief Fraction of the global horizontal irradiance coming from the isotropic sky instead of the sun disk.
+		 */
+		float m_diffuseFraction = 0.2f;
+		float m_pushDistance = 0.001f;
+		unsigned m_seed = 0;
+		bool OnInspect(const std::shared_ptr<EditorLayer>& editorLayer);
+	};
+
+	struct SorghumIlluminationPlant
+	{
+		/**
+		 * \brief The sorghum entity, invalid for plants of an instanced field.
+		 */
+		Entity m_entity{};
+		std::string m_name;
+		glm::vec3 m_position = glm::vec3(0.0f);
+	};
+
+	/**
+	 * \brief Irradiance of every triangle of a sorghum field, estimated by path tracing on the CPU.
+	 * The field is collected into one BVH and all triangles are sampled in parallel.
+	 */
+	class SorghumIlluminationEstimator
+	{
+		TriangleBVH m_bvh;
+		std::vector<glm::vec3> m_positions;
+		std::vector<glm::uvec3> m_triangles;
+		std::vector<glm::vec3> m_triangleNormals;
+		std::vector<float> m_triangleAreas;
+		std::vector<unsigned> m_trianglePlantIndices;
+		std::vector<SorghumIlluminationPlant> m_plants;
+		void AddMesh(const std::shared_ptr<Mesh>& mesh, const glm::mat4& transform, unsigned plantIndex);
+		std::vector<float> m_triangleIrradiance;
+		std::vector<unsigned> m_triangleSampleCounts;
+	public:
+		SorghumIlluminationSettings m_settings{};
+		/**
+		 * \brief Gather the leaf and stem meshes of all sorghums of the scene in world space and rebuild the BVH.
+		 * Instanced fields count every instance as one plant, shared by the stem, leaf and panicle instances with the same matrix.
+		 */
+		void CollectField(const std::shared_ptr<Scene>& scene);
+		/**
+		 * \brief Estimate the irradiance of all collected triangles under the given sky.
+		 */
+		void Estimate(SkyIlluminanceSnapshot snapshot);
+		void Clear();
+
+		[[nodiscard]] size_t GetTriangleSize() const;
+		[[nodiscard]] size_t GetPlantSize() const;
+		[[nodiscard]] const std::vector<float>& GetTriangleIrradiance() const;
+		/**
+		 * \brief Irradiance integrated over the area of the plant, same order as the plants found by CollectField.
+		 */
+		[[nodiscard]] std::vector<float> GetPlantIntercepted() const;
+		[[nodiscard]] float GetAverageSampleCount() const;
+		void ExportCSV(const std::shared_ptr<Scene>& scene, const std::filesystem::path& path) const;
+	};
+}
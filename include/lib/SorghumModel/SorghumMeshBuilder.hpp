@@ -0,0 +1,33 @@
+#pragma once
+#include "SorghumState.hpp"
+using namespace EvoEngine;
+namespace EcoSysLab
+{
+	struct SorghumMeshBuffer
+	{
+		std::vector<Vertex> m_vertices;
+		std::vector<unsigned int> m_indices;
+	};
+
+	/**
+	 * \brief Stem and leaf geometry of one plant. Leaves hold one buffer per leaf when separated, otherwise one merged buffer.
+	 */
+	struct SorghumGeometryBuffers
+	{
+		SorghumMeshBuffer m_stem;
+		std::vector<SorghumMeshBuffer> m_leaves;
+	};
+
+	/**
+	 * \brief Builds the stem and leaf buffers of many plants at once. A counting pass sizes every buffer, then all organs
+	 * of all plants write their vertices and indices in parallel. Creating meshes and entities is left to the caller.
+	 */
+	class SorghumMeshBuilder
+	{
+	public:
+		static void Build(const std::vector<std::shared_ptr<SorghumState>>& sorghumStates,
+			const SorghumMeshGeneratorSettings& sorghumMeshGeneratorSettings,
+			float verticalSubdivisionLength, int horizontalSubdivisionStep,
+			std::vector<SorghumGeometryBuffers>& geometryBuffers);
+	};
+}
@@ -40,6 +40,19 @@ namespace EcoSysLab
 
 		void GenerateGeometry(std::vector<Vertex>& vertices,
 			std::vector<unsigned int>& indices) const;
+		/**
+		 * \brief Same as above with explicit subdivision, used to build coarser levels of detail.
+		 */
+		void GenerateGeometry(std::vector<Vertex>& vertices,
+			std::vector<unsigned int>& indices, float verticalSubdivisionLength, int horizontalSubdivisionStep) const;
+		[[nodiscard]] static size_t GetVertexCount(size_t segmentSize, int horizontalSubdivisionStep);
+		[[nodiscard]] static size_t GetIndexCount(size_t segmentSize, int horizontalSubdivisionStep);
+		/**
+		 * \brief Writes the geometry of already subdivided segments into preallocated buffers sized by GetVertexCount and GetIndexCount.
+		 * \param vertexIndex Index of the first written vertex within the final mesh.
+		 */
+		static void GenerateGeometry(const std::vector<SorghumSplineSegment>& segments, int horizontalSubdivisionStep,
+			Vertex* vertices, unsigned int* indices, size_t vertexIndex);
 	};
 
 	class SorghumLeafState
@@ -53,6 +66,16 @@ namespace EcoSysLab
 
 		void GenerateGeometry(std::vector<Vertex>& vertices,
 			std::vector<unsigned int>& indices, bool bottomFace = false, float thickness = 0.0f) const;
+		void GenerateGeometry(std::vector<Vertex>& vertices,
+			std::vector<unsigned int>& indices, bool bottomFace, float thickness, float verticalSubdivisionLength, int horizontalSubdivisionStep) const;
+		[[nodiscard]] static size_t GetVertexCount(size_t segmentSize, int horizontalSubdivisionStep);
+		[[nodiscard]] static size_t GetIndexCount(size_t segmentSize, int horizontalSubdivisionStep);
+		/**
+		 * \brief Writes the geometry of already subdivided segments into preallocated buffers sized by GetVertexCount and GetIndexCount.
+		 * \param vertexIndex Index of the first written vertex within the final mesh.
+		 */
+		void GenerateGeometry(const std::vector<SorghumSplineSegment>& segments, bool bottomFace, float thickness, int horizontalSubdivisionStep,
+			Vertex* vertices, unsigned int* indices, size_t vertexIndex) const;
 	};
 
 	class SorghumState : public IAsset
@@ -7,6 +7,7 @@ using namespace EvoEngine;
 namespace EcoSysLab {
 
 class SorghumStateGenerator : public IAsset {
+  unsigned m_parameterVersion = 0;
 public:
   //Panicle
   SingleDistribution<glm::vec2> m_panicleSize;
@@ -48,6 +49,12 @@ public:
   void Serialize(YAML::Emitter &out) const override;
   void Deserialize(const YAML::Node &in) override;
 
+  /**
+   * \brief Changes whenever the parameters are edited or loaded. Call MarkParametersChanged after setting them from code.
+   */
+  [[nodiscard]] unsigned GetParameterVersion() const;
+  void MarkParametersChanged();
+
   [[nodiscard]] Entity CreateEntity(unsigned int seed = 0) const;
   void Apply(const std::shared_ptr<SorghumState>& targetState, unsigned int seed = 0) const;
 };
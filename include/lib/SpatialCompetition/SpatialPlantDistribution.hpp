@@ -72,7 +72,50 @@ namespace EcoSysLab
 		bool m_forceRemoveOverlap = true;
 
 		float m_dynamicBalanceFactor = 3.0f;
+		/**
+		 * \brief Seed of all random decisions in the simulation. The same seed and starting state give the same result at any thread count.
+		 */
+		unsigned m_seed = 0;
+	};
 
+	/**
+	 * \brief Counter-based random numbers. A value only depends on the seed and the counters, never on which thread draws it or in which order.
+	 */
+	struct SpatialPlantRandom
+	{
+		[[nodiscard]] static uint64_t Hash(uint64_t seed, uint64_t counter0, uint64_t counter1, uint64_t counter2);
+		/**
+		 * \return Uniform value in [0, 1).
+		 */
+		[[nodiscard]] static float Uniform(uint64_t seed, uint64_t counter0, uint64_t counter1, uint64_t counter2);
+	};
+
+	/**
+	 * \brief Removes overlaps between plants. Plants are ranked by value, then by a hashed tie-break, then by id,
+	 * and the random draws of a contest are keyed by the ids of both plants, packed as (winner << 32) | loser. The result does not depend on the thread count.
+	 */
+	struct SpatialPlantOverlapResolver
+	{
+		enum : unsigned char { Undecided = 0, Survived = 1, Removed = 2 };
+		std::vector<float> m_values;
+		/**
+		 * \brief Stable identity of each entry, used as the counter of its random draws.
+		 */
+		std::vector<uint64_t> m_ids;
+		/**
+		 * \brief Indices of the overlapping entries, sorted ascending.
+		 */
+		std::vector<std::vector<int>> m_neighborLists;
+		/**
+		 * \brief Set to Removed for entries that don't take part, Undecided for the others. Holds the result after Resolve.
+		 */
+		std::vector<unsigned char> m_states;
+		void Resize(size_t size);
+		void Resolve(bool forceRemoveOverlap, uint64_t seed, uint64_t time);
+	private:
+		std::vector<unsigned char> m_ready;
+		std::vector<int> m_cutoffs;
+		std::vector<uint64_t> m_tieBreaks;
 	};
 
 	struct SpatialPlantGridCell
@@ -94,6 +137,9 @@ namespace EcoSysLab
 
 	class SpatialPlantDistribution {
 		SpatialPlantGrid m_plantGrid;
+		void CollectNeighbors(const SpatialPlant& plant, float maxRadius, std::vector<SpatialPlantHandle>& neighbors);
+		void SeedPlants();
+		void ResolveOverlaps(float maxRadius);
 	public:
 		SpatialPlantDistribution();
 		int m_simulationTime = 0;
@@ -102,6 +148,12 @@ namespace EcoSysLab
 		std::queue<SpatialPlantHandle> m_recycledPlants{};
 		SpatialPlantGlobalParameters m_spatialPlantGlobalParameters{};
 		[[nodiscard]] float CalculateGrowth(const SpatialPlantGlobalParameters &richardGrowthModelParameters, SpatialPlantHandle plantHandle, const std::vector<SpatialPlantHandle> &neighborPlantHandles) const;
+		[[nodiscard]] static float CalculateGrowth(const SpatialPlantGlobalParameters& richardGrowthModelParameters, const std::vector<SpatialPlantParameter>& spatialPlantParameters,
+			const std::vector<SpatialPlant>& plants, int plantIndex, const std::vector<int>& neighborPlantIndices);
+		/**
+		 * \brief Fits the grid to m_maxRadius of the global parameters. Plants outside of it are recycled.
+		 */
+		void UpdateGrid();
 		void Simulate();
 
 		SpatialPlantHandle AddPlant(SpatialPlantParameterHandle spatialPlantParameterHandle, float radius, const glm::vec2 &position);
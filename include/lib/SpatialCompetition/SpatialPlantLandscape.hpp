@@ -0,0 +1,126 @@
+#pragma once
+#include "SpatialPlantDistribution.hpp"
+using namespace EvoEngine;
+namespace EcoSysLab
+{
+	/**
+	 * \brief Plants of one square tile of the landscape, stored as flat arrays.
+	 */
+	struct SpatialPlantTile
+	{
+		glm::ivec2 m_coordinate = glm::ivec2(0);
+		std::vector<glm::vec2> m_positions;
+		std::vector<float> m_radii;
+		std::vector<SpatialPlantParameterHandle> m_parameterHandles;
+		/**
+		 * \brief Landscape-wide id of the plant, used as the counter of its random draws.
+		 */
+		std::vector<uint64_t> m_ids;
+
+		[[nodiscard]] size_t GetPlantSize() const;
+		void AddPlant(uint64_t id, SpatialPlantParameterHandle parameterHandle, float radius, const glm::vec2& position);
+		/**
+		 * \brief Removes the plants with a non-zero flag and keeps the order of the rest.
+		 */
+		void RemovePlants(const std::vector<unsigned char>& removeFlags);
+		void Clear();
+		[[nodiscard]] bool Save(const std::filesystem::path& path) const;
+		[[nodiscard]] bool Load(const std::filesystem::path& path);
+	};
+
+	/**
+	 * \brief Packed cell index over a flat list of plants. Cells are stored as one index array with offsets.
+	 */
+	class SpatialPlantCellIndex
+	{
+		glm::vec2 m_min = glm::vec2(0.0f);
+		float m_cellSize = 1.0f;
+		glm::ivec2 m_resolution = glm::ivec2(0);
+		std::vector<unsigned> m_cellStarts;
+		std::vector<unsigned> m_plantIndices;
+	public:
+		void Build(const std::vector<SpatialPlant>& plants, const glm::vec2& min, const glm::vec2& max, float cellSize);
+		/**
+		 * \brief Visits the plants of every cell that touches the square around the position, in cell order.
+		 */
+		template<typename Func>
+		void ForEachPlant(const glm::vec2& position, float radius, Func&& func) const;
+	};
+
+	/**
+	 * \brief Landscape made of fixed-size tiles. Only the tiles inside the active region are simulated. Their neighbors are
+	 * kept in memory as the halo, every other tile is written to the storage folder and loaded again when needed.
+	 */
+	class SpatialPlantLandscape
+	{
+		std::map<uint64_t, SpatialPlantTile> m_tiles;
+		std::set<uint64_t> m_storedTiles;
+		uint64_t m_nextPlantId = 0;
+
+		[[nodiscard]] std::filesystem::path GetTilePath(const glm::ivec2& coordinate) const;
+		SpatialPlantTile& RefTile(const glm::ivec2& coordinate);
+		void CollectPlants(const SpatialPlantTile& tile, float haloWidth, std::vector<SpatialPlant>& plants, std::vector<uint64_t>& ids) const;
+		void EvictTiles();
+	public:
+		/**
+		 * \brief Edge length of a tile. The interaction range of the largest plant should stay below it.
+		 */
+		float m_tileSize = 200.0f;
+		/**
+		 * \brief First and last tile coordinates of the active region, both inclusive.
+		 */
+		glm::ivec2 m_activeMin = glm::ivec2(0);
+		glm::ivec2 m_activeMax = glm::ivec2(0);
+		std::filesystem::path m_storagePath;
+		int m_simulationTime = 0;
+		std::vector<SpatialPlantParameter> m_spatialPlantParameters{};
+		SpatialPlantGlobalParameters m_spatialPlantGlobalParameters{};
+
+		[[nodiscard]] static uint64_t GetTileKey(const glm::ivec2& coordinate);
+		[[nodiscard]] glm::ivec2 GetTileCoordinate(const glm::vec2& position) const;
+		[[nodiscard]] bool IsActive(const glm::ivec2& coordinate) const;
+
+		uint64_t AddPlant(SpatialPlantParameterHandle spatialPlantParameterHandle, float radius, const glm::vec2& position);
+		/**
+		 * \brief Replaces the landscape with the parameters and plants of a distribution.
+		 */
+		void Import(const SpatialPlantDistribution& distribution);
+		/**
+		 * \brief Copies the plants of the active region into a distribution, e.g. for display.
+		 */
+		void Export(SpatialPlantDistribution& distribution) const;
+		void Simulate();
+		/**
+		 * \brief Writes all tiles in memory to the storage folder, together with the landscape state (plant id counter, time, parameters and the stored tiles).
+		 */
+		bool Save();
+		/**
+		 * \brief Replaces the landscape with the one saved in the storage folder. Tiles are loaded when they are needed.
+		 */
+		bool Load();
+		void Clear();
+
+		[[nodiscard]] size_t GetResidentTileSize() const;
+		[[nodiscard]] size_t GetStoredTileSize() const;
+		[[nodiscard]] size_t GetResidentPlantSize() const;
+	};
+
+	template <typename Func>
+	void SpatialPlantCellIndex::ForEachPlant(const glm::vec2& position, const float radius, Func&& func) const
+	{
+		if (m_resolution.x == 0 || m_resolution.y == 0) return;
+		const auto minCoordinate = glm::clamp(glm::ivec2(glm::floor((position - radius - m_min) / m_cellSize)), glm::ivec2(0), m_resolution - 1);
+		const auto maxCoordinate = glm::clamp(glm::ivec2(glm::floor((position + radius - m_min) / m_cellSize)), glm::ivec2(0), m_resolution - 1);
+		for (int x = minCoordinate.x; x <= maxCoordinate.x; x++)
+		{
+			for (int y = minCoordinate.y; y <= maxCoordinate.y; y++)
+			{
+				const auto cellIndex = x * m_resolution.y + y;
+				for (auto i = m_cellStarts[cellIndex]; i < m_cellStarts[cellIndex + 1]; i++)
+				{
+					func(static_cast<int>(m_plantIndices[i]));
+				}
+			}
+		}
+	}
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "SpatialPlantDistribution.hpp"
+#include "SpatialPlantLandscape.hpp"
 #include "TreeModel.hpp"
 using namespace EvoEngine;
 namespace EcoSysLab {
@@ -9,6 +10,9 @@ namespace EcoSysLab {
 		std::vector<AssetRef> m_treeDescriptors{};
 
 		SpatialPlantDistribution m_distribution{};
+		SpatialPlantLandscape m_landscape{};
+		char m_landscapeStoragePath[256] = "SpatialPlantTiles";
+		int m_landscapeStepCount = 1;
 		bool m_simulate = false;
 		static void OnInspectSpatialPlantDistributionFunction(const SpatialPlantDistribution& spatialPlantDistribution,
 			const std::function<void(glm::vec2 position)>& func, const std::function<void(ImVec2 origin, float zoomFactor, ImDrawList*)>& drawFunc);
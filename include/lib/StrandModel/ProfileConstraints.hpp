@@ -3,8 +3,52 @@
 using namespace EvoEngine;
 namespace EcoSysLab
 {
+	/**
+	 * \brief Uniform grid over a set of segments, built once so that queries don't scan every segment.
+	 * Each cell keeps the segments that can be closest to some point inside it, so closest point queries match a full scan.
+	 */
+	class ProfileSegmentGrid
+	{
+		glm::vec2 m_minBound = glm::vec2(0.0f);
+		glm::ivec2 m_resolution = glm::ivec2(0);
+		float m_cellSize = 1.0f;
+		bool m_closed = false;
+		std::vector<std::pair<glm::vec2, glm::vec2>> m_segments{};
+		std::vector<unsigned char> m_centerInside{};
+		std::vector<unsigned> m_candidateOffsets{};
+		std::vector<unsigned> m_candidates{};
+		[[nodiscard]] int GetCellIndex(const glm::vec2& position) const;
+		[[nodiscard]] glm::vec2 GetCellCenter(int cellIndex) const;
+	public:
+		/**
+		 * @param closed The segments form a closed loop, enables inside tests.
+		 * @param resolution Cells along the longer side of the segments' bounding box. The grid reaches half that size beyond the box.
+		 */
+		void Build(const std::vector<std::pair<glm::vec2, glm::vec2>>& segments, bool closed, unsigned resolution);
+		void Clear();
+		[[nodiscard]] bool Empty() const;
+		[[nodiscard]] size_t GetSegmentCount() const;
+		/**
+		 * @return False if the position is outside the grid.
+		 */
+		bool FindClosestPoint(const glm::vec2& position, glm::vec2& closestPoint) const;
+		/**
+		 * Even-odd test, only valid for closed loops. For simple loops it agrees with the four ray test of ProfileBoundary,
+		 * self-intersecting loops can differ since that test needs an odd count on every ray.
+		 * @return False if the position is outside the grid, lies on a segment, or its path from the cell center passes
+		 * a vertex, where the answer depends on rounding. Callers fall back to the full scan then.
+		 */
+		bool InBoundary(const glm::vec2& position, bool& inBoundary) const;
+		/**
+		 * Distance to the closest segment, negative inside closed loops.
+		 * @return False if the position is outside the grid.
+		 */
+		bool GetSignedDistance(const glm::vec2& position, float& signedDistance) const;
+	};
+
 	class ProfileBoundary
 	{
+		ProfileSegmentGrid m_segmentGrid{};
 	public:
 		std::vector<glm::vec2> m_points {};
 		glm::vec2 m_center = glm::vec2(0.0f);
@@ -14,13 +58,23 @@ namespace EcoSysLab
 		[[nodiscard]] bool InBoundary(const glm::vec2& position) const;
 		[[nodiscard]] bool InBoundary(const glm::vec2& position, glm::vec2& closestPoint) const;
 		static bool Intersect(const glm::vec2& p1, const glm::vec2& q1, const glm::vec2& p2, const glm::vec2& q2);
+		/**
+		 * Precompute the grid used by InBoundary. Rebuild after editing the points, queries fall back to the full scan
+		 * if the point count no longer matches or the position is outside the grid.
+		 */
+		void BuildSegmentGrid(unsigned resolution = 64);
 	};
 	class ProfileAttractor
 	{
+		ProfileSegmentGrid m_segmentGrid{};
 	public:
 		std::vector<std::pair<glm::vec2, glm::vec2>> m_attractorPoints{};
 		void RenderAttractor(ImVec2 origin, float zoomFactor, ImDrawList* drawList, ImU32 color, float thickness) const;
 		glm::vec2 FindClosestPoint(const glm::vec2& position) const;
+		/**
+		 * Precompute the grid used by FindClosestPoint, see ProfileBoundary::BuildSegmentGrid.
+		 */
+		void BuildSegmentGrid(unsigned resolution = 64);
 	};
 	class ProfileConstraints
 	{
@@ -30,5 +84,9 @@ namespace EcoSysLab
 		[[nodiscard]] int FindBoundary(const glm::vec2& position) const;
 		[[nodiscard]] bool Valid(size_t boundaryIndex) const;
 		[[nodiscard]] glm::vec2 GetTarget(const glm::vec2& position) const;
+		/**
+		 * Build the segment grids of all boundaries and attractors, call once after the constraints change.
+		 */
+		void BuildSegmentGrids(unsigned resolution = 64);
 	};
 }
\ No newline at end of file
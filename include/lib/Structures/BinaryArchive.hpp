@@ -0,0 +1,162 @@
+#pragma once
+#include "TreeIOUtils.hpp"
+using namespace EvoEngine;
+namespace EcoSysLab {
+	/**
+	 * \brief Read only view of a typed array stored in an archive chunk.
+	 */
+	template<typename T>
+	struct BinaryArchiveView
+	{
+		const T* m_data = nullptr;
+		size_t m_size = 0;
+		[[nodiscard]] const T* begin() const { return m_data; }
+		[[nodiscard]] const T* end() const { return m_data + m_size; }
+		[[nodiscard]] size_t size() const { return m_size; }
+		[[nodiscard]] bool empty() const { return m_size == 0; }
+		const T& operator[](const size_t index) const { return m_data[index]; }
+	};
+
+	/**
+	 * \brief Collects named chunks of raw data and writes them as one versioned binary file.
+	 * Layout: a 32 byte header, the chunk payloads aligned to 16 bytes, then the chunk table.
+	 */
+	class BinaryArchiveWriter
+	{
+		struct Chunk
+		{
+			std::string m_name;
+			std::vector<unsigned char> m_data;
+			size_t m_rawSize = 0;
+			unsigned m_flags = 0;
+			unsigned m_elementSize = 1;
+		};
+		std::vector<Chunk> m_chunks;
+		std::unordered_set<std::string> m_chunkNames;
+	public:
+		/**
+		 * \brief Compress chunks added without an explicit choice. Chunks that don't shrink are stored raw.
+		 */
+		bool m_compress = false;
+		/**
+		 * @return False if a chunk with the same name was already added, the archive is left unchanged.
+		 */
+		bool AddChunk(const std::string& name, const void* data, size_t size, unsigned elementSize, bool compress);
+		bool AddChunk(const std::string& name, const void* data, size_t size, unsigned elementSize = 1);
+		template<typename T>
+		bool AddArray(const std::string& name, const std::vector<T>& list);
+		template<typename T>
+		bool AddValue(const std::string& name, const T& value);
+		/**
+		 * \brief Store one field of every element as a column.
+		 * @param getter Called as getter(const Element&), returns T.
+		 */
+		template<typename T, typename Element, typename Getter>
+		bool AddColumn(const std::string& name, const std::vector<Element>& elements, Getter&& getter);
+		bool Write(const std::filesystem::path& path) const;
+		void Clear();
+	};
+
+	/**
+	 * \brief Opens an archive written by BinaryArchiveWriter by mapping the file into memory.
+	 * Raw chunks are returned as views into the mapping without copies, compressed chunks are inflated once on first access.
+	 * Views stay valid until the reader is closed. Reads may come from several threads at once.
+	 */
+	class BinaryArchiveReader
+	{
+		struct ChunkEntry
+		{
+			uint64_t m_offset = 0;
+			uint64_t m_storedSize = 0;
+			uint64_t m_rawSize = 0;
+			unsigned m_flags = 0;
+			unsigned m_elementSize = 1;
+		};
+		std::unordered_map<std::string, ChunkEntry> m_entries;
+		mutable std::unordered_map<std::string, std::vector<unsigned char>> m_inflatedChunks;
+		mutable std::mutex m_inflatedChunksMutex;
+		treeutil::MappedFile m_file;
+		const unsigned char* m_data = nullptr;
+		size_t m_size = 0;
+		bool GetChunk(const std::string& name, const unsigned char*& data, size_t& size) const;
+	public:
+		BinaryArchiveReader() = default;
+		BinaryArchiveReader(const BinaryArchiveReader&) = delete;
+		BinaryArchiveReader& operator=(const BinaryArchiveReader&) = delete;
+		~BinaryArchiveReader();
+		bool Open(const std::filesystem::path& path);
+		void Close();
+		[[nodiscard]] bool HasChunk(const std::string& name) const;
+		[[nodiscard]] std::vector<std::string> GetChunkNames() const;
+		/**
+		 * @return An empty view if the chunk is missing.
+		 */
+		template<typename T>
+		[[nodiscard]] BinaryArchiveView<T> GetArray(const std::string& name) const;
+		template<typename T>
+		bool GetValue(const std::string& name, T& value) const;
+		/**
+		 * \brief Load a column written by AddColumn back into the elements. Extra values on either side are ignored.
+		 * @param setter Called as setter(Element&, const T&).
+		 * @return False if the chunk is missing.
+		 */
+		template<typename T, typename Element, typename Setter>
+		bool ReadColumn(const std::string& name, std::vector<Element>& elements, Setter&& setter) const;
+	};
+
+	template <typename T>
+	bool BinaryArchiveWriter::AddArray(const std::string& name, const std::vector<T>& list)
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		return AddChunk(name, list.data(), list.size() * sizeof(T), sizeof(T));
+	}
+
+	template <typename T>
+	bool BinaryArchiveWriter::AddValue(const std::string& name, const T& value)
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		return AddChunk(name, &value, sizeof(T), sizeof(T), false);
+	}
+
+	template <typename T, typename Element, typename Getter>
+	bool BinaryArchiveWriter::AddColumn(const std::string& name, const std::vector<Element>& elements, Getter&& getter)
+	{
+		std::vector<T> list(elements.size());
+		for (size_t i = 0; i < elements.size(); i++) list[i] = getter(elements[i]);
+		return AddArray(name, list);
+	}
+
+	template <typename T>
+	BinaryArchiveView<T> BinaryArchiveReader::GetArray(const std::string& name) const
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		BinaryArchiveView<T> retVal{};
+		const unsigned char* data = nullptr;
+		size_t size = 0;
+		if (!GetChunk(name, data, size)) return retVal;
+		retVal.m_data = reinterpret_cast<const T*>(data);
+		retVal.m_size = size / sizeof(T);
+		return retVal;
+	}
+
+	template <typename T>
+	bool BinaryArchiveReader::GetValue(const std::string& name, T& value) const
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		const unsigned char* data = nullptr;
+		size_t size = 0;
+		if (!GetChunk(name, data, size) || size != sizeof(T)) return false;
+		std::memcpy(&value, data, sizeof(T));
+		return true;
+	}
+
+	template <typename T, typename Element, typename Setter>
+	bool BinaryArchiveReader::ReadColumn(const std::string& name, std::vector<Element>& elements, Setter&& setter) const
+	{
+		const auto list = GetArray<T>(name);
+		if (!HasChunk(name)) return false;
+		const auto size = glm::min(list.size(), elements.size());
+		for (size_t i = 0; i < size; i++) setter(elements[i], list[i]);
+		return true;
+	}
+}
@@ -0,0 +1,291 @@
+#pragma once
+#include "Jobs.hpp"
+using namespace EvoEngine;
+namespace EcoSysLab {
+	/**
+	 * \brief Spatial index that keeps the elements of all voxels in one array sorted by voxel, with a table of voxel offsets.
+	 * Uses the same coordinate system as VoxelGrid. ElementData must have a glm::vec3 m_position.
+	 * Within a voxel, elements keep the order in which they were passed to Build.
+	 */
+	template <typename ElementData>
+	class PackedVoxelGrid
+	{
+		std::vector<ElementData> m_elements;
+		/**
+		 * Voxel i owns the elements in [m_voxelOffsets[i], m_voxelOffsets[i] + m_voxelCounts[i]).
+		 * The count drops below the allocated range when elements are removed.
+		 */
+		std::vector<unsigned> m_voxelOffsets;
+		std::vector<unsigned> m_voxelCounts;
+		std::vector<unsigned> m_elementVoxelIndices;
+		std::vector<unsigned> m_order;
+		glm::vec3 m_minBound = glm::vec3(0.0f);
+		float m_voxelSize = 1.0f;
+		glm::ivec3 m_resolution = { 0, 0, 0 };
+	public:
+		void Initialize(float voxelSize, const glm::vec3& minBound, const glm::vec3& maxBound);
+		/**
+		 * Replace all elements with a parallel counting sort by voxel. Elements outside the bounds are kept in the closest voxel.
+		 */
+		void Build(const std::vector<ElementData>& elements);
+		void Clear();
+
+		[[nodiscard]] size_t GetVoxelCount() const;
+		[[nodiscard]] size_t GetElementCount() const;
+		[[nodiscard]] glm::ivec3 GetResolution() const;
+		[[nodiscard]] glm::vec3 GetMinBound() const;
+		[[nodiscard]] float GetVoxelSize() const;
+		[[nodiscard]] int GetIndex(const glm::ivec3& coordinate) const;
+		[[nodiscard]] glm::ivec3 GetCoordinate(const glm::vec3& position) const;
+
+		/**
+		 * Visit every element within the radius of the center.
+		 * @param visitor Called as visitor(ElementData&).
+		 */
+		template <typename Visitor>
+		void ForEach(const glm::vec3& center, float radius, Visitor&& visitor);
+		/**
+		 * @return True if any element is within the radius of the center. Stops at the first one.
+		 */
+		[[nodiscard]] bool Any(const glm::vec3& center, float radius) const;
+		/**
+		 * Remove elements within the radius of the center for which the predicate returns true. Removal does not keep the order within a voxel.
+		 * @param predicate Called as predicate(const ElementData&).
+		 */
+		template <typename Predicate>
+		void RemoveIf(const glm::vec3& center, float radius, Predicate&& predicate);
+		/**
+		 * Visit the remaining elements, voxels are processed in parallel.
+		 * @param visitor Called as visitor(ElementData&), must not touch other voxels.
+		 */
+		template <typename Visitor>
+		void ParallelForEachElement(Visitor&& visitor);
+		/**
+		 * Visit the remaining elements in voxel order.
+		 * @param visitor Called as visitor(ElementData&).
+		 */
+		template <typename Visitor>
+		void ForEachElement(Visitor&& visitor);
+	};
+
+	template <typename ElementData>
+	void PackedVoxelGrid<ElementData>::Initialize(const float voxelSize, const glm::vec3& minBound, const glm::vec3& maxBound)
+	{
+		const glm::vec3 regulatedMinBound = glm::floor(minBound / voxelSize) * voxelSize;
+		const glm::vec3 regulatedMaxBound = glm::ceil(maxBound / voxelSize) * voxelSize;
+		m_voxelSize = voxelSize;
+		m_minBound = regulatedMinBound;
+		m_resolution = glm::ivec3(
+			glm::ceil((regulatedMaxBound.x - regulatedMinBound.x) / voxelSize) + 1,
+			glm::ceil((regulatedMaxBound.y - regulatedMinBound.y) / voxelSize) + 1,
+			glm::ceil((regulatedMaxBound.z - regulatedMinBound.z) / voxelSize) + 1);
+		Clear();
+	}
+
+	template <typename ElementData>
+	void PackedVoxelGrid<ElementData>::Build(const std::vector<ElementData>& elements)
+	{
+		const auto voxelCount = GetVoxelCount();
+		const auto elementCount = elements.size();
+		m_elementVoxelIndices.resize(elementCount);
+		m_order.resize(elementCount);
+		m_elements.resize(elementCount);
+		m_voxelOffsets.resize(voxelCount + 1);
+		m_voxelCounts.resize(voxelCount);
+		std::vector<std::atomic<unsigned>> voxelCursors(voxelCount);
+		Jobs::RunParallelFor(voxelCount, [&](unsigned voxelIndex)
+			{
+				voxelCursors[voxelIndex].store(0, std::memory_order_relaxed);
+			}
+		);
+		//1. Count elements per voxel.
+		Jobs::RunParallelFor(elementCount, [&](unsigned elementIndex)
+			{
+				const auto voxelIndex = GetIndex(glm::clamp(GetCoordinate(elements[elementIndex].m_position), glm::ivec3(0), m_resolution - 1));
+				m_elementVoxelIndices[elementIndex] = voxelIndex;
+				voxelCursors[voxelIndex].fetch_add(1, std::memory_order_relaxed);
+			}
+		);
+		//2. Exclusive scan into offsets, the counters become the write cursors.
+		unsigned offset = 0;
+		for (size_t voxelIndex = 0; voxelIndex < voxelCount; voxelIndex++)
+		{
+			const auto count = voxelCursors[voxelIndex].load(std::memory_order_relaxed);
+			m_voxelOffsets[voxelIndex] = offset;
+			m_voxelCounts[voxelIndex] = count;
+			voxelCursors[voxelIndex].store(offset, std::memory_order_relaxed);
+			offset += count;
+		}
+		m_voxelOffsets[voxelCount] = offset;
+		//3. Scatter element indices, then restore the input order within each voxel so queries stay deterministic.
+		Jobs::RunParallelFor(elementCount, [&](unsigned elementIndex)
+			{
+				m_order[voxelCursors[m_elementVoxelIndices[elementIndex]].fetch_add(1, std::memory_order_relaxed)] = elementIndex;
+			}
+		);
+		Jobs::RunParallelFor(voxelCount, [&](unsigned voxelIndex)
+			{
+				const auto begin = m_voxelOffsets[voxelIndex];
+				const auto end = m_voxelOffsets[voxelIndex + 1];
+				if (end - begin > 1) std::sort(m_order.begin() + begin, m_order.begin() + end);
+				for (auto i = begin; i < end; i++) m_elements[i] = elements[m_order[i]];
+			}
+		);
+	}
+
+	template <typename ElementData>
+	void PackedVoxelGrid<ElementData>::Clear()
+	{
+		m_elements.clear();
+		m_voxelOffsets.assign(GetVoxelCount() + 1, 0);
+		m_voxelCounts.assign(GetVoxelCount(), 0);
+	}
+
+	template <typename ElementData>
+	size_t PackedVoxelGrid<ElementData>::GetVoxelCount() const
+	{
+		return static_cast<size_t>(m_resolution.x) * m_resolution.y * m_resolution.z;
+	}
+
+	template <typename ElementData>
+	size_t PackedVoxelGrid<ElementData>::GetElementCount() const
+	{
+		size_t count = 0;
+		for (const auto& voxelCount : m_voxelCounts) count += voxelCount;
+		return count;
+	}
+
+	template <typename ElementData>
+	glm::ivec3 PackedVoxelGrid<ElementData>::GetResolution() const
+	{
+		return m_resolution;
+	}
+
+	template <typename ElementData>
+	glm::vec3 PackedVoxelGrid<ElementData>::GetMinBound() const
+	{
+		return m_minBound;
+	}
+
+	template <typename ElementData>
+	float PackedVoxelGrid<ElementData>::GetVoxelSize() const
+	{
+		return m_voxelSize;
+	}
+
+	template <typename ElementData>
+	int PackedVoxelGrid<ElementData>::GetIndex(const glm::ivec3& coordinate) const
+	{
+		return coordinate.x + coordinate.y * m_resolution.x + coordinate.z * m_resolution.x * m_resolution.y;
+	}
+
+	template <typename ElementData>
+	glm::ivec3 PackedVoxelGrid<ElementData>::GetCoordinate(const glm::vec3& position) const
+	{
+		return glm::ivec3(glm::floor((position - m_minBound) / m_voxelSize));
+	}
+
+	template <typename ElementData>
+	template <typename Visitor>
+	void PackedVoxelGrid<ElementData>::ForEach(const glm::vec3& center, const float radius, Visitor&& visitor)
+	{
+		if (m_voxelCounts.empty()) return;
+		const auto start = glm::max(GetCoordinate(center - glm::vec3(radius)), glm::ivec3(0));
+		const auto end = glm::min(GetCoordinate(center + glm::vec3(radius)), m_resolution - 1);
+		const auto radius2 = radius * radius;
+		for (int i = start.x; i <= end.x; i++) {
+			for (int j = start.y; j <= end.y; j++) {
+				for (int k = start.z; k <= end.z; k++) {
+					const auto voxelIndex = GetIndex(glm::ivec3(i, j, k));
+					const auto begin = m_voxelOffsets[voxelIndex];
+					const auto voxelEnd = begin + m_voxelCounts[voxelIndex];
+					for (auto elementIndex = begin; elementIndex < voxelEnd; elementIndex++)
+					{
+						auto& element = m_elements[elementIndex];
+						const auto diff = element.m_position - center;
+						if (glm::dot(diff, diff) > radius2) continue;
+						visitor(element);
+					}
+				}
+			}
+		}
+	}
+
+	template <typename ElementData>
+	bool PackedVoxelGrid<ElementData>::Any(const glm::vec3& center, const float radius) const
+	{
+		if (m_voxelCounts.empty()) return false;
+		const auto start = glm::max(GetCoordinate(center - glm::vec3(radius)), glm::ivec3(0));
+		const auto end = glm::min(GetCoordinate(center + glm::vec3(radius)), m_resolution - 1);
+		const auto radius2 = radius * radius;
+		for (int i = start.x; i <= end.x; i++) {
+			for (int j = start.y; j <= end.y; j++) {
+				for (int k = start.z; k <= end.z; k++) {
+					const auto voxelIndex = GetIndex(glm::ivec3(i, j, k));
+					const auto begin = m_voxelOffsets[voxelIndex];
+					const auto voxelEnd = begin + m_voxelCounts[voxelIndex];
+					for (auto elementIndex = begin; elementIndex < voxelEnd; elementIndex++)
+					{
+						const auto diff = m_elements[elementIndex].m_position - center;
+						if (glm::dot(diff, diff) <= radius2) return true;
+					}
+				}
+			}
+		}
+		return false;
+	}
+
+	template <typename ElementData>
+	template <typename Predicate>
+	void PackedVoxelGrid<ElementData>::RemoveIf(const glm::vec3& center, const float radius, Predicate&& predicate)
+	{
+		if (m_voxelCounts.empty()) return;
+		const auto start = glm::max(GetCoordinate(center - glm::vec3(radius)), glm::ivec3(0));
+		const auto end = glm::min(GetCoordinate(center + glm::vec3(radius)), m_resolution - 1);
+		const auto radius2 = radius * radius;
+		for (int i = start.x; i <= end.x; i++) {
+			for (int j = start.y; j <= end.y; j++) {
+				for (int k = start.z; k <= end.z; k++) {
+					const auto voxelIndex = GetIndex(glm::ivec3(i, j, k));
+					const auto begin = m_voxelOffsets[voxelIndex];
+					auto& count = m_voxelCounts[voxelIndex];
+					for (auto elementIndex = begin; elementIndex < begin + count;)
+					{
+						const auto diff = m_elements[elementIndex].m_position - center;
+						if (glm::dot(diff, diff) <= radius2 && predicate(static_cast<const ElementData&>(m_elements[elementIndex])))
+						{
+							count--;
+							m_elements[elementIndex] = m_elements[begin + count];
+						}
+						else elementIndex++;
+					}
+				}
+			}
+		}
+	}
+
+	template <typename ElementData>
+	template <typename Visitor>
+	void PackedVoxelGrid<ElementData>::ParallelForEachElement(Visitor&& visitor)
+	{
+		Jobs::RunParallelFor(m_voxelCounts.size(), [&](unsigned voxelIndex)
+			{
+				const auto begin = m_voxelOffsets[voxelIndex];
+				const auto end = begin + m_voxelCounts[voxelIndex];
+				for (auto elementIndex = begin; elementIndex < end; elementIndex++) visitor(m_elements[elementIndex]);
+			}
+		);
+	}
+
+	template <typename ElementData>
+	template <typename Visitor>
+	void PackedVoxelGrid<ElementData>::ForEachElement(Visitor&& visitor)
+	{
+		for (size_t voxelIndex = 0; voxelIndex < m_voxelCounts.size(); voxelIndex++)
+		{
+			const auto begin = m_voxelOffsets[voxelIndex];
+			const auto end = begin + m_voxelCounts[voxelIndex];
+			for (auto elementIndex = begin; elementIndex < end; elementIndex++) visitor(m_elements[elementIndex]);
+		}
+	}
+}
@@ -225,8 +225,21 @@ namespace EcoSysLab {
 
 		int m_newVersion = 0;
 		int m_version = -1;
+		int m_infoVersion = 0;
 		std::vector<SkeletonNodeHandle> m_sortedNodeList;
 		std::vector<SkeletonFlowHandle> m_sortedFlowList;
+		//The flow after every flow in m_sortedFlowList, -1 for the last one. Split flows are linked in here before the list is rebuilt.
+		std::vector<SkeletonFlowHandle> m_sortedFlowNext;
+
+		//Nodes and flows added by Extend since the last sort. A flow is inserted right after the second handle, or appended if it's -1.
+		std::vector<SkeletonNodeHandle> m_pendingNodeList;
+		std::vector<std::pair<SkeletonFlowHandle, SkeletonFlowHandle>> m_pendingFlowList;
+		bool m_requireFullSort = true;
+
+		void CalculateNodeRootDistance(SkeletonNodeHandle handle);
+		void CalculateNodeEndDistance(SkeletonNodeHandle handle);
+		void CalculateNodeRegulatedGlobalRotation(SkeletonNodeHandle handle);
+		void CalculateFlow(SkeletonFlowHandle handle);
 
 		SkeletonNodeHandle AllocateNode();
 
@@ -324,6 +337,8 @@ namespace EcoSysLab {
 
 		/**
 		 *  Force the structure to sort the node and flow list.
+		 *  If the tree only grew through Extend since the last sort, the new nodes and flows are added to the lists in place,
+		 *  otherwise the lists are rebuilt breadth first. Either way parents come before their children.
 		 *  \n!!You MUST call this after you prune the tree or altered the tree structure manually!!
 		 */
 		void SortLists();
@@ -335,6 +350,13 @@ namespace EcoSysLab {
 		 * @return The version
 		 */
 		[[nodiscard]] int GetVersion() const;
+		/**
+		 * Get the version of the node infos. Code that moves, turns or resizes nodes calls MarkInfoChanged once afterwards.
+		 * Versions are drawn from a shared counter, so a copied or restored skeleton never reuses a version seen before.
+		 * @return The version
+		 */
+		[[nodiscard]] int GetInfoVersion() const;
+		void MarkInfoChanged();
 
 		/**
 		 * Calculate the structural information of the flows.
@@ -419,7 +441,42 @@ namespace EcoSysLab {
 	void Skeleton<SkeletonData, FlowData, NodeData>::SortLists() {
 		if (m_version == m_newVersion) return;
 		if (m_nodes.empty()) return;
+		if (!m_requireFullSort && m_version != -1 && m_version + static_cast<int>(m_pendingNodeList.size()) == m_newVersion)
+		{
+			m_version = m_newVersion;
+			//A new node's parent is already in the list. A flow split off by Extend takes over the children of the flow
+			//it's split from, so it's linked in right after that flow, new branches go to the end.
+			if (!m_pendingFlowList.empty())
+			{
+				m_sortedFlowNext.resize(m_flows.size(), -1);
+				const auto head = m_sortedFlowList.empty() ? -1 : m_sortedFlowList.front();
+				auto tail = m_sortedFlowList.empty() ? -1 : m_sortedFlowList.back();
+				for (const auto& [flowHandle, previousFlowHandle] : m_pendingFlowList)
+				{
+					const auto previous = previousFlowHandle == -1 ? tail : previousFlowHandle;
+					assert(previous != -1);
+					m_sortedFlowNext[flowHandle] = m_sortedFlowNext[previous];
+					m_sortedFlowNext[previous] = flowHandle;
+					if (previous == tail) tail = flowHandle;
+				}
+				const auto size = m_sortedFlowList.size() + m_pendingFlowList.size();
+				m_sortedFlowList.clear();
+				m_sortedFlowList.reserve(size);
+				for (auto flowHandle = head; flowHandle != -1; flowHandle = m_sortedFlowNext[flowHandle]) m_sortedFlowList.emplace_back(flowHandle);
+			}
+			for (const auto& nodeHandle : m_pendingNodeList)
+			{
+				assert(!m_nodes[nodeHandle].m_recycled);
+				m_sortedNodeList.emplace_back(nodeHandle);
+			}
+			m_pendingFlowList.clear();
+			m_pendingNodeList.clear();
+			return;
+		}
 		m_version = m_newVersion;
+		m_requireFullSort = false;
+		m_pendingFlowList.clear();
+		m_pendingNodeList.clear();
 		m_sortedFlowList.clear();
 		m_sortedNodeList.clear();
 		RefreshBaseNodeList();
@@ -441,6 +498,8 @@ namespace EcoSysLab {
 			}
 
 		}
+		m_sortedFlowNext.assign(m_flows.size(), -1);
+		for (size_t i = 1; i < m_sortedFlowList.size(); i++) m_sortedFlowNext[m_sortedFlowList[i - 1]] = m_sortedFlowList[i];
 
 		while (!nodeWaitList.empty()) {
 			m_sortedNodeList.emplace_back(nodeWaitList.front());
@@ -531,6 +590,7 @@ namespace EcoSysLab {
 			newFlow.m_apical = false;
 			if (targetHandle != m_flows[originalNode.m_flowHandle].m_nodes.back()) {
 				auto extendedFlowHandle = AllocateFlow();
+				m_pendingFlowList.emplace_back(extendedFlowHandle, originalNode.m_flowHandle);
 				auto& extendedFlow = m_flows[extendedFlowHandle];
 				extendedFlow.m_apical = true;
 				//Find target node.
@@ -555,12 +615,14 @@ namespace EcoSysLab {
 				SetParentFlow(extendedFlowHandle, originalNode.m_flowHandle);
 			}
 			SetParentFlow(newFlowHandle, originalNode.m_flowHandle);
+			m_pendingFlowList.emplace_back(newFlowHandle, -1);
 		}
 		else {
 			flow.m_nodes.emplace_back(newNodeHandle);
 			newNode.m_flowHandle = originalNode.m_flowHandle;
 			newNode.m_apical = true;
 		}
+		m_pendingNodeList.emplace_back(newNodeHandle);
 		m_newVersion++;
 		return newNodeHandle;
 	}
@@ -597,6 +659,7 @@ namespace EcoSysLab {
 			}
 		}
 		RecycleFlowSingle(handle, flowHandler);
+		m_requireFullSort = true;
 		m_newVersion++;
 	}
 
@@ -636,6 +699,7 @@ namespace EcoSysLab {
 					}
 				}
 			}
+			m_requireFullSort = true;
 			return;
 		}
 		//Collect list of subsequent nodes
@@ -666,6 +730,7 @@ namespace EcoSysLab {
 			RecycleNodeSingle(i, nodeHandler);
 
 		}
+		m_requireFullSort = true;
 		m_newVersion++;
 	}
 
@@ -778,6 +843,7 @@ namespace EcoSysLab {
 	Skeleton<SkeletonData, FlowData, NodeData>::Skeleton(const unsigned initialNodeCount) {
 		m_maxNodeIndex = -1;
 		m_maxFlowIndex = -1;
+		MarkInfoChanged();
 		for (int i = 0; i < initialNodeCount; i++) {
 			auto flowHandle = AllocateFlow();
 			auto nodeHandle = AllocateNode();
@@ -834,6 +900,10 @@ namespace EcoSysLab {
 		m_nodePool = srcSkeleton.m_nodePool;
 		m_sortedNodeList = srcSkeleton.m_sortedNodeList;
 		m_sortedFlowList = srcSkeleton.m_sortedFlowList;
+		m_sortedFlowNext = srcSkeleton.m_sortedFlowNext;
+		m_pendingNodeList = srcSkeleton.m_pendingNodeList;
+		m_pendingFlowList = srcSkeleton.m_pendingFlowList;
+		m_requireFullSort = srcSkeleton.m_requireFullSort;
 
 		m_nodes.resize(srcSkeleton.m_nodes.size());
 		for (int i = 0; i < srcSkeleton.m_nodes.size(); i++)
@@ -865,6 +935,7 @@ namespace EcoSysLab {
 		m_maxFlowIndex = srcSkeleton.m_maxFlowIndex;
 		m_newVersion = srcSkeleton.m_newVersion;
 		m_version = srcSkeleton.m_version;
+		MarkInfoChanged();
 		m_min = srcSkeleton.m_min;
 		m_max = srcSkeleton.m_max;
 	}
@@ -882,41 +953,71 @@ namespace EcoSysLab {
 	}
 
 	template <typename SkeletonData, typename FlowData, typename NodeData>
-	void Skeleton<SkeletonData, FlowData, NodeData>::CalculateDistance()
+	void Skeleton<SkeletonData, FlowData, NodeData>::CalculateNodeRootDistance(const SkeletonNodeHandle handle)
 	{
-		for (const auto& nodeHandle : m_sortedNodeList) {
-			auto& node = m_nodes[nodeHandle];
-			auto& nodeInfo = node.m_info;
-			if (node.GetParentHandle() == -1) {
-				nodeInfo.m_rootDistance = nodeInfo.m_length;
-				nodeInfo.m_chainIndex = 0;
-			}
-			else {
-				const auto& parentInternode = m_nodes[node.GetParentHandle()];
-				nodeInfo.m_rootDistance = parentInternode.m_info.m_rootDistance + nodeInfo.m_length;
+		auto& node = m_nodes[handle];
+		auto& nodeInfo = node.m_info;
+		if (node.GetParentHandle() == -1) {
+			nodeInfo.m_rootDistance = nodeInfo.m_length;
+			nodeInfo.m_chainIndex = 0;
+		}
+		else {
+			const auto& parentInternode = m_nodes[node.GetParentHandle()];
+			nodeInfo.m_rootDistance = parentInternode.m_info.m_rootDistance + nodeInfo.m_length;
 
-				if(node.IsApical())
-				{
-					node.m_info.m_chainIndex = parentInternode.m_info.m_chainIndex + 1;
-				}else
-				{
-					node.m_info.m_chainIndex = 0;
-				}
+			if(node.IsApical())
+			{
+				node.m_info.m_chainIndex = parentInternode.m_info.m_chainIndex + 1;
+			}else
+			{
+				node.m_info.m_chainIndex = 0;
 			}
 		}
+	}
+
+	template <typename SkeletonData, typename FlowData, typename NodeData>
+	void Skeleton<SkeletonData, FlowData, NodeData>::CalculateNodeEndDistance(const SkeletonNodeHandle handle)
+	{
+		auto& node = m_nodes[handle];
+		float maxDistanceToAnyBranchEnd = 0;
+		node.m_info.m_endDistance = 0;
+		for (const auto& i : node.PeekChildHandles())
+		{
+			const auto& childNode = m_nodes[i];
+			const float childMaxDistanceToAnyBranchEnd =
+				childNode.m_info.m_endDistance +
+				childNode.m_info.m_length;
+			maxDistanceToAnyBranchEnd = glm::max(maxDistanceToAnyBranchEnd, childMaxDistanceToAnyBranchEnd);
+		}
+		node.m_info.m_endDistance = maxDistanceToAnyBranchEnd;
+	}
+
+	template <typename SkeletonData, typename FlowData, typename NodeData>
+	void Skeleton<SkeletonData, FlowData, NodeData>::CalculateNodeRegulatedGlobalRotation(const SkeletonNodeHandle handle)
+	{
+		auto& node = m_nodes[handle];
+		auto& nodeInfo = node.m_info;
+		if (node.m_parentHandle != -1) {
+			auto& parentInfo = m_nodes[node.m_parentHandle].m_info;
+			auto front = nodeInfo.m_globalRotation * glm::vec3(0, 0, -1);
+			auto parentRegulatedUp = parentInfo.m_regulatedGlobalRotation * glm::vec3(0, 1, 0);
+			auto regulatedUp = glm::normalize(glm::cross(glm::cross(front, parentRegulatedUp), front));
+			nodeInfo.m_regulatedGlobalRotation = glm::quatLookAt(front, regulatedUp);
+		}
+		else
+		{
+			nodeInfo.m_regulatedGlobalRotation = nodeInfo.m_globalRotation;
+		}
+	}
+
+	template <typename SkeletonData, typename FlowData, typename NodeData>
+	void Skeleton<SkeletonData, FlowData, NodeData>::CalculateDistance()
+	{
+		for (const auto& nodeHandle : m_sortedNodeList) {
+			CalculateNodeRootDistance(nodeHandle);
+		}
 		for (auto it = m_sortedNodeList.rbegin(); it != m_sortedNodeList.rend(); ++it) {
-			auto& node = m_nodes[*it];
-			float maxDistanceToAnyBranchEnd = 0;
-			node.m_info.m_endDistance = 0;
-			for (const auto& i : node.PeekChildHandles())
-			{
-				const auto& childNode = m_nodes[i];
-				const float childMaxDistanceToAnyBranchEnd =
-					childNode.m_info.m_endDistance +
-					childNode.m_info.m_length;
-				maxDistanceToAnyBranchEnd = glm::max(maxDistanceToAnyBranchEnd, childMaxDistanceToAnyBranchEnd);
-			}
-			node.m_info.m_endDistance = maxDistanceToAnyBranchEnd;
+			CalculateNodeEndDistance(*it);
 		}
 	}
 
@@ -926,23 +1027,12 @@ namespace EcoSysLab {
 		m_min = glm::vec3(FLT_MAX);
 		m_max = glm::vec3(-FLT_MAX);
 		for (const auto& nodeHandle : m_sortedNodeList) {
-			auto& node = m_nodes[nodeHandle];
-			auto& nodeInfo = node.m_info;
+			const auto& node = m_nodes[nodeHandle];
 			m_min = glm::min(m_min, node.m_info.m_globalPosition);
 			m_min = glm::min(m_min, node.m_info.GetGlobalEndPosition());
 			m_max = glm::max(m_max, node.m_info.m_globalPosition);
 			m_max = glm::max(m_max, node.m_info.GetGlobalEndPosition());
-			if (node.m_parentHandle != -1) {
-				auto& parentInfo = m_nodes[node.m_parentHandle].m_info;
-				auto front = nodeInfo.m_globalRotation * glm::vec3(0, 0, -1);
-				auto parentRegulatedUp = parentInfo.m_regulatedGlobalRotation * glm::vec3(0, 1, 0);
-				auto regulatedUp = glm::normalize(glm::cross(glm::cross(front, parentRegulatedUp), front));
-				nodeInfo.m_regulatedGlobalRotation = glm::quatLookAt(front, regulatedUp);
-			}
-			else
-			{
-				nodeInfo.m_regulatedGlobalRotation = nodeInfo.m_globalRotation;
-			}
+			CalculateNodeRegulatedGlobalRotation(nodeHandle);
 		}
 	}
 
@@ -1077,28 +1167,43 @@ namespace EcoSysLab {
 		return m_version;
 	}
 
+	template<typename SkeletonData, typename FlowData, typename NodeData>
+	int Skeleton<SkeletonData, FlowData, NodeData>::GetInfoVersion() const {
+		return m_infoVersion;
+	}
+
+	template<typename SkeletonData, typename FlowData, typename NodeData>
+	void Skeleton<SkeletonData, FlowData, NodeData>::MarkInfoChanged() {
+		static std::atomic<int> infoVersionCounter = 0;
+		m_infoVersion = ++infoVersionCounter;
+	}
+
+	template<typename SkeletonData, typename FlowData, typename NodeData>
+	void Skeleton<SkeletonData, FlowData, NodeData>::CalculateFlow(const SkeletonFlowHandle handle) {
+		auto& flow = m_flows[handle];
+		auto& firstNode = m_nodes[flow.m_nodes.front()];
+		auto& lastNode = m_nodes[flow.m_nodes.back()];
+		flow.m_info.m_startThickness = firstNode.m_info.m_thickness;
+		flow.m_info.m_globalStartPosition = firstNode.m_info.m_globalPosition;
+		flow.m_info.m_globalStartRotation = firstNode.m_info.m_globalRotation;
+
+		flow.m_info.m_endThickness = lastNode.m_info.m_thickness;
+		flow.m_info.m_globalEndPosition = lastNode.m_info.m_globalPosition +
+			lastNode.m_info.m_length *
+			(lastNode.m_info.m_globalRotation * glm::vec3(0, 0, -1));
+		flow.m_info.m_globalEndRotation = lastNode.m_info.m_globalRotation;
+
+		flow.m_info.m_flowLength = 0.0f;
+		for (const auto& nodeHandle : flow.m_nodes)
+		{
+			flow.m_info.m_flowLength += m_nodes[nodeHandle].m_info.m_length;
+		}
+	}
+
 	template<typename SkeletonData, typename FlowData, typename NodeData>
 	void Skeleton<SkeletonData, FlowData, NodeData>::CalculateFlows() {
 		for (const auto& flowHandle : m_sortedFlowList) {
-			auto& flow = m_flows[flowHandle];
-			auto& firstNode = m_nodes[flow.m_nodes.front()];
-			auto& lastNode = m_nodes[flow.m_nodes.back()];
-			flow.m_info.m_startThickness = firstNode.m_info.m_thickness;
-			flow.m_info.m_globalStartPosition = firstNode.m_info.m_globalPosition;
-			flow.m_info.m_globalStartRotation = firstNode.m_info.m_globalRotation;
-
-			flow.m_info.m_endThickness = lastNode.m_info.m_thickness;
-			flow.m_info.m_globalEndPosition = lastNode.m_info.m_globalPosition +
-				lastNode.m_info.m_length *
-				(lastNode.m_info.m_globalRotation * glm::vec3(0, 0, -1));
-			flow.m_info.m_globalEndRotation = lastNode.m_info.m_globalRotation;
-
-			flow.m_info.m_flowLength = 0.0f;
-			for (const auto& nodeHandle : flow.m_nodes)
-			{
-				flow.m_info.m_flowLength += m_nodes[nodeHandle].m_info.m_length;
-			}
-
+			CalculateFlow(flowHandle);
 		}
 	}
 
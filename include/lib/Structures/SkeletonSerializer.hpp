@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Skeleton.hpp"
+#include "BinaryArchive.hpp"
 using namespace EvoEngine;
 namespace EcoSysLab {
 	template<typename SkeletonData, typename FlowData, typename NodeData>
@@ -15,6 +16,21 @@ namespace EcoSysLab {
 			const std::function<void(const YAML::Node& nodeIn, NodeData& nodeData)>& nodeFunc,
 			const std::function<void(const YAML::Node& flowIn, FlowData& flowData)>& flowFunc,
 			const std::function<void(const YAML::Node& skeletonIn, SkeletonData& skeletonData)>& skeletonFunc);
+
+		/**
+		 * \brief Columnar binary form, every field of all nodes or flows becomes one chunk named prefix + field.
+		 * The data function writes the custom data of the whole skeleton at once instead of being called per node.
+		 */
+		static void Serialize(BinaryArchiveWriter& archive, const std::string& prefix, const Skeleton<SkeletonData, FlowData, NodeData>& skeleton,
+			const std::function<void(BinaryArchiveWriter& dataArchive, const std::string& dataPrefix, const Skeleton<SkeletonData, FlowData, NodeData>& dataSkeleton)>& dataFunc);
+		/**
+		 * \brief Rebuild a skeleton written by the binary Serialize. The data function runs after the structure is restored.
+		 * @return False if the archive holds no skeleton under the prefix.
+		 */
+		static bool Deserialize(const BinaryArchiveReader& archive, const std::string& prefix, Skeleton<SkeletonData, FlowData, NodeData>& skeleton,
+			const std::function<void(const BinaryArchiveReader& dataArchive, const std::string& dataPrefix, Skeleton<SkeletonData, FlowData, NodeData>& dataSkeleton)>& dataFunc);
+	private:
+		static void RestoreStructure(Skeleton<SkeletonData, FlowData, NodeData>& skeleton);
 	};
 
 	template <typename SkeletonData, typename FlowData, typename NodeData>
@@ -182,6 +198,7 @@ namespace EcoSysLab {
 		if (in["m_maxFlowIndex"]) skeleton.m_maxFlowIndex = in["m_maxFlowIndex"].as<int>();
 		if (in["m_newVersion"]) skeleton.m_newVersion = in["m_newVersion"].as<int>();
 		skeleton.m_version = -1;
+		skeleton.MarkInfoChanged();
 		if (in["m_min"]) skeleton.m_min = in["m_min"].as<glm::vec3>();
 		if (in["m_max"]) skeleton.m_max = in["m_max"].as<glm::vec3>();
 		
@@ -367,6 +384,7 @@ namespace EcoSysLab {
 					node.m_info.m_wounds.resize(data.size() / sizeof(SkeletonNodeWound));
 					std::memcpy(node.m_info.m_wounds.data(), data.data(), data.size());
 				}
+				nodeHandle++;
 			}
 		}
 
@@ -455,6 +473,14 @@ namespace EcoSysLab {
 				flowHandle++;
 			}
 		}
+		RestoreStructure(skeleton);
+
+		if (in["m_data"]) skeletonFunc(in["m_data"], skeleton.m_data);
+	}
+
+	template <typename SkeletonData, typename FlowData, typename NodeData>
+	void SkeletonSerializer<SkeletonData, FlowData, NodeData>::RestoreStructure(Skeleton<SkeletonData, FlowData, NodeData>& skeleton)
+	{
 		skeleton.m_nodePool = {};
 		skeleton.m_flowPool = {};
 		for(const auto& node : skeleton.m_nodes)
@@ -487,7 +513,130 @@ namespace EcoSysLab {
 		skeleton.CalculateDistance();
 		skeleton.CalculateFlows();
 		skeleton.CalculateRegulatedGlobalRotation();
+	}
 
-		if (in["m_data"]) skeletonFunc(in["m_data"], skeleton.m_data);
+	template <typename SkeletonData, typename FlowData, typename NodeData>
+	void SkeletonSerializer<SkeletonData, FlowData, NodeData>::Serialize(BinaryArchiveWriter& archive, const std::string& prefix,
+		const Skeleton<SkeletonData, FlowData, NodeData>& skeleton,
+		const std::function<void(BinaryArchiveWriter& dataArchive, const std::string& dataPrefix, const Skeleton<SkeletonData, FlowData, NodeData>& dataSkeleton)>& dataFunc)
+	{
+		archive.AddValue(prefix + "m_maxNodeIndex", skeleton.m_maxNodeIndex);
+		archive.AddValue(prefix + "m_maxFlowIndex", skeleton.m_maxFlowIndex);
+		archive.AddValue(prefix + "m_newVersion", skeleton.m_newVersion);
+		archive.AddValue(prefix + "m_min", skeleton.m_min);
+		archive.AddValue(prefix + "m_max", skeleton.m_max);
+
+		using Node = SkeletonNode<NodeData>;
+		const auto& nodes = skeleton.m_nodes;
+		archive.AddColumn<int>(prefix + "m_nodes.m_recycled", nodes, [](const Node& node) { return node.m_recycled ? 1 : 0; });
+		archive.AddColumn<SkeletonFlowHandle>(prefix + "m_nodes.m_flowHandle", nodes, [](const Node& node) { return node.m_flowHandle; });
+		archive.AddColumn<SkeletonNodeHandle>(prefix + "m_nodes.m_parentHandle", nodes, [](const Node& node) { return node.m_parentHandle; });
+		archive.AddColumn<int>(prefix + "m_nodes.m_apical", nodes, [](const Node& node) { return node.m_apical ? 1 : 0; });
+		archive.AddColumn<int>(prefix + "m_nodes.m_index", nodes, [](const Node& node) { return node.m_index; });
+		archive.AddColumn<glm::vec3>(prefix + "m_nodes.m_info.m_globalPosition", nodes, [](const Node& node) { return node.m_info.m_globalPosition; });
+		archive.AddColumn<glm::quat>(prefix + "m_nodes.m_info.m_globalRotation", nodes, [](const Node& node) { return node.m_info.m_globalRotation; });
+		archive.AddColumn<float>(prefix + "m_nodes.m_info.m_length", nodes, [](const Node& node) { return node.m_info.m_length; });
+		archive.AddColumn<float>(prefix + "m_nodes.m_info.m_thickness", nodes, [](const Node& node) { return node.m_info.m_thickness; });
+		archive.AddColumn<glm::vec4>(prefix + "m_nodes.m_info.m_color", nodes, [](const Node& node) { return node.m_info.m_color; });
+		archive.AddColumn<int>(prefix + "m_nodes.m_info.m_locked", nodes, [](const Node& node) { return node.m_info.m_locked ? 1 : 0; });
+		archive.AddColumn<float>(prefix + "m_nodes.m_info.m_leaves", nodes, [](const Node& node) { return node.m_info.m_leaves; });
+		archive.AddColumn<float>(prefix + "m_nodes.m_info.m_fruits", nodes, [](const Node& node) { return node.m_info.m_fruits; });
+		//Variable length lists are stored as one count per element followed by all items back to back.
+		std::vector<int> woundCounts(nodes.size());
+		std::vector<SkeletonNodeWound> wounds;
+		for (size_t i = 0; i < nodes.size(); i++)
+		{
+			woundCounts[i] = static_cast<int>(nodes[i].m_info.m_wounds.size());
+			wounds.insert(wounds.end(), nodes[i].m_info.m_wounds.begin(), nodes[i].m_info.m_wounds.end());
+		}
+		archive.AddArray(prefix + "m_nodes.m_info.m_woundCount", woundCounts);
+		archive.AddArray(prefix + "m_nodes.m_info.m_wounds", wounds);
+
+		using Flow = SkeletonFlow<FlowData>;
+		const auto& flows = skeleton.m_flows;
+		archive.AddColumn<int>(prefix + "m_flows.m_recycled", flows, [](const Flow& flow) { return flow.m_recycled ? 1 : 0; });
+		archive.AddColumn<SkeletonFlowHandle>(prefix + "m_flows.m_parentHandle", flows, [](const Flow& flow) { return flow.m_parentHandle; });
+		archive.AddColumn<int>(prefix + "m_flows.m_apical", flows, [](const Flow& flow) { return flow.m_apical ? 1 : 0; });
+		archive.AddColumn<int>(prefix + "m_flows.m_index", flows, [](const Flow& flow) { return flow.m_index; });
+		std::vector<int> flowNodeCounts(flows.size());
+		std::vector<SkeletonNodeHandle> flowNodes;
+		for (size_t i = 0; i < flows.size(); i++)
+		{
+			flowNodeCounts[i] = static_cast<int>(flows[i].m_nodes.size());
+			flowNodes.insert(flowNodes.end(), flows[i].m_nodes.begin(), flows[i].m_nodes.end());
+		}
+		archive.AddArray(prefix + "m_flows.m_nodeCount", flowNodeCounts);
+		archive.AddArray(prefix + "m_flows.m_nodes", flowNodes);
+
+		dataFunc(archive, prefix, skeleton);
+	}
+
+	template <typename SkeletonData, typename FlowData, typename NodeData>
+	bool SkeletonSerializer<SkeletonData, FlowData, NodeData>::Deserialize(const BinaryArchiveReader& archive, const std::string& prefix,
+		Skeleton<SkeletonData, FlowData, NodeData>& skeleton,
+		const std::function<void(const BinaryArchiveReader& dataArchive, const std::string& dataPrefix, Skeleton<SkeletonData, FlowData, NodeData>& dataSkeleton)>& dataFunc)
+	{
+		if (!archive.HasChunk(prefix + "m_nodes.m_recycled") || !archive.HasChunk(prefix + "m_flows.m_recycled")) return false;
+		archive.GetValue(prefix + "m_maxNodeIndex", skeleton.m_maxNodeIndex);
+		archive.GetValue(prefix + "m_maxFlowIndex", skeleton.m_maxFlowIndex);
+		archive.GetValue(prefix + "m_newVersion", skeleton.m_newVersion);
+		skeleton.m_version = -1;
+		skeleton.MarkInfoChanged();
+		archive.GetValue(prefix + "m_min", skeleton.m_min);
+		archive.GetValue(prefix + "m_max", skeleton.m_max);
+
+		using Node = SkeletonNode<NodeData>;
+		auto& nodes = skeleton.m_nodes;
+		nodes.clear();
+		nodes.resize(archive.GetArray<int>(prefix + "m_nodes.m_recycled").size());
+		for (size_t i = 0; i < nodes.size(); i++) nodes[i].m_handle = static_cast<SkeletonNodeHandle>(i);
+		archive.ReadColumn<int>(prefix + "m_nodes.m_recycled", nodes, [](Node& node, const int value) { node.m_recycled = value == 1; });
+		archive.ReadColumn<SkeletonFlowHandle>(prefix + "m_nodes.m_flowHandle", nodes, [](Node& node, const SkeletonFlowHandle value) { node.m_flowHandle = value; });
+		archive.ReadColumn<SkeletonNodeHandle>(prefix + "m_nodes.m_parentHandle", nodes, [](Node& node, const SkeletonNodeHandle value) { node.m_parentHandle = value; });
+		archive.ReadColumn<int>(prefix + "m_nodes.m_apical", nodes, [](Node& node, const int value) { node.m_apical = value == 1; });
+		archive.ReadColumn<int>(prefix + "m_nodes.m_index", nodes, [](Node& node, const int value) { node.m_index = value; });
+		archive.ReadColumn<glm::vec3>(prefix + "m_nodes.m_info.m_globalPosition", nodes, [](Node& node, const glm::vec3& value) { node.m_info.m_globalPosition = value; });
+		archive.ReadColumn<glm::quat>(prefix + "m_nodes.m_info.m_globalRotation", nodes, [](Node& node, const glm::quat& value) { node.m_info.m_globalRotation = value; });
+		archive.ReadColumn<float>(prefix + "m_nodes.m_info.m_length", nodes, [](Node& node, const float value) { node.m_info.m_length = value; });
+		archive.ReadColumn<float>(prefix + "m_nodes.m_info.m_thickness", nodes, [](Node& node, const float value) { node.m_info.m_thickness = value; });
+		archive.ReadColumn<glm::vec4>(prefix + "m_nodes.m_info.m_color", nodes, [](Node& node, const glm::vec4& value) { node.m_info.m_color = value; });
+		archive.ReadColumn<int>(prefix + "m_nodes.m_info.m_locked", nodes, [](Node& node, const int value) { node.m_info.m_locked = value == 1; });
+		archive.ReadColumn<float>(prefix + "m_nodes.m_info.m_leaves", nodes, [](Node& node, const float value) { node.m_info.m_leaves = value; });
+		archive.ReadColumn<float>(prefix + "m_nodes.m_info.m_fruits", nodes, [](Node& node, const float value) { node.m_info.m_fruits = value; });
+		{
+			const auto woundCounts = archive.GetArray<int>(prefix + "m_nodes.m_info.m_woundCount");
+			const auto wounds = archive.GetArray<SkeletonNodeWound>(prefix + "m_nodes.m_info.m_wounds");
+			size_t offset = 0;
+			for (size_t i = 0; i < glm::min(woundCounts.size(), nodes.size()); i++)
+			{
+				const auto count = glm::min(static_cast<size_t>(woundCounts[i]), wounds.size() - offset);
+				nodes[i].m_info.m_wounds.assign(wounds.begin() + offset, wounds.begin() + offset + count);
+				offset += count;
+			}
+		}
+
+		using Flow = SkeletonFlow<FlowData>;
+		auto& flows = skeleton.m_flows;
+		flows.clear();
+		flows.resize(archive.GetArray<int>(prefix + "m_flows.m_recycled").size());
+		for (size_t i = 0; i < flows.size(); i++) flows[i].m_handle = static_cast<SkeletonFlowHandle>(i);
+		archive.ReadColumn<int>(prefix + "m_flows.m_recycled", flows, [](Flow& flow, const int value) { flow.m_recycled = value == 1; });
+		archive.ReadColumn<SkeletonFlowHandle>(prefix + "m_flows.m_parentHandle", flows, [](Flow& flow, const SkeletonFlowHandle value) { flow.m_parentHandle = value; });
+		archive.ReadColumn<int>(prefix + "m_flows.m_apical", flows, [](Flow& flow, const int value) { flow.m_apical = value == 1; });
+		archive.ReadColumn<int>(prefix + "m_flows.m_index", flows, [](Flow& flow, const int value) { flow.m_index = value; });
+		{
+			const auto flowNodeCounts = archive.GetArray<int>(prefix + "m_flows.m_nodeCount");
+			const auto flowNodes = archive.GetArray<SkeletonNodeHandle>(prefix + "m_flows.m_nodes");
+			size_t offset = 0;
+			for (size_t i = 0; i < glm::min(flowNodeCounts.size(), flows.size()); i++)
+			{
+				const auto count = glm::min(static_cast<size_t>(flowNodeCounts[i]), flowNodes.size() - offset);
+				flows[i].m_nodes.assign(flowNodes.begin() + offset, flowNodes.begin() + offset + count);
+				offset += count;
+			}
+		}
+		RestoreStructure(skeleton);
+		dataFunc(archive, prefix, skeleton);
+		return true;
 	}
 }
@@ -92,6 +92,10 @@ namespace EcoSysLab
 		 */
 		[[nodiscard]] StrandSegmentHandle GetNextHandle() const;
 
+		/**
+		 * Position of this segment within its strand.
+		 * @return The index.
+		 */
 		[[nodiscard]] int GetIndex() const;
 		StrandSegment() = default;
 		explicit StrandSegment(StrandHandle strandHandle, StrandSegmentHandle handle, StrandSegmentHandle prevHandle);
@@ -155,11 +159,18 @@ namespace EcoSysLab
 		std::queue<StrandSegmentHandle> m_strandSegmentPool;
 
 		int m_version = -1;
-		void BuildStrand(const Strand<StrandData>& strand, std::vector<glm::uint>& strands, std::vector<StrandPoint>& points, int nodeMaxCount) const;
+		void BuildStrand(const Strand<StrandData>& strand, StrandPoint* points, size_t segmentCount) const;
 
 		[[nodiscard]] StrandSegmentHandle AllocateStrandSegment(StrandHandle strandHandle, StrandSegmentHandle prevHandle, int index);
 	public:
 
+		/**
+		 * Append the curves of all strands. Each strand gets its base point, up to nodeMaxCount segment ends and one extrapolated point at each end.
+		 * The output ranges are counted first so that the strands are filled in parallel.
+		 * @param strands The start of each strand in points.
+		 * @param points The control points.
+		 * @param nodeMaxCount The maximum number of segments per strand, -1 for all.
+		 */
 		void BuildStrands(std::vector<glm::uint>& strands, std::vector<StrandPoint>& points, int nodeMaxCount) const;
 
 		StrandGroupData m_data;
@@ -245,48 +256,49 @@ namespace EcoSysLab
 		[[nodiscard]] int GetVersion() const;
 
 		[[nodiscard]] glm::vec3 GetStrandSegmentStart(StrandSegmentHandle handle) const;
+
+		/**
+		 * Position of a segment within its strand, same as StrandSegment::GetIndex.
+		 * @param handle The handle of the strand segment.
+		 * @return The index, -1 for recycled segments.
+		 */
+		[[nodiscard]] int GetStrandSegmentIndex(StrandSegmentHandle handle) const;
 	};
 
 	template <typename StrandGroupData, typename StrandData, typename StrandSegmentData>
 	void StrandGroup<StrandGroupData, StrandData, StrandSegmentData>::BuildStrand(const Strand<StrandData>& strand,
-		std::vector<glm::uint>& strands, std::vector<StrandPoint>& points, int nodeMaxCount) const
+		StrandPoint* points, const size_t segmentCount) const
 	{
 		const auto& strandSegmentHandles = strand.PeekStrandSegmentHandles();
-		if (strandSegmentHandles.empty())
-			return;
-
 		auto& baseInfo = strand.m_info.m_baseInfo;
-		const auto startIndex = points.size();
-		strands.emplace_back(startIndex);
 		StrandPoint basePoint;
 		basePoint.m_color = baseInfo.m_color;
 		basePoint.m_thickness = baseInfo.m_thickness;
 		basePoint.m_position = baseInfo.m_globalPosition;
 
-		points.emplace_back(basePoint);
-		points.emplace_back(basePoint);
+		points[0] = basePoint;
+		points[1] = basePoint;
 
 		StrandPoint point;
-		for (int i = 0; i < strandSegmentHandles.size() && (nodeMaxCount == -1 || i < nodeMaxCount); i++)
+		for (size_t i = 0; i < segmentCount; i++)
 		{
 			const auto& strandSegment = PeekStrandSegment(strandSegmentHandles[i]);
-			//auto distance = glm::min(prevDistance, nextDistance);
 			point.m_color = strandSegment.m_info.m_color;
 			point.m_thickness = strandSegment.m_info.m_thickness;
 			point.m_position = strandSegment.m_info.m_globalPosition;
-			points.emplace_back(point);
+			points[i + 2] = point;
 		}
-		auto& backPoint = points.at(points.size() - 2);
-		auto& lastPoint = points.at(points.size() - 1);
+		const auto& backPoint = points[segmentCount];
+		const auto& lastPoint = points[segmentCount + 1];
 
 		point.m_color = 2.0f * lastPoint.m_color - backPoint.m_color;
 		point.m_thickness = 2.0f * lastPoint.m_thickness - backPoint.m_thickness;
 		point.m_position = 2.0f * lastPoint.m_position - backPoint.m_position;
-		points.emplace_back(point);
+		points[segmentCount + 2] = point;
 
-		auto& firstPoint = points.at(startIndex);
-		auto& secondPoint = points.at(startIndex + 1);
-		auto& thirdPoint = points.at(startIndex + 2);
+		auto& firstPoint = points[0];
+		const auto& secondPoint = points[1];
+		const auto& thirdPoint = points[2];
 		firstPoint.m_color = 2.0f * secondPoint.m_color - thirdPoint.m_color;
 		firstPoint.m_thickness = 2.0f * secondPoint.m_thickness - thirdPoint.m_thickness;
 		firstPoint.m_position = 2.0f * secondPoint.m_position - thirdPoint.m_position;
@@ -321,11 +333,32 @@ namespace EcoSysLab
 	void StrandGroup<StrandGroupData, StrandData, StrandSegmentData>::BuildStrands(std::vector<glm::uint>& strands,
 		std::vector<StrandPoint>& points, int nodeMaxCount) const
 	{
-		for (const auto& strand : m_strands)
+		//First pass: the number of segments of each strand, then the offsets into both outputs.
+		std::vector<size_t> segmentCounts(m_strands.size(), 0);
+		std::vector<size_t> strandOffsets(m_strands.size() + 1, 0);
+		std::vector<size_t> pointOffsets(m_strands.size() + 1, 0);
+		for (size_t strandIndex = 0; strandIndex < m_strands.size(); strandIndex++)
 		{
-			if (strand.IsRecycled()) continue;
-			BuildStrand(strand, strands, points, nodeMaxCount);
+			const auto& strand = m_strands[strandIndex];
+			const auto segmentSize = strand.m_strandSegmentHandles.size();
+			const bool build = !strand.IsRecycled() && segmentSize != 0;
+			if (build) segmentCounts[strandIndex] = nodeMaxCount == -1 ? segmentSize : glm::min(segmentSize, static_cast<size_t>(glm::max(0, nodeMaxCount)));
+			strandOffsets[strandIndex + 1] = strandOffsets[strandIndex] + (build ? 1 : 0);
+			pointOffsets[strandIndex + 1] = pointOffsets[strandIndex] + (build ? segmentCounts[strandIndex] + 3 : 0);
 		}
+		const auto strandStart = strands.size();
+		const auto pointStart = points.size();
+		strands.resize(strandStart + strandOffsets.back());
+		points.resize(pointStart + pointOffsets.back());
+		//Second pass: every strand fills its own range.
+		Jobs::RunParallelFor(m_strands.size(), [&](unsigned strandIndex)
+			{
+				if (strandOffsets[strandIndex] == strandOffsets[strandIndex + 1]) return;
+				const auto startIndex = pointStart + pointOffsets[strandIndex];
+				strands[strandStart + strandOffsets[strandIndex]] = startIndex;
+				BuildStrand(m_strands[strandIndex], &points[startIndex], segmentCounts[strandIndex]);
+			}
+		);
 	}
 
 	template <typename StrandGroupData, typename StrandData, typename StrandSegmentData>
@@ -365,10 +398,9 @@ namespace EcoSysLab
 	{
 		auto& strand = m_strands[targetHandle];
 		assert(!strand.m_recycled);
-		auto& prevSegment = m_strandSegments[targetSegmentHandle];
-		const auto prevSegmentIndex = prevSegment.m_index;
-		const auto nextSegmentHandle = strand.m_strandSegmentHandles[prevSegmentIndex + 1];
-		if (strand.m_strandSegmentHandles.size() - 1 == prevSegmentIndex) return Extend(targetHandle);
+		const auto nextSegmentHandle = m_strandSegments[targetSegmentHandle].m_nextHandle;
+		if (nextSegmentHandle == -1) return Extend(targetHandle);
+		const auto prevSegmentIndex = m_strandSegments[targetSegmentHandle].m_index;
 		const auto newSegmentHandle = AllocateStrandSegment(targetHandle, targetSegmentHandle, prevSegmentIndex + 1);
 		auto& newSegment = m_strandSegments[newSegmentHandle];
 		newSegment.m_endSegment = false;
@@ -376,7 +408,8 @@ namespace EcoSysLab
 		auto& nextSegment = m_strandSegments[nextSegmentHandle];
 		nextSegment.m_prevHandle = newSegmentHandle;
 		strand.m_strandSegmentHandles.insert(strand.m_strandSegmentHandles.begin() + prevSegmentIndex + 1, newSegmentHandle);
-		for (int i = prevSegmentIndex + 2; i < strand.m_strandSegmentHandles.size(); ++i)
+		//Renumber the segments after the new one right away, so stored indices are never stale. This walks the same tail the insert shifted.
+		for (int i = prevSegmentIndex + 2; i < strand.m_strandSegmentHandles.size(); i++)
 		{
 			m_strandSegments[strand.m_strandSegmentHandles[i]].m_index = i;
 		}
@@ -518,6 +551,15 @@ namespace EcoSysLab
 		return segmentStart;
 	}
 
+	template <typename StrandGroupData, typename StrandData, typename StrandSegmentData>
+	int StrandGroup<StrandGroupData, StrandData, StrandSegmentData>::GetStrandSegmentIndex(
+		const StrandSegmentHandle handle) const
+	{
+		const auto& segment = m_strandSegments[handle];
+		if (segment.m_recycled || segment.m_strandHandle == -1) return -1;
+		return segment.m_index;
+	}
+
 	template <typename StrandSegmentData>
 	bool StrandSegment<StrandSegmentData>::IsEnd() const
 	{
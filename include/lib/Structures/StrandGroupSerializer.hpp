@@ -1,6 +1,7 @@
 #pragma once
 
 #include "StrandGroup.hpp"
+#include "BinaryArchive.hpp"
 using namespace EvoEngine;
 namespace EcoSysLab {
 	template<typename StrandGroupData, typename StrandData, typename StrandSegmentData>
@@ -15,6 +16,19 @@ namespace EcoSysLab {
 			const std::function<void(const YAML::Node& strandSegmentIn, StrandSegmentData& segmentData)>& strandSegmentFunc,
 			const std::function<void(const YAML::Node& strandIn, StrandData& strandData)>& strandFunc,
 			const std::function<void(const YAML::Node& groupIn, StrandGroupData& groupData)>& groupFunc);
+
+		/**
+		 * \brief Columnar binary form, every field of all strands or strand segments becomes one chunk named prefix + field.
+		 * The data function writes the custom data of the whole group at once.
+		 */
+		static void Serialize(BinaryArchiveWriter& archive, const std::string& prefix, const StrandGroup<StrandGroupData, StrandData, StrandSegmentData>& strandGroup,
+			const std::function<void(BinaryArchiveWriter& dataArchive, const std::string& dataPrefix, const StrandGroup<StrandGroupData, StrandData, StrandSegmentData>& dataStrandGroup)>& dataFunc);
+		/**
+		 * \brief Rebuild a strand group written by the binary Serialize. The data function runs after the structure is restored.
+		 * @return False if the archive holds no strand group under the prefix.
+		 */
+		static bool Deserialize(const BinaryArchiveReader& archive, const std::string& prefix, StrandGroup<StrandGroupData, StrandData, StrandSegmentData>& strandGroup,
+			const std::function<void(const BinaryArchiveReader& dataArchive, const std::string& dataPrefix, StrandGroup<StrandGroupData, StrandData, StrandSegmentData>& dataStrandGroup)>& dataFunc);
 	};
 
 	template <typename StrandGroupData, typename StrandData, typename StrandSegmentData>
@@ -100,7 +114,7 @@ namespace EcoSysLab {
 			strandSegmentPrevList[strandSegmentIndex] = strandSegment.m_prevHandle;
 			strandSegmentNextList[strandSegmentIndex] = strandSegment.m_nextHandle;
 			strandSegmentStrandHandleList[strandSegmentIndex] = strandSegment.m_strandHandle;
-			strandSegmentIndexList[strandSegmentIndex] = strandSegment.m_index;
+			strandSegmentIndexList[strandSegmentIndex] = strandGroup.GetStrandSegmentIndex(strandSegmentIndex);
 
 			strandSegmentGlobalPositionList[strandSegmentIndex] = strandSegment.m_info.m_globalPosition;
 			strandSegmentThicknessList[strandSegmentIndex] = strandSegment.m_info.m_thickness;
@@ -406,4 +420,98 @@ namespace EcoSysLab {
 
 		if (in["m_data"]) groupFunc(in["m_data"], strandGroup.m_data);
 	}
+
+	template <typename StrandGroupData, typename StrandData, typename StrandSegmentData>
+	void StrandGroupSerializer<StrandGroupData, StrandData, StrandSegmentData>::Serialize(BinaryArchiveWriter& archive, const std::string& prefix,
+		const StrandGroup<StrandGroupData, StrandData, StrandSegmentData>& strandGroup,
+		const std::function<void(BinaryArchiveWriter& dataArchive, const std::string& dataPrefix, const StrandGroup<StrandGroupData, StrandData, StrandSegmentData>& dataStrandGroup)>& dataFunc)
+	{
+		using StrandT = Strand<StrandData>;
+		using Segment = StrandSegment<StrandSegmentData>;
+		const auto& strands = strandGroup.m_strands;
+		archive.AddColumn<int>(prefix + "m_strands.m_recycled", strands, [](const StrandT& strand) { return strand.m_recycled ? 1 : 0; });
+		archive.AddColumn<glm::vec4>(prefix + "m_strands.m_info.m_color", strands, [](const StrandT& strand) { return strand.m_info.m_color; });
+		archive.AddColumn<glm::vec3>(prefix + "m_strands.m_info.m_baseInfo.m_globalPosition", strands, [](const StrandT& strand) { return strand.m_info.m_baseInfo.m_globalPosition; });
+		archive.AddColumn<float>(prefix + "m_strands.m_info.m_baseInfo.m_thickness", strands, [](const StrandT& strand) { return strand.m_info.m_baseInfo.m_thickness; });
+		archive.AddColumn<glm::vec4>(prefix + "m_strands.m_info.m_baseInfo.m_color", strands, [](const StrandT& strand) { return strand.m_info.m_baseInfo.m_color; });
+		archive.AddColumn<int>(prefix + "m_strands.m_info.m_baseInfo.m_isBoundary", strands, [](const StrandT& strand) { return strand.m_info.m_baseInfo.m_isBoundary ? 1 : 0; });
+		std::vector<int> segmentCounts(strands.size());
+		std::vector<StrandSegmentHandle> segmentHandles;
+		for (size_t i = 0; i < strands.size(); i++)
+		{
+			segmentCounts[i] = static_cast<int>(strands[i].m_strandSegmentHandles.size());
+			segmentHandles.insert(segmentHandles.end(), strands[i].m_strandSegmentHandles.begin(), strands[i].m_strandSegmentHandles.end());
+		}
+		archive.AddArray(prefix + "m_strands.m_strandSegmentCount", segmentCounts);
+		archive.AddArray(prefix + "m_strands.m_strandSegmentHandles", segmentHandles);
+
+		const auto& segments = strandGroup.m_strandSegments;
+		archive.AddColumn<int>(prefix + "m_strandSegments.m_endSegment", segments, [](const Segment& segment) { return segment.m_endSegment ? 1 : 0; });
+		archive.AddColumn<int>(prefix + "m_strandSegments.m_recycled", segments, [](const Segment& segment) { return segment.m_recycled ? 1 : 0; });
+		archive.AddColumn<StrandSegmentHandle>(prefix + "m_strandSegments.m_prevHandle", segments, [](const Segment& segment) { return segment.m_prevHandle; });
+		archive.AddColumn<StrandSegmentHandle>(prefix + "m_strandSegments.m_nextHandle", segments, [](const Segment& segment) { return segment.m_nextHandle; });
+		archive.AddColumn<StrandHandle>(prefix + "m_strandSegments.m_strandHandle", segments, [](const Segment& segment) { return segment.m_strandHandle; });
+		archive.AddColumn<int>(prefix + "m_strandSegments.m_index", segments, [&](const Segment& segment) { return strandGroup.GetStrandSegmentIndex(segment.m_handle); });
+		archive.AddColumn<glm::vec3>(prefix + "m_strandSegments.m_info.m_globalPosition", segments, [](const Segment& segment) { return segment.m_info.m_globalPosition; });
+		archive.AddColumn<float>(prefix + "m_strandSegments.m_info.m_thickness", segments, [](const Segment& segment) { return segment.m_info.m_thickness; });
+		archive.AddColumn<glm::vec4>(prefix + "m_strandSegments.m_info.m_color", segments, [](const Segment& segment) { return segment.m_info.m_color; });
+		archive.AddColumn<int>(prefix + "m_strandSegments.m_info.m_isBoundary", segments, [](const Segment& segment) { return segment.m_info.m_isBoundary ? 1 : 0; });
+
+		dataFunc(archive, prefix, strandGroup);
+	}
+
+	template <typename StrandGroupData, typename StrandData, typename StrandSegmentData>
+	bool StrandGroupSerializer<StrandGroupData, StrandData, StrandSegmentData>::Deserialize(const BinaryArchiveReader& archive, const std::string& prefix,
+		StrandGroup<StrandGroupData, StrandData, StrandSegmentData>& strandGroup,
+		const std::function<void(const BinaryArchiveReader& dataArchive, const std::string& dataPrefix, StrandGroup<StrandGroupData, StrandData, StrandSegmentData>& dataStrandGroup)>& dataFunc)
+	{
+		if (!archive.HasChunk(prefix + "m_strands.m_recycled") || !archive.HasChunk(prefix + "m_strandSegments.m_recycled")) return false;
+		using StrandT = Strand<StrandData>;
+		using Segment = StrandSegment<StrandSegmentData>;
+		auto& strands = strandGroup.m_strands;
+		strands.clear();
+		strands.resize(archive.GetArray<int>(prefix + "m_strands.m_recycled").size());
+		for (size_t i = 0; i < strands.size(); i++) strands[i].m_handle = static_cast<StrandHandle>(i);
+		archive.ReadColumn<int>(prefix + "m_strands.m_recycled", strands, [](StrandT& strand, const int value) { strand.m_recycled = value == 1; });
+		archive.ReadColumn<glm::vec4>(prefix + "m_strands.m_info.m_color", strands, [](StrandT& strand, const glm::vec4& value) { strand.m_info.m_color = value; });
+		archive.ReadColumn<glm::vec3>(prefix + "m_strands.m_info.m_baseInfo.m_globalPosition", strands, [](StrandT& strand, const glm::vec3& value) { strand.m_info.m_baseInfo.m_globalPosition = value; });
+		archive.ReadColumn<float>(prefix + "m_strands.m_info.m_baseInfo.m_thickness", strands, [](StrandT& strand, const float value) { strand.m_info.m_baseInfo.m_thickness = value; });
+		archive.ReadColumn<glm::vec4>(prefix + "m_strands.m_info.m_baseInfo.m_color", strands, [](StrandT& strand, const glm::vec4& value) { strand.m_info.m_baseInfo.m_color = value; });
+		archive.ReadColumn<int>(prefix + "m_strands.m_info.m_baseInfo.m_isBoundary", strands, [](StrandT& strand, const int value) { strand.m_info.m_baseInfo.m_isBoundary = value == 1; });
+		{
+			const auto segmentCounts = archive.GetArray<int>(prefix + "m_strands.m_strandSegmentCount");
+			const auto segmentHandles = archive.GetArray<StrandSegmentHandle>(prefix + "m_strands.m_strandSegmentHandles");
+			size_t offset = 0;
+			for (size_t i = 0; i < strands.size() && i < segmentCounts.size(); i++)
+			{
+				const auto end = glm::min(offset + segmentCounts[i], segmentHandles.size());
+				strands[i].m_strandSegmentHandles.assign(segmentHandles.begin() + offset, segmentHandles.begin() + end);
+				offset = end;
+			}
+		}
+
+		auto& segments = strandGroup.m_strandSegments;
+		segments.clear();
+		segments.resize(archive.GetArray<int>(prefix + "m_strandSegments.m_recycled").size());
+		for (size_t i = 0; i < segments.size(); i++) segments[i].m_handle = static_cast<StrandSegmentHandle>(i);
+		archive.ReadColumn<int>(prefix + "m_strandSegments.m_endSegment", segments, [](Segment& segment, const int value) { segment.m_endSegment = value == 1; });
+		archive.ReadColumn<int>(prefix + "m_strandSegments.m_recycled", segments, [](Segment& segment, const int value) { segment.m_recycled = value == 1; });
+		archive.ReadColumn<StrandSegmentHandle>(prefix + "m_strandSegments.m_prevHandle", segments, [](Segment& segment, const StrandSegmentHandle value) { segment.m_prevHandle = value; });
+		archive.ReadColumn<StrandSegmentHandle>(prefix + "m_strandSegments.m_nextHandle", segments, [](Segment& segment, const StrandSegmentHandle value) { segment.m_nextHandle = value; });
+		archive.ReadColumn<StrandHandle>(prefix + "m_strandSegments.m_strandHandle", segments, [](Segment& segment, const StrandHandle value) { segment.m_strandHandle = value; });
+		archive.ReadColumn<int>(prefix + "m_strandSegments.m_index", segments, [](Segment& segment, const int value) { segment.m_index = value; });
+		archive.ReadColumn<glm::vec3>(prefix + "m_strandSegments.m_info.m_globalPosition", segments, [](Segment& segment, const glm::vec3& value) { segment.m_info.m_globalPosition = value; });
+		archive.ReadColumn<float>(prefix + "m_strandSegments.m_info.m_thickness", segments, [](Segment& segment, const float value) { segment.m_info.m_thickness = value; });
+		archive.ReadColumn<glm::vec4>(prefix + "m_strandSegments.m_info.m_color", segments, [](Segment& segment, const glm::vec4& value) { segment.m_info.m_color = value; });
+		archive.ReadColumn<int>(prefix + "m_strandSegments.m_info.m_isBoundary", segments, [](Segment& segment, const int value) { segment.m_info.m_isBoundary = value == 1; });
+
+		strandGroup.m_strandPool = {};
+		strandGroup.m_strandSegmentPool = {};
+		for (const auto& strand : strands) if (strand.m_recycled) strandGroup.m_strandPool.emplace(strand.m_handle);
+		for (const auto& segment : segments) if (segment.m_recycled) strandGroup.m_strandSegmentPool.emplace(segment.m_handle);
+		strandGroup.m_version++;
+
+		dataFunc(archive, prefix, strandGroup);
+		return true;
+	}
 }
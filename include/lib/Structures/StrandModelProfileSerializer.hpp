@@ -1,6 +1,7 @@
 #pragma once
 
 #include "StrandModelProfile.hpp"
+#include "BinaryArchive.hpp"
 using namespace EvoEngine;
 namespace EcoSysLab {
 	template<typename ParticleData>
@@ -11,6 +12,22 @@ namespace EcoSysLab {
 
 		static void Deserialize(const YAML::Node& in, StrandModelProfile<ParticleData>& strandModelProfile,
 			const std::function<void(const YAML::Node& particleIn, ParticleData& particleData)>& particleFunc);
+
+		/**
+		 * \brief Binary form for the profiles of many nodes at once. The particles of all profiles share one set of columns,
+		 * with one particle count per profile. Particle data is not stored.
+		 */
+		static void Serialize(BinaryArchiveWriter& archive, const std::string& prefix, const std::vector<const StrandModelProfile<ParticleData>*>& profiles);
+		/**
+		 * @param profiles Same number and order of profiles as passed to the binary Serialize.
+		 * @return False if the archive holds no profiles under the prefix.
+		 */
+		static bool Deserialize(const BinaryArchiveReader& archive, const std::string& prefix, const std::vector<StrandModelProfile<ParticleData>*>& profiles);
+	private:
+		template<typename T, typename Getter>
+		static void AddParticleColumn(BinaryArchiveWriter& archive, const std::string& name, const std::vector<const StrandModelProfile<ParticleData>*>& profiles, Getter&& getter);
+		template<typename T, typename Setter>
+		static void ReadParticleColumn(const BinaryArchiveReader& archive, const std::string& name, const std::vector<StrandModelProfile<ParticleData>*>& profiles, Setter&& setter);
 	};
 
 	template <typename ParticleData>
@@ -284,4 +301,91 @@ namespace EcoSysLab {
 			}
 		}
 	}
+
+	template <typename ParticleData>
+	template <typename T, typename Getter>
+	void StrandModelProfileSerializer<ParticleData>::AddParticleColumn(BinaryArchiveWriter& archive, const std::string& name,
+		const std::vector<const StrandModelProfile<ParticleData>*>& profiles, Getter&& getter)
+	{
+		std::vector<T> list;
+		for (const auto* profile : profiles)
+		{
+			if (!profile) continue;
+			for (const auto& particle : profile->m_particles2D) list.emplace_back(getter(particle));
+		}
+		archive.AddArray(name, list);
+	}
+
+	template <typename ParticleData>
+	template <typename T, typename Setter>
+	void StrandModelProfileSerializer<ParticleData>::ReadParticleColumn(const BinaryArchiveReader& archive, const std::string& name,
+		const std::vector<StrandModelProfile<ParticleData>*>& profiles, Setter&& setter)
+	{
+		const auto list = archive.GetArray<T>(name);
+		size_t index = 0;
+		for (auto* profile : profiles)
+		{
+			if (!profile) continue;
+			for (auto& particle : profile->m_particles2D)
+			{
+				if (index >= list.size()) return;
+				setter(particle, list[index]);
+				index++;
+			}
+		}
+	}
+
+	template <typename ParticleData>
+	void StrandModelProfileSerializer<ParticleData>::Serialize(BinaryArchiveWriter& archive, const std::string& prefix,
+		const std::vector<const StrandModelProfile<ParticleData>*>& profiles)
+	{
+		using Particle = Particle2D<ParticleData>;
+		std::vector<int> particleCounts(profiles.size());
+		for (size_t i = 0; i < profiles.size(); i++) particleCounts[i] = profiles[i] ? static_cast<int>(profiles[i]->m_particles2D.size()) : 0;
+		archive.AddArray(prefix + "m_particleCount", particleCounts);
+		AddParticleColumn<glm::vec3>(archive, prefix + "m_particles.m_color", profiles, [](const Particle& particle) { return particle.m_color; });
+		AddParticleColumn<glm::vec2>(archive, prefix + "m_particles.m_position", profiles, [](const Particle& particle) { return particle.m_position; });
+		AddParticleColumn<glm::vec2>(archive, prefix + "m_particles.m_lastPosition", profiles, [](const Particle& particle) { return particle.m_lastPosition; });
+		AddParticleColumn<glm::vec2>(archive, prefix + "m_particles.m_acceleration", profiles, [](const Particle& particle) { return particle.m_acceleration; });
+		AddParticleColumn<glm::vec2>(archive, prefix + "m_particles.m_deltaPosition", profiles, [](const Particle& particle) { return particle.m_deltaPosition; });
+		AddParticleColumn<int>(archive, prefix + "m_particles.m_boundary", profiles, [](const Particle& particle) { return particle.m_boundary ? 1 : 0; });
+		AddParticleColumn<float>(archive, prefix + "m_particles.m_distanceToBoundary", profiles, [](const Particle& particle) { return particle.m_distanceToBoundary; });
+		AddParticleColumn<glm::vec2>(archive, prefix + "m_particles.m_initialPosition", profiles, [](const Particle& particle) { return particle.m_initialPosition; });
+		AddParticleColumn<SkeletonNodeHandle>(archive, prefix + "m_particles.m_correspondingChildNodeHandle", profiles, [](const Particle& particle) { return particle.m_correspondingChildNodeHandle; });
+		AddParticleColumn<StrandHandle>(archive, prefix + "m_particles.m_strandHandle", profiles, [](const Particle& particle) { return particle.m_strandHandle; });
+		AddParticleColumn<StrandSegmentHandle>(archive, prefix + "m_particles.m_strandSegmentHandle", profiles, [](const Particle& particle) { return particle.m_strandSegmentHandle; });
+		AddParticleColumn<int>(archive, prefix + "m_particles.m_mainChild", profiles, [](const Particle& particle) { return particle.m_mainChild ? 1 : 0; });
+		AddParticleColumn<int>(archive, prefix + "m_particles.m_base", profiles, [](const Particle& particle) { return particle.m_base ? 1 : 0; });
+	}
+
+	template <typename ParticleData>
+	bool StrandModelProfileSerializer<ParticleData>::Deserialize(const BinaryArchiveReader& archive, const std::string& prefix,
+		const std::vector<StrandModelProfile<ParticleData>*>& profiles)
+	{
+		using Particle = Particle2D<ParticleData>;
+		if (!archive.HasChunk(prefix + "m_particleCount")) return false;
+		const auto particleCounts = archive.GetArray<int>(prefix + "m_particleCount");
+		for (size_t i = 0; i < profiles.size(); i++)
+		{
+			if (!profiles[i]) continue;
+			auto& particles = profiles[i]->m_particles2D;
+			particles.clear();
+			particles.resize(i < particleCounts.size() ? particleCounts[i] : 0);
+			for (size_t particleIndex = 0; particleIndex < particles.size(); particleIndex++) particles[particleIndex].m_handle = static_cast<ParticleHandle>(particleIndex);
+		}
+		ReadParticleColumn<glm::vec3>(archive, prefix + "m_particles.m_color", profiles, [](Particle& particle, const glm::vec3& value) { particle.m_color = value; });
+		ReadParticleColumn<glm::vec2>(archive, prefix + "m_particles.m_position", profiles, [](Particle& particle, const glm::vec2& value) { particle.m_position = value; });
+		ReadParticleColumn<glm::vec2>(archive, prefix + "m_particles.m_lastPosition", profiles, [](Particle& particle, const glm::vec2& value) { particle.m_lastPosition = value; });
+		ReadParticleColumn<glm::vec2>(archive, prefix + "m_particles.m_acceleration", profiles, [](Particle& particle, const glm::vec2& value) { particle.m_acceleration = value; });
+		ReadParticleColumn<glm::vec2>(archive, prefix + "m_particles.m_deltaPosition", profiles, [](Particle& particle, const glm::vec2& value) { particle.m_deltaPosition = value; });
+		ReadParticleColumn<int>(archive, prefix + "m_particles.m_boundary", profiles, [](Particle& particle, const int value) { particle.m_boundary = value == 1; });
+		ReadParticleColumn<float>(archive, prefix + "m_particles.m_distanceToBoundary", profiles, [](Particle& particle, const float value) { particle.m_distanceToBoundary = value; });
+		ReadParticleColumn<glm::vec2>(archive, prefix + "m_particles.m_initialPosition", profiles, [](Particle& particle, const glm::vec2& value) { particle.m_initialPosition = value; });
+		ReadParticleColumn<SkeletonNodeHandle>(archive, prefix + "m_particles.m_correspondingChildNodeHandle", profiles, [](Particle& particle, const SkeletonNodeHandle value) { particle.m_correspondingChildNodeHandle = value; });
+		ReadParticleColumn<StrandHandle>(archive, prefix + "m_particles.m_strandHandle", profiles, [](Particle& particle, const StrandHandle value) { particle.m_strandHandle = value; });
+		ReadParticleColumn<StrandSegmentHandle>(archive, prefix + "m_particles.m_strandSegmentHandle", profiles, [](Particle& particle, const StrandSegmentHandle value) { particle.m_strandSegmentHandle = value; });
+		ReadParticleColumn<int>(archive, prefix + "m_particles.m_mainChild", profiles, [](Particle& particle, const int value) { particle.m_mainChild = value == 1; });
+		ReadParticleColumn<int>(archive, prefix + "m_particles.m_base", profiles, [](Particle& particle, const int value) { particle.m_base = value == 1; });
+		return true;
+	}
 }
@@ -0,0 +1,54 @@
+#pragma once
+using namespace EvoEngine;
+namespace EcoSysLab {
+	/**
+	 * \brief Bounding volume hierarchy over a static triangle soup, stored as one flat node array.
+	 * Built with binned surface area heuristic splits. Queries are read only and can run from many threads at once.
+	 */
+	class TriangleBVH
+	{
+		struct Node
+		{
+			glm::vec3 m_min = glm::vec3(0.0f);
+			/**
+			 * Index of the left child for inner nodes, the right child follows it. Index of the first triangle for leaves.
+			 */
+			unsigned m_leftOrFirst = 0;
+			glm::vec3 m_max = glm::vec3(0.0f);
+			/**
+			 * Number of triangles of a leaf, 0 for inner nodes.
+			 */
+			unsigned m_count = 0;
+		};
+		std::vector<Node> m_nodes;
+		std::vector<unsigned> m_triangleIndices;
+		std::vector<glm::vec3> m_v0;
+		std::vector<glm::vec3> m_edge1;
+		std::vector<glm::vec3> m_edge2;
+
+		void UpdateBounds(Node& node) const;
+		void Subdivide(unsigned nodeIndex, const std::vector<glm::vec3>& centroids);
+		[[nodiscard]] bool IntersectTriangle(unsigned triangleIndex, const glm::vec3& origin, const glm::vec3& direction, float& distance) const;
+		[[nodiscard]] static float IntersectBounds(const Node& node, const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance);
+	public:
+		/**
+		 * Leaves hold at most this many triangles.
+		 */
+		static constexpr unsigned m_maxLeafSize = 4;
+		void Build(const std::vector<glm::vec3>& positions, const std::vector<glm::uvec3>& triangles);
+		void Clear();
+		[[nodiscard]] size_t GetTriangleSize() const;
+		[[nodiscard]] size_t GetNodeSize() const;
+		/**
+		 * Find the closest triangle hit by the ray.
+		 * @param distance Upper bound of the search on input, distance to the hit on output.
+		 * @param triangleIndex Index of the hit triangle in the array passed to Build.
+		 * @return True if a triangle was hit.
+		 */
+		bool Intersect(const glm::vec3& origin, const glm::vec3& direction, float& distance, unsigned& triangleIndex) const;
+		/**
+		 * @return True if any triangle is hit closer than maxDistance. Stops at the first hit.
+		 */
+		[[nodiscard]] bool Occluded(const glm::vec3& origin, const glm::vec3& direction, float maxDistance) const;
+	};
+}
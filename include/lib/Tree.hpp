@@ -12,6 +12,7 @@
 #include "ShootDescriptor.hpp"
 #include "Soil.hpp"
 #include "BillboardCloud.hpp"
+#include "BinaryArchive.hpp"
 
 #ifdef BUILD_WITH_PHYSICS
 #include "PhysicsLayer.hpp"
@@ -62,6 +63,49 @@ namespace EcoSysLab {
 		glm::vec4 m_lineFocusColor = glm::vec4(1.f, 0.f, 0.f, 1.f);
 		glm::vec4 m_branchFocusColor = glm::vec4(1.f, 0.f, 0.f, 1.f);
 		void OnInspect();
+		[[nodiscard]] bool operator==(const SkeletalGraphSettings& other) const;
+		[[nodiscard]] bool operator!=(const SkeletalGraphSettings& other) const;
+	};
+
+	/**
+	 * \brief Inputs of the instances of one node in the skeletal graph.
+	 */
+	struct SkeletalGraphNodeState
+	{
+		SkeletonNodeHandle m_handle = -1;
+		glm::vec3 m_position = glm::vec3(0.0f);
+		glm::quat m_rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+		float m_length = 0.0f;
+		float m_thickness = 0.0f;
+		bool m_junction = false;
+		bool m_subTree = false;
+	};
+
+	/**
+	 * \brief Entities, lists and cached instances of the skeletal graph of a tree. Kept between updates so frames where
+	 * the skeleton did not change upload nothing, and a change of focus only rebuilds the nodes entering or leaving it.
+	 */
+	struct SkeletalGraph
+	{
+		Entity m_lineEntity{};
+		Entity m_pointEntity{};
+		std::shared_ptr<ParticleInfoList> m_lineList;
+		std::shared_ptr<ParticleInfoList> m_pointList;
+		std::vector<ParticleInfo> m_lineParticleInfos;
+		std::vector<ParticleInfo> m_pointParticleInfos;
+		/**
+		 * Sorted indices of the nodes whose instances were rebuilt in the last update.
+		 */
+		std::vector<unsigned> m_dirtyNodes;
+		std::vector<int> m_sortedIndices;
+		std::vector<unsigned char> m_subTreeFlags;
+
+		int m_skeletonVersion = -1;
+		int m_infoVersion = -1;
+		SkeletonNodeHandle m_baseNodeHandle = -1;
+		bool m_strandReady = false;
+		SkeletalGraphSettings m_settings{};
+		void Reset();
 	};
 	struct JunctionLine {
 		int m_lineIndex = -1;
@@ -91,13 +135,20 @@ namespace EcoSysLab {
 		friend class EcoSysLabLayer;
 		void PrepareController(const std::shared_ptr<ShootDescriptor>& shootDescriptor, const std::shared_ptr<Soil>& soil, const std::shared_ptr<Climate>& climate);
 		ShootGrowthController m_shootGrowthController{};
+		mutable SkeletalGraph m_skeletalGraph{};
 
 		void GenerateTreeParts(const TreeMeshGeneratorSettings& meshGeneratorSettings, std::vector<TreePartData>& treeParts);
+		static void SerializeShootSkeleton(BinaryArchiveWriter& archive, const std::string& prefix, const ShootSkeleton& shootSkeleton);
+		static bool DeserializeShootSkeleton(const BinaryArchiveReader& archive, const std::string& prefix, ShootSkeleton& shootSkeleton);
 	public:
 		StrandModelParameters m_strandModelParameters{};
 		static void SerializeTreeGrowthSettings(const TreeGrowthSettings& treeGrowthSettings, YAML::Emitter& out);
 		static void DeserializeTreeGrowthSettings(TreeGrowthSettings& treeGrowthSettings, const YAML::Node& param);
 		static bool OnInspectTreeGrowthSettings(TreeGrowthSettings& treeGrowthSettings);
+		/**
+		 * Fill the growth controller from the shoot descriptor, including the pruning callbacks. Does not touch the scene, so it can be used to grow a TreeModel without a Tree entity.
+		 */
+		static void PrepareShootGrowthController(const std::shared_ptr<ShootDescriptor>& shootDescriptor, float lowBranchPruning, float crownShynessDistance, ShootGrowthController& shootGrowthController);
 		bool m_generateMesh = true;
 		float m_lowBranchPruning = 0.f;
 		float m_crownShynessDistance = 0.f;
@@ -177,6 +228,10 @@ namespace EcoSysLab {
 		void FromLSystemString(const std::shared_ptr<LSystemString>& lSystemString);
 		void FromTreeGraph(const std::shared_ptr<TreeGraph>& treeGraph);
 		void FromTreeGraphV2(const std::shared_ptr<TreeGraphV2>& treeGraphV2);
+		/**
+		 * \brief Import a graph parsed by TreeGraph::ImportArrays or TreeGraphV2::ImportArrays without building the node tree.
+		 */
+		void FromTreeGraphArrays(const TreeGraphArrays& treeGraphArrays);
 		void ExportTreeParts(const TreeMeshGeneratorSettings& meshGeneratorSettings, YAML::Emitter& out);
 		void ExportTreeParts(const TreeMeshGeneratorSettings& meshGeneratorSettings, treeio::json& out);
 
@@ -185,6 +240,16 @@ namespace EcoSysLab {
 		void ExportRadialBoundingVolume(const std::shared_ptr<RadialBoundingVolume>& rbv) const;
 		void CollectAssetRef(std::vector<AssetRef>& list) override;
 		void Deserialize(const YAML::Node& in) override;
+		/**
+		 * \brief Save the shoot skeleton, its history and the strand model skeleton with its strands as a chunked binary archive.
+		 * Particle physics data is not included.
+		 */
+		bool SaveBinary(const std::filesystem::path& path, bool compress = false) const;
+		/**
+		 * \brief Load an archive written by SaveBinary. The file is memory mapped and the columns are copied into the skeletons.
+		 * Archives without strands leave the strand group empty and the particles without strand handles.
+		 */
+		bool LoadBinary(const std::filesystem::path& path);
 
 		void GenerateBillboardClouds(const BillboardCloud::GenerateSettings& foliageGenerateSettings);
 
@@ -96,6 +96,25 @@ public:
         bool markedForRemoval{ false };
     }; // struct NodeChain
 
+    /**
+     * @brief Flat representation of the chain hierarchy, indexed by chain index.
+     * Chains are in topological order - parents always have lower index than their children.
+     */
+    struct FlatChains
+    {
+        /// @brief Type used for chain indexing.
+        using ChainIdxT = NodeChain::ChainIdxT;
+
+        /// Parent chain index for each chain, INVALID_CHAIN_IDX for the root chain.
+        std::vector<ChainIdxT> parents{ };
+        /// Offset of the first child of each chain within children, with one extra entry at the end.
+        std::vector<std::size_t> childOffsets{ };
+        /// Child chain indices of all chains, stored back to back.
+        std::vector<ChainIdxT> children{ };
+        /// Length of each chain.
+        std::vector<float> lengths{ };
+    }; // struct FlatChains
+
     /// Description of chains, possibly containing multiple sub-chains.
     struct CompactNodeChain
     {
@@ -203,9 +222,18 @@ public:
     // Oprations:
 
     /// @brief Perform computation by upwards propagation - from root towards the leaves. Returned bool used for premature stopping.
-    void cascadeUpwards(UpwardPropFunT fun);
+    template <typename FunT = UpwardPropFunT>
+    void cascadeUpwards(FunT &&fun);
     /// @brief Perform computation by downwards propagation - from leaves towards the root. Returned bool used for premature stopping.
-    void cascadeDownwards(DownwardPropFunT fun);
+    template <typename FunT = DownwardPropFunT>
+    void cascadeDownwards(FunT &&fun);
+
+    /// @brief Call fun(chainIdx) for all chains, parents before their children.
+    template <typename FunT>
+    void cascadeChainsUpwards(FunT &&fun) const;
+    /// @brief Call fun(chainIdx) for all chains, children before their parents.
+    template <typename FunT>
+    void cascadeChainsDownwards(FunT &&fun) const;
 
     // Accessors:
 
@@ -213,11 +241,15 @@ public:
     const InternalArrayTree &internalTree() const;
     /// @brief Access the list of leaf nodes in the internalTree().
     const NodeIdStorage &leafNodes() const;
+    /// @brief Access all nodes of the internalTree() in topological order - parents before their children.
+    const NodeIdStorage &nodeOrder() const;
 
     /// @brief Access the chains. The first chain is always the root one.
     const ChainStorage &chains() const;
     /// @brief Access the list of leaf chains in the chains().
     const ChainIdxStorage &leafChains() const;
+    /// @brief Access the flat representation of chains().
+    const FlatChains &flatChains() const;
     /// @brief Get maximum depth of all of the chains.
     std::size_t maxChainDepth() const;
     /// @brief Get maximum Gravelius depth of all of the chains.
@@ -264,6 +296,8 @@ private:
     /// @brief Generate node chains for the current tree.
     bool generateNodeChains(const InternalArrayTree &tree, ChainStorage &chains,
         ChainIdxStorage &leafChains, std::size_t &maxChainDepth, std::size_t &maxGraveliusDepth);
+    /// @brief Generate flat representation of given chains.
+    bool generateFlatChains(const InternalArrayTree &tree, const ChainStorage &chains, FlatChains &flatChains);
 
     /**
      * @brief Perform double reflection rotation minimization for given frames.
@@ -282,18 +316,26 @@ private:
     /// @brief Calculate basis for node at srcPos, which continues with dstPos.
     OrthoBasis calculateBasis(const Vector3D &srcPos, const Vector3D &dstPos) const;
 
-    /// @brief Mark given chain, all of its children and associated nodes for removal. Returns number of chains marked.
-    std::size_t markChainForRemoval(InternalArrayTree &tree, ChainStorage &chains,
-        const NodeChain::ChainIdxT &chainIdx) const;
+    /**
+     * @brief Mark given chains, all of their children and associated nodes for removal in a single pass.
+     * @param removalRoots Flag for each chain, set for chains whose whole sub-tree should be removed.
+     * @return Returns number of chains newly marked.
+     */
+    std::size_t markChainsForRemoval(InternalArrayTree &tree, ChainStorage &chains,
+        const std::vector<bool> &removalRoots) const;
 
     /// Internal tree used by this instance.
     InternalArrayTree mInternalTree{ };
     /// List leaf node ids from mInternalTree.
     NodeIdStorage mLeafNodes{ };
+    /// All node ids from mInternalTree, parents before their children.
+    NodeIdStorage mNodeOrder{ };
     /// List of chains making up the whole tree. First chain is the root one.
     ChainStorage mChains{ };
     /// List of indices of leaf chains from mChains.
     ChainIdxStorage mLeafChains{ };
+    /// Flat representation of mChains.
+    FlatChains mFlatChains{ };
     /// Maximum depth of all of the chains.
     std::size_t mMaxChainDepth{ };
     /// Maximum Gravelius depth of all of the chains.
@@ -320,6 +362,7 @@ void TreeChains::NodeChain::forEachSegment(TreeT &tree,
     {
         const auto currentNodeIdx{ *currentNodeIt };
         lambda(tree.getNode(lastNodeIdx), tree.getNode(currentNodeIdx));
+        lastNodeIdx = currentNodeIdx;
     }
 }
 
@@ -337,6 +380,7 @@ ReturnT TreeChains::NodeChain::forEachSegment(TreeT &tree,
     {
         const auto currentNodeIdx{ *currentNodeIt };
         returnVal = lambda(tree.getNode(lastNodeIdx), tree.getNode(currentNodeIdx), returnVal);
+        lastNodeIdx = currentNodeIdx;
     }
 
     return returnVal;
@@ -359,6 +403,34 @@ ReturnT TreeChains::NodeChain::forEachNode(TreeT &tree,
     return returnVal;
 }
 
+template <typename FunT>
+void TreeChains::cascadeUpwards(FunT &&fun)
+{
+    for (const auto &nodeId : mNodeOrder)
+    { if (fun(mInternalTree, nodeId)) { return; } }
+}
+
+template <typename FunT>
+void TreeChains::cascadeDownwards(FunT &&fun)
+{
+    for (auto it = mNodeOrder.rbegin(); it != mNodeOrder.rend(); ++it)
+    { if (fun(mInternalTree, *it)) { return; } }
+}
+
+template <typename FunT>
+void TreeChains::cascadeChainsUpwards(FunT &&fun) const
+{
+    for (NodeChain::ChainIdxT chainIdx = 0u; chainIdx < mChains.size(); ++chainIdx)
+    { fun(chainIdx); }
+}
+
+template <typename FunT>
+void TreeChains::cascadeChainsDownwards(FunT &&fun) const
+{
+    for (auto chainIdx = mChains.size(); chainIdx > 0u; --chainIdx)
+    { fun(chainIdx - 1u); }
+}
+
 template <typename TreeT>
 auto TreeChains::NodeChain::calculateChainLength(const TreeT &tree) const
 {
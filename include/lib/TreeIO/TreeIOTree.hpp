@@ -370,6 +370,18 @@ public:
     /// @brief Parse ArrayTreeT from file path using .tree format. Does not provide runtime meta-data.
     inline static ArrayTreeT fromPathNoRuntime(const std::string &path);
 
+    /**
+     * @brief Load multiple trees, parsing files in parallel.
+     * Each file is memory mapped and may use the .tree, .json or binary format.
+     * @param paths Paths to the tree files.
+     * @param threadCount Number of threads to use, 0 for hardware concurrency.
+     * @return Returns trees in the same order as the paths. Trees which failed to parse are empty.
+     */
+    template <typename RuntimeMetaDataT>
+    static std::vector<ArrayTreeT> fromPaths(const std::vector<std::string> &paths, std::size_t threadCount = 0u);
+    /// @brief Load multiple trees, parsing files in parallel. Does not provide runtime meta-data.
+    inline static std::vector<ArrayTreeT> fromPathsNoRuntime(const std::vector<std::string> &paths, std::size_t threadCount = 0u);
+
     /// @brief Is given node index a valid one?
     static constexpr bool isNodeIdValidValue(const NodeIdT &idx);
 
@@ -467,6 +479,14 @@ public:
     /// @brief Save the tree into file specified by provided path.
     bool saveTree(const std::string &path) const;
 
+    /// @brief Save the tree into file specified by provided path using the binary format.
+    bool saveTreeBinary(const std::string &path) const;
+
+    /// Magic bytes at the start of the binary format.
+    static constexpr char BINARY_MAGIC[4]{ 'T', 'R', 'B', 'N' };
+    /// Version of the binary format.
+    static constexpr std::uint32_t BINARY_VERSION{ 1u };
+
     /// @brief Print debug information about tree nodes.
     void printNodeInfo() const;
 
@@ -554,14 +574,20 @@ protected:
     /// @brief Create empty tree with a single root node, using given runtime meta-data.
     static ArrayTreeT emptyTree(const TreeRuntimeMetaData::Ptr &runtime);
 
-    /// @brief De-serialize ArrayTree from given string.
-    static ArrayTreeT parseTreeFromString(const std::string &serialized, const TreeRuntimeMetaData::Ptr &runtime);
+    /// @brief Load the tree from given memory mapped file.
+    static ArrayTreeT parseTreeFromPath(const std::string &path, const TreeRuntimeMetaData::Ptr &runtime);
+
+    /// @brief De-serialize ArrayTree from given string, detecting the format.
+    static ArrayTreeT parseTreeFromString(std::string_view serialized, const TreeRuntimeMetaData::Ptr &runtime);
 
     /// @brief De-serialize ArrayTree from .tree format.
-    static ArrayTreeT parseTreeFromTreeString(const std::string &serialized, const TreeRuntimeMetaData::Ptr &runtime);
+    static ArrayTreeT parseTreeFromTreeString(std::string_view serialized, const TreeRuntimeMetaData::Ptr &runtime);
 
     /// @brief De-serialize ArrayTree from .json format.
-    static ArrayTreeT parseTreeFromJSONString(const std::string &serialized, const TreeRuntimeMetaData::Ptr &runtime);
+    static ArrayTreeT parseTreeFromJSONString(std::string_view serialized, const TreeRuntimeMetaData::Ptr &runtime);
+
+    /// @brief De-serialize ArrayTree from the binary format.
+    static ArrayTreeT parseTreeFromBinaryString(std::string_view serialized, const TreeRuntimeMetaData::Ptr &runtime);
 
 	/// Identifier of the root node.
 	NodeIdT mRoot{ INVALID_NODE_ID };
@@ -850,12 +876,39 @@ template <typename DataT, typename MetaDataT>
 template <typename RuntimeMetaDataT>
 ArrayTreeT<DataT, MetaDataT> ArrayTreeT<DataT, MetaDataT>::fromPath(const std::string &path)
 {
-    auto readTree{ parseTreeFromString(treeutil::readWholeFile(path), treeutil::WrapperCtrT<RuntimeMetaDataT>()) };
+    auto readTree{ parseTreeFromPath(path, treeutil::WrapperCtrT<RuntimeMetaDataT>()) };
     readTree.mLoaded = true; readTree.mFilePath = path;
 
     return readTree;
 }
 
+template <typename DataT, typename MetaDataT>
+template <typename RuntimeMetaDataT>
+std::vector<ArrayTreeT<DataT, MetaDataT>> ArrayTreeT<DataT, MetaDataT>::fromPaths(
+    const std::vector<std::string> &paths, std::size_t threadCount)
+{
+    std::vector<ArrayTreeT> trees(paths.size());
+    treeutil::parallelFor(paths.size(), [&] (std::size_t idx) {
+        trees[idx] = parseTreeFromPath(paths[idx], treeutil::WrapperCtrT<RuntimeMetaDataT>());
+        trees[idx].mFilePath = paths[idx];
+    }, threadCount);
+
+    return trees;
+}
+
+template <typename DataT, typename MetaDataT>
+inline std::vector<ArrayTreeT<DataT, MetaDataT>> ArrayTreeT<DataT, MetaDataT>::fromPathsNoRuntime(
+    const std::vector<std::string> &paths, std::size_t threadCount)
+{
+    std::vector<ArrayTreeT> trees(paths.size());
+    treeutil::parallelFor(paths.size(), [&] (std::size_t idx) {
+        trees[idx] = parseTreeFromPath(paths[idx], nullptr);
+        trees[idx].mFilePath = paths[idx];
+    }, threadCount);
+
+    return trees;
+}
+
 template <typename DataT, typename MetaDataT>
 template <typename RuntimeMetaDataT>
 ArrayTreeT<DataT, MetaDataT> ArrayTreeT<DataT, MetaDataT>::fromString(const std::string &serialized)
@@ -864,7 +917,7 @@ ArrayTreeT<DataT, MetaDataT> ArrayTreeT<DataT, MetaDataT>::fromString(const std:
 template <typename DataT, typename MetaDataT>
 inline ArrayTreeT<DataT, MetaDataT> ArrayTreeT<DataT, MetaDataT>::fromPathNoRuntime(const std::string &path)
 {
-    auto readTree{ parseTreeFromString(treeutil::readWholeFile(path), nullptr) };
+    auto readTree{ parseTreeFromPath(path, nullptr) };
     readTree.mLoaded = true; readTree.mFilePath = path;
 
     return readTree;
@@ -1224,13 +1277,69 @@ bool ArrayTreeT<DataT, MetaDataT>::saveTree(const std::string &path) const
     if (!treeFile.is_open())
     { return false; }
 
-    treeFile << serialize();
+    // Stream directly into the file, without building the whole string first.
+    treeFile << mMetaData.serialize() << "\n#####\n";
+    saveTreeRecursion(treeFile, mRoot);
 
     treeFile.close();
 
     return true;
 }
 
+template <typename DataT, typename MetaDataT>
+bool ArrayTreeT<DataT, MetaDataT>::saveTreeBinary(const std::string &path) const
+{
+    if (!isNodeIdValid(mRoot))
+    { return false; }
+
+    // Order nodes depth-first, so that parents always precede their children.
+    std::vector<NodeIdT> order{ };
+    std::vector<std::uint32_t> parents{ };
+    std::vector<NodeIdT> stack{ mRoot };
+    std::vector<std::size_t> newIndices(mNodes.size(), 0u);
+    order.reserve(mNodes.size());
+    parents.reserve(mNodes.size());
+    while (!stack.empty())
+    {
+        const auto currentId{ stack.back() }; stack.pop_back();
+        const auto &currentNode{ getNode(currentId) };
+        newIndices[nodeIdToIdx(currentId)] = order.size();
+        parents.push_back(isNodeIdValid(currentNode.parent()) && currentId != mRoot ?
+            static_cast<std::uint32_t>(newIndices[nodeIdToIdx(currentNode.parent())]) :
+            std::numeric_limits<std::uint32_t>::max());
+        order.push_back(currentId);
+        const auto &children{ currentNode.children() };
+        for (auto it = children.rbegin(); it != children.rend(); ++it)
+        { stack.push_back(*it); }
+    }
+
+    std::vector<float> values{ };
+    values.reserve(order.size() * 4u);
+    for (const auto &nodeId : order)
+    {
+        const auto &data{ getNode(nodeId).data() };
+        values.push_back(data.pos.x); values.push_back(data.pos.y); values.push_back(data.pos.z);
+        values.push_back(data.thickness);
+    }
+
+    std::ofstream treeFile{ path, std::ios::out | std::ios::binary };
+    if (!treeFile.is_open())
+    { return false; }
+
+    const auto metaData{ mMetaData.serialize() };
+    const auto nodeCount{ static_cast<std::uint64_t>(order.size()) };
+    const auto metaDataSize{ static_cast<std::uint64_t>(metaData.size()) };
+    treeFile.write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    treeFile.write(reinterpret_cast<const char*>(&BINARY_VERSION), sizeof(BINARY_VERSION));
+    treeFile.write(reinterpret_cast<const char*>(&nodeCount), sizeof(nodeCount));
+    treeFile.write(reinterpret_cast<const char*>(&metaDataSize), sizeof(metaDataSize));
+    treeFile.write(metaData.data(), metaData.size());
+    treeFile.write(reinterpret_cast<const char*>(parents.data()), parents.size() * sizeof(std::uint32_t));
+    treeFile.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+
+    return treeFile.good();
+}
+
 template <typename DataT, typename MetaDataT>
 void ArrayTreeT<DataT, MetaDataT>::printNodeInfo() const
 {
@@ -1398,19 +1507,43 @@ ArrayTreeT<DataT, MetaDataT> ArrayTreeT<DataT, MetaDataT>::emptyTree(
 }
 
 template <typename DataT, typename MetaDataT>
-ArrayTreeT<DataT, MetaDataT> ArrayTreeT<DataT, MetaDataT>::parseTreeFromString(
-    const std::string &serialized, const TreeRuntimeMetaData::Ptr &runtime)
+ArrayTreeT<DataT, MetaDataT> ArrayTreeT<DataT, MetaDataT>::parseTreeFromPath(
+    const std::string &path, const TreeRuntimeMetaData::Ptr &runtime)
 {
+    const treeutil::MappedFile file{ path };
+    if (!file.isOpen())
+    {
+        treeutil::Error << "Failed to open tree file \"" << path << "\"!" << std::endl;
+        return emptyTree(runtime);
+    }
+
+    return parseTreeFromString(file.view(), runtime);
+}
 
+template <typename DataT, typename MetaDataT>
+ArrayTreeT<DataT, MetaDataT> ArrayTreeT<DataT, MetaDataT>::parseTreeFromString(
+    std::string_view serialized, const TreeRuntimeMetaData::Ptr &runtime)
+{
     // Detect the type of file:
-    const auto dividerPosition{ serialized.find_first_of("#####") };
+    if (serialized.size() >= sizeof(BINARY_MAGIC) &&
+        std::equal(std::begin(BINARY_MAGIC), std::end(BINARY_MAGIC), serialized.begin()))
+    {
+        try {
+            return parseTreeFromBinaryString(serialized, runtime);
+        } catch (std::exception &e) {
+            treeutil::Error << "Failed to parse tree from binary! : \"" << e.what() << "\"" << std::endl;
+            return emptyTree(runtime);
+        }
+    }
+
+    const auto dividerPosition{ serialized.find("#####") };
     const auto firstCharacterPos{ std::find_if(
         serialized.begin(), serialized.end(),
-        [](auto c){ return !std::isspace(c); })
+        [](auto c){ return !std::isspace(static_cast<unsigned char>(c)); })
     };
     const auto firstCharacter{ firstCharacterPos != serialized.end() ? *firstCharacterPos : '\0' };
 
-    if (dividerPosition != std::string::npos || firstCharacter != '{')
+    if (dividerPosition != std::string_view::npos || firstCharacter != '{')
     {
         try {
             return parseTreeFromTreeString(serialized, runtime);
@@ -1432,136 +1565,91 @@ ArrayTreeT<DataT, MetaDataT> ArrayTreeT<DataT, MetaDataT>::parseTreeFromString(
 
 template <typename DataT, typename MetaDataT>
 ArrayTreeT<DataT, MetaDataT> ArrayTreeT<DataT, MetaDataT>::parseTreeFromTreeString(
-    const std::string &serialized, const TreeRuntimeMetaData::Ptr &runtime)
+    std::string_view serialized, const TreeRuntimeMetaData::Ptr &runtime)
 {
     // Split meta info and nodes
-    auto divider{ serialized.find_first_of("#####") };
+    auto divider{ serialized.find("#####") };
     auto dividernext{ divider + 5u };
-    if (divider == std::string::npos)
+    if (divider == std::string_view::npos)
     { // No divider found, assume there is no metadata and just read the branches:
         divider = 0u;
         dividernext = 0u;
     }
-    const auto metatext{ serialized.substr(0u, divider) };
     const auto nodetext{ serialized.substr(dividernext) };
 
     // Parse it.
     MetaDataT metaData{ };
-    metaData.deserialize(metatext, runtime);
+    metaData.deserialize(std::string{ serialized.substr(0u, divider) }, runtime);
 
-    // Parse the tree structure
-    std::size_t ptr{ 0u };
-    std::size_t depth{ 0u };
-    const char brackets[4] = { '(','[',']' };
-    const char closing[2] = { ',',')' };
-
-    ArrayTree newTree;
+    ArrayTreeT newTree;
     newTree.mLoaded = false;
+    // Each node is opened by exactly one bracket.
+    newTree.mNodes.reserve(static_cast<std::size_t>(std::count(nodetext.begin(), nodetext.end(), '(')));
 
-    bool hasRoot = false;
+    // Single pass over the buffer, values are parsed in place.
     std::vector<NodeIdT> turtleDives{ }; // for storing parent to go back to on each dive.
     NodeIdT current{ INVALID_NODE_ID };
-    // break skips to the end where the tree is assembled as if the reading went fine.
-    while (depth >= 0u && ptr < nodetext.size())
+    const char *ptr{ nodetext.data() };
+    const char *const end{ nodetext.data() + nodetext.size() };
+    while (ptr < end)
     {
-        const auto nextb{ nodetext.find_first_of(brackets, ptr) };
-        if (nextb == std::string::npos)
-        { // No more brackets
-            std::cerr << "npos";
-            if (depth > 0u)
-            { // Mismatched parsing (some nodes were not closed)
-                return newTree;
-            }
-            else
-            { // Ok end
-                break;
-            }
-        }
-        ptr = nextb + 1; // move pointer
-        const auto nbracket{ nodetext[nextb] };
-        const auto b_dive{ nbracket == '[' };
-        const auto b_diveup{ nbracket == ']' };
-        const auto b_newnode{ nbracket == '(' };
-        if (b_dive)
-        { depth++; turtleDives.push_back(current); }
-        else if (b_diveup)
+        const auto nbracket{ *ptr++ };
+        if (nbracket == '[')
+        { turtleDives.push_back(current); }
+        else if (nbracket == ']')
         {
-            if (depth == 0u)
+            if (turtleDives.empty())
             { // Mismatched parsing (atemped to close square bracket at depth 0)
-                newTree.mLoaded = false;
                 return newTree;
             }
-            depth--;
             // Make the last stored element the 'current' again and then delete it from the list
             current = turtleDives.back();
             turtleDives.pop_back();
         }
-        else if (b_newnode)
+        else if (nbracket == '(')
         {
-            NodeT myNode;
-            // Parse params
-            int nextsem;
-            bool finishedNode = false;
-            std::string subbie;
-            // x
-            nextsem = nodetext.find_first_of(closing, ptr);
-            if (!finishedNode)
-            {
-                finishedNode |= nodetext[nextsem] == ')';
-                subbie = nodetext.substr(ptr, nextsem - ptr);
-                //std::cout << subbie << "\n";
-                myNode.data().pos.x = std::stof(subbie);
-                ptr = nextsem + 1;
-            }
-            // y
-            nextsem = nodetext.find_first_of(closing, ptr);
-            if (!finishedNode)
-            {
-                finishedNode |= nodetext[nextsem] == ')';
-                subbie = nodetext.substr(ptr, nextsem - ptr);
-                //std::cout << subbie << "\n";
-                myNode.data().pos.y = std::stof(subbie);
-                ptr = nextsem + 1;
-            }
-            // z
-            nextsem = nodetext.find_first_of(closing, ptr);
-            if (!finishedNode)
+            // Values are x, y, z and thickness, missing trailing values keep their defaults.
+            float values[4]{ 0.0f, 0.0f, 0.0f, 0.0f };
+            std::size_t valueCount{ 0u };
+            while (true)
             {
-                finishedNode |= nodetext[nextsem] == ')';
-                subbie = nodetext.substr(ptr, nextsem - ptr);
-                //std::cout << subbie << "\n";
-                myNode.data().pos.z = std::stof(subbie);
-                ptr = nextsem + 1;
-            }
-            // w
-            nextsem = nodetext.find_first_of(closing, ptr);
-            if (!finishedNode)
-            {
-                finishedNode |= nodetext[nextsem] == ')';
-                subbie = nodetext.substr(ptr, nextsem - ptr);
-                //std::cout << subbie << "\n";
-                myNode.data().thickness = std::stof(subbie);
-                ptr = nextsem + 1;
-            }
-            //insert my node at the end (since it's a struct) and then make it 'current':
-            myNode.mArrayParent = current;
-            NodeIdT myNodeId{ INVALID_NODE_ID };
-            if (hasRoot)
-            { myNodeId = newTree.addNodeChild(current, myNode.data()); }
-            else
-            { hasRoot = true; myNodeId = newTree.addRoot(myNode.data()); }
-            current = myNodeId;
-
-            //move to the next closing bracket
-            const auto nextb{ nodetext.find_first_of(')', ptr - 1) };
-            if (nextb == std::string::npos)
-            { //mismatched parsing (the current node was not closed)
-                newTree.mLoaded = false;
-                return newTree;
+                while (ptr < end && std::isspace(static_cast<unsigned char>(*ptr)))
+                { ++ptr; }
+                if (ptr >= end)
+                { //mismatched parsing (the current node was not closed)
+                    return newTree;
+                }
+                if (*ptr == ')')
+                { ++ptr; break; }
+
+                float value{ 0.0f };
+                if (!treeutil::parseFloat(ptr, end, value))
+                { throw std::invalid_argument("Invalid node value"); }
+                if (valueCount < 4u)
+                { values[valueCount] = value; }
+                ++valueCount;
+
+                // Skip anything up to the next separator.
+                while (ptr < end && *ptr != ',' && *ptr != ')')
+                { ++ptr; }
+                if (ptr < end && *ptr == ',')
+                { ++ptr; }
             }
-            ptr = nextb + 1;
+
+            NodeDataT data{ };
+            data.pos.x = values[0]; data.pos.y = values[1]; data.pos.z = values[2];
+            data.thickness = values[3];
+            //insert my node at the end and then make it 'current':
+            current = newTree.isNodeIdValid(newTree.mRoot) ?
+                newTree.addNodeChild(current, data) :
+                newTree.addRoot(data);
         }
     }
+    if (!turtleDives.empty())
+    { // Mismatched parsing (some nodes were not closed)
+        return newTree;
+    }
+
     // Assemble the final tree:
     newTree.mMetaData = metaData;
     newTree.mLoaded = true;
@@ -1569,6 +1657,72 @@ ArrayTreeT<DataT, MetaDataT> ArrayTreeT<DataT, MetaDataT>::parseTreeFromTreeStri
     return newTree;
 }
 
+template <typename DataT, typename MetaDataT>
+ArrayTreeT<DataT, MetaDataT> ArrayTreeT<DataT, MetaDataT>::parseTreeFromBinaryString(
+    std::string_view serialized, const TreeRuntimeMetaData::Ptr &runtime)
+{
+    const char *ptr{ serialized.data() + sizeof(BINARY_MAGIC) };
+    const char *const end{ serialized.data() + serialized.size() };
+    const auto read{ [&] (void *destination, std::size_t size) {
+        if (static_cast<std::size_t>(end - ptr) < size)
+        { throw std::runtime_error("Unexpected end of binary tree"); }
+        std::memcpy(destination, ptr, size);
+        ptr += size;
+    } };
+
+    std::uint32_t version{ 0u };
+    std::uint64_t nodeCount{ 0u };
+    std::uint64_t metaDataSize{ 0u };
+    read(&version, sizeof(version));
+    if (version != BINARY_VERSION)
+    { throw std::runtime_error("Unsupported binary tree version"); }
+    read(&nodeCount, sizeof(nodeCount));
+    read(&metaDataSize, sizeof(metaDataSize));
+    if (static_cast<std::uint64_t>(end - ptr) < metaDataSize)
+    { throw std::runtime_error("Unexpected end of binary tree"); }
+
+    MetaDataT metaData{ };
+    metaData.deserialize(std::string{ ptr, static_cast<std::size_t>(metaDataSize) }, runtime);
+    ptr += metaDataSize;
+
+    if (static_cast<std::uint64_t>(end - ptr) / (sizeof(std::uint32_t) + 4u * sizeof(float)) < nodeCount)
+    { throw std::runtime_error("Unexpected end of binary tree"); }
+    std::vector<std::uint32_t> parents(nodeCount);
+    std::vector<float> values(nodeCount * 4u);
+    read(parents.data(), parents.size() * sizeof(std::uint32_t));
+    read(values.data(), values.size() * sizeof(float));
+
+    ArrayTreeT newTree;
+    newTree.mLoaded = false;
+    newTree.mNodes.reserve(nodeCount);
+    std::vector<NodeIdT> ids(nodeCount, INVALID_NODE_ID);
+    for (std::size_t iii = 0u; iii < nodeCount; ++iii)
+    {
+        NodeDataT data{ };
+        data.pos.x = values[iii * 4u]; data.pos.y = values[iii * 4u + 1u]; data.pos.z = values[iii * 4u + 2u];
+        data.thickness = values[iii * 4u + 3u];
+        const auto parent{ parents[iii] };
+        if (parent == std::numeric_limits<std::uint32_t>::max())
+        {
+            if (newTree.isNodeIdValid(newTree.mRoot))
+            { throw std::runtime_error("Multiple roots in binary tree"); }
+            ids[iii] = newTree.addRoot(data);
+        }
+        else
+        {
+            // Parents always precede their children.
+            if (parent >= iii)
+            { throw std::runtime_error("Invalid parent in binary tree"); }
+            ids[iii] = newTree.addNodeChild(ids[parent], data);
+        }
+    }
+
+    newTree.mMetaData = metaData;
+    newTree.mLoaded = true;
+
+    return newTree;
+}
+
 namespace impl
 {
 
@@ -1584,7 +1738,7 @@ inline auto getRootJSONObject(const std::string &serialized)
 
 template <typename DataT, typename MetaDataT>
 ArrayTreeT<DataT, MetaDataT> ArrayTreeT<DataT, MetaDataT>::parseTreeFromJSONString(
-    const std::string &serialized, const TreeRuntimeMetaData::Ptr &runtime)
+    std::string_view serialized, const TreeRuntimeMetaData::Ptr &runtime)
 {
     //auto dataRoot{ impl::getRootJSONObject(serialized) };
     //auto data{ dataRoot };
@@ -1592,16 +1746,18 @@ ArrayTreeT<DataT, MetaDataT> ArrayTreeT<DataT, MetaDataT>::parseTreeFromJSONStri
     //for (auto &d : dataRoot)
     //{ if (d.contains("Count") && d.contains("Internodes")) { data = d; } }
 
-    const json data = json::parse(serialized);
+    // Parse directly from the buffer, without copying it into a string.
+    const json data = json::parse(serialized.begin(), serialized.end());
 
     if (!data.contains("Count") || !data.contains("Internodes"))
     { return { }; }
 
     const auto nodeCount{ data["Count"].get<std::size_t>() };
-    const json internodes = data["Internodes"];
+    const json &internodes = data["Internodes"];
 
-    ArrayTree tree{ };
+    ArrayTreeT tree{ };
     tree.mLoaded = false;
+    tree.mNodes.reserve(nodeCount);
 
     struct NodeInfo
     {
@@ -1637,7 +1793,7 @@ ArrayTreeT<DataT, MetaDataT> ArrayTreeT<DataT, MetaDataT>::parseTreeFromJSONStri
         info.thickness = dat["Thickness"].get<float>();
         info.level = dat["Level"].get<std::size_t>();
         info.startAge = dat["Start Age"].get<std::size_t>();
-        json pos = dat["Position"];
+        const json &pos = dat["Position"];
         //auto basePos{ chosenDat["Position"] };
         //auto pos{ basePos };
         //for (auto &d : basePos)
@@ -1648,46 +1804,52 @@ ArrayTreeT<DataT, MetaDataT> ArrayTreeT<DataT, MetaDataT>::parseTreeFromJSONStri
         return info;
     } };
 
-    std::map<std::size_t, NodeInfo> nodes{ };
-    NodeInfo rootNode{ };
-    bool rootNodeFound{ false };
+    // Nodes are stored contiguously, the map only translates file indices.
+    std::vector<NodeInfo> nodes{ };
+    nodes.reserve(internodes.size());
+    std::unordered_map<std::size_t, std::size_t> nodeIndices{ };
+    nodeIndices.reserve(internodes.size());
 
-    for (const auto node : internodes)
+    for (const auto &node : internodes)
     { // Parse all nodes within the file.
-        const auto nodeInfo{ parseNode(node) };
-        if (!rootNodeFound)
-        { rootNode = nodeInfo; rootNodeFound = true; }
-
-        nodes.emplace(nodeInfo.index, nodeInfo);
+        nodes.emplace_back(parseNode(node));
+        nodeIndices.emplace(nodes.back().index, nodes.size() - 1u);
     }
+    if (nodes.empty())
+    { return { }; }
 
     struct NodeProcessingInfo
     {
-        /// Information about the node.
-        NodeInfo info{ };
+        /// Position of the node within the parsed node list.
+        std::size_t nodeIdx{ 0u };
         /// Index of the parent node, already within the tree.
         NodeIdT parentId{ INVALID_NODE_ID };
     }; // struct NodeProcessingInfo
 
-    std::stack<NodeProcessingInfo> toProcess{ };
-    toProcess.push({ rootNode, INVALID_NODE_ID });
+    std::vector<NodeProcessingInfo> toProcess{ };
+    toProcess.push_back({ 0u, INVALID_NODE_ID });
 
     while (!toProcess.empty())
     { // Construct the tree.
-        const auto node{ toProcess.top() }; toProcess.pop();
-        NodeT newNode{ };
+        const auto node{ toProcess.back() }; toProcess.pop_back();
+        const auto &info{ nodes[node.nodeIdx] };
+        NodeDataT newNodeData{ };
 
-        newNode.data().pos = node.info.position;
-        newNode.data().thickness = node.info.thickness;
+        newNodeData.pos = info.position;
+        newNodeData.thickness = info.thickness;
 
         const auto newNodeId{
             node.parentId == INVALID_NODE_ID ?
-            tree.addRoot(newNode.data()) :
-            tree.addNodeChild(node.parentId, newNode.data())
+            tree.addRoot(newNodeData) :
+            tree.addNodeChild(node.parentId, newNodeData)
         };
 
-        for (const auto &childId : node.info.children)
-        { toProcess.push({ nodes[childId], newNodeId }); }
+        for (const auto &childId : info.children)
+        {
+            const auto findIt{ nodeIndices.find(childId) };
+            if (findIt != nodeIndices.end())
+            { toProcess.push_back({ findIt->second, newNodeId }); }
+        }
     }
 
     // Create meta-data and finalize the tree.
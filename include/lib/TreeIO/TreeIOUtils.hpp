@@ -10,19 +10,28 @@
 
 #include <array>
 #include <algorithm>
+#include <atomic>
+#include <charconv>
 #include <cmath>
+#include <cstring>
+#include <exception>
 #include <filesystem>
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <random>
 #include <set>
 #include <stack>
 #include <string>
+#include <string_view>
 #include <sstream>
+#include <thread>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -396,6 +405,51 @@ private:
 protected:
 }; // class Timer
 
+/// @brief Read-only memory mapping of a whole file.
+class MappedFile
+{
+public:
+    /// @brief Create an empty mapping.
+    MappedFile() = default;
+    /// @brief Map given file, check isOpen() for success.
+    explicit MappedFile(const std::string &path);
+    /// @brief Unmap the file.
+    ~MappedFile();
+
+    // Move only:
+    MappedFile(const MappedFile &other) = delete;
+    MappedFile &operator=(const MappedFile &other) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    /// @brief Map given file, closing any previous one. Returns success.
+    bool open(const std::string &path);
+    /// @brief Unmap the current file.
+    void close();
+    /// @brief Is there a file currently mapped? Empty files count as open.
+    bool isOpen() const;
+
+    /// @brief Access the mapped content.
+    std::string_view view() const;
+private:
+    /// @brief Take over the mapping of other, leaving it empty.
+    void takeFrom(MappedFile &other);
+
+    /// Start of the mapped content.
+    const char *mData{ nullptr };
+    /// Size of the mapped content in bytes.
+    std::size_t mSize{ 0u };
+    /// Was the file opened successfully?
+    bool mOpen{ false };
+    /// Platform file handle.
+    void *mFileHandle{ nullptr };
+    /// Platform mapping handle.
+    void *mMappingHandle{ nullptr };
+    /// Platform file descriptor.
+    int mFileDescriptor{ -1 };
+protected:
+}; // class MappedFile
+
 /// @brief Helper for printing progress bars in ASCII.
 class ProgressBar
 {
@@ -710,6 +764,19 @@ bool deleteFile(const std::string &path);
 /// @brief Read all of the given file into a string and return the result.
 std::string readWholeFile(const std::string &path);
 
+/**
+ * @brief Parse a single floating point value using std::from_chars.
+ * Leading white spaces and '+' are skipped, cursor is moved behind the value on success.
+ */
+bool parseFloat(const char *&cursor, const char *end, float &value);
+
+/**
+ * @brief Run func(index) for all indices in <0, count) on multiple threads.
+ * If func throws, the remaining indices are skipped and the first exception is rethrown on the calling thread.
+ * @param threadCount Number of threads to use, 0 for hardware concurrency.
+ */
+void parallelFor(std::size_t count, const std::function<void(std::size_t)> &func, std::size_t threadCount = 0u);
+
 /// @brief Replace extension of the input path with given extension. Extension should include the ".".
 std::string replaceExtension(const std::string &path, const std::string &extension);
 
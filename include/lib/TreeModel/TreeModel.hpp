@@ -3,6 +3,7 @@
 #include "ClimateModel.hpp"
 #include "Octree.hpp"
 #include "TreeGrowthController.hpp"
+#include <random>
 
 using namespace EvoEngine;
 namespace EcoSysLab {
@@ -16,6 +17,23 @@ namespace EcoSysLab {
 		float m_spaceColonizationTheta = 90.0f;
 	};
 
+	/**
+	 * \brief While in scope, the random numbers of tree growth on the calling thread are drawn from the given generator.
+	 * Outside any scope (or with a null generator) they come from glm's global generator.
+	 */
+	class TreeRandomScope
+	{
+		std::mt19937* m_previousGenerator;
+	public:
+		explicit TreeRandomScope(std::mt19937* generator);
+		~TreeRandomScope();
+		TreeRandomScope(const TreeRandomScope&) = delete;
+		TreeRandomScope& operator=(const TreeRandomScope&) = delete;
+
+		[[nodiscard]] static float LinearRand(float min, float max);
+		[[nodiscard]] static float GaussRand(float mean, float deviation);
+	};
+
 	class TreeModel {
 #pragma region Tree Growth
 		ShootFlux CollectShootFlux(const std::vector<SkeletonNodeHandle>& sortedInternodeList);
@@ -120,10 +138,11 @@ namespace EcoSysLab {
 		 * @param shootGrowthController The procedural parameters that guides the growth of the branches.
 		 * @param pruning If we want auto pruning to be enabled.
 		 * @param overrideGrowthRate If positive (clamped to below 1), the growth rate will be overwritten instead of calculating by available resources.
+		 * @param randomGenerator If set, the random numbers of this iteration are drawn from it instead of glm's global generator.
 		 * @return Whether the growth caused a structural change during the growth.
 		 */
 		bool Grow(float deltaTime, const glm::mat4& globalTransform, ClimateModel& climateModel,
-			const ShootGrowthController& shootGrowthController, bool pruning = true);
+			const ShootGrowthController& shootGrowthController, bool pruning = true, std::mt19937* randomGenerator = nullptr);
 
 		/**
 		 * Grow one iteration of the tree, given the nutrients and the procedural parameters.
@@ -134,10 +153,11 @@ namespace EcoSysLab {
 		 * @param shootGrowthController The procedural parameters that guides the growth of the branches.
 		 * @param pruning If we want auto pruning to be enabled.
 		 * @param overrideGrowthRate If positive (clamped to below 1), the growth rate will be overwritten instead of calculating by available resources.
+		 * @param randomGenerator If set, the random numbers of this iteration are drawn from it instead of glm's global generator.
 		 * @return Whether the growth caused a structural change during the growth.
 		 */
 		bool Grow(float deltaTime, SkeletonNodeHandle baseInternodeHandle, const glm::mat4& globalTransform, ClimateModel& climateModel,
-			const ShootGrowthController& shootGrowthController, bool pruning = true);
+			const ShootGrowthController& shootGrowthController, bool pruning = true, std::mt19937* randomGenerator = nullptr);
 
 		int m_historyLimit = -1;
 
@@ -18,8 +18,12 @@ namespace EcoSysLab
 		SkeletonNodeHandle m_nodeHandle = -1;
 	};
 
+	/**
+	 * \brief The range of the voxel's markers in the cell sorted marker list.
+	 */
 	struct TreeOccupancyGridVoxelData {
-		std::vector<TreeOccupancyGridMarker> m_markers;
+		unsigned m_markerOffset = 0;
+		unsigned m_markerSize = 0;
 	};
 
 	struct TreeOccupancyGridBasicData
@@ -35,6 +39,13 @@ namespace EcoSysLab
 		float m_detectionDistanceFactor = 4;
 		float m_internodeLength = 1.0f;
 		size_t m_markersPerVoxel = 5;
+		std::vector<TreeOccupancyGridMarker> m_markers;
+		/**
+		 * Rebuild the cell sorted marker list from the markers the voxels keep,
+		 * adding new markers to every voxel the filter accepts. Called as filter(voxelIndex) from worker threads.
+		 */
+		void RebuildMarkers(const std::function<bool(unsigned voxelIndex)>& filter);
+		void GetVoxelRange(const glm::vec3& position, float radius, glm::ivec3& start, glm::ivec3& end) const;
 	public:
 		void ResetMarkers();
 		[[nodiscard]] float GetRemovalDistanceFactor() const;
@@ -50,10 +61,101 @@ namespace EcoSysLab
 			float removalDistanceFactor = 2.0f, float theta = 90.0f, float detectionDistanceFactor = 4.0f, size_t markersPerVoxel = 1);
 		void Initialize(const std::shared_ptr<RadialBoundingVolume>& srcRadialBoundingVolume, const glm::vec3& min, const glm::vec3& max, float internodeLength,
 			float removalDistanceFactor = 2.0f, float theta = 90.0f, float detectionDistanceFactor = 4.0f, size_t markersPerVoxel = 1);
+		/**
+		 * \brief Seed markers only in the voxels that contain at least one of the points, e.g. a scanned crown.
+		 */
+		void Initialize(const glm::vec3* points, size_t pointCount, const glm::vec3& min, const glm::vec3& max, float internodeLength,
+			float removalDistanceFactor = 2.0f, float theta = 90.0f, float detectionDistanceFactor = 4.0f, size_t markersPerVoxel = 1);
 		[[nodiscard]] VoxelGrid<TreeOccupancyGridVoxelData>& RefGrid();
+		/**
+		 * \brief All markers, sorted by voxel.
+		 */
+		[[nodiscard]] const std::vector<TreeOccupancyGridMarker>& PeekMarkers() const;
 		[[nodiscard]] glm::vec3 GetMin() const;
 		[[nodiscard]] glm::vec3 GetMax() const;
 
 		void InsertObstacle(const GlobalTransform& globalTransform, const std::shared_ptr<CubeVolume>& cubeVolume);
+
+		/**
+		 * \brief Space colonization pass over the free markers, run in parallel in two phases.
+		 * First every node claims the free markers within the removal distance, the node that comes first in the list wins.
+		 * Then every node visits the markers that are still free for it within the detection distance,
+		 * so the result is the same as visiting the nodes one by one in list order.
+		 * Markers are searched in the voxels within the removal distance of the node.
+		 * @param positions Node positions in claim order, e.g. following the sorted node list.
+		 * @param nodeHandles The handle stored into the markers a node claims, same size as positions.
+		 * @param func Called as func(nodeIndex, direction) for every free marker a node detects.
+		 * It runs on worker threads, but each node index is only visited by one thread.
+		 */
+		template<typename Func>
+		void Colonize(const std::vector<glm::vec3>& positions, const std::vector<SkeletonNodeHandle>& nodeHandles,
+			float removalDistance, float detectionDistance, Func&& func);
 	};
+
+	template <typename Func>
+	void TreeOccupancyGrid::Colonize(const std::vector<glm::vec3>& positions, const std::vector<SkeletonNodeHandle>& nodeHandles,
+		const float removalDistance, const float detectionDistance, Func&& func)
+	{
+		const auto nodeSize = glm::min(positions.size(), nodeHandles.size());
+		if (nodeSize == 0 || m_markers.empty()) return;
+		std::vector<std::atomic<int>> claims(m_markers.size());
+		Jobs::RunParallelFor(claims.size(), [&](unsigned i)
+			{
+				claims[i].store(INT_MAX, std::memory_order_relaxed);
+			}
+		);
+		//Claim, keep the smallest node index per marker.
+		Jobs::RunParallelFor(nodeSize, [&](unsigned nodeIndex)
+			{
+				const auto& position = positions[nodeIndex];
+				glm::ivec3 start, end;
+				GetVoxelRange(position, removalDistance, start, end);
+				for (int x = start.x; x <= end.x; x++)
+					for (int y = start.y; y <= end.y; y++)
+						for (int z = start.z; z <= end.z; z++)
+						{
+							const auto& voxelData = m_occupancyGrid.Peek(glm::ivec3(x, y, z));
+							for (auto markerIndex = voxelData.m_markerOffset; markerIndex < voxelData.m_markerOffset + voxelData.m_markerSize; markerIndex++)
+							{
+								if (m_markers[markerIndex].m_nodeHandle != -1) continue;
+								const auto distance = glm::distance(m_markers[markerIndex].m_position, position);
+								if (distance >= detectionDistance || distance >= removalDistance) continue;
+								auto& claim = claims[markerIndex];
+								int current = claim.load(std::memory_order_relaxed);
+								while (static_cast<int>(nodeIndex) < current && !claim.compare_exchange_weak(current, static_cast<int>(nodeIndex), std::memory_order_relaxed)) {}
+							}
+						}
+			}
+		);
+		//Accumulate, markers claimed by an earlier node are skipped.
+		Jobs::RunParallelFor(nodeSize, [&](unsigned nodeIndex)
+			{
+				const auto& position = positions[nodeIndex];
+				glm::ivec3 start, end;
+				GetVoxelRange(position, removalDistance, start, end);
+				for (int x = start.x; x <= end.x; x++)
+					for (int y = start.y; y <= end.y; y++)
+						for (int z = start.z; z <= end.z; z++)
+						{
+							const auto& voxelData = m_occupancyGrid.Peek(glm::ivec3(x, y, z));
+							for (auto markerIndex = voxelData.m_markerOffset; markerIndex < voxelData.m_markerOffset + voxelData.m_markerSize; markerIndex++)
+							{
+								const auto& marker = m_markers[markerIndex];
+								if (marker.m_nodeHandle != -1) continue;
+								const auto diff = marker.m_position - position;
+								const auto distance = glm::length(diff);
+								if (distance >= detectionDistance) continue;
+								if (claims[markerIndex].load(std::memory_order_relaxed) <= static_cast<int>(nodeIndex)) continue;
+								func(nodeIndex, glm::normalize(diff));
+							}
+						}
+			}
+		);
+		Jobs::RunParallelFor(m_markers.size(), [&](unsigned markerIndex)
+			{
+				const int claim = claims[markerIndex].load(std::memory_order_relaxed);
+				if (claim != INT_MAX) m_markers[markerIndex].m_nodeHandle = nodeHandles[claim];
+			}
+		);
+	}
 }
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace EcoSysLab
+{
+	/**
+	 * \brief Batch versions of glm::perlin and glm::simplex. With SSE2 four points are evaluated per step, following glm's
+	 * math operation by operation, so values agree with glm up to float rounding (within NoiseKernels::Tolerance).
+	 * Without SSE2 they call glm per point.
+	 */
+	class NoiseKernels
+	{
+	public:
+		/**
+		 * \brief Largest allowed difference to glm, checked by noise_kernel_check in DatasetGeneration.
+		 */
+		static constexpr float Tolerance = 1e-4f;
+		[[nodiscard]] static bool IsVectorized();
+		/**
+		 * values[i] = glm::perlin(points[i] * scale + bias). Coordinates should stay below 2^31 in magnitude.
+		 */
+		static void Perlin(const glm::vec2* points, float* values, size_t size, const glm::vec2& scale = glm::vec2(1.0f), const glm::vec2& bias = glm::vec2(0.0f));
+		static void Perlin(const glm::vec3* points, float* values, size_t size, const glm::vec3& scale = glm::vec3(1.0f), const glm::vec3& bias = glm::vec3(0.0f));
+		/**
+		 * values[i] = glm::simplex(points[i] * scale + bias). Coordinates should stay below 2^31 in magnitude.
+		 */
+		static void Simplex(const glm::vec2* points, float* values, size_t size, const glm::vec2& scale = glm::vec2(1.0f), const glm::vec2& bias = glm::vec2(0.0f));
+		static void Simplex(const glm::vec3* points, float* values, size_t size, const glm::vec3& scale = glm::vec3(1.0f), const glm::vec3& bias = glm::vec3(0.0f));
+	};
+}
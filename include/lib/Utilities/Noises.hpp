@@ -40,6 +40,12 @@ namespace EcoSysLab
 		void Load(const std::string& name, const YAML::Node& in);
 		void RandomOffset(float min, float max);
 		[[nodiscard]] float GetValue(const glm::vec2& position) const;
+		/**
+		 * Evaluate many positions at once, matches GetValue per position within NoiseKernels::Tolerance.
+		 * Each descriptor is set up once and then applied to all positions in a tight loop.
+		 */
+		void GetValues(const glm::vec2* positions, float* values, size_t size) const;
+		void GetValues(const std::vector<glm::vec2>& positions, std::vector<float>& values) const;
 	};
 
 	class Noise3D {
@@ -52,5 +58,10 @@ namespace EcoSysLab
 		void Load(const std::string& name, const YAML::Node& in);
 
 		[[nodiscard]] float GetValue(const glm::vec3& position) const;
+		/**
+		 * Evaluate many positions at once, matches GetValue per position within NoiseKernels::Tolerance.
+		 */
+		void GetValues(const glm::vec3* positions, float* values, size_t size) const;
+		void GetValues(const std::vector<glm::vec3>& positions, std::vector<float>& values) const;
 	};
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <vector>
 #include "Skeleton.hpp"
 #include "NodeGraph.hpp"
+#include "NoiseKernels.hpp"
 using namespace EvoEngine;
 
 namespace EcoSysLab
@@ -47,7 +48,11 @@ namespace EcoSysLab
 		void Save(const std::string& name, YAML::Emitter& out) const;
 		void Load(const std::string& name, const YAML::Node& in);
 		void Calculate(const T& samplePoint, float& value) const;
-
+		/**
+		 * Apply the stage to many points at once, matches calling Calculate per point within NoiseKernels::Tolerance.
+		 * @param stageValues Scratch space for at least size values.
+		 */
+		void Calculate(const T* samplePoints, float* values, size_t size, float* stageValues) const;
 	};
 	
 	template <typename T>
@@ -100,20 +105,31 @@ namespace EcoSysLab
 	{
 		bool OnInspect(SkeletonNodeHandle nodeHandle);
 		float Process(SkeletonNodeHandle nodeHandle, const glm::vec2& samplePoint, float value);
+		void CompilePipeline(SkeletonNodeHandle nodeHandle, std::vector<const ProceduralNoiseStage<glm::vec2>*>& stages) const;
 	public:
 		Skeleton<ProceduralNoiseSkeletonData, ProceduralNoiseFlowData, ProceduralNoiseStage<glm::vec2>> m_pipeline {};
 		void Serialize(YAML::Emitter& out) const override;
 		void Deserialize(const YAML::Node& in) override;
 		bool OnInspect(const std::shared_ptr<EditorLayer>& editorLayer) override;
 		float Process(const glm::vec2& samplePoint, float value);
+		/**
+		 * Process many points at once. The pipeline is flattened once, then every stage runs over a block of points.
+		 * @param values Start values on input, resized to the point count (new entries start at 0), results on output.
+		 */
+		void Process(const std::vector<glm::vec2>& samplePoints, std::vector<float>& values);
 	};
 	class ProceduralNoise3D : public IAsset
 	{
 		bool OnInspect(SkeletonNodeHandle nodeHandle);
 		float Process(SkeletonNodeHandle nodeHandle, const glm::vec3& samplePoint, float value);
+		void CompilePipeline(SkeletonNodeHandle nodeHandle, std::vector<const ProceduralNoiseStage<glm::vec3>*>& stages) const;
 	public:
 		Skeleton<ProceduralNoiseSkeletonData, ProceduralNoiseFlowData, ProceduralNoiseStage<glm::vec3>> m_pipeline {};
 		float Process(const glm::vec3& samplePoint, float value);
+		/**
+		 * Process many points at once, see ProceduralNoise2D::Process.
+		 */
+		void Process(const std::vector<glm::vec3>& samplePoints, std::vector<float>& values);
 		void Serialize(YAML::Emitter& out) const override;
 		void Deserialize(const YAML::Node& in) override;
 		bool OnInspect(const std::shared_ptr<EditorLayer>& editorLayer) override;
@@ -183,5 +199,92 @@ namespace EcoSysLab
 		}
 	}
 
+	template <typename T>
+	void ProceduralNoiseStage<T>::Calculate(const T* samplePoints, float* values, const size_t size, float* stageValues) const
+	{
+		const auto offset = m_offset;
+		const auto frequency = m_frequency;
+		switch (m_valueType) {
+		case ProceduralNoiseValueType::Constant:
+			std::fill(stageValues, stageValues + size, m_constantValue);
+			break;
+		case ProceduralNoiseValueType::Linear:
+			for (size_t i = 0; i < size; i++)
+			{
+				const auto actualSamplePoint = (samplePoints[i] + offset) * frequency;
+				stageValues[i] = actualSamplePoint.x + actualSamplePoint.y;
+			}
+			break;
+		case ProceduralNoiseValueType::Sine:
+			for (size_t i = 0; i < size; i++)
+			{
+				const auto actualSamplePoint = (samplePoints[i] + offset) * frequency;
+				stageValues[i] = glm::sin(actualSamplePoint.x) + glm::sin(actualSamplePoint.y);
+			}
+			break;
+		case ProceduralNoiseValueType::Tangent:
+			for (size_t i = 0; i < size; i++)
+			{
+				const auto actualSamplePoint = (samplePoints[i] + offset) * frequency;
+				stageValues[i] = glm::tan(actualSamplePoint.x) + glm::tan(actualSamplePoint.y);
+			}
+			break;
+		case ProceduralNoiseValueType::Simplex:
+		case ProceduralNoiseValueType::Perlin:
+		{
+			//Offset is added before the kernel so its input is rounded exactly like (p + offset) * frequency.
+			constexpr size_t chunkSize = 256;
+			T offsetPoints[chunkSize];
+			for (size_t start = 0; start < size; start += chunkSize)
+			{
+				const size_t count = glm::min(chunkSize, size - start);
+				for (size_t i = 0; i < count; i++) offsetPoints[i] = samplePoints[start + i] + offset;
+				if (m_valueType == ProceduralNoiseValueType::Perlin) NoiseKernels::Perlin(offsetPoints, stageValues + start, count, frequency);
+				else NoiseKernels::Simplex(offsetPoints, stageValues + start, count, frequency);
+			}
+		}
+		break;
+		default:
+			std::fill(stageValues, stageValues + size, 0.f);
+			break;
+		}
+
+		switch (m_operatorType)
+		{
+		case ProceduralNoiseOperatorType::None:
+			break;
+		case ProceduralNoiseOperatorType::Add:
+			for (size_t i = 0; i < size; i++) values[i] += stageValues[i];
+			break;
+		case ProceduralNoiseOperatorType::Subtract:
+			for (size_t i = 0; i < size; i++) values[i] -= stageValues[i];
+			break;
+		case ProceduralNoiseOperatorType::Multiply:
+			for (size_t i = 0; i < size; i++) values[i] *= stageValues[i];
+			break;
+		case ProceduralNoiseOperatorType::Divide:
+			for (size_t i = 0; i < size; i++) values[i] /= stageValues[i];
+			break;
+		case ProceduralNoiseOperatorType::Pow:
+			for (size_t i = 0; i < size; i++) values[i] = glm::pow(values[i], stageValues[i]);
+			break;
+		case ProceduralNoiseOperatorType::Min:
+			for (size_t i = 0; i < size; i++) values[i] = glm::min(values[i], stageValues[i]);
+			break;
+		case ProceduralNoiseOperatorType::Max:
+			for (size_t i = 0; i < size; i++) values[i] = glm::max(values[i], stageValues[i]);
+			break;
+		case ProceduralNoiseOperatorType::FlipUp:
+			for (size_t i = 0; i < size; i++) values[i] = glm::abs(values[i] - stageValues[i]) + stageValues[i];
+			break;
+		case ProceduralNoiseOperatorType::FlipDown:
+			for (size_t i = 0; i < size; i++) values[i] = -glm::abs(-values[i] + stageValues[i]) + stageValues[i];
+			break;
+		case ProceduralNoiseOperatorType::Reset:
+			std::copy(stageValues, stageValues + size, values);
+			break;
+		}
+	}
+
 	
 }
@@ -17,6 +17,43 @@ namespace EcoSysLab
         std::vector<std::shared_ptr<TreeGraphNode>> m_children;
     };
 
+    /**
+     * \brief A tree graph as flat columns indexed by node, parents always come before their children.
+     */
+    struct TreeGraphArrays {
+        std::vector<int> m_ids;
+        /**
+         * \brief Index of the parent in the columns, -1 for the root.
+         */
+        std::vector<int> m_parents;
+        std::vector<glm::vec3> m_starts;
+        std::vector<glm::vec3> m_positions;
+        std::vector<glm::quat> m_globalRotations;
+        std::vector<float> m_lengths;
+        std::vector<float> m_thicknesses;
+        std::vector<unsigned char> m_fromApicalBud;
+
+        void Clear();
+        [[nodiscard]] size_t GetSize() const;
+        void Reserve(size_t size);
+        /**
+         * Append a node and derive m_fromApicalBud: the first child of a parent continues its flow.
+         * @return The index of the node.
+         */
+        int Add(int id, int parentIndex, const glm::vec3& start, const glm::vec3& position, const glm::quat& globalRotation, float length, float thickness);
+        /**
+         * \brief Flatten a node tree built by TreeGraph::Deserialize or TreeGraphV2::Deserialize, breadth first.
+         */
+        void FromNodeTree(const std::shared_ptr<TreeGraphNode>& root);
+        /**
+         * \brief Rebuild the skeleton from the columns, node i of the columns becomes one node of the skeleton.
+         */
+        template<typename SkeletonData, typename FlowData, typename NodeData>
+        void ToSkeleton(Skeleton<SkeletonData, FlowData, NodeData>& skeleton) const;
+    private:
+        std::vector<int> m_childCounts;
+    };
+
     class TreeGraph : public IAsset {
         void CollectChild(const std::shared_ptr<TreeGraphNode>& node, std::vector<std::vector<std::shared_ptr<TreeGraphNode>>>& graphNodes, int currentLayer) const;
     public:
@@ -30,6 +67,12 @@ namespace EcoSysLab
         void Serialize(YAML::Emitter& out) const override;
 
         void Deserialize(const YAML::Node& in) override;
+        /**
+         * \brief Parse the same document as Deserialize into columns, visiting every map once instead of looking nodes up by index.
+         * @return False if the document is malformed or a parent is missing, the error is logged and no exception escapes.
+         */
+        static bool ParseArrays(const YAML::Node& in, TreeGraphArrays& arrays);
+        static bool ImportArrays(const std::filesystem::path& path, TreeGraphArrays& arrays);
 
         bool OnInspect(const std::shared_ptr<EditorLayer>& editorLayer) override;
     };
@@ -47,7 +90,38 @@ namespace EcoSysLab
         void Serialize(YAML::Emitter& out) const override;
 
         void Deserialize(const YAML::Node& in) override;
+        /**
+         * \brief Parse the same document as Deserialize into columns, visiting every map once instead of looking nodes up by index.
+         * @return False if the document is malformed or a parent is missing, the error is logged and no exception escapes.
+         */
+        static bool ParseArrays(const YAML::Node& in, TreeGraphArrays& arrays);
+        static bool ImportArrays(const std::filesystem::path& path, TreeGraphArrays& arrays);
 
         bool OnInspect(const std::shared_ptr<EditorLayer>& editorLayer) override;
     };
+
+    template <typename SkeletonData, typename FlowData, typename NodeData>
+    void TreeGraphArrays::ToSkeleton(Skeleton<SkeletonData, FlowData, NodeData>& skeleton) const
+    {
+        skeleton = Skeleton<SkeletonData, FlowData, NodeData>();
+        const auto size = GetSize();
+        if (size == 0) return;
+        std::vector<SkeletonNodeHandle> handles(size);
+        handles[0] = 0;
+        for (size_t i = 1; i < size; i++)
+        {
+            handles[i] = skeleton.Extend(handles[m_parents[i]], !m_fromApicalBud[i]);
+        }
+        for (size_t i = 0; i < size; i++)
+        {
+            auto& nodeInfo = skeleton.RefNode(handles[i]).m_info;
+            nodeInfo.m_globalPosition = m_starts[i];
+            nodeInfo.m_globalRotation = glm::normalize(m_globalRotations[i]);
+            nodeInfo.m_length = m_lengths[i];
+            nodeInfo.m_thickness = m_thicknesses[i];
+        }
+        skeleton.SortLists();
+        skeleton.CalculateDistance();
+        skeleton.CalculateFlows();
+    }
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "Application.hpp"
+#include "BinaryArchive.hpp"
 #include "ClassRegistry.hpp"
 #include "DatasetGenerator.hpp"
 #include "EcoSysLabLayer.hpp"
@@ -9,13 +10,19 @@
 #include "Soil.hpp"
 #include "SorghumLayer.hpp"
 #include "Tree.hpp"
+#include "NoiseKernels.hpp"
 #include "TreeStructor.hpp"
+#include "TreeDatasetEngine.hpp"
+#include "TreeGraph.hpp"
+#include "TreeIOTree.hpp"
 #include "WindowLayer.hpp"
 #ifdef BUILD_WITH_RAYTRACER
 #include <CUDAModule.hpp>
 #include <RayTracerLayer.hpp>
 #endif
 #include <TreePointCloudScanner.hpp>
+#include <glm/gtc/noise.hpp>
+#include <glm/gtc/random.hpp>
 
 #include "DatasetGenerator.hpp"
 #include "ParticlePhysics2DDemo.hpp"
@@ -235,6 +242,480 @@ void sorghum_field_point_cloud()
 		index++;
 	}
 }
+void sorghum_field_mesh_benchmark()
+{
+	std::filesystem::path resourceFolderPath("../../../Resources");
+	if (!std::filesystem::exists(resourceFolderPath)) {
+		resourceFolderPath = "../../Resources";
+	}
+	if (!std::filesystem::exists(resourceFolderPath)) {
+		resourceFolderPath = "../Resources";
+	}
+	resourceFolderPath = std::filesystem::absolute(resourceFolderPath);
+
+	std::filesystem::path project_path = resourceFolderPath / "SorghumProject" / "test.eveproj";
+	start_project_windowless(project_path);
+
+	const auto sorghumLayer = Application::GetLayer<SorghumLayer>();
+	const auto scene = Application::GetActiveScene();
+	const auto sorghumDescriptor = std::dynamic_pointer_cast<SorghumStateGenerator>(ProjectManager::GetOrCreateAsset(std::filesystem::path("SorghumStateGenerator") / "Random.ssg"));
+	const SorghumMeshGeneratorSettings sorghumMeshGeneratorSettings{};
+	for (const int gridSize : { 10, 20, 40, 70, 100 }) {
+		SorghumFieldPatch pattern{};
+		pattern.m_gridSize = { gridSize, gridSize };
+		pattern.m_gridDistance = { 0.75f, 0.75f };
+		std::vector<glm::mat4> matricesList;
+		pattern.GenerateField(matricesList);
+		for (const bool instanced : { false, true }) {
+			const auto sorghumField = ProjectManager::CreateTemporaryAsset<SorghumField>();
+			sorghumField->m_sizeLimit = gridSize * gridSize;
+			sorghumField->m_instanced = instanced;
+			sorghumField->m_matrices.resize(matricesList.size());
+			for (int i = 0; i < matricesList.size(); i++)
+			{
+				sorghumField->m_matrices[i] = { sorghumDescriptor, matricesList[i] };
+			}
+			//Field instantiation includes mesh generation, regenerating shows the cost of the batched builder alone.
+			const auto start = std::chrono::high_resolution_clock::now();
+			const auto field = sorghumField->InstantiateField();
+			const auto instantiated = std::chrono::high_resolution_clock::now();
+			if (!instanced) sorghumLayer->GenerateMeshForAllSorghums(sorghumMeshGeneratorSettings);
+			const auto regenerated = std::chrono::high_resolution_clock::now();
+			EVOENGINE_LOG("Plants: " + std::to_string(gridSize * gridSize) + (instanced ? " | Instanced" : " | Per plant")
+				+ " | Build field: " + std::to_string(std::chrono::duration<double>(instantiated - start).count()) + "s"
+				+ (instanced ? "" : " | Regenerate meshes: " + std::to_string(std::chrono::duration<double>(regenerated - instantiated).count()) + "s"));
+			scene->DeleteEntity(field);
+			Application::Loop();
+		}
+	}
+}
+
+bool noise_kernel_check()
+{
+	//Random points over a wide range, every seventh snapped to the lattice where floor and fract are most fragile.
+	constexpr size_t size = 1000003;
+	std::vector<glm::vec2> points2D(size);
+	std::vector<glm::vec3> points3D(size);
+	for (size_t i = 0; i < size; i++)
+	{
+		points2D[i] = glm::linearRand(glm::vec2(-1000.0f), glm::vec2(1000.0f));
+		points3D[i] = glm::linearRand(glm::vec3(-1000.0f), glm::vec3(1000.0f));
+		if (i % 7 == 0) {
+			points2D[i] = glm::round(points2D[i]);
+			points3D[i] = glm::round(points3D[i]);
+		}
+	}
+	const glm::vec3 scale = glm::vec3(0.37f, 0.41f, 0.29f);
+	const glm::vec3 bias = glm::vec3(3.0f, -2.0f, 1.0f);
+	std::vector<float> kernelValues(size);
+	std::vector<float> glmValues(size);
+	bool passed = true;
+	const auto compare = [&](const std::string& name, const std::function<void()>& kernel, const std::function<void()>& reference)
+		{
+			const auto start = std::chrono::high_resolution_clock::now();
+			kernel();
+			const auto kernelEnd = std::chrono::high_resolution_clock::now();
+			reference();
+			const auto referenceEnd = std::chrono::high_resolution_clock::now();
+			float maxError = 0.0f;
+			for (size_t i = 0; i < size; i++) maxError = glm::max(maxError, glm::abs(kernelValues[i] - glmValues[i]));
+			EVOENGINE_LOG(name + (NoiseKernels::IsVectorized() ? " | SSE2" : " | Scalar")
+				+ " | Max error: " + std::to_string(maxError)
+				+ " | Kernel: " + std::to_string(std::chrono::duration<double>(kernelEnd - start).count()) + "s"
+				+ " | glm: " + std::to_string(std::chrono::duration<double>(referenceEnd - kernelEnd).count()) + "s");
+			if (maxError > NoiseKernels::Tolerance) {
+				EVOENGINE_ERROR(name + ": kernel differs from glm by more than NoiseKernels::Tolerance!");
+				passed = false;
+			}
+		};
+	const glm::vec2 scale2D = glm::vec2(scale);
+	const glm::vec2 bias2D = glm::vec2(bias);
+	compare("Perlin 2D", [&] { NoiseKernels::Perlin(points2D.data(), kernelValues.data(), size, scale2D, bias2D); },
+		[&] { for (size_t i = 0; i < size; i++) glmValues[i] = glm::perlin(points2D[i] * scale2D + bias2D); });
+	compare("Perlin 3D", [&] { NoiseKernels::Perlin(points3D.data(), kernelValues.data(), size, scale, bias); },
+		[&] { for (size_t i = 0; i < size; i++) glmValues[i] = glm::perlin(points3D[i] * scale + bias); });
+	compare("Simplex 2D", [&] { NoiseKernels::Simplex(points2D.data(), kernelValues.data(), size, scale2D, bias2D); },
+		[&] { for (size_t i = 0; i < size; i++) glmValues[i] = glm::simplex(points2D[i] * scale2D + bias2D); });
+	compare("Simplex 3D", [&] { NoiseKernels::Simplex(points3D.data(), kernelValues.data(), size, scale, bias); },
+		[&] { for (size_t i = 0; i < size; i++) glmValues[i] = glm::simplex(points3D[i] * scale + bias); });
+	return passed;
+}
+
+bool binary_archive_check()
+{
+	const auto path = std::filesystem::temp_directory_path() / "binary_archive_check.eslb";
+	bool passed = true;
+	const auto check = [&](const bool condition, const std::string& message)
+		{
+			if (condition) return;
+			EVOENGINE_ERROR("Binary archive: " + message);
+			passed = false;
+		};
+	//Smooth positions compress well, noise doesn't and must fall back to raw storage.
+	constexpr size_t size = 4000000;
+	std::vector<glm::vec3> positions(size);
+	std::vector<int> noise(size);
+	for (size_t i = 0; i < size; i++)
+	{
+		positions[i] = glm::vec3(glm::sin(i * 0.001f), i * 0.0001f, glm::cos(i * 0.001f));
+		noise[i] = glm::linearRand(-1000000, 1000000);
+	}
+	const std::vector<int> empty;
+	for (const bool compress : { false, true })
+	{
+		BinaryArchiveWriter writer;
+		writer.m_compress = compress;
+		check(writer.AddArray("positions", positions), "AddArray failed");
+		check(writer.AddArray("noise", noise), "AddArray failed");
+		check(writer.AddArray("empty", empty), "AddArray failed");
+		check(writer.AddValue("count", static_cast<int>(size)), "AddValue failed");
+		check(writer.AddColumn<float>("heights", positions, [](const glm::vec3& position) { return position.y; }), "AddColumn failed");
+		check(!writer.AddValue("count", 0), "duplicate chunk accepted");
+		const auto start = std::chrono::high_resolution_clock::now();
+		check(writer.Write(path), "Write failed");
+		const auto written = std::chrono::high_resolution_clock::now();
+		BinaryArchiveReader reader;
+		check(reader.Open(path), "Open failed");
+		const auto loadedPositions = reader.GetArray<glm::vec3>("positions");
+		const auto loadedNoise = reader.GetArray<int>("noise");
+		const auto read = std::chrono::high_resolution_clock::now();
+		check(loadedPositions.size() == size && std::equal(positions.begin(), positions.end(), loadedPositions.begin()), "positions differ");
+		check(loadedNoise.size() == size && std::equal(noise.begin(), noise.end(), loadedNoise.begin()), "noise differs");
+		check(reader.HasChunk("empty") && reader.GetArray<int>("empty").empty(), "empty chunk lost");
+		int count = 0;
+		check(reader.GetValue("count", count) && count == static_cast<int>(size), "value differs");
+		std::vector<glm::vec3> heights(size);
+		check(reader.ReadColumn<float>("heights", heights, [](glm::vec3& position, const float height) { position.y = height; }), "column missing");
+		for (size_t i = 0; i < size && passed; i++) check(heights[i].y == positions[i].y, "column differs");
+		check(!reader.HasChunk("missing") && reader.GetArray<int>("missing").empty(), "missing chunk found");
+		const auto megabytes = static_cast<double>(size * (sizeof(glm::vec3) + sizeof(int))) / (1024.0 * 1024.0);
+		EVOENGINE_LOG(std::string(compress ? "Compressed" : "Raw")
+			+ " | File: " + std::to_string(static_cast<double>(std::filesystem::file_size(path)) / (1024.0 * 1024.0)) + "MB"
+			+ " | Write: " + std::to_string(megabytes / std::chrono::duration<double>(written - start).count()) + "MB/s"
+			+ " | Read: " + std::to_string(megabytes / std::chrono::duration<double>(read - written).count()) + "MB/s");
+	}
+	std::filesystem::remove(path);
+	return passed;
+}
+
+/**
+ * Needs an open project for the temporary assets.
+ */
+bool tree_graph_parse_check()
+{
+	bool passed = true;
+	const auto compare = [&](const std::string& name, const TreeGraphArrays& expected, const TreeGraphArrays& actual)
+		{
+			const bool equal = expected.m_ids == actual.m_ids && expected.m_parents == actual.m_parents
+				&& expected.m_starts == actual.m_starts && expected.m_positions == actual.m_positions
+				&& expected.m_globalRotations == actual.m_globalRotations && expected.m_lengths == actual.m_lengths
+				&& expected.m_thicknesses == actual.m_thicknesses && expected.m_fromApicalBud == actual.m_fromApicalBud;
+			if (!equal) {
+				EVOENGINE_ERROR(name + ": ParseArrays differs from Deserialize!");
+				passed = false;
+			}
+		};
+	const auto timed = [](const std::function<void()>& func)
+		{
+			const auto start = std::chrono::high_resolution_clock::now();
+			func();
+			return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+		};
+	const auto writeComponents = [](YAML::Emitter& out, const float* components, const int size)
+		{
+			out << YAML::BeginSeq;
+			for (int i = 0; i < size; i++) out << components[i];
+			out << YAML::EndSeq;
+		};
+	for (const int nodeSize : { 10, 100, 1000, 5000 })
+	{
+		//Nodes are created breadth first, so ids, layer order and FromNodeTree's order all agree.
+		std::vector<int> parents = { -1 };
+		std::vector<int> layers = { 0 };
+		for (int i = 0; parents.size() < nodeSize; i++)
+		{
+			//The last node always gets a child so the tree keeps growing.
+			const int childCount = glm::linearRand(i + 1 == parents.size() ? 1 : 0, 3);
+			for (int child = 0; child < childCount && parents.size() < nodeSize; child++)
+			{
+				parents.emplace_back(i);
+				layers.emplace_back(layers[i] + 1);
+			}
+		}
+		const int layerSize = layers.back() + 1;
+
+		YAML::Emitter graphOut;
+		graphOut << YAML::BeginMap << YAML::Key << "name" << YAML::Value << "Check";
+		graphOut << YAML::Key << "layersize" << YAML::Value << layerSize;
+		graphOut << YAML::Key << "layers" << YAML::Value << YAML::BeginMap;
+		for (int node = 0, layerIndex = -1, layerNodeIndex = 0; node < nodeSize; node++)
+		{
+			if (layers[node] != layerIndex)
+			{
+				if (layerIndex != -1) graphOut << YAML::EndMap;
+				layerIndex = layers[node];
+				layerNodeIndex = 0;
+				graphOut << YAML::Key << std::to_string(layerIndex) << YAML::Value << YAML::BeginMap;
+				graphOut << YAML::Key << "internodesize" << YAML::Value << static_cast<int>(std::count(layers.begin(), layers.end(), layerIndex));
+			}
+			const auto rotation = glm::normalize(glm::quat(glm::linearRand(0.1f, 1.0f), glm::linearRand(-1.0f, 1.0f), glm::linearRand(-1.0f, 1.0f), glm::linearRand(-1.0f, 1.0f)));
+			const auto position = glm::linearRand(glm::vec3(-10.0f), glm::vec3(10.0f));
+			graphOut << YAML::Key << std::to_string(layerNodeIndex++) << YAML::Value << YAML::BeginMap;
+			graphOut << YAML::Key << "id" << YAML::Value << node;
+			graphOut << YAML::Key << "parent" << YAML::Value << (parents[node] == 0 ? -1 : parents[node]);
+			graphOut << YAML::Key << "quat" << YAML::Value;
+			writeComponents(graphOut, &rotation[0], 4);
+			graphOut << YAML::Key << "position" << YAML::Value;
+			writeComponents(graphOut, &position[0], 3);
+			graphOut << YAML::Key << "thickness" << YAML::Value << glm::linearRand(0.01f, 0.1f);
+			graphOut << YAML::Key << "length" << YAML::Value << glm::linearRand(0.1f, 1.0f);
+			graphOut << YAML::EndMap;
+		}
+		graphOut << YAML::EndMap << YAML::EndMap << YAML::EndMap;
+
+		//V2 parents always come before their children, ids are already in breadth first order.
+		YAML::Emitter graphV2Out;
+		graphV2Out << YAML::BeginMap;
+		for (int node = 0; node < nodeSize; node++)
+		{
+			const auto position = glm::linearRand(glm::vec3(-10.0f), glm::vec3(10.0f));
+			graphV2Out << YAML::Key << std::to_string(node) << YAML::Value << YAML::BeginMap;
+			graphV2Out << YAML::Key << "parent" << YAML::Value << parents[node];
+			graphV2Out << YAML::Key << "position" << YAML::Value;
+			writeComponents(graphV2Out, &position[0], 3);
+			graphV2Out << YAML::Key << "radius" << YAML::Value << glm::linearRand(0.01f, 0.1f);
+			graphV2Out << YAML::EndMap;
+		}
+		graphV2Out << YAML::EndMap;
+
+		const auto graphIn = YAML::Load(graphOut.c_str());
+		const auto graphV2In = YAML::Load(graphV2Out.c_str());
+		const auto treeGraph = ProjectManager::CreateTemporaryAsset<TreeGraph>();
+		const auto treeGraphV2 = ProjectManager::CreateTemporaryAsset<TreeGraphV2>();
+		TreeGraphArrays expected{};
+		TreeGraphArrays actual{};
+		const auto deserializeTime = timed([&] { treeGraph->Deserialize(graphIn); expected.FromNodeTree(treeGraph->m_root); });
+		const auto parseTime = timed([&] { if (!TreeGraph::ParseArrays(graphIn, actual)) passed = false; });
+		compare("TreeGraph " + std::to_string(nodeSize), expected, actual);
+		const auto deserializeV2Time = timed([&] { treeGraphV2->Deserialize(graphV2In); expected.FromNodeTree(treeGraphV2->m_root); });
+		const auto parseV2Time = timed([&] { if (!TreeGraphV2::ParseArrays(graphV2In, actual)) passed = false; });
+		compare("TreeGraphV2 " + std::to_string(nodeSize), expected, actual);
+		EVOENGINE_LOG("Nodes: " + std::to_string(nodeSize)
+			+ " | TreeGraph Deserialize: " + std::to_string(deserializeTime) + "s ParseArrays: " + std::to_string(parseTime) + "s"
+			+ " | TreeGraphV2 Deserialize: " + std::to_string(deserializeV2Time) + "s ParseArrays: " + std::to_string(parseV2Time) + "s");
+	}
+	//Malformed documents report an error instead of throwing.
+	TreeGraphArrays malformed{};
+	if (TreeGraph::ParseArrays(YAML::Load("{layersize: 2, layers: {0: {0: {id: x}}}}"), malformed)
+		|| TreeGraphV2::ParseArrays(YAML::Load("{0: {parent: -1, position: [0, 1, 0], radius: []}}"), malformed))
+	{
+		EVOENGINE_ERROR("Malformed tree graph accepted!");
+		passed = false;
+	}
+	return passed;
+}
+
+/**
+ * Needs an open project. Grows a tree with history and strands, writes it with SaveBinary, reads it into a second tree and compares both.
+ */
+bool tree_binary_round_trip_check(const std::filesystem::path& treeDescriptorPath, const int iterations)
+{
+	const auto scene = Application::GetActiveScene();
+	const auto ecoSysLabLayer = Application::GetLayer<EcoSysLabLayer>();
+	if (!ecoSysLabLayer || !ProjectManager::IsInProjectFolder(treeDescriptorPath))
+	{
+		EVOENGINE_ERROR("Tree binary round trip: needs the EcoSysLab layer and a tree descriptor in the project!");
+		return false;
+	}
+	bool passed = true;
+	const auto check = [&](const bool condition, const std::string& message)
+		{
+			if (condition) return;
+			EVOENGINE_ERROR("Tree binary round trip: " + message);
+			passed = false;
+		};
+	const auto compareSkeleton = [&](const std::string& name, const auto& expected, const auto& actual)
+		{
+			const auto& expectedNodes = expected.PeekRawNodes();
+			const auto& actualNodes = actual.PeekRawNodes();
+			check(expectedNodes.size() == actualNodes.size(), name + " node count differs");
+			check(expected.PeekSortedNodeList().size() == actual.PeekSortedNodeList().size(), name + " sorted node count differs");
+			for (size_t i = 0; i < expectedNodes.size() && i < actualNodes.size() && passed; i++)
+			{
+				const auto& a = expectedNodes[i];
+				const auto& b = actualNodes[i];
+				check(a.IsRecycled() == b.IsRecycled() && a.GetParentHandle() == b.GetParentHandle() && a.GetFlowHandle() == b.GetFlowHandle()
+					&& a.PeekChildHandles() == b.PeekChildHandles(), name + " node " + std::to_string(i) + " structure differs");
+				check(a.m_info.m_globalPosition == b.m_info.m_globalPosition && a.m_info.m_globalRotation == b.m_info.m_globalRotation
+					&& a.m_info.m_length == b.m_info.m_length && a.m_info.m_thickness == b.m_info.m_thickness, name + " node " + std::to_string(i) + " info differs");
+			}
+			const auto& expectedFlows = expected.PeekRawFlows();
+			const auto& actualFlows = actual.PeekRawFlows();
+			check(expectedFlows.size() == actualFlows.size(), name + " flow count differs");
+			for (size_t i = 0; i < expectedFlows.size() && i < actualFlows.size() && passed; i++)
+			{
+				const auto& a = expectedFlows[i];
+				const auto& b = actualFlows[i];
+				check(a.IsRecycled() == b.IsRecycled() && a.GetParentHandle() == b.GetParentHandle()
+					&& a.PeekChildHandles() == b.PeekChildHandles() && a.PeekNodeHandles() == b.PeekNodeHandles(), name + " flow " + std::to_string(i) + " differs");
+			}
+		};
+
+	const auto treeDescriptor = std::dynamic_pointer_cast<TreeDescriptor>(ProjectManager::GetOrCreateAsset(ProjectManager::GetPathRelativeToProject(treeDescriptorPath)));
+	const auto treeEntity = scene->CreateEntity("Round Trip Tree");
+	const auto tree = scene->GetOrSetPrivateComponent<Tree>(treeEntity).lock();
+	tree->m_treeDescriptor = treeDescriptor;
+	tree->m_treeModel.m_treeGrowthSettings.m_useSpaceColonization = false;
+	Application::Loop();
+	for (int i = 0; i < iterations; i++)
+	{
+		ecoSysLabLayer->Simulate();
+		if (i % 10 == 0) tree->m_treeModel.Step();
+	}
+	tree->BuildStrandModel();
+
+	const auto loadedEntity = scene->CreateEntity("Loaded Tree");
+	const auto loadedTree = scene->GetOrSetPrivateComponent<Tree>(loadedEntity).lock();
+	const auto path = std::filesystem::temp_directory_path() / "tree_binary_round_trip_check.esb";
+	for (const bool compress : { false, true })
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+		check(tree->SaveBinary(path, compress), "SaveBinary failed");
+		const auto saved = std::chrono::high_resolution_clock::now();
+		check(loadedTree->LoadBinary(path), "LoadBinary failed");
+		const auto loaded = std::chrono::high_resolution_clock::now();
+
+		compareSkeleton("Shoot skeleton", tree->m_treeModel.PeekShootSkeleton(), loadedTree->m_treeModel.PeekShootSkeleton());
+		check(tree->m_treeModel.CurrentIteration() == loadedTree->m_treeModel.CurrentIteration(), "history size differs");
+		for (int i = 0; i < tree->m_treeModel.CurrentIteration() && i < loadedTree->m_treeModel.CurrentIteration(); i++)
+		{
+			compareSkeleton("History " + std::to_string(i), tree->m_treeModel.PeekShootSkeleton(i), loadedTree->m_treeModel.PeekShootSkeleton(i));
+		}
+		const auto& strandSkeleton = tree->m_strandModel.m_strandModelSkeleton;
+		const auto& loadedStrandSkeleton = loadedTree->m_strandModel.m_strandModelSkeleton;
+		compareSkeleton("Strand model skeleton", strandSkeleton, loadedStrandSkeleton);
+		for (size_t i = 0; i < strandSkeleton.PeekRawNodes().size() && i < loadedStrandSkeleton.PeekRawNodes().size() && passed; i++)
+		{
+			const auto& particles = strandSkeleton.PeekRawNodes()[i].m_data.m_profile.PeekParticles();
+			const auto& loadedParticles = loadedStrandSkeleton.PeekRawNodes()[i].m_data.m_profile.PeekParticles();
+			check(particles.size() == loadedParticles.size(), "profile " + std::to_string(i) + " particle count differs");
+			for (size_t j = 0; j < particles.size() && j < loadedParticles.size(); j++)
+			{
+				check(particles[j].GetPosition() == loadedParticles[j].GetPosition() && particles[j].m_strandHandle == loadedParticles[j].m_strandHandle
+					&& particles[j].m_strandSegmentHandle == loadedParticles[j].m_strandSegmentHandle, "profile " + std::to_string(i) + " particle " + std::to_string(j) + " differs");
+			}
+		}
+		const auto& strandGroup = strandSkeleton.m_data.m_strandGroup;
+		const auto& loadedStrandGroup = loadedStrandSkeleton.m_data.m_strandGroup;
+		check(strandGroup.PeekStrands().size() == loadedStrandGroup.PeekStrands().size(), "strand count differs");
+		check(strandGroup.PeekStrandSegments().size() == loadedStrandGroup.PeekStrandSegments().size(), "strand segment count differs");
+		for (size_t i = 0; i < strandGroup.PeekStrands().size() && i < loadedStrandGroup.PeekStrands().size() && passed; i++)
+		{
+			check(strandGroup.PeekStrands()[i].PeekStrandSegmentHandles() == loadedStrandGroup.PeekStrands()[i].PeekStrandSegmentHandles(), "strand " + std::to_string(i) + " differs");
+		}
+		for (size_t i = 0; i < strandGroup.PeekStrandSegments().size() && i < loadedStrandGroup.PeekStrandSegments().size() && passed; i++)
+		{
+			const auto& a = strandGroup.PeekStrandSegments()[i];
+			const auto& b = loadedStrandGroup.PeekStrandSegments()[i];
+			check(a.m_data.m_nodeHandle == b.m_data.m_nodeHandle && a.m_data.m_profileParticleHandle == b.m_data.m_profileParticleHandle
+				&& a.m_info.m_globalPosition == b.m_info.m_globalPosition && strandGroup.GetStrandSegmentIndex(i) == loadedStrandGroup.GetStrandSegmentIndex(i),
+				"strand segment " + std::to_string(i) + " differs");
+		}
+		const auto megabytes = static_cast<double>(std::filesystem::file_size(path)) / (1024.0 * 1024.0);
+		EVOENGINE_LOG(std::string(compress ? "Compressed" : "Raw")
+			+ " | Nodes: " + std::to_string(tree->m_treeModel.PeekShootSkeleton().PeekSortedNodeList().size())
+			+ " | History: " + std::to_string(tree->m_treeModel.CurrentIteration())
+			+ " | Strands: " + std::to_string(strandGroup.PeekStrands().size())
+			+ " | File: " + std::to_string(megabytes) + "MB"
+			+ " | Save: " + std::to_string(std::chrono::duration<double>(saved - start).count()) + "s"
+			+ " | Load: " + std::to_string(std::chrono::duration<double>(loaded - saved).count()) + "s ("
+			+ std::to_string(megabytes / std::chrono::duration<double>(loaded - saved).count()) + "MB/s)");
+	}
+	std::filesystem::remove(path);
+	scene->DeleteEntity(loadedEntity);
+	scene->DeleteEntity(treeEntity);
+	Application::Loop();
+	return passed;
+}
+
+/**
+ * Writes random ArrayTrees with saveTreeBinary and saveTree, loads them through fromPathsNoRuntime and compares the binary
+ * copies with the originals. A throwing task must reach the caller of treeutil::parallelFor instead of terminating.
+ */
+bool array_tree_binary_round_trip_check()
+{
+	bool passed = true;
+	const auto check = [&](const bool condition, const std::string& message)
+		{
+			if (condition) return;
+			EVOENGINE_ERROR("ArrayTree binary round trip: " + message);
+			passed = false;
+		};
+	const auto folder = std::filesystem::temp_directory_path();
+	for (const int nodeSize : { 1, 100, 10000, 200000 })
+	{
+		treeio::ArrayTree tree{};
+		std::vector<treeio::ArrayTree::NodeIdT> nodeIds;
+		treeio::TreeNodeData data{};
+		data.pos = treeutil::Vector3D(0.0f, 0.0f, 0.0f);
+		data.thickness = 0.1f;
+		nodeIds.emplace_back(tree.addRoot(data));
+		while (nodeIds.size() < nodeSize)
+		{
+			data.pos = treeutil::Vector3D(glm::linearRand(glm::vec3(-10.0f), glm::vec3(10.0f)));
+			data.thickness = glm::linearRand(0.001f, 0.1f);
+			nodeIds.emplace_back(tree.addNodeChild(nodeIds[glm::linearRand(0, static_cast<int>(nodeIds.size()) - 1)], data));
+		}
+		const auto textPath = (folder / ("array_tree_check_" + std::to_string(nodeSize) + ".tree")).string();
+		const auto binaryPath = (folder / ("array_tree_check_" + std::to_string(nodeSize) + ".treeb")).string();
+		check(tree.saveTree(textPath) && tree.saveTreeBinary(binaryPath), "failed to write " + std::to_string(nodeSize) + " nodes");
+		const auto start = std::chrono::high_resolution_clock::now();
+		const auto textTrees = treeio::ArrayTree::fromPathsNoRuntime({ textPath });
+		const auto textLoaded = std::chrono::high_resolution_clock::now();
+		const auto binaryTrees = treeio::ArrayTree::fromPathsNoRuntime({ binaryPath });
+		const auto binaryLoaded = std::chrono::high_resolution_clock::now();
+		const auto& loaded = binaryTrees.front();
+		check(textTrees.front().nodeCount() == tree.nodeCount(), "text node count differs");
+		check(loaded.nodeCount() == tree.nodeCount(), "binary node count differs");
+		//The binary file orders nodes depth first, so both trees are walked in parallel from their roots.
+		std::vector<std::pair<treeio::ArrayTree::NodeIdT, treeio::ArrayTree::NodeIdT>> stack;
+		if (loaded.nodeCount() == tree.nodeCount()) stack.emplace_back(tree.getRootId(), loaded.getRootId());
+		while (!stack.empty() && passed)
+		{
+			const auto [id, loadedId] = stack.back();
+			stack.pop_back();
+			const auto& a = tree.getNode(id).data();
+			const auto& b = loaded.getNode(loadedId).data();
+			check(a.pos.x == b.pos.x && a.pos.y == b.pos.y && a.pos.z == b.pos.z && a.thickness == b.thickness, "node " + std::to_string(id) + " differs");
+			const auto& children = tree.getNodeChildren(id);
+			const auto& loadedChildren = loaded.getNodeChildren(loadedId);
+			check(children.size() == loadedChildren.size(), "children of node " + std::to_string(id) + " differ");
+			for (size_t i = 0; i < children.size() && i < loadedChildren.size(); i++) stack.emplace_back(children[i], loadedChildren[i]);
+		}
+		EVOENGINE_LOG("Nodes: " + std::to_string(nodeSize)
+			+ " | Text: " + std::to_string(std::filesystem::file_size(textPath) / 1024) + "KB "
+			+ std::to_string(std::chrono::duration<double>(textLoaded - start).count()) + "s"
+			+ " | Binary: " + std::to_string(std::filesystem::file_size(binaryPath) / 1024) + "KB "
+			+ std::to_string(std::chrono::duration<double>(binaryLoaded - textLoaded).count()) + "s");
+		std::filesystem::remove(textPath);
+		std::filesystem::remove(binaryPath);
+	}
+	bool rethrown = false;
+	try
+	{
+		treeutil::parallelFor(64, [](const std::size_t index)
+			{
+				if (index % 16 == 3) throw std::runtime_error("Task " + std::to_string(index));
+			}, 4);
+	}
+	catch (const std::runtime_error&)
+	{
+		rethrown = true;
+	}
+	check(rethrown, "exception of a parallelFor task was not rethrown");
+	return passed;
+}
+
 void tree_trunk_mesh()
 {
 	std::filesystem::path resourceFolderPath("../../../Resources");
@@ -262,23 +743,30 @@ void tree_trunk_mesh()
 
 	tmgs.m_enableFoliage = false;
 	std::filesystem::path target_descriptor_folder_path = resourceFolderPath / "EcoSysLabProject" / "Trunk";
-	std::vector<std::shared_ptr<TreeDescriptor>> collectedTreeDescriptors{};
+	std::vector<TreeDatasetTask> tasks{};
 	for (const auto& i : std::filesystem::recursive_directory_iterator(target_descriptor_folder_path))
 	{
 		if (i.is_regular_file() && i.path().extension().string() == ".tree")
 		{
 			for (int treeIndex = 0; treeIndex < 500; treeIndex++)
 			{
-				std::string name = "Tree_" + std::to_string(treeIndex);
-				std::string infoName = "Info_" + std::to_string(treeIndex);
-				std::string trunkName = "Trunk_" + std::to_string(treeIndex);
-				std::filesystem::path target_info_path = output_root / (infoName + ".txt");
-				std::filesystem::path target_tree_mesh_path = output_root / (name + ".obj");
-				std::filesystem::path target_trunk_mesh_path = output_root / (trunkName + ".obj");
-				DatasetGenerator::GenerateTreeTrunkMesh(i.path().string(), 0.08220f, 999, 50000, tmgs, target_tree_mesh_path.string(), target_trunk_mesh_path.string(), target_info_path.string());
+				TreeDatasetTask task{};
+				task.m_treeDescriptorPath = i.path();
+				task.m_seed = treeIndex;
+				task.m_name = i.path().stem().string() + "_" + std::to_string(treeIndex);
+				tasks.emplace_back(task);
 			}
 		}
 	}
+	TreeDatasetSettings settings{};
+	settings.m_deltaTime = 0.08220f;
+	settings.m_maxIterations = 999;
+	settings.m_maxTreeNodeCount = 50000;
+	settings.m_meshGeneratorSettings = tmgs;
+	settings.m_exportTreeMesh = true;
+	settings.m_exportTrunkMesh = true;
+	settings.m_exportTreeInfo = true;
+	TreeDatasetEngine::Generate(tasks, settings, output_root);
 }
 
 void tree_growth_mesh()
@@ -371,6 +859,9 @@ void apple_tree_growth()
 int main() {
 	//apple_tree_growth();
 	//sorghum_field_point_cloud();
+	//sorghum_field_mesh_benchmark();
+	//noise_kernel_check();
+	//binary_archive_check();
 	if (!std::filesystem::exists(resourceFolderPath)) {
 		resourceFolderPath = "../../Resources";
 	}
@@ -381,6 +872,9 @@ int main() {
 
 	std::filesystem::path project_path = resourceFolderPath / "EcoSysLabProject" / "test.eveproj";
 	start_project_windowless(project_path);
+	//tree_graph_parse_check();
+	//tree_binary_round_trip_check(resourceFolderPath / "EcoSysLabProject" / "TreeDescriptors" / "Apple.tree", 100);
+	//array_tree_binary_round_trip_check();
 
 	bool exportJunction = true;
 	forest_patch_point_cloud_joined("Coniferous", exportJunction, 1);
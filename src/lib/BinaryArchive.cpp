@@ -0,0 +1,337 @@
+#include "BinaryArchive.hpp"
+
+using namespace EcoSysLab;
+
+constexpr char ARCHIVE_MAGIC[4] = { 'E', 'S', 'L', 'B' };
+constexpr unsigned ARCHIVE_VERSION = 1;
+constexpr size_t ARCHIVE_HEADER_SIZE = 32;
+constexpr size_t ARCHIVE_ALIGNMENT = 16;
+constexpr unsigned CHUNK_FLAG_COMPRESSED = 1;
+
+constexpr int LZ_HASH_BITS = 16;
+constexpr size_t LZ_MIN_MATCH = 4;
+constexpr size_t LZ_MAX_OFFSET = 65535;
+constexpr size_t LZ_END_LITERALS = 12;
+
+static uint32_t ReadU32(const unsigned char* data)
+{
+	uint32_t value;
+	std::memcpy(&value, data, sizeof(uint32_t));
+	return value;
+}
+
+static void WriteLength(std::vector<unsigned char>& out, size_t length)
+{
+	while (length >= 255)
+	{
+		out.emplace_back(255);
+		length -= 255;
+	}
+	out.emplace_back(static_cast<unsigned char>(length));
+}
+
+/**
+ * Byte planes of equally sized lanes are grouped together, so the exponents and high bytes of floats end up next to each other.
+ */
+static void Shuffle(const unsigned char* src, unsigned char* dst, const size_t size, const unsigned stride)
+{
+	const size_t count = size / stride;
+	for (unsigned lane = 0; lane < stride; lane++)
+	{
+		for (size_t i = 0; i < count; i++) dst[lane * count + i] = src[i * stride + lane];
+	}
+	std::memcpy(dst + count * stride, src + count * stride, size - count * stride);
+}
+
+static void Unshuffle(const unsigned char* src, unsigned char* dst, const size_t size, const unsigned stride)
+{
+	const size_t count = size / stride;
+	for (unsigned lane = 0; lane < stride; lane++)
+	{
+		for (size_t i = 0; i < count; i++) dst[i * stride + lane] = src[lane * count + i];
+	}
+	std::memcpy(dst + count * stride, src + count * stride, size - count * stride);
+}
+
+/**
+ * LZ77 with the sequence layout of the LZ4 block format: a token with literal and match lengths,
+ * the literals, then a 16 bit match offset. The last sequence holds only literals.
+ */
+static void Compress(const unsigned char* src, const size_t size, std::vector<unsigned char>& out)
+{
+	out.clear();
+	out.reserve(size / 2 + 16);
+	std::vector<int64_t> table(static_cast<size_t>(1) << LZ_HASH_BITS, -1);
+	size_t anchor = 0;
+	size_t position = 0;
+	const auto emit = [&](const size_t literalEnd, const size_t offset, const size_t matchLength)
+		{
+			const size_t literalLength = literalEnd - anchor;
+			const size_t matchCode = matchLength == 0 ? 0 : matchLength - LZ_MIN_MATCH;
+			out.emplace_back(static_cast<unsigned char>((glm::min(literalLength, static_cast<size_t>(15)) << 4) | glm::min(matchCode, static_cast<size_t>(15))));
+			if (literalLength >= 15) WriteLength(out, literalLength - 15);
+			out.insert(out.end(), src + anchor, src + literalEnd);
+			if (matchLength == 0) return;
+			out.emplace_back(static_cast<unsigned char>(offset & 0xFF));
+			out.emplace_back(static_cast<unsigned char>(offset >> 8));
+			if (matchCode >= 15) WriteLength(out, matchCode - 15);
+		};
+	while (position + LZ_END_LITERALS <= size)
+	{
+		const uint32_t sequence = ReadU32(src + position);
+		const auto hash = static_cast<uint32_t>(sequence * 2654435761u) >> (32 - LZ_HASH_BITS);
+		const int64_t reference = table[hash];
+		table[hash] = static_cast<int64_t>(position);
+		if (reference < 0 || position - reference > LZ_MAX_OFFSET || ReadU32(src + reference) != sequence)
+		{
+			position++;
+			continue;
+		}
+		size_t matchLength = LZ_MIN_MATCH;
+		while (position + matchLength + LZ_END_LITERALS <= size && src[reference + matchLength] == src[position + matchLength]) matchLength++;
+		emit(position, position - reference, matchLength);
+		position += matchLength;
+		anchor = position;
+	}
+	emit(size, 0, 0);
+}
+
+static bool Decompress(const unsigned char* src, const size_t size, unsigned char* dst, const size_t rawSize)
+{
+	size_t in = 0;
+	size_t out = 0;
+	const auto readLength = [&](size_t length)
+		{
+			unsigned char next = 255;
+			while (next == 255 && in < size)
+			{
+				next = src[in++];
+				length += next;
+			}
+			return length;
+		};
+	while (in < size)
+	{
+		const unsigned char token = src[in++];
+		size_t literalLength = token >> 4;
+		if (literalLength == 15) literalLength = readLength(literalLength);
+		if (in + literalLength > size || out + literalLength > rawSize) return false;
+		std::memcpy(dst + out, src + in, literalLength);
+		in += literalLength;
+		out += literalLength;
+		if (in == size) break;
+		if (in + 2 > size) return false;
+		const size_t offset = src[in] | static_cast<size_t>(src[in + 1]) << 8;
+		in += 2;
+		size_t matchLength = token & 15;
+		if (matchLength == 15) matchLength = readLength(matchLength);
+		matchLength += LZ_MIN_MATCH;
+		if (offset == 0 || offset > out || out + matchLength > rawSize) return false;
+		//Matches may overlap their own output, so copy forward one byte at a time.
+		for (size_t i = 0; i < matchLength; i++, out++) dst[out] = dst[out - offset];
+	}
+	return out == rawSize;
+}
+
+bool BinaryArchiveWriter::AddChunk(const std::string& name, const void* data, const size_t size, const unsigned elementSize, const bool compress)
+{
+	//The reader looks chunks up by name, a second chunk with the same name would be unreachable.
+	if (!m_chunkNames.emplace(name).second)
+	{
+		EVOENGINE_ERROR("Duplicate chunk " + name);
+		return false;
+	}
+	m_chunks.emplace_back();
+	auto& chunk = m_chunks.back();
+	chunk.m_name = name;
+	chunk.m_rawSize = size;
+	chunk.m_elementSize = glm::max(1u, elementSize);
+	const auto bytes = static_cast<const unsigned char*>(data);
+	if (compress && size > 64)
+	{
+		const unsigned stride = chunk.m_elementSize % 4 == 0 ? 4 : chunk.m_elementSize % 2 == 0 ? 2 : 1;
+		std::vector<unsigned char> shuffled(size);
+		Shuffle(bytes, shuffled.data(), size, stride);
+		Compress(shuffled.data(), size, chunk.m_data);
+		if (chunk.m_data.size() < size)
+		{
+			chunk.m_flags = CHUNK_FLAG_COMPRESSED;
+			return true;
+		}
+	}
+	chunk.m_data.assign(bytes, bytes + size);
+	return true;
+}
+
+bool BinaryArchiveWriter::AddChunk(const std::string& name, const void* data, const size_t size, const unsigned elementSize)
+{
+	return AddChunk(name, data, size, elementSize, m_compress);
+}
+
+bool BinaryArchiveWriter::Write(const std::filesystem::path& path) const
+{
+	std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		EVOENGINE_ERROR("Can't open file " + path.string());
+		return false;
+	}
+	const auto writePod = [&](const auto& value) { file.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+	const char padding[ARCHIVE_ALIGNMENT] = {};
+	file.write(padding, ARCHIVE_ALIGNMENT);
+	file.write(padding, ARCHIVE_HEADER_SIZE - ARCHIVE_ALIGNMENT);
+	std::vector<uint64_t> offsets(m_chunks.size());
+	uint64_t position = ARCHIVE_HEADER_SIZE;
+	for (size_t i = 0; i < m_chunks.size(); i++)
+	{
+		offsets[i] = position;
+		const auto& data = m_chunks[i].m_data;
+		file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		position += data.size();
+		const auto paddingSize = (ARCHIVE_ALIGNMENT - position % ARCHIVE_ALIGNMENT) % ARCHIVE_ALIGNMENT;
+		file.write(padding, static_cast<std::streamsize>(paddingSize));
+		position += paddingSize;
+	}
+	const uint64_t tableOffset = position;
+	for (size_t i = 0; i < m_chunks.size(); i++)
+	{
+		const auto& chunk = m_chunks[i];
+		writePod(static_cast<uint32_t>(chunk.m_name.size()));
+		file.write(chunk.m_name.data(), static_cast<std::streamsize>(chunk.m_name.size()));
+		writePod(static_cast<uint32_t>(chunk.m_flags));
+		writePod(static_cast<uint32_t>(chunk.m_elementSize));
+		writePod(offsets[i]);
+		writePod(static_cast<uint64_t>(chunk.m_data.size()));
+		writePod(static_cast<uint64_t>(chunk.m_rawSize));
+	}
+	file.seekp(0);
+	file.write(ARCHIVE_MAGIC, 4);
+	writePod(static_cast<uint32_t>(ARCHIVE_VERSION));
+	writePod(static_cast<uint32_t>(m_chunks.size()));
+	writePod(static_cast<uint32_t>(0));
+	writePod(tableOffset);
+	file.close();
+	return !file.fail();
+}
+
+void BinaryArchiveWriter::Clear()
+{
+	m_chunks.clear();
+	m_chunkNames.clear();
+}
+
+BinaryArchiveReader::~BinaryArchiveReader()
+{
+	Close();
+}
+
+bool BinaryArchiveReader::Open(const std::filesystem::path& path)
+{
+	Close();
+	if (!m_file.open(path.string()))
+	{
+		EVOENGINE_ERROR("Can't open file " + path.string());
+		return false;
+	}
+	const auto content = m_file.view();
+	m_data = reinterpret_cast<const unsigned char*>(content.data());
+	m_size = content.size();
+	if (!m_data || m_size < ARCHIVE_HEADER_SIZE || std::memcmp(m_data, ARCHIVE_MAGIC, 4) != 0)
+	{
+		EVOENGINE_ERROR("Not a binary archive: " + path.string());
+		Close();
+		return false;
+	}
+	const auto version = ReadU32(m_data + 4);
+	if (version > ARCHIVE_VERSION)
+	{
+		EVOENGINE_ERROR("Unsupported binary archive version " + std::to_string(version) + ": " + path.string());
+		Close();
+		return false;
+	}
+	const auto chunkCount = ReadU32(m_data + 8);
+	uint64_t position;
+	std::memcpy(&position, m_data + 16, sizeof(uint64_t));
+	for (unsigned i = 0; i < chunkCount; i++)
+	{
+		if (position + 4 > m_size) break;
+		const auto nameLength = ReadU32(m_data + position);
+		position += 4;
+		if (position + nameLength + 32 > m_size) break;
+		std::string name(reinterpret_cast<const char*>(m_data + position), nameLength);
+		position += nameLength;
+		ChunkEntry entry;
+		entry.m_flags = ReadU32(m_data + position);
+		entry.m_elementSize = ReadU32(m_data + position + 4);
+		std::memcpy(&entry.m_offset, m_data + position + 8, sizeof(uint64_t));
+		std::memcpy(&entry.m_storedSize, m_data + position + 16, sizeof(uint64_t));
+		std::memcpy(&entry.m_rawSize, m_data + position + 24, sizeof(uint64_t));
+		position += 32;
+		if (entry.m_offset + entry.m_storedSize > m_size) continue;
+		m_entries[name] = entry;
+	}
+	if (m_entries.size() != chunkCount)
+	{
+		EVOENGINE_ERROR("Corrupted chunk table: " + path.string());
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void BinaryArchiveReader::Close()
+{
+	m_entries.clear();
+	{
+		std::lock_guard lock(m_inflatedChunksMutex);
+		m_inflatedChunks.clear();
+	}
+	m_file.close();
+	m_data = nullptr;
+	m_size = 0;
+}
+
+bool BinaryArchiveReader::HasChunk(const std::string& name) const
+{
+	return m_entries.find(name) != m_entries.end();
+}
+
+std::vector<std::string> BinaryArchiveReader::GetChunkNames() const
+{
+	std::vector<std::string> retVal;
+	for (const auto& [name, entry] : m_entries) retVal.emplace_back(name);
+	std::sort(retVal.begin(), retVal.end());
+	return retVal;
+}
+
+bool BinaryArchiveReader::GetChunk(const std::string& name, const unsigned char*& data, size_t& size) const
+{
+	const auto search = m_entries.find(name);
+	if (search == m_entries.end()) return false;
+	const auto& entry = search->second;
+	if (!(entry.m_flags & CHUNK_FLAG_COMPRESSED))
+	{
+		data = m_data + entry.m_offset;
+		size = entry.m_storedSize;
+		return true;
+	}
+	//Map nodes don't move on insert, so the returned pointer stays valid after the lock is released.
+	std::lock_guard lock(m_inflatedChunksMutex);
+	auto inflated = m_inflatedChunks.find(name);
+	if (inflated == m_inflatedChunks.end())
+	{
+		std::vector<unsigned char> shuffled(entry.m_rawSize);
+		if (!Decompress(m_data + entry.m_offset, entry.m_storedSize, shuffled.data(), entry.m_rawSize))
+		{
+			EVOENGINE_ERROR("Corrupted chunk " + name);
+			return false;
+		}
+		std::vector<unsigned char> chunk(entry.m_rawSize);
+		const unsigned stride = entry.m_elementSize % 4 == 0 ? 4 : entry.m_elementSize % 2 == 0 ? 2 : 1;
+		Unshuffle(shuffled.data(), chunk.data(), chunk.size(), stride);
+		inflated = m_inflatedChunks.emplace(name, std::move(chunk)).first;
+	}
+	data = inflated->second.data();
+	size = inflated->second.size();
+	return true;
+}
@@ -16,17 +16,28 @@ bool ClimateDescriptor::OnInspect(const std::shared_ptr<EditorLayer>& editorLaye
 		const auto climate = scene->GetOrSetPrivateComponent<Climate>(climateEntity).lock();
 		climate->m_climateDescriptor = ProjectManager::GetAsset(GetHandle());
 	}
+	FileUtils::OpenFile("Import forcing CSV", "CSV", { ".csv" }, [&](const std::filesystem::path& path) {
+		if (m_climateParameters.m_forcing.ImportCSV(path)) changed = true;
+		}, false);
+	if (ImGui::TreeNode("Forcing")) {
+		m_climateParameters.m_forcing.OnInspect();
+		if (ImGui::Button("Clear forcing")) {
+			m_climateParameters.m_forcing.Clear();
+			changed = true;
+		}
+		ImGui::TreePop();
+	}
 	return changed;
 }
 
 void ClimateDescriptor::Serialize(YAML::Emitter& out) const
 {
-	
+	m_climateParameters.m_forcing.Serialize("m_forcing", out);
 }
 
 void ClimateDescriptor::Deserialize(const YAML::Node& in)
 {
-	
+	m_climateParameters.m_forcing.Deserialize("m_forcing", in);
 }
 
 bool Climate::OnInspect(const std::shared_ptr<EditorLayer>& editorLayer)
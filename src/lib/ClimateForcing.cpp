@@ -0,0 +1,320 @@
+#include "ClimateForcing.hpp"
+
+using namespace EcoSysLab;
+
+void ClimateTimeSeries::Resample(const std::vector<float>& times, const std::vector<float>& values, float timeStep, const size_t maxSampleSize)
+{
+	m_values.clear();
+	m_startTime = 0.0f;
+	m_timeStep = m_inverseTimeStep = 1.0f;
+	const auto size = glm::min(times.size(), values.size());
+	if (size == 0) return;
+	m_startTime = times.front();
+	const float endTime = times[size - 1];
+	if (timeStep <= 0.0f)
+	{
+		timeStep = FLT_MAX;
+		for (size_t i = 1; i < size; i++)
+		{
+			const float gap = times[i] - times[i - 1];
+			if (gap > 0.0f) timeStep = glm::min(timeStep, gap);
+		}
+		if (timeStep == FLT_MAX) timeStep = 1.0f;
+	}
+	//The step is shrunk so that a whole number of steps spans the duration, the last sample then lands on the end time.
+	const float duration = endTime - m_startTime;
+	const auto maxIntervalCount = static_cast<double>(glm::max(maxSampleSize, static_cast<size_t>(2)) - 1);
+	const auto intervalCount = duration > 0.0f
+		? static_cast<size_t>(glm::clamp(std::ceil(static_cast<double>(duration) / timeStep - 1e-4), 1.0, maxIntervalCount))
+		: static_cast<size_t>(0);
+	if (intervalCount > 0) timeStep = duration / static_cast<float>(intervalCount);
+	m_timeStep = timeStep;
+	m_inverseTimeStep = 1.0f / timeStep;
+	const auto sampleSize = intervalCount + 1;
+	m_values.resize(sampleSize);
+	//Both sequences are ordered, so the source cursor only moves forward.
+	size_t cursor = 0;
+	for (size_t i = 0; i < sampleSize; i++)
+	{
+		const float time = i == intervalCount ? endTime : glm::min(endTime, m_startTime + static_cast<float>(i) * timeStep);
+		while (cursor + 1 < size && times[cursor + 1] <= time) cursor++;
+		if (cursor + 1 >= size)
+		{
+			m_values[i] = values[size - 1];
+			continue;
+		}
+		const float gap = times[cursor + 1] - times[cursor];
+		const float a = gap > 0.0f ? (time - times[cursor]) / gap : 1.0f;
+		m_values[i] = glm::mix(values[cursor], values[cursor + 1], a);
+	}
+}
+
+void ClimateTimeSeries::Set(const float startTime, const float timeStep, const std::vector<float>& values)
+{
+	m_startTime = startTime;
+	m_timeStep = timeStep > 0.0f ? timeStep : 1.0f;
+	m_inverseTimeStep = 1.0f / m_timeStep;
+	m_values = values;
+}
+
+void ClimateTimeSeries::UnwrapDegrees(std::vector<float>& values)
+{
+	float offset = 0.0f;
+	for (size_t i = 1; i < values.size(); i++)
+	{
+		const float previous = values[i - 1];
+		float current = values[i] + offset;
+		while (current - previous > 180.0f) { current -= 360.0f; offset -= 360.0f; }
+		while (current - previous < -180.0f) { current += 360.0f; offset += 360.0f; }
+		values[i] = current;
+	}
+}
+
+float ClimateTimeSeries::Sample(const float time) const
+{
+	if (m_values.empty()) return 0.0f;
+	const float position = (time - m_startTime) * m_inverseTimeStep;
+	if (position <= 0.0f) return m_values.front();
+	const auto lastIndex = m_values.size() - 1;
+	if (position >= static_cast<float>(lastIndex)) return m_values.back();
+	const auto index = static_cast<size_t>(position);
+	const float a = position - static_cast<float>(index);
+	return m_values[index] + (m_values[index + 1] - m_values[index]) * a;
+}
+
+void ClimateTimeSeries::Sample(const float* times, float* results, const size_t size) const
+{
+	if (m_values.size() < 2)
+	{
+		const float value = m_values.empty() ? 0.0f : m_values.front();
+		for (size_t i = 0; i < size; i++) results[i] = value;
+		return;
+	}
+	const float* values = m_values.data();
+	const float lastPosition = static_cast<float>(m_values.size() - 1);
+	const int lastSegment = static_cast<int>(m_values.size()) - 2;
+	const float startTime = m_startTime;
+	const float inverseTimeStep = m_inverseTimeStep;
+	for (size_t i = 0; i < size; i++)
+	{
+		const float position = glm::clamp((times[i] - startTime) * inverseTimeStep, 0.0f, lastPosition);
+		const int index = glm::min(static_cast<int>(position), lastSegment);
+		const float a = position - static_cast<float>(index);
+		results[i] = values[index] + (values[index + 1] - values[index]) * a;
+	}
+}
+
+float ClimateTimeSeries::GetStartTime() const
+{
+	return m_startTime;
+}
+
+float ClimateTimeSeries::GetEndTime() const
+{
+	if (m_values.empty()) return m_startTime;
+	return m_startTime + static_cast<float>(m_values.size() - 1) * m_timeStep;
+}
+
+float ClimateTimeSeries::GetTimeStep() const
+{
+	return m_timeStep;
+}
+
+const std::vector<float>& ClimateTimeSeries::PeekValues() const
+{
+	return m_values;
+}
+
+bool ClimateTimeSeries::Empty() const
+{
+	return m_values.empty();
+}
+
+bool ClimateForcing::ReadCSV(const std::filesystem::path& path, std::vector<std::string>& columnNames, std::vector<std::vector<float>>& columns)
+{
+	columnNames.clear();
+	columns.clear();
+	std::ifstream file(path);
+	if (!file.is_open())
+	{
+		EVOENGINE_ERROR("Can't open file " + path.string());
+		return false;
+	}
+	std::string line;
+	if (!std::getline(file, line))
+	{
+		EVOENGINE_ERROR("Missing header in " + path.string());
+		return false;
+	}
+	{
+		std::stringstream header(line);
+		std::string name;
+		while (std::getline(header, name, ','))
+		{
+			const auto first = name.find_first_not_of(" \t\r\"");
+			const auto last = name.find_last_not_of(" \t\r\"");
+			columnNames.emplace_back(first == std::string::npos ? std::string() : name.substr(first, last - first + 1));
+		}
+	}
+	if (columnNames.empty())
+	{
+		EVOENGINE_ERROR("Missing header in " + path.string());
+		return false;
+	}
+	columns.resize(columnNames.size());
+	while (std::getline(file, line))
+	{
+		if (line.empty() || line == "\r") continue;
+		//Fields are parsed in place, no per field strings are created.
+		const char* cursor = line.c_str();
+		for (size_t columnIndex = 0; columnIndex < columns.size(); columnIndex++)
+		{
+			char* end = nullptr;
+			float value = std::strtof(cursor, &end);
+			if (end == cursor) value = std::numeric_limits<float>::quiet_NaN();
+			columns[columnIndex].emplace_back(value);
+			cursor = std::strchr(end, ',');
+			if (!cursor)
+			{
+				for (size_t i = columnIndex + 1; i < columns.size(); i++) columns[i].emplace_back(std::numeric_limits<float>::quiet_NaN());
+				break;
+			}
+			cursor++;
+		}
+	}
+	return true;
+}
+
+bool ClimateForcing::ImportCSV(const std::filesystem::path& path, const std::string& timeColumnName, const float timeStep)
+{
+	std::vector<std::string> columnNames;
+	std::vector<std::vector<float>> columns;
+	if (!ReadCSV(path, columnNames, columns)) return false;
+	const auto timeColumn = std::find(columnNames.begin(), columnNames.end(), timeColumnName);
+	if (timeColumn == columnNames.end())
+	{
+		EVOENGINE_ERROR("Missing column " + timeColumnName + " in " + path.string());
+		return false;
+	}
+	const auto& times = columns[timeColumn - columnNames.begin()];
+	std::vector<size_t> order(times.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](const size_t a, const size_t b) { return times[a] < times[b]; });
+
+	Clear();
+	std::vector<float> sortedTimes;
+	std::vector<float> sortedValues;
+	for (size_t columnIndex = 0; columnIndex < columns.size(); columnIndex++)
+	{
+		if (columnIndex == static_cast<size_t>(timeColumn - columnNames.begin())) continue;
+		sortedTimes.clear();
+		sortedValues.clear();
+		for (const auto rowIndex : order)
+		{
+			if (std::isnan(times[rowIndex]) || std::isnan(columns[columnIndex][rowIndex])) continue;
+			sortedTimes.emplace_back(times[rowIndex]);
+			sortedValues.emplace_back(columns[columnIndex][rowIndex]);
+		}
+		if (sortedTimes.empty()) continue;
+		SetVariable(columnNames[columnIndex], sortedTimes, sortedValues, timeStep);
+	}
+	return true;
+}
+
+int ClimateForcing::SetVariable(const std::string& name, const std::vector<float>& times, const std::vector<float>& values, const float timeStep)
+{
+	auto variableIndex = GetVariableIndex(name);
+	if (variableIndex == -1)
+	{
+		variableIndex = static_cast<int>(m_variables.size());
+		m_variableNames.emplace_back(name);
+		m_variables.emplace_back();
+	}
+	m_variables[variableIndex].Resample(times, values, timeStep);
+	return variableIndex;
+}
+
+void ClimateForcing::Clear()
+{
+	m_variableNames.clear();
+	m_variables.clear();
+}
+
+int ClimateForcing::GetVariableIndex(const std::string& name) const
+{
+	for (int i = 0; i < m_variableNames.size(); i++)
+	{
+		if (m_variableNames[i] == name) return i;
+	}
+	return -1;
+}
+
+const std::vector<std::string>& ClimateForcing::GetVariableNames() const
+{
+	return m_variableNames;
+}
+
+const ClimateTimeSeries& ClimateForcing::PeekVariable(const int variableIndex) const
+{
+	return m_variables[variableIndex];
+}
+
+float ClimateForcing::Sample(const int variableIndex, const float time) const
+{
+	return m_variables[variableIndex].Sample(time);
+}
+
+void ClimateForcing::Sample(const int variableIndex, const std::vector<float>& times, std::vector<float>& results) const
+{
+	results.resize(times.size());
+	m_variables[variableIndex].Sample(times.data(), results.data(), times.size());
+}
+
+bool ClimateForcing::Empty() const
+{
+	return m_variables.empty();
+}
+
+void ClimateForcing::Serialize(const std::string& name, YAML::Emitter& out) const
+{
+	out << YAML::Key << name << YAML::Value << YAML::BeginSeq;
+	for (int i = 0; i < m_variables.size(); i++)
+	{
+		const auto& values = m_variables[i].PeekValues();
+		out << YAML::BeginMap;
+		out << YAML::Key << "m_name" << YAML::Value << m_variableNames[i];
+		out << YAML::Key << "m_startTime" << YAML::Value << m_variables[i].GetStartTime();
+		out << YAML::Key << "m_timeStep" << YAML::Value << m_variables[i].GetTimeStep();
+		out << YAML::Key << "m_values" << YAML::Value << YAML::Binary(
+			reinterpret_cast<const unsigned char*>(values.data()), values.size() * sizeof(float));
+		out << YAML::EndMap;
+	}
+	out << YAML::EndSeq;
+}
+
+void ClimateForcing::Deserialize(const std::string& name, const YAML::Node& in)
+{
+	if (!in[name]) return;
+	Clear();
+	for (const auto& inVariable : in[name])
+	{
+		if (!inVariable["m_name"] || !inVariable["m_values"]) continue;
+		const auto inValues = inVariable["m_values"].as<YAML::Binary>();
+		std::vector<float> values(inValues.size() / sizeof(float));
+		std::memcpy(values.data(), inValues.data(), values.size() * sizeof(float));
+		m_variableNames.emplace_back(inVariable["m_name"].as<std::string>());
+		m_variables.emplace_back();
+		m_variables.back().Set(inVariable["m_startTime"] ? inVariable["m_startTime"].as<float>() : 0.0f,
+			inVariable["m_timeStep"] ? inVariable["m_timeStep"].as<float>() : 1.0f, values);
+	}
+}
+
+void ClimateForcing::OnInspect()
+{
+	for (int i = 0; i < m_variables.size(); i++)
+	{
+		const auto& variable = m_variables[i];
+		ImGui::Text("%s: [%.2f, %.2f], step %.4f, %d samples", m_variableNames[i].c_str(), variable.GetStartTime(), variable.GetEndTime(),
+			variable.GetTimeStep(), static_cast<int>(variable.PeekValues().size()));
+	}
+}
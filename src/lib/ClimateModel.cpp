@@ -6,6 +6,7 @@ using namespace EcoSysLab;
 
 float ClimateModel::GetTemperature(const glm::vec3& position) const
 {
+	if (m_temperatureIndex != -1) return m_forcing.Sample(m_temperatureIndex, m_time * 365.0f);
 	int month = static_cast<int>(m_time * 365) / 30 % 12;
 	int days = static_cast<int>(m_time * 365) % 30;
 	
@@ -27,6 +28,12 @@ float ClimateModel::GetTemperature(const glm::vec3& position) const
 	return avgTemp;
 }
 
+float ClimateModel::GetPrecipitation(const glm::vec3& position) const
+{
+	if (m_precipitationIndex != -1) return m_forcing.Sample(m_precipitationIndex, m_time * 365.0f);
+	return 0.0f;
+}
+
 float ClimateModel::GetEnvironmentalLight(const glm::vec3& position, glm::vec3& lightDirection) const
 {
 	return m_environmentGrid.Sample(position, lightDirection);
@@ -35,4 +42,17 @@ float ClimateModel::GetEnvironmentalLight(const glm::vec3& position, glm::vec3&
 void ClimateModel::Initialize(const ClimateParameters& climateParameters)
 {
 	m_time = 0;
+	SetForcing(climateParameters.m_forcing);
+}
+
+void ClimateModel::SetForcing(const ClimateForcing& forcing)
+{
+	m_forcing = forcing;
+	m_temperatureIndex = m_forcing.GetVariableIndex("Temperature");
+	m_precipitationIndex = m_forcing.GetVariableIndex("Precipitation");
+}
+
+const ClimateForcing& ClimateModel::PeekForcing() const
+{
+	return m_forcing;
 }
@@ -17,6 +17,7 @@
 #include "RenderLayer.hpp" 
 #include "TreeStructor.hpp"
 #include "TreePointCloudScanner.hpp"
+#include "MeshExporter.hpp"
 #include "ClassRegistry.hpp"
 #include "CubeVolume.hpp"
 #include "FlowerDescriptor.hpp"
@@ -893,7 +894,7 @@ void EcoSysLabLayer::OnInspect(const std::shared_ptr<EditorLayer>& editorLayer)
 				
 				ImGui::TreePop();
 			}
-			FileUtils::SaveFile("Export all trees as OBJ", "OBJ", { ".obj" }, [&](const std::filesystem::path& path) {
+			FileUtils::SaveFile("Export all trees as OBJ", "OBJ", { ".obj", ".ply", ".glb" }, [&](const std::filesystem::path& path) {
 				ExportAllTrees(path);
 				}, false);
 			if (ImGui::TreeNodeEx("Stats")) {
@@ -1606,129 +1607,35 @@ void EcoSysLabLayer::ExportAllTrees(const std::filesystem::path& path) const
 	const auto scene = GetScene();
 	const std::vector<Entity>* treeEntities =
 		scene->UnsafeGetPrivateComponentOwnersList<Tree>();
-	if (treeEntities && !treeEntities->empty())
+	if (treeEntities && !treeEntities->empty() && MeshExporter::IsSupported(path))
 	{
-		if (path.extension() == ".obj") {
-			std::ofstream of;
-			of.open(path.string(), std::ofstream::out | std::ofstream::trunc);
-			if (of.is_open()) {
-				std::string start = "#Forest OBJ exporter, by Bosheng Li";
-				start += "\n";
-				of.write(start.c_str(), start.size());
-				of.flush();
-				unsigned startIndex = 1;
-				if (m_meshGeneratorSettings.m_enableBranch) {
-					unsigned treeIndex = 0;
-					for (const auto& entity : *treeEntities) {
-						const auto tree = scene->GetOrSetPrivateComponent<Tree>(entity).lock();
-						const auto mesh = tree->GenerateBranchMesh(m_meshGeneratorSettings);
-						auto& vertices = mesh->UnsafeGetVertices();
-						auto& triangles = mesh->UnsafeGetTriangles();
-						const auto gt = scene->GetDataComponent<GlobalTransform>(entity);
-						if (!vertices.empty() && !triangles.empty()) {
-							std::string header =
-								"#Vertices: " + std::to_string(vertices.size()) +
-								", tris: " + std::to_string(triangles.size());
-							header += "\n";
-							of.write(header.c_str(), header.size());
-							of.flush();
-							std::stringstream data;
-							data << "o branch " + std::to_string(treeIndex) + "\n";
-#pragma region Data collection
-							for (auto i = 0; i < vertices.size(); i++) {
-								auto vertexPosition = glm::vec4(vertices.at(i).m_position, 1.0f);
-								vertexPosition = gt.m_value * vertexPosition;
-								auto& color = vertices.at(i).m_color;
-								data << "v " + std::to_string(vertexPosition.x) + " " +
-									std::to_string(vertexPosition.y) + " " +
-									std::to_string(vertexPosition.z) + " " +
-									std::to_string(color.x) + " " + std::to_string(color.y) + " " +
-									std::to_string(color.z) + "\n";
-							}
-							for (const auto& vertex : vertices) {
-								data << "vt " + std::to_string(vertex.m_texCoord.x) + " " +
-									std::to_string(vertex.m_texCoord.y) + "\n";
-							}
-							// data += "s off\n";
-							data << "# List of indices for faces vertices, with (x, y, z).\n";
-							for (auto i = 0; i < triangles.size(); i++) {
-								const auto triangle = triangles[i];
-								const auto f1 = triangle.x + startIndex;
-								const auto f2 = triangle.y + startIndex;
-								const auto f3 = triangle.z + startIndex;
-								data << "f " + std::to_string(f1) + "/" + std::to_string(f1) + "/" +
-									std::to_string(f1) + " " + std::to_string(f2) + "/" +
-									std::to_string(f2) + "/" + std::to_string(f2) + " " +
-									std::to_string(f3) + "/" + std::to_string(f3) + "/" +
-									std::to_string(f3) + "\n";
-							}
-#pragma endregion
-							const auto result = data.str();
-							of.write(result.c_str(), result.size());
-							of.flush();
-							startIndex += vertices.size();
-						}
-						treeIndex++;
-					}
-				}
-				if (m_meshGeneratorSettings.m_enableFoliage) {
-					unsigned treeIndex = 0;
-					for (const auto& entity : *treeEntities) {
-						const auto tree = scene->GetOrSetPrivateComponent<Tree>(entity).lock();
-						const auto mesh = tree->GenerateFoliageMesh(m_meshGeneratorSettings);
-						auto& vertices = mesh->UnsafeGetVertices();
-						auto& triangles = mesh->UnsafeGetTriangles();
-						const auto gt = scene->GetDataComponent<GlobalTransform>(entity);
-						if (!vertices.empty() && !triangles.empty()) {
-							std::string header =
-								"#Vertices: " + std::to_string(vertices.size()) +
-								", tris: " + std::to_string(triangles.size());
-							header += "\n";
-							of.write(header.c_str(), header.size());
-							of.flush();
-							std::stringstream data;
-							data << "o foliage " + std::to_string(treeIndex) + "\n";
-#pragma region Data collection
-							for (auto i = 0; i < vertices.size(); i++) {
-								auto vertexPosition = glm::vec4(vertices.at(i).m_position, 1.0f);
-								vertexPosition = gt.m_value * vertexPosition;
-								auto& color = vertices.at(i).m_color;
-								data << "v " + std::to_string(vertexPosition.x) + " " +
-									std::to_string(vertexPosition.y) + " " +
-									std::to_string(vertexPosition.z) + " " +
-									std::to_string(color.x) + " " + std::to_string(color.y) + " " +
-									std::to_string(color.z) + "\n";
-							}
-							for (const auto& vertex : vertices) {
-								data << "vt " + std::to_string(vertex.m_texCoord.x) + " " +
-									std::to_string(vertex.m_texCoord.y) + "\n";
-							}
-							// data += "s off\n";
-							data << "# List of indices for faces vertices, with (x, y, z).\n";
-							for (auto i = 0; i < triangles.size(); i++) {
-								const auto triangle = triangles[i];
-								const auto f1 = triangle.x + startIndex;
-								const auto f2 = triangle.y + startIndex;
-								const auto f3 = triangle.z + startIndex;
-								data << "f " + std::to_string(f1) + "/" + std::to_string(f1) + "/" +
-									std::to_string(f1) + " " + std::to_string(f2) + "/" +
-									std::to_string(f2) + "/" + std::to_string(f2) + " " +
-									std::to_string(f3) + "/" + std::to_string(f3) + "/" +
-									std::to_string(f3) + "\n";
-							}
-#pragma endregion
-							const auto result = data.str();
-							of.write(result.c_str(), result.size());
-							of.flush();
-							startIndex += vertices.size();
-
-						}
-						treeIndex++;
-					}
+		//Meshes are generated tree by tree since the mesh generators schedule their own jobs, the exporter then formats the trees in parallel.
+		std::vector<std::shared_ptr<Mesh>> meshes;
+		std::vector<MeshExportChunk> chunks;
+		const auto addChunks = [&](const std::string& prefix, const std::function<std::shared_ptr<Mesh>(const std::shared_ptr<Tree>&)>& generate)
+			{
+				unsigned treeIndex = 0;
+				for (const auto& entity : *treeEntities) {
+					const auto tree = scene->GetOrSetPrivateComponent<Tree>(entity).lock();
+					const auto mesh = generate(tree);
+					meshes.emplace_back(mesh);
+					MeshExportChunk chunk;
+					chunk.m_name = prefix + std::to_string(treeIndex);
+					chunk.m_vertices = &mesh->UnsafeGetVertices();
+					chunk.m_triangles = &mesh->UnsafeGetTriangles();
+					chunk.m_transformed = true;
+					chunk.m_transform = scene->GetDataComponent<GlobalTransform>(entity).m_value;
+					chunks.emplace_back(std::move(chunk));
+					treeIndex++;
 				}
-				of.close();
-			}
+			};
+		if (m_meshGeneratorSettings.m_enableBranch) {
+			addChunks("branch ", [&](const std::shared_ptr<Tree>& tree) { return tree->GenerateBranchMesh(m_meshGeneratorSettings); });
+		}
+		if (m_meshGeneratorSettings.m_enableFoliage) {
+			addChunks("foliage ", [&](const std::shared_ptr<Tree>& tree) { return tree->GenerateFoliageMesh(m_meshGeneratorSettings); });
 		}
+		MeshExporter::Export(path, chunks);
 	}
 }
 
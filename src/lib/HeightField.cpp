@@ -4,7 +4,7 @@
 
 using namespace EcoSysLab;
 
-float HeightField::GetValue(const glm::vec2& position)
+float HeightField::GetValue(const glm::vec2& position) const
 {
 	float retVal = 0.0f;
 	if (position.x < 0)
@@ -15,6 +15,11 @@ float HeightField::GetValue(const glm::vec2& position)
 	return retVal;
 }
 
+void HeightField::GetValues(const std::vector<glm::vec2>& positions, std::vector<float>& values) const
+{
+	m_noises2D.GetValues(positions, values);
+}
+
 void HeightField::RandomOffset(const float min, const float max)
 {
 	m_noises2D.RandomOffset(min, max);
@@ -41,28 +46,281 @@ void HeightField::Deserialize(const YAML::Node& in)
 	m_noises2D.Load("m_noises2D", in);
 }
 
-void HeightField::GenerateMesh(const glm::vec2& start, const glm::uvec2& resolution, float unitSize, std::vector<Vertex>& vertices, std::vector<glm::uvec3>& triangles, float xDepth, float zDepth)
+void HeightField::GenerateMesh(const glm::vec2& start, const glm::uvec2& resolution, float unitSize, std::vector<Vertex>& vertices, std::vector<glm::uvec3>& triangles, float xDepth, float zDepth) const
 {
-	for (unsigned i = 0; i < resolution.x * m_precisionLevel; i++) {
-		for (unsigned j = 0; j < resolution.y * m_precisionLevel; j++) {
-			Vertex archetype;
-			archetype.m_position.x = start.x + unitSize * i / m_precisionLevel;
-			archetype.m_position.z = start.y + unitSize * j / m_precisionLevel;
-			archetype.m_position.y = GetValue({ archetype.m_position.x , archetype.m_position.z });
-			archetype.m_texCoord = glm::vec2(static_cast<float>(i) / (resolution.x * m_precisionLevel),
-				static_cast<float>(j) / (resolution.y * m_precisionLevel));
-			vertices.push_back(archetype);
+	const unsigned xSize = resolution.x * m_precisionLevel;
+	const unsigned zSize = resolution.y * m_precisionLevel;
+	const auto vertexStart = vertices.size();
+	vertices.resize(vertexStart + xSize * zSize);
+	//Each row samples its heights in one batch, rows run in parallel.
+	Jobs::RunParallelFor(xSize, [&](unsigned i)
+		{
+			std::vector<glm::vec2> positions(zSize);
+			std::vector<float> heights;
+			for (unsigned j = 0; j < zSize; j++)
+			{
+				positions[j] = glm::vec2(start.x + unitSize * i / m_precisionLevel, start.y + unitSize * j / m_precisionLevel);
+			}
+			GetValues(positions, heights);
+			for (unsigned j = 0; j < zSize; j++) {
+				auto& vertex = vertices[vertexStart + i * zSize + j];
+				vertex = {};
+				vertex.m_position = glm::vec3(positions[j].x, heights[j], positions[j].y);
+				vertex.m_texCoord = glm::vec2(static_cast<float>(i) / (resolution.x * m_precisionLevel),
+					static_cast<float>(j) / (resolution.y * m_precisionLevel));
+			}
+		}
+	);
+	//Normals from central differences of the neighbouring vertices, one sided at the border.
+	Jobs::RunParallelFor(xSize, [&](unsigned i)
+		{
+			const auto previousRow = vertexStart + (i > 0 ? i - 1 : i) * zSize;
+			const auto nextRow = vertexStart + (i + 1 < xSize ? i + 1 : i) * zSize;
+			for (unsigned j = 0; j < zSize; j++) {
+				const auto previous = vertexStart + i * zSize + (j > 0 ? j - 1 : j);
+				const auto next = vertexStart + i * zSize + (j + 1 < zSize ? j + 1 : j);
+				const auto dx = vertices[nextRow + j].m_position - vertices[previousRow + j].m_position;
+				const auto dz = vertices[next].m_position - vertices[previous].m_position;
+				const auto normal = glm::cross(dz, dx);
+				vertices[vertexStart + i * zSize + j].m_normal = glm::length(normal) > 0.0f ? glm::normalize(normal) : glm::vec3(0, 1, 0);
+			}
+		}
+	);
+
+	if (xSize < 2 || zSize < 2) return;
+	const auto skip = [&](const int i, const int j)
+		{
+			return static_cast<float>(i) / (resolution.x * m_precisionLevel - 2) > (1.0 - zDepth) && static_cast<float>(j) / (resolution.y * m_precisionLevel - 2) < xDepth;
+		};
+	//Count the kept quads of each row first so that every row writes into its own range.
+	std::vector<size_t> rowTriangleOffsets(xSize);
+	Jobs::RunParallelFor(xSize - 1, [&](unsigned i)
+		{
+			size_t count = 0;
+			for (int j = 0; j < zSize - 1; j++) if (!skip(i, j)) count += 2;
+			rowTriangleOffsets[i + 1] = count;
+		}
+	);
+	for (unsigned i = 1; i < xSize; i++) rowTriangleOffsets[i] += rowTriangleOffsets[i - 1];
+	const auto triangleStart = triangles.size();
+	triangles.resize(triangleStart + rowTriangleOffsets.back());
+	Jobs::RunParallelFor(xSize - 1, [&](unsigned i)
+		{
+			auto triangleIndex = triangleStart + rowTriangleOffsets[i];
+			const int n = xSize;
+			const auto offset = static_cast<unsigned>(vertexStart);
+			for (int j = 0; j < zSize - 1; j++) {
+				if (skip(i, j)) continue;
+				triangles[triangleIndex] = glm::uvec3(offset + i + j * n, offset + i + 1 + j * n, offset + i + (j + 1) * n);
+				triangles[triangleIndex + 1] = glm::uvec3(offset + i + 1 + (j + 1) * n, offset + i + (j + 1) * n,
+					offset + i + 1 + j * n);
+				triangleIndex += 2;
+			}
+		}
+	);
+}
+
+void HeightField::GenerateTileMesh(const glm::vec2& tileStart, const float tileSize, unsigned segmentCount, const float skirtDepth,
+	const glm::vec2& uvStart, const glm::vec2& uvSize, std::vector<Vertex>& vertices, std::vector<glm::uvec3>& triangles) const
+{
+	segmentCount = glm::max(1u, segmentCount);
+	const float step = tileSize / static_cast<float>(segmentCount);
+	const unsigned rowSize = segmentCount + 1;
+	//One extra ring of samples around the tile for the normals at the border.
+	const unsigned sampleRowSize = segmentCount + 3;
+	std::vector<glm::vec2> positions(sampleRowSize * sampleRowSize);
+	for (unsigned z = 0; z < sampleRowSize; z++)
+	{
+		for (unsigned x = 0; x < sampleRowSize; x++)
+		{
+			positions[x + z * sampleRowSize] = tileStart + glm::vec2(static_cast<float>(x) - 1.0f, static_cast<float>(z) - 1.0f) * step;
 		}
 	}
+	std::vector<float> heights;
+	GetValues(positions, heights);
+	const auto height = [&](const unsigned x, const unsigned z) { return heights[x + z * sampleRowSize]; };
 
-	for (int i = 0; i < resolution.x * m_precisionLevel - 1; i++) {
-		for (int j = 0; j < resolution.y * m_precisionLevel - 1; j++) {
-			if (static_cast<float>(i) / (resolution.x * m_precisionLevel - 2) > (1.0 - zDepth) && static_cast<float>(j) / (resolution.y * m_precisionLevel - 2) < xDepth) continue;
-			const int n = resolution.x * m_precisionLevel;
-			triangles.emplace_back(i + j * n, i + 1 + j * n, i + (j + 1) * n);
-			triangles.emplace_back(i + 1 + (j + 1) * n, i + (j + 1) * n,
-				i + 1 + j * n);
+	const bool skirt = skirtDepth > 0.0f;
+	const auto vertexStart = vertices.size();
+	const auto triangleStart = triangles.size();
+	vertices.resize(vertexStart + rowSize * rowSize + (skirt ? 4 * rowSize : 0));
+	triangles.resize(triangleStart + 2 * segmentCount * segmentCount + (skirt ? 8 * segmentCount : 0));
+	for (unsigned z = 0; z < rowSize; z++)
+	{
+		for (unsigned x = 0; x < rowSize; x++)
+		{
+			const auto& position = positions[x + 1 + (z + 1) * sampleRowSize];
+			auto& vertex = vertices[vertexStart + x + z * rowSize];
+			vertex = {};
+			vertex.m_position = glm::vec3(position.x, height(x + 1, z + 1), position.y);
+			vertex.m_normal = glm::normalize(glm::vec3(height(x, z + 1) - height(x + 2, z + 1), 2.0f * step, height(x + 1, z) - height(x + 1, z + 2)));
+			vertex.m_texCoord = (position - uvStart) / uvSize;
+		}
+	}
+	auto triangleIndex = triangleStart;
+	const auto offset = static_cast<unsigned>(vertexStart);
+	for (unsigned z = 0; z < segmentCount; z++)
+	{
+		for (unsigned x = 0; x < segmentCount; x++)
+		{
+			const unsigned a = offset + x + z * rowSize;
+			triangles[triangleIndex] = glm::uvec3(a, a + rowSize, a + 1);
+			triangles[triangleIndex + 1] = glm::uvec3(a + 1, a + rowSize, a + rowSize + 1);
+			triangleIndex += 2;
+		}
+	}
+	if (!skirt) return;
+	//The four edges are walked counter clockwise seen from above so that the skirt faces outwards.
+	const auto edgeVertex = [&](const unsigned edge, const unsigned k)
+		{
+			switch (edge)
+			{
+			case 0: return k;
+			case 1: return segmentCount + k * rowSize;
+			case 2: return segmentCount - k + segmentCount * rowSize;
+			default: return (segmentCount - k) * rowSize;
+			}
+		};
+	const auto skirtStart = offset + rowSize * rowSize;
+	for (unsigned edge = 0; edge < 4; edge++)
+	{
+		for (unsigned k = 0; k < rowSize; k++)
+		{
+			auto& skirtVertex = vertices[skirtStart + edge * rowSize + k];
+			skirtVertex = vertices[offset + edgeVertex(edge, k)];
+			skirtVertex.m_position.y -= skirtDepth;
+		}
+		for (unsigned k = 0; k < segmentCount; k++)
+		{
+			const unsigned top = offset + edgeVertex(edge, k);
+			const unsigned nextTop = offset + edgeVertex(edge, k + 1);
+			const unsigned bottom = skirtStart + edge * rowSize + k;
+			triangles[triangleIndex] = glm::uvec3(top, nextTop, bottom);
+			triangles[triangleIndex + 1] = glm::uvec3(nextTop, bottom + 1, bottom);
+			triangleIndex += 2;
+		}
+	}
+}
+
+void HeightFieldTileGrid::Initialize(const glm::vec2& start, const glm::ivec2& tileCount, const float tileSize, const unsigned tileResolution)
+{
+	m_start = start;
+	m_tileCount = glm::max(tileCount, glm::ivec2(0));
+	m_tileSize = tileSize;
+	m_tileResolution = glm::max(1u, tileResolution);
+	m_tiles.clear();
+	m_tiles.resize(m_tileCount.x * m_tileCount.y);
+}
+
+void HeightFieldTileGrid::UpdateLod(const glm::vec3& viewPosition, const float lodDistance, const unsigned maxLod)
+{
+	const glm::vec2 viewPoint = glm::vec2(viewPosition.x, viewPosition.z);
+	for (int z = 0; z < m_tileCount.y; z++)
+	{
+		for (int x = 0; x < m_tileCount.x; x++)
+		{
+			const auto center = m_start + (glm::vec2(x, z) + 0.5f) * m_tileSize;
+			const auto lod = static_cast<unsigned>(glm::distance(viewPoint, center) / glm::max(lodDistance, FLT_EPSILON));
+			SetLod({ x, z }, glm::min(lod, maxLod));
 		}
 	}
 }
 
+void HeightFieldTileGrid::SetLod(const glm::ivec2& tileCoordinate, unsigned lod)
+{
+	//Stop once a tile is a single quad.
+	unsigned lodLimit = 0;
+	while ((m_tileResolution >> lodLimit) > 1) lodLimit++;
+	lod = glm::min(lod, lodLimit);
+	auto& tile = m_tiles[tileCoordinate.x + tileCoordinate.y * m_tileCount.x];
+	if (tile.m_lod == lod) return;
+	tile.m_lod = lod;
+	tile.m_dirty = true;
+}
+
+void HeightFieldTileGrid::MarkDirty(const glm::vec2& min, const glm::vec2& max)
+{
+	if (m_tiles.empty()) return;
+	const auto minCoordinate = GetTileCoordinate(min - m_tileSize);
+	const auto maxCoordinate = GetTileCoordinate(max + m_tileSize);
+	for (int z = minCoordinate.y; z <= maxCoordinate.y; z++)
+	{
+		for (int x = minCoordinate.x; x <= maxCoordinate.x; x++)
+		{
+			auto& tile = m_tiles[x + z * m_tileCount.x];
+			const float step = m_tileSize / static_cast<float>(glm::max(1u, m_tileResolution >> tile.m_lod));
+			const auto tileMin = m_start + glm::vec2(x, z) * m_tileSize - step;
+			const auto tileMax = tileMin + m_tileSize + 2.0f * step;
+			if (tileMin.x > max.x || tileMin.y > max.y || tileMax.x < min.x || tileMax.y < min.y) continue;
+			tile.m_dirty = true;
+		}
+	}
+}
+
+void HeightFieldTileGrid::MarkAllDirty()
+{
+	for (auto& tile : m_tiles) tile.m_dirty = true;
+}
+
+size_t HeightFieldTileGrid::Update(const HeightField& heightField)
+{
+	std::vector<int> dirtyTileIndices;
+	for (int tileIndex = 0; tileIndex < m_tiles.size(); tileIndex++)
+	{
+		if (m_tiles[tileIndex].m_dirty) dirtyTileIndices.emplace_back(tileIndex);
+	}
+	const auto uvSize = glm::vec2(m_tileCount) * m_tileSize;
+	Jobs::RunParallelFor(dirtyTileIndices.size(), [&](unsigned i)
+		{
+			const auto tileIndex = dirtyTileIndices[i];
+			auto& tile = m_tiles[tileIndex];
+			const glm::ivec2 tileCoordinate = { tileIndex % m_tileCount.x, tileIndex / m_tileCount.x };
+			tile.m_vertices.clear();
+			tile.m_triangles.clear();
+			heightField.GenerateTileMesh(m_start + glm::vec2(tileCoordinate) * m_tileSize, m_tileSize, m_tileResolution >> tile.m_lod, m_skirtDepth,
+				m_start, uvSize, tile.m_vertices, tile.m_triangles);
+			tile.m_dirty = false;
+		}
+	);
+	return dirtyTileIndices.size();
+}
+
+glm::ivec2 HeightFieldTileGrid::GetTileCount() const
+{
+	return m_tileCount;
+}
+
+glm::ivec2 HeightFieldTileGrid::GetTileCoordinate(const glm::vec2& position) const
+{
+	const auto coordinate = glm::ivec2(glm::floor((position - m_start) / m_tileSize));
+	return glm::clamp(coordinate, glm::ivec2(0), glm::max(m_tileCount - 1, glm::ivec2(0)));
+}
+
+const HeightFieldTile& HeightFieldTileGrid::PeekTile(const glm::ivec2& tileCoordinate) const
+{
+	return m_tiles[tileCoordinate.x + tileCoordinate.y * m_tileCount.x];
+}
+
+const std::vector<HeightFieldTile>& HeightFieldTileGrid::PeekTiles() const
+{
+	return m_tiles;
+}
+
+void HeightFieldTileGrid::GetMesh(std::vector<Vertex>& vertices, std::vector<glm::uvec3>& triangles) const
+{
+	size_t vertexSize = vertices.size();
+	size_t triangleSize = triangles.size();
+	for (const auto& tile : m_tiles)
+	{
+		vertexSize += tile.m_vertices.size();
+		triangleSize += tile.m_triangles.size();
+	}
+	vertices.reserve(vertexSize);
+	triangles.reserve(triangleSize);
+	for (const auto& tile : m_tiles)
+	{
+		const auto offset = glm::uvec3(static_cast<unsigned>(vertices.size()));
+		vertices.insert(vertices.end(), tile.m_vertices.begin(), tile.m_vertices.end());
+		for (const auto& triangle : tile.m_triangles) triangles.emplace_back(triangle + offset);
+	}
+}
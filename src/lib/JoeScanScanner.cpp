@@ -116,6 +116,266 @@ void logger(const jsError err, const std::string msg)
 	}
 }
 
+void JoeScanFrame::Reserve(const size_t maxPointCount)
+{
+	m_points.resize(maxPointCount);
+	m_brightness.resize(maxPointCount);
+	Clear();
+}
+
+void JoeScanFrame::Clear()
+{
+	m_hasEncoderValue = false;
+	m_encoderValue = 0.f;
+	m_pointCount = 0;
+}
+
+bool JoeScanFrame::PushPoint(const glm::vec2& point, const int brightness)
+{
+	if (m_pointCount >= m_points.size()) return false;
+	m_points[m_pointCount] = point;
+	m_brightness[m_pointCount] = brightness;
+	m_pointCount++;
+	return true;
+}
+
+void JoeScanFrameRing::Allocate(const size_t frameCount, const size_t maxPointCount)
+{
+	m_frames.resize(glm::max(frameCount, static_cast<size_t>(2)));
+	for (auto& frame : m_frames) frame.Reserve(maxPointCount);
+	Reset();
+}
+
+void JoeScanFrameRing::Reset()
+{
+	m_head.store(0);
+	m_tail.store(0);
+	m_droppedFrameCount.store(0);
+}
+
+JoeScanFrame* JoeScanFrameRing::BeginWrite()
+{
+	if (m_frames.empty()) return nullptr;
+	const auto head = m_head.load(std::memory_order_relaxed);
+	const auto tail = m_tail.load(std::memory_order_acquire);
+	if (head - tail >= m_frames.size()) return nullptr;
+	return &m_frames[head % m_frames.size()];
+}
+
+void JoeScanFrameRing::EndWrite()
+{
+	m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+const JoeScanFrame* JoeScanFrameRing::BeginRead()
+{
+	if (m_frames.empty()) return nullptr;
+	const auto tail = m_tail.load(std::memory_order_relaxed);
+	const auto head = m_head.load(std::memory_order_acquire);
+	if (tail == head) return nullptr;
+	return &m_frames[tail % m_frames.size()];
+}
+
+void JoeScanFrameRing::EndRead()
+{
+	m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void JoeScanFrameRing::DropFrame()
+{
+	m_droppedFrameCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+size_t JoeScanFrameRing::GetDroppedFrameCount() const
+{
+	return m_droppedFrameCount.load();
+}
+
+size_t JoeScanFrameRing::GetCapacity() const
+{
+	return m_frames.size();
+}
+
+size_t JoeScanFrameRing::GetProducedFrameCount() const
+{
+	return m_head.load();
+}
+
+void JoeScanProfilePool::Allocate(const size_t profileCount, const size_t maxPointCount)
+{
+	m_maxPointCount = maxPointCount;
+	if (m_profiles.size() < profileCount) m_profiles.resize(profileCount);
+	for (auto& profile : m_profiles)
+	{
+		profile.m_points.reserve(maxPointCount);
+		profile.m_brightness.reserve(maxPointCount);
+	}
+	m_binProfileIndices.reserve(profileCount);
+	Clear();
+}
+
+void JoeScanProfilePool::Clear()
+{
+	m_profileCount = 0;
+	m_binProfileIndices.clear();
+	m_firstBin = 0;
+}
+
+JoeScanProfile& JoeScanProfilePool::Acquire(const int bin)
+{
+	if (m_binProfileIndices.empty()) m_firstBin = bin;
+	//Encoder values usually move in one direction, so the table grows at the back within the reserved capacity.
+	if (bin < m_firstBin)
+	{
+		m_binProfileIndices.insert(m_binProfileIndices.begin(), m_firstBin - bin, -1);
+		m_firstBin = bin;
+	}
+	const auto binIndex = static_cast<size_t>(bin - m_firstBin);
+	if (binIndex >= m_binProfileIndices.size()) m_binProfileIndices.resize(binIndex + 1, -1);
+	auto& profileIndex = m_binProfileIndices[binIndex];
+	if (profileIndex == -1)
+	{
+		if (m_profileCount == m_profiles.size())
+		{
+			m_profiles.emplace_back();
+			m_profiles.back().m_points.reserve(m_maxPointCount);
+			m_profiles.back().m_brightness.reserve(m_maxPointCount);
+		}
+		profileIndex = static_cast<int>(m_profileCount);
+		m_profileCount++;
+	}
+	return m_profiles[profileIndex];
+}
+
+void JoeScanProfilePool::CopyProfiles(std::vector<JoeScanProfile>& profiles) const
+{
+	profiles.reserve(profiles.size() + m_profileCount);
+	for (const auto profileIndex : m_binProfileIndices)
+	{
+		if (profileIndex != -1) profiles.emplace_back(m_profiles[profileIndex]);
+	}
+}
+
+size_t JoeScanFrameRing::GetConsumedFrameCount() const
+{
+	return m_tail.load();
+}
+
+JoeScanHeadSource::JoeScanHeadSource(const jsScanSystem scanSystem)
+{
+	m_scanSystem = scanSystem;
+	m_profiles.resize(glm::max(0, jsScanSystemGetProfilesPerFrame(m_scanSystem)));
+}
+
+size_t JoeScanHeadSource::GetMaxPointCount() const
+{
+	return m_profiles.size() * JS_PROFILE_DATA_LEN;
+}
+
+bool JoeScanHeadSource::IsRealTime() const
+{
+	return true;
+}
+
+int JoeScanHeadSource::ReadFrame(JoeScanFrame& frame)
+{
+	const int scanResult = jsScanSystemWaitUntilFrameAvailable(m_scanSystem, 1000);
+	if (0 == scanResult) {
+		return 0;
+	}
+	if (0 > scanResult) {
+		EVOENGINE_ERROR("Failed to wait for frame.");
+		return scanResult;
+	}
+	const int getFrameResult = jsScanSystemGetFrame(m_scanSystem, m_profiles.data());
+	if (0 >= getFrameResult) {
+		EVOENGINE_ERROR("Failed to read frame.");
+		return -1;
+	}
+	frame.Clear();
+	size_t validCount = 0;
+	for (const auto& profile : m_profiles) {
+		if (jsRawProfileIsValid(profile))
+		{
+			bool containRealData = false;
+			for (const auto& point : profile.data)
+			{
+				if (point.x != 0 || point.y != 0)
+				{
+					containRealData = true;
+					frame.PushPoint(glm::vec2(point.x, point.y), point.brightness);
+				}
+			}
+			if (containRealData) validCount++;
+		}
+		if (validCount != 0 && !frame.m_hasEncoderValue) {
+			frame.m_hasEncoderValue = true;
+			frame.m_encoderValue = profile.encoder_values[0];
+		}
+	}
+	return 1;
+}
+
+JoeScanReplaySource::JoeScanReplaySource(const std::vector<JoeScanProfile>& profiles, const float lineRate, const bool loop)
+{
+	m_profiles = profiles;
+	m_lineRate = lineRate;
+	m_loop = loop;
+	for (const auto& profile : m_profiles) m_maxPointCount = glm::max(m_maxPointCount, profile.m_points.size());
+}
+
+size_t JoeScanReplaySource::GetMaxPointCount() const
+{
+	return m_maxPointCount;
+}
+
+bool JoeScanReplaySource::IsRealTime() const
+{
+	return m_lineRate > 0.f;
+}
+
+int JoeScanReplaySource::ReadFrame(JoeScanFrame& frame)
+{
+	if (m_nextProfileIndex >= m_profiles.size())
+	{
+		if (!m_loop || m_profiles.empty()) return -1;
+		m_nextProfileIndex = 0;
+	}
+	if (m_lineRate > 0.f)
+	{
+		const auto now = std::chrono::steady_clock::now();
+		if (!m_started)
+		{
+			m_started = true;
+			m_nextFrameTime = now;
+		}
+		std::this_thread::sleep_until(m_nextFrameTime);
+		m_nextFrameTime += std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / m_lineRate));
+	}
+	const auto& profile = m_profiles[m_nextProfileIndex];
+	m_nextProfileIndex++;
+	frame.Clear();
+	for (size_t i = 0; i < profile.m_points.size(); i++)
+	{
+		frame.PushPoint(profile.m_points[i], i < profile.m_brightness.size() ? profile.m_brightness[i] : 0);
+	}
+	frame.m_hasEncoderValue = true;
+	frame.m_encoderValue = profile.m_encoderValue;
+	return 1;
+}
+
+/**
+ * How long the pipeline threads sleep when the ring is full or empty. The ring buffers far longer than this at scan head line rates.
+ */
+constexpr auto PIPELINE_IDLE_WAIT = std::chrono::microseconds(200);
+
+void RaiseScanThreadPriority()
+{
+#ifdef _WIN32
+	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+#endif
+}
+
 void JoeScanScanner::StopScanningProcess()
 {
 	if (m_scanEnabled) {
@@ -128,18 +388,108 @@ void JoeScanScanner::StopScanningProcess()
 	if (m_scannerJob.Valid()) {
 		Jobs::Wait(m_scannerJob);
 		m_scannerJob = {};
-		m_points.clear();
-		if (const auto joeScan = m_joeScan.Get<JoeScan>())
+	}
+	if (m_recorderJob.Valid()) {
+		Jobs::Wait(m_recorderJob);
+		m_recorderJob = {};
+	}
+	m_frameSource.reset();
+	m_statistics.m_producedFrameCount = m_frameRing->GetProducedFrameCount();
+	m_statistics.m_consumedFrameCount = m_frameRing->GetConsumedFrameCount();
+	m_statistics.m_droppedFrameCount = m_frameRing->GetDroppedFrameCount();
+	m_statistics.m_elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_pipelineStartTime).count();
+	EVOENGINE_LOG("JoeScan: " + std::to_string(m_statistics.m_consumedFrameCount) + " frames recorded, "
+		+ std::to_string(m_statistics.m_droppedFrameCount) + " dropped, "
+		+ std::to_string(m_statistics.m_elapsedSeconds > 0.0 ? m_statistics.m_consumedFrameCount / m_statistics.m_elapsedSeconds : 0.0) + " frames/s");
+	m_points.clear();
+	if (m_replaying)
+	{
+		m_replaying = false;
+		return;
+	}
+	if (const auto joeScan = m_joeScan.Get<JoeScan>())
+	{
+		joeScan->m_profiles.clear();
+		m_preservedProfiles.CopyProfiles(joeScan->m_profiles);
+
+		EVOENGINE_LOG("Recorded " + std::to_string(joeScan->m_profiles.size()));
+	}
+}
+
+void JoeScanScanner::StopFinishedPipeline()
+{
+	//A replay without loop, or a failing scan head, ends the producer on its own.
+	if (m_scanEnabled && m_producerFinished->load()) StopScanningProcess();
+}
+
+void JoeScanScanner::RecordFrame(const JoeScanFrame& frame, const JoeScanScannerSettings& settings)
+{
+	if (!frame.m_hasEncoderValue) return;
+	{
+		std::lock_guard lock(*m_scannerMutex);
+		m_points.resize(frame.m_pointCount);
+		for (size_t i = 0; i < frame.m_pointCount; i++) m_points[i] = frame.m_points[i] / 10000.f;
+	}
+	auto& profile = m_preservedProfiles.Acquire(static_cast<int>(frame.m_encoderValue / settings.m_step));
+	profile.m_encoderValue = frame.m_encoderValue;
+	profile.m_points.assign(frame.m_points.begin(), frame.m_points.begin() + frame.m_pointCount);
+	profile.m_brightness.assign(frame.m_brightness.begin(), frame.m_brightness.begin() + frame.m_pointCount);
+}
+
+void JoeScanScanner::StartPipeline(const std::shared_ptr<JoeScanFrameSource>& source, const size_t expectedProfileCount, const JoeScanScannerSettings& settings)
+{
+	m_frameSource = source;
+	m_frameRing->Allocate(m_ringFrameCount, source->GetMaxPointCount());
+	m_preservedProfiles.Allocate(expectedProfileCount, source->GetMaxPointCount());
+	m_producerFinished->store(false);
+	m_pipelineStartTime = std::chrono::steady_clock::now();
+
+	m_scanEnabled = true;
+	m_scannerJob = Jobs::Run([&]()
+		{
+			RaiseScanThreadPriority();
+			const bool realTime = m_frameSource->IsRealTime();
+			// A real-time source cannot be paused, frames that do not fit into the ring are read into the overflow frame and dropped.
+			JoeScanFrame overflowFrame;
+			if (realTime) overflowFrame.Reserve(m_frameSource->GetMaxPointCount());
+			while (m_scanEnabled)
+			{
+				JoeScanFrame* frame = m_frameRing->BeginWrite();
+				if (!frame)
+				{
+					if (!realTime)
+					{
+						std::this_thread::sleep_for(PIPELINE_IDLE_WAIT);
+						continue;
+					}
+					frame = &overflowFrame;
+				}
+				const int readResult = m_frameSource->ReadFrame(*frame);
+				if (0 == readResult) continue;
+				if (0 > readResult) break;
+				if (frame == &overflowFrame) m_frameRing->DropFrame();
+				else m_frameRing->EndWrite();
+			}
+			m_producerFinished->store(true);
+		}
+	);
+	m_recorderJob = Jobs::Run([&, settings]()
 		{
-			joeScan->m_profiles.clear();
-			for (const auto& profile : m_preservedProfiles)
+			while (true)
 			{
-				joeScan->m_profiles.emplace_back(profile.second);
+				const bool producerFinished = m_producerFinished->load();
+				while (const auto* frame = m_frameRing->BeginRead())
+				{
+					RecordFrame(*frame, settings);
+					m_frameRing->EndRead();
+				}
+				if (producerFinished) break;
+				std::this_thread::sleep_for(PIPELINE_IDLE_WAIT);
 			}
-
-			EVOENGINE_LOG("Recorded " + std::to_string(joeScan->m_profiles.size()));
 		}
-	}
+	);
+	Jobs::Execute(m_scannerJob);
+	Jobs::Execute(m_recorderJob);
 }
 
 void JoeScanScanner::StartScanProcess(const JoeScanScannerSettings& settings)
@@ -147,7 +497,6 @@ void JoeScanScanner::StartScanProcess(const JoeScanScannerSettings& settings)
 	StopScanningProcess();
 
 	m_points.clear();
-	m_preservedProfiles.clear();
 	const int32_t minPeriod = jsScanSystemGetMinScanPeriod(m_scanSystem);
 	if (0 >= minPeriod) {
 		EVOENGINE_ERROR("Failed to read min scan period.");
@@ -158,71 +507,35 @@ void JoeScanScanner::StartScanProcess(const JoeScanScannerSettings& settings)
 		EVOENGINE_ERROR("Failed to start scanning.");
 		return;
 	}
+	StartPipeline(std::make_shared<JoeScanHeadSource>(m_scanSystem), glm::max(m_expectedProfileCount, 1), settings);
+}
 
-	m_scanEnabled = true;
-	m_scannerJob = Jobs::Run([&, settings]()
-		{
-			SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
-			const auto profileSize = jsScanSystemGetProfilesPerFrame(m_scanSystem);
-			int i = 0;
-			while (m_scanEnabled)
-			{
-				const int scanResult = jsScanSystemWaitUntilFrameAvailable(m_scanSystem, 1000);
-				if (0 == scanResult) {
-					continue;
-				}
-				if (0 > scanResult) {
-					EVOENGINE_ERROR("Failed to wait for frame.");
-					break;
-				}
+void JoeScanScanner::StartReplayProcess(const JoeScanScannerSettings& settings)
+{
+	StopScanningProcess();
 
-				std::vector<jsProfile> profiles;
-				profiles.resize(profileSize);
-				const int getFrameResult = jsScanSystemGetFrame(m_scanSystem, profiles.data());
-				if (0 >= getFrameResult) {
-					EVOENGINE_ERROR("Failed to read frame.");
-					break;
-				}
-				size_t validCount = 0;
-				std::vector<glm::vec2> points;
-				JoeScanProfile joeScanProfile;
-				bool hasEncoderValue = false;
-				for (int profileIndex = 0; profileIndex < profileSize; profileIndex++) {
-					if (jsRawProfileIsValid(profiles[profileIndex]))
-					{
-						bool containRealData = false;
-						for (const auto& point : profiles[profileIndex].data)
-						{
-							if (point.x != 0 || point.y != 0)
-							{
-								containRealData = true;
-								points.emplace_back(glm::vec2(point.x, point.y) / 10000.f);
-								joeScanProfile.m_points.emplace_back(glm::vec2(point.x, point.y));
-								joeScanProfile.m_brightness.emplace_back(point.brightness);
-							}
-						}
-						if (containRealData) validCount++;
-					}
-					if (validCount != 0 && !hasEncoderValue) {
-						hasEncoderValue = true;
-						joeScanProfile.m_encoderValue = profiles[profileIndex].encoder_values[0];
-					}
-				}
-				if (hasEncoderValue) {
-					std::lock_guard lock(*m_scannerMutex);
-					m_points = points;
-					m_preservedProfiles[joeScanProfile.m_encoderValue / settings.m_step] = joeScanProfile;
-				}
-				i++;
-			}
-		}
-	);
-	Jobs::Execute(m_scannerJob);
+	const auto joeScan = m_joeScan.Get<JoeScan>();
+	if (!joeScan || joeScan->m_profiles.empty())
+	{
+		EVOENGINE_ERROR("JoeScan: Nothing to replay.");
+		return;
+	}
+	m_points.clear();
+	m_replaying = true;
+	StartPipeline(std::make_shared<JoeScanReplaySource>(joeScan->m_profiles, m_replayLineRate, m_replayLoop),
+		glm::max(static_cast<size_t>(glm::max(m_expectedProfileCount, 1)), joeScan->m_profiles.size()), settings);
+}
+
+const JoeScanPipelineStatistics& JoeScanScanner::GetStatistics() const
+{
+	return m_statistics;
 }
 
 JoeScanScanner::JoeScanScanner()
 {
 	m_scannerMutex = std::make_shared<std::mutex>();
+	m_frameRing = std::make_shared<JoeScanFrameRing>();
+	m_producerFinished = std::make_shared<std::atomic<bool>>(true);
 }
 
 bool JoeScanScanner::InitializeScanSystem(const std::shared_ptr<Json>& json, jsScanSystem& scanSystem, std::vector<jsScanHead>& scanHeads)
@@ -287,16 +600,25 @@ void JoeScanScanner::Serialize(YAML::Emitter& out) const
 {
 	m_config.Save("m_config", out);
 	m_joeScan.Save("m_joeScan", out);
+	out << YAML::Key << "m_ringFrameCount" << YAML::Value << m_ringFrameCount;
+	out << YAML::Key << "m_expectedProfileCount" << YAML::Value << m_expectedProfileCount;
+	out << YAML::Key << "m_replayLineRate" << YAML::Value << m_replayLineRate;
+	out << YAML::Key << "m_replayLoop" << YAML::Value << m_replayLoop;
 }
 
 void JoeScanScanner::Deserialize(const YAML::Node& in)
 {
 	m_config.Load("m_config", in);
 	m_joeScan.Load("m_joeScan", in);
+	if (in["m_ringFrameCount"]) m_ringFrameCount = in["m_ringFrameCount"].as<int>();
+	if (in["m_expectedProfileCount"]) m_expectedProfileCount = in["m_expectedProfileCount"].as<int>();
+	if (in["m_replayLineRate"]) m_replayLineRate = in["m_replayLineRate"].as<float>();
+	if (in["m_replayLoop"]) m_replayLoop = in["m_replayLoop"].as<bool>();
 }
 
 bool JoeScanScanner::OnInspect(const std::shared_ptr<EditorLayer>& editorLayer)
 {
+	StopFinishedPipeline();
 	bool changed = false;
 	if (editorLayer->DragAndDropButton<Json>(m_config, "Json Config")) changed = true;
 	if (editorLayer->DragAndDropButton<JoeScan>(m_joeScan, "JoeScan")) changed = true;
@@ -322,6 +644,21 @@ bool JoeScanScanner::OnInspect(const std::shared_ptr<EditorLayer>& editorLayer)
 	{
 		StopScanningProcess();
 	}
+	if (!m_scanEnabled) {
+		ImGui::DragInt("Ring frame count", &m_ringFrameCount, 1, 2, 65536);
+		ImGui::DragInt("Expected profile count", &m_expectedProfileCount, 1, 1, 1000000);
+		ImGui::DragFloat("Replay line rate", &m_replayLineRate, 10.f, 0.f, 100000.f);
+		ImGui::Checkbox("Replay loop", &m_replayLoop);
+		if (m_joeScan.Get<JoeScan>() && ImGui::Button("Start Replay"))
+		{
+			StartReplayProcess({});
+		}
+		if (m_statistics.m_producedFrameCount != 0)
+		{
+			ImGui::Text("Last run: %zu recorded, %zu dropped, %.1f frames/s", m_statistics.m_consumedFrameCount, m_statistics.m_droppedFrameCount,
+				m_statistics.m_elapsedSeconds > 0.0 ? m_statistics.m_consumedFrameCount / m_statistics.m_elapsedSeconds : 0.0);
+		}
+	}
 	static std::shared_ptr<ParticleInfoList> latestPointList;
 	if (!latestPointList) latestPointList = ProjectManager::CreateTemporaryAsset<ParticleInfoList>();
 	if (m_scanEnabled) {
@@ -349,7 +686,7 @@ bool JoeScanScanner::OnInspect(const std::shared_ptr<EditorLayer>& editorLayer)
 
 void JoeScanScanner::FixedUpdate()
 {
-
+	StopFinishedPipeline();
 }
 
 void JoeScanScanner::OnCreate()
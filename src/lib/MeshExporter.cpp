@@ -0,0 +1,535 @@
+#include "MeshExporter.hpp"
+
+#include "Jobs.hpp"
+#include <charconv>
+using namespace EcoSysLab;
+
+size_t MeshExportChunk::GetVertexCount() const
+{
+	return m_vertices ? m_vertices->size() : 0;
+}
+
+size_t MeshExportChunk::GetTexCoordCount() const
+{
+	if (m_texCoords) return m_texCoords->size();
+	return GetVertexCount();
+}
+
+size_t MeshExportChunk::GetTriangleCount() const
+{
+	if (m_triangles) return m_triangles->size();
+	if (m_vertexTexCoordIndices) return m_vertexTexCoordIndices->size() / 3;
+	if (m_indices) return m_indices->size() / 3;
+	return 0;
+}
+
+bool MeshExportChunk::IsEmpty() const
+{
+	return GetVertexCount() == 0 || GetTriangleCount() == 0;
+}
+
+glm::vec3 MeshExportChunk::GetPosition(const size_t vertexIndex) const
+{
+	const auto& position = m_vertices->at(vertexIndex).m_position;
+	if (!m_transformed) return position;
+	return m_transform * glm::vec4(position, 1.0f);
+}
+
+glm::vec2 MeshExportChunk::GetTexCoord(const size_t texCoordIndex) const
+{
+	if (m_texCoords) return m_texCoords->at(texCoordIndex);
+	return m_vertices->at(texCoordIndex).m_texCoord;
+}
+
+void MeshExportChunk::GetTriangle(const size_t triangleIndex, glm::uvec3& vertexIndices, glm::uvec3& texCoordIndices) const
+{
+	if (m_triangles)
+	{
+		vertexIndices = m_triangles->at(triangleIndex);
+		texCoordIndices = vertexIndices;
+	}
+	else if (m_vertexTexCoordIndices)
+	{
+		const auto& i0 = m_vertexTexCoordIndices->at(triangleIndex * 3);
+		const auto& i1 = m_vertexTexCoordIndices->at(triangleIndex * 3 + 1);
+		const auto& i2 = m_vertexTexCoordIndices->at(triangleIndex * 3 + 2);
+		vertexIndices = { i0.first, i1.first, i2.first };
+		texCoordIndices = { i0.second, i1.second, i2.second };
+	}
+	else
+	{
+		vertexIndices = { m_indices->at(triangleIndex * 3), m_indices->at(triangleIndex * 3 + 1), m_indices->at(triangleIndex * 3 + 2) };
+		texCoordIndices = vertexIndices;
+	}
+}
+
+/**
+ * Text buffer that keeps its storage between uses. Numbers are written with std::to_chars, no temporaries are created per value.
+ */
+class MeshExportTextBuffer
+{
+	std::string& m_storage;
+	size_t m_size = 0;
+	void Ensure(const size_t count)
+	{
+		if (m_size + count > m_storage.size()) m_storage.resize(glm::max(m_storage.size() * 2, m_size + count));
+	}
+public:
+	explicit MeshExportTextBuffer(std::string& storage) : m_storage(storage) {}
+	void Append(const char* text, const size_t length)
+	{
+		Ensure(length);
+		std::memcpy(m_storage.data() + m_size, text, length);
+		m_size += length;
+	}
+	void Append(const std::string& text)
+	{
+		Append(text.data(), text.size());
+	}
+	void Append(const char character)
+	{
+		Ensure(1);
+		m_storage[m_size++] = character;
+	}
+	void Append(const float value)
+	{
+		//Same as std::to_string, 6 digits after the decimal point.
+		Ensure(64);
+		const auto result = std::to_chars(m_storage.data() + m_size, m_storage.data() + m_storage.size(), value, std::chars_format::fixed, 6);
+		m_size = result.ptr - m_storage.data();
+	}
+	void Append(const size_t value)
+	{
+		Ensure(24);
+		const auto result = std::to_chars(m_storage.data() + m_size, m_storage.data() + m_storage.size(), value);
+		m_size = result.ptr - m_storage.data();
+	}
+	[[nodiscard]] const char* Data() const
+	{
+		return m_storage.data();
+	}
+	[[nodiscard]] size_t Size() const
+	{
+		return m_size;
+	}
+};
+
+/**
+ * PLY and glTF store one texture coordinate per vertex. Chunks with their own texture coordinates are split for them,
+ * every distinct (vertex, texCoord) pair used by the faces becomes one exported vertex.
+ */
+class MeshExportVertexSplit
+{
+	std::vector<std::pair<unsigned, unsigned>> m_corners;
+	std::vector<glm::uvec3> m_triangles;
+	bool m_split = false;
+public:
+	void Build(const MeshExportChunk& chunk)
+	{
+		m_corners.clear();
+		m_triangles.clear();
+		m_split = chunk.m_texCoords != nullptr;
+		if (!m_split) return;
+		const auto triangleCount = chunk.GetTriangleCount();
+		m_triangles.resize(triangleCount);
+		std::unordered_map<uint64_t, unsigned> cornerIndices;
+		cornerIndices.reserve(chunk.GetVertexCount());
+		glm::uvec3 vertexIndices, texCoordIndices;
+		for (size_t i = 0; i < triangleCount; i++)
+		{
+			chunk.GetTriangle(i, vertexIndices, texCoordIndices);
+			for (int j = 0; j < 3; j++)
+			{
+				const auto key = static_cast<uint64_t>(vertexIndices[j]) << 32 | texCoordIndices[j];
+				const auto [search, inserted] = cornerIndices.emplace(key, static_cast<unsigned>(m_corners.size()));
+				if (inserted) m_corners.emplace_back(vertexIndices[j], texCoordIndices[j]);
+				m_triangles[i][j] = search->second;
+			}
+		}
+	}
+	[[nodiscard]] size_t GetVertexCount(const MeshExportChunk& chunk) const
+	{
+		return m_split ? m_corners.size() : chunk.GetVertexCount();
+	}
+	/**
+	 * @param index Index of the exported vertex.
+	 * @param vertexIndex Index of the chunk vertex it comes from.
+	 */
+	void GetVertex(const MeshExportChunk& chunk, const size_t index, size_t& vertexIndex, glm::vec2& texCoord) const
+	{
+		if (!m_split)
+		{
+			vertexIndex = index;
+			texCoord = chunk.m_vertices->at(index).m_texCoord;
+			return;
+		}
+		vertexIndex = m_corners[index].first;
+		texCoord = chunk.GetTexCoord(m_corners[index].second);
+	}
+	[[nodiscard]] glm::uvec3 GetTriangle(const MeshExportChunk& chunk, const size_t triangleIndex) const
+	{
+		if (m_split) return m_triangles[triangleIndex];
+		glm::uvec3 vertexIndices, texCoordIndices;
+		chunk.GetTriangle(triangleIndex, vertexIndices, texCoordIndices);
+		return vertexIndices;
+	}
+};
+
+void FormatOBJChunk(const MeshExportChunk& chunk, const size_t vertexOffset, const size_t texCoordOffset, MeshExportTextBuffer& buffer)
+{
+	const auto vertexCount = chunk.GetVertexCount();
+	const auto texCoordCount = chunk.GetTexCoordCount();
+	const auto triangleCount = chunk.GetTriangleCount();
+	buffer.Append("#Vertices: ", 11);
+	buffer.Append(vertexCount);
+	buffer.Append(", tris: ", 8);
+	buffer.Append(triangleCount);
+	buffer.Append('\n');
+	buffer.Append("o ", 2);
+	buffer.Append(chunk.m_name);
+	buffer.Append('\n');
+	for (size_t i = 0; i < vertexCount; i++)
+	{
+		const auto position = chunk.GetPosition(i);
+		const auto& color = chunk.m_vertices->at(i).m_color;
+		buffer.Append("v ", 2);
+		buffer.Append(position.x);
+		buffer.Append(' ');
+		buffer.Append(position.y);
+		buffer.Append(' ');
+		buffer.Append(position.z);
+		buffer.Append(' ');
+		buffer.Append(color.x);
+		buffer.Append(' ');
+		buffer.Append(color.y);
+		buffer.Append(' ');
+		buffer.Append(color.z);
+		buffer.Append('\n');
+	}
+	for (size_t i = 0; i < texCoordCount; i++)
+	{
+		const auto texCoord = chunk.GetTexCoord(i);
+		buffer.Append("vt ", 3);
+		buffer.Append(texCoord.x);
+		buffer.Append(' ');
+		buffer.Append(texCoord.y);
+		buffer.Append('\n');
+	}
+	buffer.Append("# List of indices for faces vertices, with (x, y, z).\n");
+	glm::uvec3 vertexIndices, texCoordIndices;
+	for (size_t i = 0; i < triangleCount; i++)
+	{
+		chunk.GetTriangle(i, vertexIndices, texCoordIndices);
+		buffer.Append('f');
+		for (int j = 0; j < 3; j++)
+		{
+			const size_t vertexIndex = vertexIndices[j] + vertexOffset;
+			buffer.Append(' ');
+			buffer.Append(vertexIndex);
+			buffer.Append('/');
+			buffer.Append(static_cast<size_t>(texCoordIndices[j] + texCoordOffset));
+			buffer.Append('/');
+			buffer.Append(vertexIndex);
+		}
+		buffer.Append('\n');
+	}
+}
+
+bool MeshExporter::Export(const std::filesystem::path& path, const std::vector<MeshExportChunk>& chunks)
+{
+	const auto extension = path.extension().string();
+	if (extension == ".obj") return ExportOBJ(path, chunks);
+	if (extension == ".ply") return ExportPLY(path, chunks);
+	if (extension == ".glb") return ExportGLB(path, chunks);
+	EVOENGINE_ERROR("Unsupported mesh format: " + extension);
+	return false;
+}
+
+bool MeshExporter::IsSupported(const std::filesystem::path& path)
+{
+	const auto extension = path.extension().string();
+	return extension == ".obj" || extension == ".ply" || extension == ".glb";
+}
+
+bool MeshExporter::ExportOBJ(const std::filesystem::path& path, const std::vector<MeshExportChunk>& chunks)
+{
+	std::ofstream of;
+	of.open(path.string(), std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+	if (!of.is_open())
+	{
+		EVOENGINE_ERROR("Export failed: can't open " + path.string());
+		return false;
+	}
+	const std::string start = "#Forest OBJ exporter, by Bosheng Li\n";
+	of.write(start.c_str(), start.size());
+
+	std::vector<size_t> chunkIndices;
+	std::vector<size_t> vertexOffsets;
+	std::vector<size_t> texCoordOffsets;
+	size_t vertexOffset = 1;
+	size_t texCoordOffset = 1;
+	for (size_t i = 0; i < chunks.size(); i++)
+	{
+		if (chunks[i].IsEmpty()) continue;
+		chunkIndices.emplace_back(i);
+		vertexOffsets.emplace_back(vertexOffset);
+		texCoordOffsets.emplace_back(texCoordOffset);
+		vertexOffset += chunks[i].GetVertexCount();
+		texCoordOffset += chunks[i].GetTexCoordCount();
+	}
+	//Chunks are formatted one batch at a time so the memory held is bounded by the batch, not the whole file.
+	const size_t batchSize = glm::max(static_cast<size_t>(Jobs::GetWorkerSize()), static_cast<size_t>(1));
+	std::vector<std::string> storages(glm::min(batchSize, chunkIndices.size()));
+	std::vector<size_t> sizes(storages.size());
+	for (size_t batchStart = 0; batchStart < chunkIndices.size(); batchStart += batchSize)
+	{
+		const auto currentBatchSize = glm::min(batchSize, chunkIndices.size() - batchStart);
+		Jobs::RunParallelFor(currentBatchSize, [&](unsigned i)
+			{
+				MeshExportTextBuffer buffer(storages[i]);
+				const auto listIndex = batchStart + i;
+				FormatOBJChunk(chunks[chunkIndices[listIndex]], vertexOffsets[listIndex], texCoordOffsets[listIndex], buffer);
+				sizes[i] = buffer.Size();
+			}
+		);
+		for (size_t i = 0; i < currentBatchSize; i++)
+		{
+			of.write(storages[i].data(), sizes[i]);
+		}
+	}
+	of.close();
+	return true;
+}
+
+bool MeshExporter::ExportPLY(const std::filesystem::path& path, const std::vector<MeshExportChunk>& chunks)
+{
+	//Vertex: position (3 float), texCoord (2 float), color (3 uchar). Face: count (uchar), indices (3 uint).
+	constexpr size_t vertexStride = sizeof(float) * 5 + 3;
+	constexpr size_t faceStride = 1 + sizeof(unsigned) * 3;
+	std::vector<MeshExportVertexSplit> splits(chunks.size());
+	Jobs::RunParallelFor(chunks.size(), [&](unsigned chunkIndex)
+		{
+			if (!chunks[chunkIndex].IsEmpty()) splits[chunkIndex].Build(chunks[chunkIndex]);
+		}
+	);
+	std::vector<size_t> vertexOffsets(chunks.size());
+	std::vector<size_t> triangleOffsets(chunks.size());
+	size_t vertexCount = 0;
+	size_t triangleCount = 0;
+	for (size_t i = 0; i < chunks.size(); i++)
+	{
+		vertexOffsets[i] = vertexCount;
+		triangleOffsets[i] = triangleCount;
+		if (chunks[i].IsEmpty()) continue;
+		vertexCount += splits[i].GetVertexCount(chunks[i]);
+		triangleCount += chunks[i].GetTriangleCount();
+	}
+	std::ofstream of;
+	of.open(path.string(), std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+	if (!of.is_open())
+	{
+		EVOENGINE_ERROR("Export failed: can't open " + path.string());
+		return false;
+	}
+	std::string header = "ply\nformat binary_little_endian 1.0\ncomment Forest PLY exporter, by Bosheng Li\n";
+	header += "element vertex " + std::to_string(vertexCount) + "\n";
+	header += "property float x\nproperty float y\nproperty float z\nproperty float s\nproperty float t\n";
+	header += "property uchar red\nproperty uchar green\nproperty uchar blue\n";
+	header += "element face " + std::to_string(triangleCount) + "\n";
+	header += "property list uchar uint vertex_indices\nend_header\n";
+	of.write(header.c_str(), header.size());
+
+	std::vector<char> data(vertexCount * vertexStride + triangleCount * faceStride);
+	char* faceData = data.data() + vertexCount * vertexStride;
+	Jobs::RunParallelFor(chunks.size(), [&](unsigned chunkIndex)
+		{
+			const auto& chunk = chunks[chunkIndex];
+			if (chunk.IsEmpty()) return;
+			const auto& split = splits[chunkIndex];
+			char* vertexPointer = data.data() + vertexOffsets[chunkIndex] * vertexStride;
+			size_t vertexIndex;
+			glm::vec2 texCoord;
+			for (size_t i = 0; i < split.GetVertexCount(chunk); i++)
+			{
+				split.GetVertex(chunk, i, vertexIndex, texCoord);
+				const auto& vertex = chunk.m_vertices->at(vertexIndex);
+				const auto position = chunk.GetPosition(vertexIndex);
+				std::memcpy(vertexPointer, &position.x, sizeof(float) * 3);
+				std::memcpy(vertexPointer + sizeof(float) * 3, &texCoord.x, sizeof(float) * 2);
+				const auto color = glm::clamp(glm::vec3(vertex.m_color), glm::vec3(0.0f), glm::vec3(1.0f)) * 255.0f + 0.5f;
+				vertexPointer[sizeof(float) * 5] = static_cast<char>(static_cast<unsigned char>(color.x));
+				vertexPointer[sizeof(float) * 5 + 1] = static_cast<char>(static_cast<unsigned char>(color.y));
+				vertexPointer[sizeof(float) * 5 + 2] = static_cast<char>(static_cast<unsigned char>(color.z));
+				vertexPointer += vertexStride;
+			}
+			char* facePointer = faceData + triangleOffsets[chunkIndex] * faceStride;
+			for (size_t i = 0; i < chunk.GetTriangleCount(); i++)
+			{
+				const auto vertexIndices = split.GetTriangle(chunk, i) + glm::uvec3(static_cast<unsigned>(vertexOffsets[chunkIndex]));
+				facePointer[0] = 3;
+				std::memcpy(facePointer + 1, &vertexIndices.x, sizeof(unsigned) * 3);
+				facePointer += faceStride;
+			}
+		}
+	);
+	of.write(data.data(), data.size());
+	of.close();
+	return true;
+}
+
+void AppendJsonFloat(std::string& json, const float value)
+{
+	char digits[32];
+	const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+	json.append(digits, result.ptr - digits);
+}
+
+void AppendJsonString(std::string& json, const std::string& value)
+{
+	json += '"';
+	for (const auto& character : value)
+	{
+		if (character == '"' || character == '\\') json += '\\';
+		json += character;
+	}
+	json += '"';
+}
+
+bool MeshExporter::ExportGLB(const std::filesystem::path& path, const std::vector<MeshExportChunk>& chunks)
+{
+	//Each chunk becomes one node with one mesh. In the binary chunk, the data of a chunk is stored as positions, colors, texCoords, indices.
+	std::vector<size_t> chunkIndices;
+	for (size_t i = 0; i < chunks.size(); i++)
+	{
+		if (!chunks[i].IsEmpty()) chunkIndices.emplace_back(i);
+	}
+	std::vector<MeshExportVertexSplit> splits(chunkIndices.size());
+	Jobs::RunParallelFor(chunkIndices.size(), [&](unsigned listIndex)
+		{
+			splits[listIndex].Build(chunks[chunkIndices[listIndex]]);
+		}
+	);
+	std::vector<size_t> vertexCounts(chunkIndices.size());
+	std::vector<size_t> byteOffsets(chunkIndices.size());
+	size_t byteLength = 0;
+	for (size_t i = 0; i < chunkIndices.size(); i++)
+	{
+		const auto& chunk = chunks[chunkIndices[i]];
+		vertexCounts[i] = splits[i].GetVertexCount(chunk);
+		byteOffsets[i] = byteLength;
+		byteLength += vertexCounts[i] * sizeof(float) * (3 + 4 + 2) + chunk.GetTriangleCount() * sizeof(unsigned) * 3;
+	}
+	std::vector<char> binary(byteLength);
+	std::vector<glm::vec3> minBounds(chunkIndices.size(), glm::vec3(FLT_MAX));
+	std::vector<glm::vec3> maxBounds(chunkIndices.size(), glm::vec3(-FLT_MAX));
+	Jobs::RunParallelFor(chunkIndices.size(), [&](unsigned listIndex)
+		{
+			const auto& chunk = chunks[chunkIndices[listIndex]];
+			const auto& split = splits[listIndex];
+			const auto vertexCount = vertexCounts[listIndex];
+			auto* positions = reinterpret_cast<float*>(binary.data() + byteOffsets[listIndex]);
+			auto* colors = positions + vertexCount * 3;
+			auto* texCoords = colors + vertexCount * 4;
+			auto* indices = reinterpret_cast<unsigned*>(texCoords + vertexCount * 2);
+			size_t vertexIndex;
+			glm::vec2 texCoord;
+			for (size_t i = 0; i < vertexCount; i++)
+			{
+				split.GetVertex(chunk, i, vertexIndex, texCoord);
+				const auto& vertex = chunk.m_vertices->at(vertexIndex);
+				const auto position = chunk.GetPosition(vertexIndex);
+				minBounds[listIndex] = glm::min(minBounds[listIndex], position);
+				maxBounds[listIndex] = glm::max(maxBounds[listIndex], position);
+				std::memcpy(positions + i * 3, &position.x, sizeof(float) * 3);
+				std::memcpy(colors + i * 4, &vertex.m_color.x, sizeof(float) * 4);
+				std::memcpy(texCoords + i * 2, &texCoord.x, sizeof(float) * 2);
+			}
+			for (size_t i = 0; i < chunk.GetTriangleCount(); i++)
+			{
+				const auto vertexIndices = split.GetTriangle(chunk, i);
+				std::memcpy(indices + i * 3, &vertexIndices.x, sizeof(unsigned) * 3);
+			}
+		}
+	);
+
+	std::string json = R"({"asset":{"version":"2.0","generator":"EcoSysLab"},"scene":0,"scenes":[{"nodes":[)";
+	for (size_t i = 0; i < chunkIndices.size(); i++)
+	{
+		if (i != 0) json += ',';
+		json += std::to_string(i);
+	}
+	json += R"(]}],"nodes":[)";
+	for (size_t i = 0; i < chunkIndices.size(); i++)
+	{
+		if (i != 0) json += ',';
+		json += R"({"mesh":)" + std::to_string(i) + R"(,"name":)";
+		AppendJsonString(json, chunks[chunkIndices[i]].m_name);
+		json += '}';
+	}
+	json += R"(],"meshes":[)";
+	for (size_t i = 0; i < chunkIndices.size(); i++)
+	{
+		if (i != 0) json += ',';
+		const auto accessor = std::to_string(i * 4);
+		json += R"({"primitives":[{"attributes":{"POSITION":)" + accessor + R"(,"COLOR_0":)" + std::to_string(i * 4 + 1)
+			+ R"(,"TEXCOORD_0":)" + std::to_string(i * 4 + 2) + R"(},"indices":)" + std::to_string(i * 4 + 3) + R"(,"mode":4}]})";
+	}
+	json += R"(],"accessors":[)";
+	for (size_t i = 0; i < chunkIndices.size(); i++)
+	{
+		if (i != 0) json += ',';
+		const auto& chunk = chunks[chunkIndices[i]];
+		const auto vertexCount = std::to_string(vertexCounts[i]);
+		json += R"({"bufferView":)" + std::to_string(i * 4) + R"(,"componentType":5126,"count":)" + vertexCount + R"(,"type":"VEC3","min":[)";
+		AppendJsonFloat(json, minBounds[i].x); json += ',';
+		AppendJsonFloat(json, minBounds[i].y); json += ',';
+		AppendJsonFloat(json, minBounds[i].z);
+		json += R"(],"max":[)";
+		AppendJsonFloat(json, maxBounds[i].x); json += ',';
+		AppendJsonFloat(json, maxBounds[i].y); json += ',';
+		AppendJsonFloat(json, maxBounds[i].z);
+		json += "]},";
+		json += R"({"bufferView":)" + std::to_string(i * 4 + 1) + R"(,"componentType":5126,"count":)" + vertexCount + R"(,"type":"VEC4"},)";
+		json += R"({"bufferView":)" + std::to_string(i * 4 + 2) + R"(,"componentType":5126,"count":)" + vertexCount + R"(,"type":"VEC2"},)";
+		json += R"({"bufferView":)" + std::to_string(i * 4 + 3) + R"(,"componentType":5125,"count":)" + std::to_string(chunk.GetTriangleCount() * 3) + R"(,"type":"SCALAR"})";
+	}
+	json += R"(],"bufferViews":[)";
+	for (size_t i = 0; i < chunkIndices.size(); i++)
+	{
+		if (i != 0) json += ',';
+		const auto& chunk = chunks[chunkIndices[i]];
+		const auto vertexCount = vertexCounts[i];
+		size_t offset = byteOffsets[i];
+		const size_t lengths[4] = { vertexCount * sizeof(float) * 3, vertexCount * sizeof(float) * 4, vertexCount * sizeof(float) * 2, chunk.GetTriangleCount() * sizeof(unsigned) * 3 };
+		for (int j = 0; j < 4; j++)
+		{
+			if (j != 0) json += ',';
+			json += R"({"buffer":0,"byteOffset":)" + std::to_string(offset) + R"(,"byteLength":)" + std::to_string(lengths[j])
+				+ R"(,"target":)" + (j == 3 ? "34963" : "34962") + "}";
+			offset += lengths[j];
+		}
+	}
+	json += R"(],"buffers":[{"byteLength":)" + std::to_string(byteLength) + "}]}";
+	while (json.size() % 4 != 0) json += ' ';
+	binary.resize((binary.size() + 3) / 4 * 4, 0);
+
+	std::ofstream of;
+	of.open(path.string(), std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+	if (!of.is_open())
+	{
+		EVOENGINE_ERROR("Export failed: can't open " + path.string());
+		return false;
+	}
+	const uint32_t jsonChunkLength = static_cast<uint32_t>(json.size());
+	const uint32_t binaryChunkLength = static_cast<uint32_t>(binary.size());
+	const uint32_t header[3] = { 0x46546C67, 2, static_cast<uint32_t>(12 + 8 + jsonChunkLength + 8 + binaryChunkLength) };
+	const uint32_t jsonChunkHeader[2] = { jsonChunkLength, 0x4E4F534A };
+	const uint32_t binaryChunkHeader[2] = { binaryChunkLength, 0x004E4942 };
+	of.write(reinterpret_cast<const char*>(header), sizeof(header));
+	of.write(reinterpret_cast<const char*>(jsonChunkHeader), sizeof(jsonChunkHeader));
+	of.write(json.data(), json.size());
+	of.write(reinterpret_cast<const char*>(binaryChunkHeader), sizeof(binaryChunkHeader));
+	of.write(binary.data(), binary.size());
+	of.close();
+	return true;
+}
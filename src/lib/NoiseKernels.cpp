@@ -0,0 +1,291 @@
+#include "NoiseKernels.hpp"
+#include "glm/gtc/noise.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ECOSYSLAB_NOISE_KERNELS_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace EcoSysLab;
+
+#ifdef ECOSYSLAB_NOISE_KERNELS_SSE2
+namespace
+{
+	/**
+	 * Four floats, one per point. The helpers mirror the glm functions used by glm::perlin and glm::simplex.
+	 */
+	struct Lanes
+	{
+		__m128 m_value;
+		Lanes(const __m128 value) : m_value(value) {}
+		Lanes(const float value) : m_value(_mm_set1_ps(value)) {}
+	};
+	Lanes operator+(const Lanes a, const Lanes b) { return _mm_add_ps(a.m_value, b.m_value); }
+	Lanes operator-(const Lanes a, const Lanes b) { return _mm_sub_ps(a.m_value, b.m_value); }
+	Lanes operator*(const Lanes a, const Lanes b) { return _mm_mul_ps(a.m_value, b.m_value); }
+	Lanes operator/(const Lanes a, const Lanes b) { return _mm_div_ps(a.m_value, b.m_value); }
+	Lanes operator-(const Lanes a) { return _mm_xor_ps(a.m_value, _mm_set1_ps(-0.0f)); }
+
+	//SSE2 has no floor, truncate and step down where truncation rounded up.
+	Lanes Floor(const Lanes a)
+	{
+		const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.m_value));
+		return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, a.m_value), _mm_set1_ps(1.0f)));
+	}
+	Lanes Fract(const Lanes a) { return a - Floor(a); }
+	Lanes Abs(const Lanes a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.m_value); }
+	Lanes Min(const Lanes a, const Lanes b) { return _mm_min_ps(a.m_value, b.m_value); }
+	Lanes Max(const Lanes a, const Lanes b) { return _mm_max_ps(a.m_value, b.m_value); }
+	//glm::step(edge, x): x < edge ? 0 : 1.
+	Lanes Step(const Lanes edge, const Lanes x) { return _mm_andnot_ps(_mm_cmplt_ps(x.m_value, edge.m_value), _mm_set1_ps(1.0f)); }
+	//glm::mix(x, y, a) for floats.
+	Lanes Mix(const Lanes x, const Lanes y, const Lanes a) { return x * (Lanes(1.0f) - a) + y * a; }
+	//glm::mod(x, 289), used by glm::perlin(vec2) and glm::simplex(vec2).
+	Lanes Mod289Divide(const Lanes x) { return x - Lanes(289.0f) * Floor(x / Lanes(289.0f)); }
+	//glm::detail::mod289.
+	Lanes Mod289(const Lanes x) { return x - Floor(x * Lanes(1.0f / 289.0f)) * Lanes(289.0f); }
+	Lanes Permute(const Lanes x) { return Mod289((x * Lanes(34.0f) + Lanes(1.0f)) * x); }
+	Lanes TaylorInvSqrt(const Lanes r) { return Lanes(1.79284291400159f) - Lanes(0.85373472095314f) * r; }
+	Lanes Fade(const Lanes t) { return t * t * t * (t * (t * Lanes(6.0f) - Lanes(15.0f)) + Lanes(10.0f)); }
+
+	struct Lanes2
+	{
+		Lanes x, y;
+	};
+	struct Lanes3
+	{
+		Lanes x, y, z;
+	};
+	Lanes Dot(const Lanes2& a, const Lanes2& b) { return a.x * b.x + a.y * b.y; }
+	Lanes Dot(const Lanes3& a, const Lanes3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+	Lanes2 Scale(const Lanes2& a, const Lanes s) { return { a.x * s, a.y * s }; }
+	Lanes3 Scale(const Lanes3& a, const Lanes s) { return { a.x * s, a.y * s, a.z * s }; }
+
+	Lanes PerlinLanes(const Lanes2& position)
+	{
+		const Lanes pi0X = Mod289Divide(Floor(position.x));
+		const Lanes pi0Y = Mod289Divide(Floor(position.y));
+		const Lanes pi1X = Mod289Divide(Floor(position.x) + Lanes(1.0f));
+		const Lanes pi1Y = Mod289Divide(Floor(position.y) + Lanes(1.0f));
+		const Lanes pf0X = Fract(position.x);
+		const Lanes pf0Y = Fract(position.y);
+		const Lanes pf1X = pf0X - Lanes(1.0f);
+		const Lanes pf1Y = pf0Y - Lanes(1.0f);
+		//Corners in glm's order: 00, 10, 01, 11.
+		const auto gradient = [](const Lanes ix, const Lanes iy)
+			{
+				const Lanes i = Permute(Permute(ix) + iy);
+				Lanes gx = Lanes(2.0f) * Fract(i / Lanes(41.0f)) - Lanes(1.0f);
+				const Lanes gy = Abs(gx) - Lanes(0.5f);
+				gx = gx - Floor(gx + Lanes(0.5f));
+				const Lanes2 g = { gx, gy };
+				return Scale(g, TaylorInvSqrt(Dot(g, g)));
+			};
+		const Lanes n00 = Dot(gradient(pi0X, pi0Y), { pf0X, pf0Y });
+		const Lanes n10 = Dot(gradient(pi1X, pi0Y), { pf1X, pf0Y });
+		const Lanes n01 = Dot(gradient(pi0X, pi1Y), { pf0X, pf1Y });
+		const Lanes n11 = Dot(gradient(pi1X, pi1Y), { pf1X, pf1Y });
+		const Lanes fadeX = Fade(pf0X);
+		const Lanes fadeY = Fade(pf0Y);
+		return Lanes(2.3f) * Mix(Mix(n00, n10, fadeX), Mix(n01, n11, fadeX), fadeY);
+	}
+
+	Lanes PerlinLanes(const Lanes3& position)
+	{
+		const Lanes3 pi0 = { Mod289(Floor(position.x)), Mod289(Floor(position.y)), Mod289(Floor(position.z)) };
+		const Lanes3 pi1 = { Mod289(Floor(position.x) + Lanes(1.0f)), Mod289(Floor(position.y) + Lanes(1.0f)), Mod289(Floor(position.z) + Lanes(1.0f)) };
+		const Lanes3 pf0 = { Fract(position.x), Fract(position.y), Fract(position.z) };
+		const Lanes3 pf1 = { pf0.x - Lanes(1.0f), pf0.y - Lanes(1.0f), pf0.z - Lanes(1.0f) };
+		const auto gradient = [](const Lanes ixy, const Lanes iz)
+			{
+				const Lanes ixyz = Permute(ixy + iz);
+				Lanes gx = ixyz * Lanes(1.0f / 7.0f);
+				Lanes gy = Fract(Floor(gx) * Lanes(1.0f / 7.0f)) - Lanes(0.5f);
+				gx = Fract(gx);
+				const Lanes gz = Lanes(0.5f) - Abs(gx) - Abs(gy);
+				const Lanes sz = Step(gz, Lanes(0.0f));
+				gx = gx - sz * (Step(Lanes(0.0f), gx) - Lanes(0.5f));
+				gy = gy - sz * (Step(Lanes(0.0f), gy) - Lanes(0.5f));
+				const Lanes3 g = { gx, gy, gz };
+				return Scale(g, TaylorInvSqrt(Dot(g, g)));
+			};
+		const Lanes ixy00 = Permute(Permute(pi0.x) + pi0.y);
+		const Lanes ixy10 = Permute(Permute(pi1.x) + pi0.y);
+		const Lanes ixy01 = Permute(Permute(pi0.x) + pi1.y);
+		const Lanes ixy11 = Permute(Permute(pi1.x) + pi1.y);
+		const Lanes n000 = Dot(gradient(ixy00, pi0.z), pf0);
+		const Lanes n100 = Dot(gradient(ixy10, pi0.z), { pf1.x, pf0.y, pf0.z });
+		const Lanes n010 = Dot(gradient(ixy01, pi0.z), { pf0.x, pf1.y, pf0.z });
+		const Lanes n110 = Dot(gradient(ixy11, pi0.z), { pf1.x, pf1.y, pf0.z });
+		const Lanes n001 = Dot(gradient(ixy00, pi1.z), { pf0.x, pf0.y, pf1.z });
+		const Lanes n101 = Dot(gradient(ixy10, pi1.z), { pf1.x, pf0.y, pf1.z });
+		const Lanes n011 = Dot(gradient(ixy01, pi1.z), { pf0.x, pf1.y, pf1.z });
+		const Lanes n111 = Dot(gradient(ixy11, pi1.z), pf1);
+		const Lanes fadeX = Fade(pf0.x);
+		const Lanes fadeY = Fade(pf0.y);
+		const Lanes fadeZ = Fade(pf0.z);
+		const Lanes nZ00 = Mix(n000, n001, fadeZ);
+		const Lanes nZ10 = Mix(n100, n101, fadeZ);
+		const Lanes nZ01 = Mix(n010, n011, fadeZ);
+		const Lanes nZ11 = Mix(n110, n111, fadeZ);
+		return Lanes(2.2f) * Mix(Mix(nZ00, nZ01, fadeY), Mix(nZ10, nZ11, fadeY), fadeX);
+	}
+
+	Lanes SimplexLanes(const Lanes2& position)
+	{
+		const Lanes c0(0.211324865405187f);
+		const Lanes c1(0.366025403784439f);
+		const Lanes c2(-0.577350269189626f);
+		const Lanes c3(0.024390243902439f);
+		//First corner.
+		const Lanes skew = position.x * c1 + position.y * c1;
+		Lanes iX = Floor(position.x + skew);
+		Lanes iY = Floor(position.y + skew);
+		const Lanes unskew = iX * c0 + iY * c0;
+		const Lanes2 x0 = { position.x - iX + unskew, position.y - iY + unskew };
+		//Other corners.
+		const Lanes i1X = _mm_and_ps(_mm_cmpgt_ps(x0.x.m_value, x0.y.m_value), _mm_set1_ps(1.0f));
+		const Lanes i1Y = Lanes(1.0f) - i1X;
+		const Lanes2 x1 = { x0.x + c0 - i1X, x0.y + c0 - i1Y };
+		const Lanes2 x2 = { x0.x + c2, x0.y + c2 };
+		//Permutations.
+		iX = Mod289Divide(iX);
+		iY = Mod289Divide(iY);
+		const Lanes p0 = Permute(Permute(iY) + iX);
+		const Lanes p1 = Permute(Permute(iY + i1Y) + iX + i1X);
+		const Lanes p2 = Permute(Permute(iY + Lanes(1.0f)) + iX + Lanes(1.0f));
+		const auto contribution = [&](const Lanes p, const Lanes2& x)
+			{
+				Lanes m = Max(Lanes(0.5f) - Dot(x, x), Lanes(0.0f));
+				m = m * m;
+				m = m * m;
+				const Lanes gx = Lanes(2.0f) * Fract(p * c3) - Lanes(1.0f);
+				const Lanes h = Abs(gx) - Lanes(0.5f);
+				const Lanes a0 = gx - Floor(gx + Lanes(0.5f));
+				m = m * (Lanes(1.79284291400159f) - Lanes(0.85373472095314f) * (a0 * a0 + h * h));
+				return m * (a0 * x.x + h * x.y);
+			};
+		return Lanes(130.0f) * (contribution(p0, x0) + contribution(p1, x1) + contribution(p2, x2));
+	}
+
+	Lanes SimplexLanes(const Lanes3& position)
+	{
+		const Lanes cX(1.0f / 6.0f);
+		const Lanes cY(1.0f / 3.0f);
+		//First corner.
+		const Lanes skew = position.x * cY + position.y * cY + position.z * cY;
+		Lanes3 i = { Floor(position.x + skew), Floor(position.y + skew), Floor(position.z + skew) };
+		const Lanes unskew = i.x * cX + i.y * cX + i.z * cX;
+		const Lanes3 x0 = { position.x - i.x + unskew, position.y - i.y + unskew, position.z - i.z + unskew };
+		//Other corners.
+		const Lanes3 g = { Step(x0.y, x0.x), Step(x0.z, x0.y), Step(x0.x, x0.z) };
+		const Lanes3 l = { Lanes(1.0f) - g.x, Lanes(1.0f) - g.y, Lanes(1.0f) - g.z };
+		const Lanes3 i1 = { Min(g.x, l.z), Min(g.y, l.x), Min(g.z, l.y) };
+		const Lanes3 i2 = { Max(g.x, l.z), Max(g.y, l.x), Max(g.z, l.y) };
+		const Lanes3 x1 = { x0.x - i1.x + cX, x0.y - i1.y + cX, x0.z - i1.z + cX };
+		const Lanes3 x2 = { x0.x - i2.x + cY, x0.y - i2.y + cY, x0.z - i2.z + cY };
+		const Lanes3 x3 = { x0.x - Lanes(0.5f), x0.y - Lanes(0.5f), x0.z - Lanes(0.5f) };
+		//Permutations.
+		i = { Mod289(i.x), Mod289(i.y), Mod289(i.z) };
+		const auto permute = [&](const Lanes3& offset)
+			{
+				return Permute(Permute(Permute(i.z + offset.z) + i.y + offset.y) + i.x + offset.x);
+			};
+		const Lanes p0 = permute({ Lanes(0.0f), Lanes(0.0f), Lanes(0.0f) });
+		const Lanes p1 = permute(i1);
+		const Lanes p2 = permute(i2);
+		const Lanes p3 = permute({ Lanes(1.0f), Lanes(1.0f), Lanes(1.0f) });
+		//Gradients: 7x7 points over a square, mapped onto an octahedron.
+		const float n = 0.142857142857f;
+		const Lanes nsX(2.0f * n);
+		const Lanes nsY(0.5f * n - 1.0f);
+		const Lanes nsZ(n);
+		const auto contribution = [&](const Lanes p, const Lanes3& x)
+			{
+				const Lanes j = p - Lanes(49.0f) * Floor(p * nsZ * nsZ);
+				const Lanes gridX = Floor(j * nsZ);
+				const Lanes gridY = Floor(j - Lanes(7.0f) * gridX);
+				const Lanes gx = gridX * nsX + nsY;
+				const Lanes gy = gridY * nsX + nsY;
+				const Lanes h = Lanes(1.0f) - Abs(gx) - Abs(gy);
+				const Lanes sh = -Step(h, Lanes(0.0f));
+				const Lanes3 gradient = {
+					gx + (Floor(gx) * Lanes(2.0f) + Lanes(1.0f)) * sh,
+					gy + (Floor(gy) * Lanes(2.0f) + Lanes(1.0f)) * sh,
+					h };
+				const Lanes norm = TaylorInvSqrt(Dot(gradient, gradient));
+				Lanes m = Max(Lanes(0.6f) - Dot(x, x), Lanes(0.0f));
+				m = m * m;
+				return m * m * Dot(Scale(gradient, norm), x);
+			};
+		return Lanes(42.0f) * (contribution(p0, x0) + contribution(p1, x1) + contribution(p2, x2) + contribution(p3, x3));
+	}
+
+	/**
+	 * Gather four points into lanes, padding past the end with the last point, evaluate and write back the valid values.
+	 */
+	template<typename T, typename Func>
+	void Evaluate(const T* points, float* values, const size_t size, const T& scale, const T& bias, Func&& func)
+	{
+		alignas(16) float coordinates[T::length()][4];
+		alignas(16) float results[4];
+		for (size_t start = 0; start < size; start += 4)
+		{
+			const size_t count = glm::min(size - start, static_cast<size_t>(4));
+			for (size_t lane = 0; lane < 4; lane++)
+			{
+				const auto point = points[start + glm::min(lane, count - 1)] * scale + bias;
+				for (int axis = 0; axis < T::length(); axis++) coordinates[axis][lane] = point[axis];
+			}
+			if constexpr (T::length() == 2) _mm_store_ps(results, func(Lanes2{ _mm_load_ps(coordinates[0]), _mm_load_ps(coordinates[1]) }).m_value);
+			else _mm_store_ps(results, func(Lanes3{ _mm_load_ps(coordinates[0]), _mm_load_ps(coordinates[1]), _mm_load_ps(coordinates[2]) }).m_value);
+			for (size_t lane = 0; lane < count; lane++) values[start + lane] = results[lane];
+		}
+	}
+}
+#endif
+
+bool NoiseKernels::IsVectorized()
+{
+#ifdef ECOSYSLAB_NOISE_KERNELS_SSE2
+	return true;
+#else
+	return false;
+#endif
+}
+
+void NoiseKernels::Perlin(const glm::vec2* points, float* values, const size_t size, const glm::vec2& scale, const glm::vec2& bias)
+{
+#ifdef ECOSYSLAB_NOISE_KERNELS_SSE2
+	Evaluate<glm::vec2>(points, values, size, scale, bias, [](const Lanes2& position) { return PerlinLanes(position); });
+#else
+	for (size_t i = 0; i < size; i++) values[i] = glm::perlin(points[i] * scale + bias);
+#endif
+}
+
+void NoiseKernels::Perlin(const glm::vec3* points, float* values, const size_t size, const glm::vec3& scale, const glm::vec3& bias)
+{
+#ifdef ECOSYSLAB_NOISE_KERNELS_SSE2
+	Evaluate<glm::vec3>(points, values, size, scale, bias, [](const Lanes3& position) { return PerlinLanes(position); });
+#else
+	for (size_t i = 0; i < size; i++) values[i] = glm::perlin(points[i] * scale + bias);
+#endif
+}
+
+void NoiseKernels::Simplex(const glm::vec2* points, float* values, const size_t size, const glm::vec2& scale, const glm::vec2& bias)
+{
+#ifdef ECOSYSLAB_NOISE_KERNELS_SSE2
+	Evaluate<glm::vec2>(points, values, size, scale, bias, [](const Lanes2& position) { return SimplexLanes(position); });
+#else
+	for (size_t i = 0; i < size; i++) values[i] = glm::simplex(points[i] * scale + bias);
+#endif
+}
+
+void NoiseKernels::Simplex(const glm::vec3* points, float* values, const size_t size, const glm::vec3& scale, const glm::vec3& bias)
+{
+#ifdef ECOSYSLAB_NOISE_KERNELS_SSE2
+	Evaluate<glm::vec3>(points, values, size, scale, bias, [](const Lanes3& position) { return SimplexLanes(position); });
+#else
+	for (size_t i = 0; i < size; i++) values[i] = glm::simplex(points[i] * scale + bias);
+#endif
+}
@@ -1,7 +1,79 @@
 #include "Noises.hpp"
+#include "NoiseKernels.hpp"
 #include "glm/gtc/noise.hpp"
 using namespace EcoSysLab;
 
+namespace
+{
+	/**
+	 * Add one descriptor's noise to every value. The type switch and the descriptor setup are done once per batch.
+	 * Perlin and simplex go through NoiseKernels and match GetValue within NoiseKernels::Tolerance, the other types
+	 * use the same per position math as GetValue.
+	 */
+	template<typename T>
+	void AccumulateNoise(const NoiseDescriptor& noiseDescriptor, const T* positions, float* values, const size_t size)
+	{
+		const auto shift = T(noiseDescriptor.m_shift);
+		const auto offset = T(noiseDescriptor.m_offset);
+		const float frequency = noiseDescriptor.m_frequency;
+		const float multiplier = noiseDescriptor.m_multiplier;
+		const float intensity = noiseDescriptor.m_intensity;
+		const float min = noiseDescriptor.m_min;
+		const float max = noiseDescriptor.m_max;
+		const bool ridgid = noiseDescriptor.m_ridgid;
+		//pow(x, 1) is x, skip the call for the common case.
+		const bool applyIntensity = intensity != 1.0f;
+		const auto finish = [&](float noise)
+			{
+				if (applyIntensity) noise = glm::pow(noise, intensity);
+				return ridgid ? -glm::abs(noise) : noise;
+			};
+		switch (static_cast<NoiseType>(noiseDescriptor.m_type))
+		{
+		case NoiseType::Perlin:
+		case NoiseType::Simplex:
+		{
+			//Shift is added before the kernel so its input is rounded exactly like frequency * (p + shift) + offset.
+			constexpr size_t chunkSize = 256;
+			T shiftedPositions[chunkSize];
+			float noises[chunkSize];
+			const bool perlin = static_cast<NoiseType>(noiseDescriptor.m_type) == NoiseType::Perlin;
+			for (size_t start = 0; start < size; start += chunkSize)
+			{
+				const size_t count = glm::min(chunkSize, size - start);
+				for (size_t i = 0; i < count; i++) shiftedPositions[i] = positions[start + i] + shift;
+				if (perlin) NoiseKernels::Perlin(shiftedPositions, noises, count, T(frequency), offset);
+				else NoiseKernels::Simplex(shiftedPositions, noises, count, T(frequency), offset);
+				for (size_t i = 0; i < count; i++) values[start + i] += finish(glm::clamp(noises[i] * multiplier, min, max));
+			}
+		}
+		break;
+		case NoiseType::Constant:
+		{
+			const float noise = finish(noiseDescriptor.m_offset);
+			for (size_t i = 0; i < size; i++) values[i] += noise;
+		}
+		break;
+		case NoiseType::Linear:
+			for (size_t i = 0; i < size; i++)
+			{
+				const auto actualPosition = positions[i] + shift;
+				float noise;
+				if constexpr (T::length() == 2) noise = noiseDescriptor.m_offset + frequency * actualPosition.x + intensity * actualPosition.y;
+				else noise = noiseDescriptor.m_offset + frequency * actualPosition.x + intensity * actualPosition.y + multiplier * actualPosition.z;
+				values[i] += finish(glm::clamp(noise, min, max));
+			}
+			break;
+		default:
+		{
+			const float noise = finish(0.0f);
+			for (size_t i = 0; i < size; i++) values[i] += noise;
+		}
+		break;
+		}
+	}
+}
+
 
 void NoiseDescriptor::Serialize(YAML::Emitter& out) const
 {
@@ -233,6 +305,19 @@ float Noise2D::GetValue(const glm::vec2& position) const
 	return glm::clamp(retVal, m_minMax.x, m_minMax.y);
 }
 
+void Noise2D::GetValues(const glm::vec2* positions, float* values, const size_t size) const
+{
+	std::fill(values, values + size, 0.0f);
+	for (const auto& noiseDescriptor : m_noiseDescriptors) AccumulateNoise(noiseDescriptor, positions, values, size);
+	for (size_t i = 0; i < size; i++) values[i] = glm::clamp(values[i], m_minMax.x, m_minMax.y);
+}
+
+void Noise2D::GetValues(const std::vector<glm::vec2>& positions, std::vector<float>& values) const
+{
+	values.resize(positions.size());
+	GetValues(positions.data(), values.data(), positions.size());
+}
+
 
 bool Noise3D::OnInspect() {
 	bool changed = false;
@@ -356,4 +441,17 @@ float Noise3D::GetValue(const glm::vec3& position) const
 		retVal += noise;
 	}
 	return glm::clamp(retVal, m_minMax.x, m_minMax.y);
-}
\ No newline at end of file
+}
+
+void Noise3D::GetValues(const glm::vec3* positions, float* values, const size_t size) const
+{
+	std::fill(values, values + size, 0.0f);
+	for (const auto& noiseDescriptor : m_noiseDescriptors) AccumulateNoise(noiseDescriptor, positions, values, size);
+	for (size_t i = 0; i < size; i++) values[i] = glm::clamp(values[i], m_minMax.x, m_minMax.y);
+}
+
+void Noise3D::GetValues(const std::vector<glm::vec3>& positions, std::vector<float>& values) const
+{
+	values.resize(positions.size());
+	GetValues(positions.data(), values.data(), positions.size());
+}
@@ -174,6 +174,7 @@ void ParticlePhysics2DDemo::FixedUpdate()
 	m_particlePhysics2D.Simulate(Times::TimeStep() / m_particlePhysics2D.GetDeltaTime(),
 		[&](auto& grid, bool gridResized)
 		{
+			if (m_boundariesUpdated) m_profileBoundaries.BuildSegmentGrids();
 			if (gridResized || m_boundariesUpdated) grid.ApplyBoundaries(m_profileBoundaries);
 			m_boundariesUpdated = false;
 		},
@@ -302,6 +302,43 @@ float ProceduralNoise2D::Process(const glm::vec2& samplePoint, float value)
 	return Process(0, samplePoint, value);
 }
 
+void ProceduralNoise2D::CompilePipeline(const SkeletonNodeHandle nodeHandle, std::vector<const ProceduralNoiseStage<glm::vec2>*>& stages) const
+{
+	//Same order as the recursive Process: a parent is applied after each of its children.
+	const auto& node = m_pipeline.PeekNode(nodeHandle);
+	const auto& childHandles = node.PeekChildHandles();
+	if (!childHandles.empty()) {
+		for (const auto& childHandle : childHandles)
+		{
+			CompilePipeline(childHandle, stages);
+			stages.emplace_back(&node.m_data);
+		}
+	}
+	else {
+		stages.emplace_back(&node.m_data);
+	}
+}
+
+void ProceduralNoise2D::Process(const std::vector<glm::vec2>& samplePoints, std::vector<float>& values)
+{
+	values.resize(samplePoints.size(), 0.f);
+	if (m_pipeline.RefRawNodes().empty() || m_pipeline.PeekNode(0).IsRecycled())
+	{
+		EVOENGINE_WARNING("Pipeline is empty!");
+		return;
+	}
+	std::vector<const ProceduralNoiseStage<glm::vec2>*> stages;
+	CompilePipeline(0, stages);
+	//Blocks keep the values and the stage scratch in cache while every stage passes over them.
+	constexpr size_t blockSize = 1024;
+	std::vector<float> stageValues(glm::min(blockSize, samplePoints.size()));
+	for (size_t blockStart = 0; blockStart < samplePoints.size(); blockStart += blockSize)
+	{
+		const auto size = glm::min(blockSize, samplePoints.size() - blockStart);
+		for (const auto* stage : stages) stage->Calculate(&samplePoints[blockStart], &values[blockStart], size, stageValues.data());
+	}
+}
+
 float ProceduralNoise3D::Process(const glm::vec3& samplePoint, float value)
 {
 	if (m_pipeline.RefRawNodes().empty() || m_pipeline.PeekNode(0).IsRecycled())
@@ -312,6 +349,43 @@ float ProceduralNoise3D::Process(const glm::vec3& samplePoint, float value)
 	return Process(0, samplePoint, value);
 }
 
+void ProceduralNoise3D::CompilePipeline(const SkeletonNodeHandle nodeHandle, std::vector<const ProceduralNoiseStage<glm::vec3>*>& stages) const
+{
+	//Same order as the recursive Process: a parent is applied after each of its children.
+	const auto& node = m_pipeline.PeekNode(nodeHandle);
+	const auto& childHandles = node.PeekChildHandles();
+	if (!childHandles.empty()) {
+		for (const auto& childHandle : childHandles)
+		{
+			CompilePipeline(childHandle, stages);
+			stages.emplace_back(&node.m_data);
+		}
+	}
+	else {
+		stages.emplace_back(&node.m_data);
+	}
+}
+
+void ProceduralNoise3D::Process(const std::vector<glm::vec3>& samplePoints, std::vector<float>& values)
+{
+	values.resize(samplePoints.size(), 0.f);
+	if (m_pipeline.RefRawNodes().empty() || m_pipeline.PeekNode(0).IsRecycled())
+	{
+		EVOENGINE_WARNING("Pipeline is empty!");
+		return;
+	}
+	std::vector<const ProceduralNoiseStage<glm::vec3>*> stages;
+	CompilePipeline(0, stages);
+	//Blocks keep the values and the stage scratch in cache while every stage passes over them.
+	constexpr size_t blockSize = 1024;
+	std::vector<float> stageValues(glm::min(blockSize, samplePoints.size()));
+	for (size_t blockStart = 0; blockStart < samplePoints.size(); blockStart += blockSize)
+	{
+		const auto size = glm::min(blockSize, samplePoints.size() - blockStart);
+		for (const auto* stage : stages) stage->Calculate(&samplePoints[blockStart], &values[blockStart], size, stageValues.data());
+	}
+}
+
 
 
 
@@ -23,6 +23,179 @@ int orientation(const glm::vec2& p, const glm::vec2& q, const glm::vec2& r)
 	return (val > 0) ? 1 : 2; // clock or counterclock wise 
 }
 
+int ProfileSegmentGrid::GetCellIndex(const glm::vec2& position) const
+{
+	const auto coordinate = glm::ivec2(glm::floor((position - m_minBound) / m_cellSize));
+	if (coordinate.x < 0 || coordinate.y < 0 || coordinate.x >= m_resolution.x || coordinate.y >= m_resolution.y) return -1;
+	return coordinate.x + coordinate.y * m_resolution.x;
+}
+
+glm::vec2 ProfileSegmentGrid::GetCellCenter(const int cellIndex) const
+{
+	return m_minBound + (glm::vec2(cellIndex % m_resolution.x, cellIndex / m_resolution.x) + 0.5f) * m_cellSize;
+}
+
+void ProfileSegmentGrid::Build(const std::vector<std::pair<glm::vec2, glm::vec2>>& segments, const bool closed, const unsigned resolution)
+{
+	Clear();
+	if (segments.empty() || resolution == 0) return;
+	m_segments = segments;
+	m_closed = closed;
+	auto min = glm::vec2(FLT_MAX);
+	auto max = glm::vec2(-FLT_MAX);
+	for (const auto& segment : m_segments)
+	{
+		min = glm::min(min, glm::min(segment.first, segment.second));
+		max = glm::max(max, glm::max(segment.first, segment.second));
+	}
+	const float extent = glm::max(max.x - min.x, max.y - min.y);
+	if (extent <= 0.0f)
+	{
+		Clear();
+		return;
+	}
+	m_cellSize = extent / static_cast<float>(resolution);
+	m_minBound = min - extent * 0.5f;
+	m_resolution = glm::ivec2(glm::ceil((max - min + extent) / m_cellSize));
+	const auto cellCount = m_resolution.x * m_resolution.y;
+	//Any point of a cell is within this distance of its center, with some slack for rounding.
+	const float cellRadius = m_cellSize * 0.75f;
+
+	m_centerInside.resize(cellCount, 0);
+	std::vector<std::vector<unsigned>> rowCandidates(m_resolution.y);
+	std::vector<unsigned> cellCandidateCounts(cellCount, 0);
+	Jobs::RunParallelFor(m_resolution.y, [&](unsigned y)
+		{
+			std::vector<float> distances(m_segments.size());
+			std::vector<float> crossings;
+			if (m_closed)
+			{
+				//Even-odd rule along the row through the cell centers.
+				const float rowY = m_minBound.y + (static_cast<float>(y) + 0.5f) * m_cellSize;
+				for (const auto& [p1, p2] : m_segments)
+				{
+					if ((p1.y > rowY) == (p2.y > rowY)) continue;
+					crossings.emplace_back(p1.x + (rowY - p1.y) * (p2.x - p1.x) / (p2.y - p1.y));
+				}
+				std::sort(crossings.begin(), crossings.end());
+			}
+			auto& candidates = rowCandidates[y];
+			size_t crossingIndex = 0;
+			for (int x = 0; x < m_resolution.x; x++)
+			{
+				const int cellIndex = x + static_cast<int>(y) * m_resolution.x;
+				const auto center = GetCellCenter(cellIndex);
+				if (m_closed)
+				{
+					while (crossingIndex < crossings.size() && crossings[crossingIndex] < center.x) crossingIndex++;
+					m_centerInside[cellIndex] = crossingIndex % 2 != 0 ? 1 : 0;
+				}
+				auto closestDistance = FLT_MAX;
+				for (size_t segmentIndex = 0; segmentIndex < m_segments.size(); segmentIndex++)
+				{
+					const auto& [p1, p2] = m_segments[segmentIndex];
+					distances[segmentIndex] = glm::distance(glm::closestPointOnLine(center, p1, p2), center);
+					closestDistance = glm::min(closestDistance, distances[segmentIndex]);
+				}
+				//A segment further than this from the center can't be the closest one for any point of the cell.
+				const float threshold = closestDistance + 2.0f * cellRadius;
+				for (size_t segmentIndex = 0; segmentIndex < m_segments.size(); segmentIndex++)
+				{
+					if (distances[segmentIndex] > threshold) continue;
+					candidates.emplace_back(segmentIndex);
+					cellCandidateCounts[cellIndex]++;
+				}
+			}
+		}
+	);
+	m_candidateOffsets.resize(cellCount + 1);
+	m_candidateOffsets[0] = 0;
+	for (int cellIndex = 0; cellIndex < cellCount; cellIndex++)
+	{
+		m_candidateOffsets[cellIndex + 1] = m_candidateOffsets[cellIndex] + cellCandidateCounts[cellIndex];
+	}
+	m_candidates.reserve(m_candidateOffsets.back());
+	for (const auto& candidates : rowCandidates) m_candidates.insert(m_candidates.end(), candidates.begin(), candidates.end());
+}
+
+void ProfileSegmentGrid::Clear()
+{
+	m_resolution = glm::ivec2(0);
+	m_segments.clear();
+	m_centerInside.clear();
+	m_candidateOffsets.clear();
+	m_candidates.clear();
+}
+
+bool ProfileSegmentGrid::Empty() const
+{
+	return m_candidateOffsets.empty();
+}
+
+size_t ProfileSegmentGrid::GetSegmentCount() const
+{
+	return m_segments.size();
+}
+
+bool ProfileSegmentGrid::FindClosestPoint(const glm::vec2& position, glm::vec2& closestPoint) const
+{
+	if (Empty()) return false;
+	const auto cellIndex = GetCellIndex(position);
+	if (cellIndex == -1) return false;
+	//Candidates are in segment order, so ties resolve like a full scan.
+	auto distance = FLT_MAX;
+	closestPoint = glm::vec2(0.0f);
+	for (auto i = m_candidateOffsets[cellIndex]; i < m_candidateOffsets[cellIndex + 1]; i++)
+	{
+		const auto& [p1, p2] = m_segments[m_candidates[i]];
+		const auto testPoint = glm::closestPointOnLine(position, p1, p2);
+		const auto newDistance = glm::distance(testPoint, position);
+		if (distance > newDistance)
+		{
+			distance = newDistance;
+			closestPoint = testPoint;
+		}
+	}
+	return true;
+}
+
+bool ProfileSegmentGrid::InBoundary(const glm::vec2& position, bool& inBoundary) const
+{
+	if (Empty() || !m_closed) return false;
+	const auto cellIndex = GetCellIndex(position);
+	if (cellIndex == -1) return false;
+	//Start from the cell center and flip for every segment crossed on the way to the position.
+	//Those segments are within the cell radius of the center, so they are all candidates.
+	const auto center = GetCellCenter(cellIndex);
+	const auto side = [](const glm::vec2& a, const glm::vec2& b, const glm::vec2& c)
+		{
+			return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x) > 0.0f;
+		};
+	bool inside = m_centerInside[cellIndex] != 0;
+	const float epsilon = m_cellSize * 1e-4f;
+	for (auto i = m_candidateOffsets[cellIndex]; i < m_candidateOffsets[cellIndex + 1]; i++)
+	{
+		const auto& [p1, p2] = m_segments[m_candidates[i]];
+		//Positions on a segment, or paths that graze a vertex, are left to the full scan.
+		if (glm::distance(glm::closestPointOnLine(position, p1, p2), position) < epsilon
+			|| glm::distance(glm::closestPointOnLine(p1, center, position), p1) < epsilon
+			|| glm::distance(glm::closestPointOnLine(p2, center, position), p2) < epsilon) return false;
+		if (side(center, position, p1) != side(center, position, p2) && side(p1, p2, center) != side(p1, p2, position)) inside = !inside;
+	}
+	inBoundary = inside;
+	return true;
+}
+
+bool ProfileSegmentGrid::GetSignedDistance(const glm::vec2& position, float& signedDistance) const
+{
+	glm::vec2 closestPoint;
+	if (!FindClosestPoint(position, closestPoint)) return false;
+	signedDistance = glm::distance(closestPoint, position);
+	bool inside = false;
+	if (InBoundary(position, inside) && inside) signedDistance = -signedDistance;
+	return true;
+}
+
 void ProfileBoundary::CalculateCenter()
 {
 	m_center = glm::vec2(0.0f);
@@ -74,6 +247,10 @@ void ProfileAttractor::RenderAttractor(ImVec2 origin, float zoomFactor, ImDrawLi
 
 glm::vec2 ProfileAttractor::FindClosestPoint(const glm::vec2& position) const
 {
+	if (glm::vec2 closestPoint; m_segmentGrid.GetSegmentCount() == m_attractorPoints.size() && m_segmentGrid.FindClosestPoint(position, closestPoint))
+	{
+		return closestPoint;
+	}
 	auto distance = FLT_MAX;
 	auto retVal = glm::vec2(0.0f);
 	for (const auto& attractorPoint : m_attractorPoints)
@@ -91,6 +268,11 @@ glm::vec2 ProfileAttractor::FindClosestPoint(const glm::vec2& position) const
 	return retVal;
 }
 
+void ProfileAttractor::BuildSegmentGrid(const unsigned resolution)
+{
+	m_segmentGrid.Build(m_attractorPoints, false, resolution);
+}
+
 bool ProfileBoundary::BoundaryValid() const
 {
 	if (m_points.size() <= 3) return false;
@@ -116,6 +298,10 @@ bool ProfileBoundary::BoundaryValid() const
 
 bool ProfileBoundary::InBoundary(const glm::vec2& position) const
 {
+	if (bool inBoundary; m_segmentGrid.GetSegmentCount() == m_points.size() && m_segmentGrid.InBoundary(position, inBoundary))
+	{
+		return inBoundary;
+	}
 	auto distance = FLT_MAX;
 	int intersectCount1 = 0;
 	int intersectCount2 = 0;
@@ -156,6 +342,11 @@ bool ProfileBoundary::InBoundary(const glm::vec2& position) const
 
 bool ProfileBoundary::InBoundary(const glm::vec2& position, glm::vec2& closestPoint) const
 {
+	if (bool inBoundary; m_segmentGrid.GetSegmentCount() == m_points.size()
+		&& m_segmentGrid.InBoundary(position, inBoundary) && m_segmentGrid.FindClosestPoint(position, closestPoint))
+	{
+		return inBoundary;
+	}
 	closestPoint = glm::vec2(0.0f);
 	auto distance = FLT_MAX;
 	int intersectCount1 = 0;
@@ -225,6 +416,16 @@ bool ProfileBoundary::Intersect(const glm::vec2& p1, const glm::vec2& q1, const
 	return false; // Doesn't fall in any of the above cases 
 }
 
+void ProfileBoundary::BuildSegmentGrid(const unsigned resolution)
+{
+	std::vector<std::pair<glm::vec2, glm::vec2>> segments(m_points.size());
+	for (int lineIndex = 0; lineIndex < m_points.size(); lineIndex++)
+	{
+		segments[lineIndex] = { m_points[lineIndex], m_points[(lineIndex + 1) % m_points.size()] };
+	}
+	m_segmentGrid.Build(segments, true, resolution);
+}
+
 int ProfileConstraints::FindBoundary(const glm::vec2& position) const
 {
 	int retVal = -1;
@@ -338,4 +539,10 @@ glm::vec2 ProfileConstraints::GetTarget(const glm::vec2& position) const
 		}
 	}
 	return closestPoint - position;
-}
\ No newline at end of file
+}
+
+void ProfileConstraints::BuildSegmentGrids(const unsigned resolution)
+{
+	for (auto& boundary : m_boundaries) boundary.BuildSegmentGrid(resolution);
+	for (auto& attractor : m_attractors) attractor.BuildSegmentGrid(resolution);
+}
@@ -26,14 +26,14 @@ void ShootDescriptor::PrepareController(ShootGrowthController& shootGrowthContro
 		};
 	shootGrowthController.m_baseNodeApicalAngle = [&](const SkeletonNode<InternodeGrowthData>& internode)
 		{
-			return glm::gaussRand(m_baseNodeApicalAngleMeanVariance.x, m_baseNodeApicalAngleMeanVariance.y);
+			return TreeRandomScope::GaussRand(m_baseNodeApicalAngleMeanVariance.x, m_baseNodeApicalAngleMeanVariance.y);
 		};
 
 	shootGrowthController.m_internodeGrowthRate = m_growthRate / m_internodeLength;
 
 	shootGrowthController.m_branchingAngle = [&](const SkeletonNode<InternodeGrowthData>& internode)
 		{
-			float value = glm::gaussRand(m_branchingAngleMeanVariance.x, m_branchingAngleMeanVariance.y);
+			float value = TreeRandomScope::GaussRand(m_branchingAngleMeanVariance.x, m_branchingAngleMeanVariance.y);
 		/*
 			if(const auto noise = m_branchingAngle.Get<ProceduralNoise2D>())
 			{
@@ -43,7 +43,7 @@ void ShootDescriptor::PrepareController(ShootGrowthController& shootGrowthContro
 		};
 	shootGrowthController.m_rollAngle = [&](const SkeletonNode<InternodeGrowthData>& internode)
 		{
-			float value = glm::gaussRand(m_rollAngleMeanVariance.x, m_rollAngleMeanVariance.y);
+			float value = TreeRandomScope::GaussRand(m_rollAngleMeanVariance.x, m_rollAngleMeanVariance.y);
 		/*
 			if (const auto noise = m_rollAngle.Get<ProceduralNoise2D>())
 			{
@@ -55,7 +55,7 @@ void ShootDescriptor::PrepareController(ShootGrowthController& shootGrowthContro
 	shootGrowthController.m_apicalAngle = [&](const SkeletonNode<InternodeGrowthData>& internode)
 		{
 			if (m_straightTrunk != 0.f && internode.m_data.m_order == 0 && internode.m_info.m_rootDistance < m_straightTrunk) return 0.f;
-			float value = glm::gaussRand(m_apicalAngleMeanVariance.x, m_apicalAngleMeanVariance.y);
+			float value = TreeRandomScope::GaussRand(m_apicalAngleMeanVariance.x, m_apicalAngleMeanVariance.y);
 		/*
 			if (const auto noise = m_apicalAngle.Get<ProceduralNoise2D>())
 			{
@@ -1,63 +1,90 @@
 //
 // Created by lllll on 2/23/2022.
 //
-#include "rapidcsv.h"
 #include "SkyIlluminance.hpp"
 #ifdef BUILD_WITH_RAYTRACER
 #include "RayTracerLayer.hpp"
 #endif
 
-using namespace EcoSysLab; SkyIlluminanceSnapshot
-SkyIlluminanceSnapshotLerp(const SkyIlluminanceSnapshot& l,
-	const SkyIlluminanceSnapshot& r, float a) {
-	if (a < 0.0f)
-		return l;
-	if (a > 1.0f)
-		return r;
+using namespace EcoSysLab;
+
+constexpr int SKY_GHI_INDEX = 0;
+constexpr int SKY_AZIMUTH_INDEX = 1;
+constexpr int SKY_ZENITH_INDEX = 2;
+
+void SkyIlluminance::UpdateForcing() {
+	m_forcing.Clear();
+	if (m_snapshots.empty()) return;
+	std::vector<float> times, ghi, azimuth, zenith;
+	for (const auto& [time, snapshot] : m_snapshots) {
+		times.emplace_back(time);
+		ghi.emplace_back(snapshot.m_ghi);
+		azimuth.emplace_back(snapshot.m_azimuth);
+		zenith.emplace_back(snapshot.m_zenith);
+	}
+	ClimateTimeSeries::UnwrapDegrees(azimuth);
+	m_forcing.SetVariable("Ghi", times, ghi);
+	m_forcing.SetVariable("Azimuth", times, azimuth);
+	m_forcing.SetVariable("Zenith", times, zenith);
+}
+
+SkyIlluminanceSnapshot SkyIlluminance::Get(const float time) {
+	if (m_snapshots.empty()) {
+		return {};
+	}
+	if (m_forcing.Empty()) UpdateForcing();
 	SkyIlluminanceSnapshot snapshot;
-	snapshot.m_ghi = l.m_ghi * a + r.m_ghi * (1.0f - a);
-	snapshot.m_azimuth = l.m_azimuth * a + r.m_azimuth * (1.0f - a);
-	snapshot.m_zenith = l.m_zenith * a + r.m_zenith * (1.0f - a);
+	snapshot.m_ghi = m_forcing.Sample(SKY_GHI_INDEX, time);
+	snapshot.m_azimuth = m_forcing.Sample(SKY_AZIMUTH_INDEX, time);
+	snapshot.m_zenith = m_forcing.Sample(SKY_ZENITH_INDEX, time);
 	return snapshot;
 }
 
-SkyIlluminanceSnapshot SkyIlluminance::Get(float time) {
+void SkyIlluminance::Get(const std::vector<float>& times, std::vector<SkyIlluminanceSnapshot>& snapshots) {
+	snapshots.resize(times.size());
 	if (m_snapshots.empty()) {
-		return {};
+		std::fill(snapshots.begin(), snapshots.end(), SkyIlluminanceSnapshot{});
+		return;
 	}
-	if (time <= m_snapshots.begin()->first)
-		return m_snapshots.begin()->second;
-	SkyIlluminanceSnapshot lastShot;
-	lastShot = m_snapshots.begin()->second;
-	float lastTime = m_snapshots.begin()->first;
-	for (const auto& pair : m_snapshots) {
-		if (time < pair.first) {
-			if (pair.first - lastTime == 0)
-				return lastShot;
-			return SkyIlluminanceSnapshotLerp(
-				lastShot, pair.second, (time - lastTime) / (pair.first - lastTime));
-		}
-		lastShot = pair.second;
-		lastTime = pair.first;
+	if (m_forcing.Empty()) UpdateForcing();
+	std::vector<float> ghi, azimuth, zenith;
+	m_forcing.Sample(SKY_GHI_INDEX, times, ghi);
+	m_forcing.Sample(SKY_AZIMUTH_INDEX, times, azimuth);
+	m_forcing.Sample(SKY_ZENITH_INDEX, times, zenith);
+	for (size_t i = 0; i < times.size(); i++) {
+		snapshots[i].m_ghi = ghi[i];
+		snapshots[i].m_azimuth = azimuth[i];
+		snapshots[i].m_zenith = zenith[i];
 	}
-	return std::prev(m_snapshots.end())->second;
 }
+
 void SkyIlluminance::ImportCSV(const std::filesystem::path& path) {
-	rapidcsv::Document doc(path.string());
-	std::vector<float> timeSeries = doc.GetColumn<float>("Time");
-	std::vector<float> ghiSeries = doc.GetColumn<float>("SunLightDensity");
-	std::vector<float> azimuthSeries = doc.GetColumn<float>("Azimuth");
-	std::vector<float> zenithSeries = doc.GetColumn<float>("Zenith");
-	assert(timeSeries.size() == ghiSeries.size() && azimuthSeries.size() == zenithSeries.size() && timeSeries.size() == azimuthSeries.size());
+	std::vector<std::string> columnNames;
+	std::vector<std::vector<float>> columns;
+	if (!ClimateForcing::ReadCSV(path, columnNames, columns)) return;
+	const auto findColumn = [&](const std::string& name) {
+		const auto it = std::find(columnNames.begin(), columnNames.end(), name);
+		if (it == columnNames.end()) {
+			EVOENGINE_ERROR("Missing column " + name + " in " + path.string());
+			return -1;
+		}
+		return static_cast<int>(it - columnNames.begin());
+	};
+	const int timeIndex = findColumn("Time");
+	const int ghiIndex = findColumn("SunLightDensity");
+	const int azimuthIndex = findColumn("Azimuth");
+	const int zenithIndex = findColumn("Zenith");
+	if (timeIndex == -1 || ghiIndex == -1 || azimuthIndex == -1 || zenithIndex == -1) return;
 	m_snapshots.clear();
 	m_maxTime = 0;
 	m_minTime = 999999;
-	for (int i = 0; i < timeSeries.size(); i++) {
+	for (size_t i = 0; i < columns[timeIndex].size(); i++) {
+		const auto time = columns[timeIndex][i];
+		if (std::isnan(time)) continue;
 		SkyIlluminanceSnapshot snapshot;
-		snapshot.m_ghi = ghiSeries[i];
-		snapshot.m_azimuth = azimuthSeries[i];
-		snapshot.m_zenith = zenithSeries[i];
-		auto time = timeSeries[i];
+		snapshot.m_ghi = columns[ghiIndex][i];
+		snapshot.m_azimuth = columns[azimuthIndex][i];
+		snapshot.m_zenith = columns[zenithIndex][i];
 		m_snapshots[time] = snapshot;
 		if (m_maxTime < time) {
 			m_maxTime = time;
@@ -66,7 +93,7 @@ void SkyIlluminance::ImportCSV(const std::filesystem::path& path) {
 			m_minTime = time;
 		}
 	}
-
+	UpdateForcing();
 }
 bool SkyIlluminance::OnInspect(const std::shared_ptr<EditorLayer>& editorLayer) {
 
@@ -123,6 +150,7 @@ void SkyIlluminance::Deserialize(const YAML::Node& in) {
 			m_snapshots[data["time"].as<float>()] = snapshot;
 		}
 	}
+	UpdateForcing();
 }
 
 glm::vec3 SkyIlluminanceSnapshot::GetSunDirection() {
@@ -332,6 +332,19 @@ bool Soil::OnInspect(const std::shared_ptr<EditorLayer>& editorLayer)
 		if (ImGui::Button("Generate surface mesh")) {
 			GenerateMesh();
 		}
+		if (ImGui::TreeNode("Tiled surface mesh"))
+		{
+			ImGui::DragFloat("Tile size", &m_groundTileSize, 0.1f, 0.1f, 100.0f);
+			ImGui::DragInt("Tile resolution", &m_groundTileResolution, 1, 1, 256);
+			ImGui::DragFloat("LOD distance", &m_groundLodDistance, 0.1f, 0.1f, 100.0f);
+			ImGui::DragInt("Max LOD", &m_groundMaxLod, 1, 0, 8);
+			const auto globalTransform = Application::GetActiveScene()->GetDataComponent<GlobalTransform>(GetOwner()).m_value;
+			const auto viewPosition = glm::vec3(glm::inverse(globalTransform) * glm::vec4(editorLayer->GetSceneCameraPosition(), 1.0f));
+			if (ImGui::Button("Generate tiled surface mesh")) GenerateTiledMesh(viewPosition, true);
+			ImGui::Checkbox("LOD follows camera", &m_groundLodFollowCamera);
+			if (m_groundLodFollowCamera) GenerateTiledMesh(viewPosition, false);
+			ImGui::TreePop();
+		}
 		// Show some general properties:
 
 		static float xDepth = 1;
@@ -602,54 +615,35 @@ void Soil::RandomOffset(float min, float max)
 	if (const auto soilDescriptor = m_soilDescriptor.Get<SoilDescriptor>())
 	{
 		soilDescriptor->RandomOffset(min, max);
+		m_groundTiles.MarkAllDirty();
 	}
 }
 
 Entity Soil::GenerateSurfaceQuadX(bool backFacing, float depth, const glm::vec2& minXY, const glm::vec2 maxXY, float waterFactor, float nutrientFactor)
 {
-	auto scene = Application::GetActiveScene();
-	auto quadEntity = scene->CreateEntity("Slice");
-	auto material = ProjectManager::CreateTemporaryAsset<Material>();
-	auto albedoTex = ProjectManager::CreateTemporaryAsset<Texture2D>();
-	auto normalTex = ProjectManager::CreateTemporaryAsset<Texture2D>();
-	auto metallicTex = ProjectManager::CreateTemporaryAsset<Texture2D>();
-	auto roughnessTex = ProjectManager::CreateTemporaryAsset<Texture2D>();
-	std::vector<glm::vec4> albedoData;
-	std::vector<glm::vec3> normalData;
-	std::vector<float> metallicData;
-	std::vector<float> roughnessData;
-	glm::ivec2 textureResolution;
-	m_soilModel.GetSoilTextureSlideX(backFacing, depth, minXY, maxXY, albedoData, normalData, roughnessData, metallicData, textureResolution, waterFactor, nutrientFactor);
-	albedoTex->SetRgbaChannelData(albedoData, textureResolution);
-	normalTex->SetRgbChannelData(normalData, textureResolution);
-	metallicTex->SetRedChannelData(metallicData, textureResolution);
-	roughnessTex->SetRedChannelData(roughnessData, textureResolution);
-	material->SetAlbedoTexture(albedoTex);
-	material->SetNormalTexture(normalTex);
-	material->SetMetallicTexture(metallicTex);
-	material->SetRoughnessTexture(roughnessTex);
-	const auto meshRenderer = scene->GetOrSetPrivateComponent<MeshRenderer>(quadEntity).lock();
-	meshRenderer->m_material = material;
-	material->m_drawSettings.m_cullMode = VK_CULL_MODE_NONE;
-	meshRenderer->m_mesh = Resources::GetResource<Mesh>("PRIMITIVE_QUAD");
-
-	GlobalTransform globalTransform;
-	glm::vec3 scale;
-	glm::vec3 position;
-	glm::vec3 rotation;
-	auto soilModelSize = glm::vec3(m_soilModel.m_resolution) * m_soilModel.m_dx;
-
-	scale = glm::vec3(soilModelSize.z * (maxXY.x - minXY.x), 1.0f, soilModelSize.y * (maxXY.y - minXY.y));
-	rotation = glm::vec3(glm::radians(90.0f), glm::radians(backFacing ? 90.0f : -90.0f), 0.0f);
-	position = m_soilModel.m_boundingBoxMin + glm::vec3(soilModelSize.x * depth, soilModelSize.y * (minXY.y + maxXY.y) * 0.5f, soilModelSize.z * (minXY.x + maxXY.x) * 0.5f);
-	globalTransform.SetPosition(position);
-	globalTransform.SetEulerRotation(rotation);
-	globalTransform.SetScale(scale);
-	scene->SetDataComponent(quadEntity, globalTransform);
-	return quadEntity;
+	std::vector<VoxelSoilModel::SoilTextureSlice> slices(1);
+	slices[0].m_alongX = true;
+	slices[0].m_backFacing = backFacing;
+	slices[0].m_depth = depth;
+	slices[0].m_min = minXY;
+	slices[0].m_max = maxXY;
+	m_soilModel.GetSoilTextureSlides(slices, waterFactor, nutrientFactor);
+	return GenerateSurfaceQuad(slices[0]);
 }
 
 Entity Soil::GenerateSurfaceQuadZ(bool backFacing, float depth, const glm::vec2& minXY, const glm::vec2 maxXY, float waterFactor, float nutrientFactor)
+{
+	std::vector<VoxelSoilModel::SoilTextureSlice> slices(1);
+	slices[0].m_alongX = false;
+	slices[0].m_backFacing = backFacing;
+	slices[0].m_depth = depth;
+	slices[0].m_min = minXY;
+	slices[0].m_max = maxXY;
+	m_soilModel.GetSoilTextureSlides(slices, waterFactor, nutrientFactor);
+	return GenerateSurfaceQuad(slices[0]);
+}
+
+Entity Soil::GenerateSurfaceQuad(const VoxelSoilModel::SoilTextureSlice& slice)
 {
 	auto scene = Application::GetActiveScene();
 	auto quadEntity = scene->CreateEntity("Slice");
@@ -660,22 +654,15 @@ Entity Soil::GenerateSurfaceQuadZ(bool backFacing, float depth, const glm::vec2&
 	auto normalTex = ProjectManager::CreateTemporaryAsset<Texture2D>();
 	auto metallicTex = ProjectManager::CreateTemporaryAsset<Texture2D>();
 	auto roughnessTex = ProjectManager::CreateTemporaryAsset<Texture2D>();
-	std::vector<glm::vec4> albedoData;
-	std::vector<glm::vec3> normalData;
-	std::vector<float> metallicData;
-	std::vector<float> roughnessData;
-	glm::ivec2 textureResolution;
-	m_soilModel.GetSoilTextureSlideZ(backFacing, depth, minXY, maxXY, albedoData, normalData, roughnessData, metallicData, textureResolution, waterFactor, nutrientFactor);
-	albedoTex->SetRgbaChannelData(albedoData, textureResolution);
-	normalTex->SetRgbChannelData(normalData, textureResolution);
-	metallicTex->SetRedChannelData(metallicData, textureResolution);
-	roughnessTex->SetRedChannelData(roughnessData, textureResolution);
+	albedoTex->SetRgbaChannelData(slice.m_albedoData, slice.m_outputResolution);
+	normalTex->SetRgbChannelData(slice.m_normalData, slice.m_outputResolution);
+	metallicTex->SetRedChannelData(slice.m_metallicData, slice.m_outputResolution);
+	roughnessTex->SetRedChannelData(slice.m_roughnessData, slice.m_outputResolution);
 	material->SetAlbedoTexture(albedoTex);
 	material->SetNormalTexture(normalTex);
 	material->SetMetallicTexture(metallicTex);
 	material->SetRoughnessTexture(roughnessTex);
 
-
 	meshRenderer->m_material = material;
 	material->m_drawSettings.m_cullMode = VK_CULL_MODE_NONE;
 	meshRenderer->m_mesh = Resources::GetResource<Mesh>("PRIMITIVE_QUAD");
@@ -685,11 +672,21 @@ Entity Soil::GenerateSurfaceQuadZ(bool backFacing, float depth, const glm::vec2&
 	glm::vec3 position;
 	glm::vec3 rotation;
 	auto soilModelSize = glm::vec3(m_soilModel.m_resolution) * m_soilModel.m_dx;
-
-	scale = glm::vec3(soilModelSize.x * (maxXY.x - minXY.x), 1.0f, soilModelSize.y * (maxXY.y - minXY.y));
-	rotation = glm::vec3(glm::radians(90.0f), glm::radians(backFacing ? 180.0f : 0.0f), 0.0f);
-	position = m_soilModel.m_boundingBoxMin + glm::vec3(soilModelSize.x * (minXY.x + maxXY.x) * 0.5f, soilModelSize.y * (minXY.y + maxXY.y) * 0.5f, soilModelSize.z * depth);
-
+	const auto& minXY = slice.m_min;
+	const auto& maxXY = slice.m_max;
+	const auto depth = slice.m_depth;
+	if (slice.m_alongX)
+	{
+		scale = glm::vec3(soilModelSize.z * (maxXY.x - minXY.x), 1.0f, soilModelSize.y * (maxXY.y - minXY.y));
+		rotation = glm::vec3(glm::radians(90.0f), glm::radians(slice.m_backFacing ? 90.0f : -90.0f), 0.0f);
+		position = m_soilModel.m_boundingBoxMin + glm::vec3(soilModelSize.x * depth, soilModelSize.y * (minXY.y + maxXY.y) * 0.5f, soilModelSize.z * (minXY.x + maxXY.x) * 0.5f);
+	}
+	else
+	{
+		scale = glm::vec3(soilModelSize.x * (maxXY.x - minXY.x), 1.0f, soilModelSize.y * (maxXY.y - minXY.y));
+		rotation = glm::vec3(glm::radians(90.0f), glm::radians(slice.m_backFacing ? 180.0f : 0.0f), 0.0f);
+		position = m_soilModel.m_boundingBoxMin + glm::vec3(soilModelSize.x * (minXY.x + maxXY.x) * 0.5f, soilModelSize.y * (minXY.y + maxXY.y) * 0.5f, soilModelSize.z * depth);
+	}
 	globalTransform.SetPosition(position);
 	globalTransform.SetEulerRotation(rotation);
 	globalTransform.SetScale(scale);
@@ -697,27 +694,38 @@ Entity Soil::GenerateSurfaceQuadZ(bool backFacing, float depth, const glm::vec2&
 	return quadEntity;
 }
 
+void Soil::GenerateSurfaceQuads(std::vector<VoxelSoilModel::SoilTextureSlice>& slices, const float waterFactor, const float nutrientFactor, const Entity parent)
+{
+	const auto scene = Application::GetActiveScene();
+	m_soilModel.GetSoilTextureSlides(slices, waterFactor, nutrientFactor);
+	for (const auto& slice : slices)
+	{
+		const auto quad = GenerateSurfaceQuad(slice);
+		scene->SetParent(quad, parent);
+	}
+}
+
 Entity Soil::GenerateCutOut(float xDepth, float zDepth, float waterFactor, float nutrientFactor, bool groundSurface)
 {
 	auto scene = Application::GetActiveScene();
 	auto combinedEntity = scene->CreateEntity("CutOut");
 
-	if (zDepth <= 0.99f) {
-		auto quad1 = GenerateSurfaceQuadX(false, 0, { 0, 0 }, { 1.0 - zDepth , 1 }, waterFactor, nutrientFactor);
-		scene->SetParent(quad1, combinedEntity);
-	}
-	if (zDepth >= 0.01f && xDepth <= 0.99f) {
-		auto quad2 = GenerateSurfaceQuadX(true, xDepth, { 1.0 - zDepth, 0 }, { 1 , 1 }, waterFactor, nutrientFactor);
-		scene->SetParent(quad2, combinedEntity);
-	}
-	if (xDepth >= 0.01f) {
-		auto quad3 = GenerateSurfaceQuadZ(false, 1.0 - zDepth, { 0, 0 }, { xDepth , 1 }, waterFactor, nutrientFactor);
-		scene->SetParent(quad3, combinedEntity);
-	}
-	if (xDepth <= 0.99f) {
-		auto quad4 = GenerateSurfaceQuadZ(true, 1.0, { xDepth, 0 }, { 1 , 1 }, waterFactor, nutrientFactor);
-		scene->SetParent(quad4, combinedEntity);
-	}
+	// all cut faces are rendered in one pass.
+	std::vector<VoxelSoilModel::SoilTextureSlice> slices;
+	const auto addSlice = [&](const bool alongX, const bool backFacing, const float depth, const glm::vec2& minXY, const glm::vec2& maxXY)
+		{
+			auto& slice = slices.emplace_back();
+			slice.m_alongX = alongX;
+			slice.m_backFacing = backFacing;
+			slice.m_depth = depth;
+			slice.m_min = minXY;
+			slice.m_max = maxXY;
+		};
+	if (zDepth <= 0.99f) addSlice(true, false, 0, { 0, 0 }, { 1.0 - zDepth , 1 });
+	if (zDepth >= 0.01f && xDepth <= 0.99f) addSlice(true, true, xDepth, { 1.0 - zDepth, 0 }, { 1 , 1 });
+	if (xDepth >= 0.01f) addSlice(false, false, 1.0 - zDepth, { 0, 0 }, { xDepth , 1 });
+	if (xDepth <= 0.99f) addSlice(false, true, 1.0, { xDepth, 0 }, { 1 , 1 });
+	GenerateSurfaceQuads(slices, waterFactor, nutrientFactor, combinedEntity);
 
 
 
@@ -752,19 +760,20 @@ Entity Soil::GenerateFullBox(float waterFactor, float nutrientFactor, bool groun
 	auto combinedEntity = scene->CreateEntity("Cube");
 
 
-	auto quad1 = GenerateSurfaceQuadX(false, 0, { 0, 0 }, { 1 , 1 }, waterFactor, nutrientFactor);
-	scene->SetParent(quad1, combinedEntity);
-
-
-	auto quad2 = GenerateSurfaceQuadX(true, 1, { 0, 0 }, { 1 , 1 }, waterFactor, nutrientFactor);
-	scene->SetParent(quad2, combinedEntity);
-
-
-	auto quad3 = GenerateSurfaceQuadZ(true, 0, { 0, 0 }, { 1 , 1 }, waterFactor, nutrientFactor);
-	scene->SetParent(quad3, combinedEntity);
-
-	auto quad4 = GenerateSurfaceQuadZ(false, 1, { 0, 0 }, { 1 , 1 }, waterFactor, nutrientFactor);
-	scene->SetParent(quad4, combinedEntity);
+	std::vector<VoxelSoilModel::SoilTextureSlice> slices(4);
+	slices[0].m_alongX = true;
+	slices[0].m_backFacing = false;
+	slices[0].m_depth = 0;
+	slices[1].m_alongX = true;
+	slices[1].m_backFacing = true;
+	slices[1].m_depth = 1;
+	slices[2].m_alongX = false;
+	slices[2].m_backFacing = true;
+	slices[2].m_depth = 0;
+	slices[3].m_alongX = false;
+	slices[3].m_backFacing = false;
+	slices[3].m_depth = 1;
+	GenerateSurfaceQuads(slices, waterFactor, nutrientFactor, combinedEntity);
 
 	if (groundSurface) {
 		auto groundSurface = GenerateMesh(0, 0);
@@ -826,7 +835,48 @@ Entity Soil::GenerateMesh(float xDepth, float zDepth)
 	heightField->GenerateMesh(glm::vec2(soilDescriptor->m_soilParameters.m_boundingBoxMin.x, soilDescriptor->m_soilParameters.m_boundingBoxMin.z),
 		glm::uvec2(soilDescriptor->m_soilParameters.m_voxelResolution.x, soilDescriptor->m_soilParameters.m_voxelResolution.z), soilDescriptor->m_soilParameters.m_deltaX, vertices, triangles
 		, xDepth, zDepth);
+	return SetGroundMesh(vertices, triangles);
+}
+
+Entity Soil::GenerateTiledMesh(const glm::vec3& viewPosition, const bool rebuild)
+{
+	const auto soilDescriptor = m_soilDescriptor.Get<SoilDescriptor>();
+	if (!soilDescriptor)
+	{
+		EVOENGINE_ERROR("No soil descriptor!");
+		return {};
+	}
+	const auto heightField = soilDescriptor->m_heightField.Get<HeightField>();
+	if (!heightField)
+	{
+		EVOENGINE_ERROR("No height field!");
+		return {};
+	}
+	const auto& soilParameters = soilDescriptor->m_soilParameters;
+	if (rebuild || m_groundTiles.PeekTiles().empty())
+	{
+		//Cover the same area as GenerateMesh.
+		const auto start = glm::vec2(soilParameters.m_boundingBoxMin.x, soilParameters.m_boundingBoxMin.z);
+		const auto size = glm::vec2(soilParameters.m_voxelResolution.x, soilParameters.m_voxelResolution.z) * soilParameters.m_deltaX;
+		const auto tileSize = glm::max(m_groundTileSize, soilParameters.m_deltaX);
+		m_groundTiles.Initialize(start, glm::ivec2(glm::ceil(size / tileSize)), tileSize, m_groundTileResolution);
+	}
+	m_groundTiles.UpdateLod(viewPosition, m_groundLodDistance, m_groundMaxLod);
+	if (m_groundTiles.Update(*heightField) == 0)
+	{
+		const auto scene = Application::GetActiveScene();
+		for (const auto& child : scene->GetChildren(GetOwner())) {
+			if (scene->GetEntityName(child) == "Ground Mesh") return child;
+		}
+	}
+	std::vector<Vertex> vertices;
+	std::vector<glm::uvec3> triangles;
+	m_groundTiles.GetMesh(vertices, triangles);
+	return SetGroundMesh(vertices, triangles);
+}
 
+Entity Soil::SetGroundMesh(const std::vector<Vertex>& vertices, const std::vector<glm::uvec3>& triangles)
+{
 	const auto scene = Application::GetActiveScene();
 	const auto self = GetOwner();
 	Entity groundSurfaceEntity;
@@ -848,6 +898,7 @@ Entity Soil::GenerateMesh(float xDepth, float zDepth)
 	const auto mesh = ProjectManager::CreateTemporaryAsset<Mesh>();
 	const auto material = ProjectManager::CreateTemporaryAsset<Material>();
 	VertexAttributes vertexAttributes{};
+	vertexAttributes.m_normal = true;
 	vertexAttributes.m_texCoord = true;
 	mesh->SetVertices(vertexAttributes, vertices, triangles);
 	meshRenderer->m_mesh = mesh;
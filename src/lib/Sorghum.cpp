@@ -42,30 +42,35 @@ void Sorghum::GenerateGeometryEntities(const SorghumMeshGeneratorSettings& sorgh
 	
 	if(!sorghumState) return;
 	if (sorghumState->m_stem.m_spline.m_segments.empty()) return;
+	std::vector<SorghumGeometryBuffers> geometryBuffers;
+	SorghumMeshBuilder::Build({ sorghumState }, sorghumMeshGeneratorSettings,
+		sorghumLayer->m_verticalSubdivisionLength, sorghumLayer->m_horizontalSubdivisionStep, geometryBuffers);
+	CreateGeometryEntities(sorghumState, geometryBuffers.front(), sorghumMeshGeneratorSettings);
+}
+
+void Sorghum::CreateGeometryEntities(const std::shared_ptr<SorghumState>& sorghumState, const SorghumGeometryBuffers& geometryBuffers,
+	const SorghumMeshGeneratorSettings& sorghumMeshGeneratorSettings)
+{
+	const auto sorghumLayer = Application::GetLayer<SorghumLayer>();
+	if (!sorghumLayer) return;
+	if (sorghumState->m_stem.m_spline.m_segments.empty()) return;
 	ClearGeometryEntities();
 	const auto scene = GetScene();
 	const auto owner = GetOwner();
+	VertexAttributes attributes{};
+	attributes.m_texCoord = true;
 	if(sorghumMeshGeneratorSettings.m_enablePanicle && sorghumState->m_panicle.m_seedAmount > 0)
 	{
 		const auto panicleEntity = scene->CreateEntity("Panicle Mesh");
 		const auto particles = scene->GetOrSetPrivateComponent<Particles>(panicleEntity).lock();
 		const auto mesh = ProjectManager::CreateTemporaryAsset<Mesh>();
-		const auto material = ProjectManager::CreateTemporaryAsset<Material>();
 		const auto particleInfoList = ProjectManager::CreateTemporaryAsset<ParticleInfoList>();
 		particles->m_mesh = mesh;
-		particles->m_material = material;
-		const auto panicleMaterial = sorghumLayer->m_panicleMaterial.Get<Material>();
-		//material->SetAlbedoTexture(panicleMaterial->GetAlbedoTexture());
-		//material->SetNormalTexture(panicleMaterial->GetNormalTexture());
-		//material->SetRoughnessTexture(panicleMaterial->GetRoughnessTexture());
-		//material->SetMetallicTexture(panicleMaterial->GetMetallicTexture());
-		material->m_materialProperties = panicleMaterial->m_materialProperties;
+		particles->m_material = sorghumLayer->m_panicleMaterial;
 		std::vector<Vertex> vertices;
 		std::vector<unsigned int> indices;
 		
 		sorghumState->m_panicle.GenerateGeometry(sorghumState->m_stem.m_spline.m_segments.back().m_position, vertices, indices, particleInfoList);
-		VertexAttributes attributes{};
-		attributes.m_texCoord = true;
 		mesh->SetVertices(attributes, vertices, indices);
 
 		particles->m_particleInfoList = particleInfoList;
@@ -76,79 +81,23 @@ void Sorghum::GenerateGeometryEntities(const SorghumMeshGeneratorSettings& sorgh
 		const auto stemEntity = scene->CreateEntity("Stem Mesh");
 		const auto meshRenderer = scene->GetOrSetPrivateComponent<MeshRenderer>(stemEntity).lock();
 		const auto mesh = ProjectManager::CreateTemporaryAsset<Mesh>();
-		const auto material = ProjectManager::CreateTemporaryAsset<Material>();
 		meshRenderer->m_mesh = mesh;
-		meshRenderer->m_material = material;
-		const auto stemMaterial = sorghumLayer->m_leafMaterial.Get<Material>();
-		//material->SetAlbedoTexture(stemMaterial->GetAlbedoTexture());
-		//material->SetNormalTexture(stemMaterial->GetNormalTexture());
-		//material->SetRoughnessTexture(stemMaterial->GetRoughnessTexture());
-		//material->SetMetallicTexture(stemMaterial->GetMetallicTexture());
-		material->m_materialProperties = stemMaterial->m_materialProperties;
-		std::vector<Vertex> vertices;
-		std::vector<unsigned int> indices;
-		sorghumState->m_stem.GenerateGeometry(vertices, indices);
-		VertexAttributes attributes{};
-		attributes.m_texCoord = true;
-		mesh->SetVertices(attributes, vertices, indices);
+		meshRenderer->m_material = sorghumLayer->m_geometryCache.GetStemMaterial();
+		mesh->SetVertices(attributes, geometryBuffers.m_stem.m_vertices, geometryBuffers.m_stem.m_indices);
 		scene->SetParent(stemEntity, owner);
 	}
 	if(sorghumMeshGeneratorSettings.m_enableLeaves)
 	{
-		if (sorghumMeshGeneratorSettings.m_leafSeparated) {
-			for (const auto& leafState : sorghumState->m_leaves)
-			{
-				const auto leafEntity = scene->CreateEntity("Leaf Mesh");
-				const auto meshRenderer = scene->GetOrSetPrivateComponent<MeshRenderer>(leafEntity).lock();
-				const auto mesh = ProjectManager::CreateTemporaryAsset<Mesh>();
-				const auto material = ProjectManager::CreateTemporaryAsset<Material>();
-				meshRenderer->m_mesh = mesh;
-				meshRenderer->m_material = material;
-				const auto leafMaterial = sorghumLayer->m_leafMaterial.Get<Material>();
-				//material->SetAlbedoTexture(leafMaterial->GetAlbedoTexture());
-				//material->SetNormalTexture(leafMaterial->GetNormalTexture());
-				//material->SetRoughnessTexture(leafMaterial->GetRoughnessTexture());
-				//material->SetMetallicTexture(leafMaterial->GetMetallicTexture());
-				material->m_materialProperties = leafMaterial->m_materialProperties;
-				std::vector<Vertex> vertices;
-				std::vector<unsigned int> indices;
-				leafState.GenerateGeometry(vertices, indices, false, 0.f);
-				if (sorghumMeshGeneratorSettings.m_bottomFace)
-				{
-					leafState.GenerateGeometry(vertices, indices, true, sorghumMeshGeneratorSettings.m_leafThickness);
-				}
-				VertexAttributes attributes{};
-				attributes.m_texCoord = true;
-				mesh->SetVertices(attributes, vertices, indices);
-				scene->SetParent(leafEntity, owner);
-			}
-		}else
+		const auto untexturedLeafMaterial = sorghumLayer->m_geometryCache.GetUntexturedLeafMaterial();
+		for (const auto& leafBuffer : geometryBuffers.m_leaves)
 		{
 			const auto leafEntity = scene->CreateEntity("Leaf Mesh");
 			const auto meshRenderer = scene->GetOrSetPrivateComponent<MeshRenderer>(leafEntity).lock();
 			const auto mesh = ProjectManager::CreateTemporaryAsset<Mesh>();
-			const auto material = ProjectManager::CreateTemporaryAsset<Material>();
 			meshRenderer->m_mesh = mesh;
-			meshRenderer->m_material = material;
-			const auto leafMaterial = sorghumLayer->m_leafMaterial.Get<Material>();
-			material->SetAlbedoTexture(leafMaterial->GetAlbedoTexture());
-			//material->SetNormalTexture(leafMaterial->GetNormalTexture());
-			//material->SetRoughnessTexture(leafMaterial->GetRoughnessTexture());
-			//material->SetMetallicTexture(leafMaterial->GetMetallicTexture());
-			material->m_materialProperties = leafMaterial->m_materialProperties;
-			std::vector<Vertex> vertices;
-			std::vector<unsigned int> indices;
-			for (const auto& leafState : sorghumState->m_leaves)
-			{
-				leafState.GenerateGeometry(vertices, indices, false, 0.f);
-				if (sorghumMeshGeneratorSettings.m_bottomFace)
-				{
-					leafState.GenerateGeometry(vertices, indices, true, sorghumMeshGeneratorSettings.m_leafThickness);
-				}
-			}
-			VertexAttributes attributes{};
-			attributes.m_texCoord = true;
-			mesh->SetVertices(attributes, vertices, indices);
+			if (sorghumMeshGeneratorSettings.m_leafSeparated) meshRenderer->m_material = untexturedLeafMaterial;
+			else meshRenderer->m_material = sorghumLayer->m_leafMaterial;
+			mesh->SetVertices(attributes, leafBuffer.m_vertices, leafBuffer.m_indices);
 			scene->SetParent(leafEntity, owner);
 		}
 	}
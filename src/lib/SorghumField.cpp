@@ -52,6 +52,7 @@ bool SorghumField::OnInspect(const std::shared_ptr<EditorLayer>& editorLayer) {
 	bool changed = false;
 	if(ImGui::DragInt("Size limit", &m_sizeLimit, 1, 0, 10000)) changed = false;
 	if(ImGui::DragFloat("Sorghum size", &m_sorghumSize, 0.01f, 0, 10)) changed = false;
+	if(ImGui::Checkbox("Instanced", &m_instanced)) changed = true;
 	if (ImGui::Button("Instantiate")) {
 		InstantiateField();
 	}
@@ -63,6 +64,7 @@ bool SorghumField::OnInspect(const std::shared_ptr<EditorLayer>& editorLayer) {
 void SorghumField::Serialize(YAML::Emitter& out) const {
 	out << YAML::Key << "m_sizeLimit" << YAML::Value << m_sizeLimit;
 	out << YAML::Key << "m_sorghumSize" << YAML::Value << m_sorghumSize;
+	out << YAML::Key << "m_instanced" << YAML::Value << m_instanced;
 
 	out << YAML::Key << "m_matrices" << YAML::Value << YAML::BeginSeq;
 	for (auto& i : m_matrices) {
@@ -78,6 +80,8 @@ void SorghumField::Deserialize(const YAML::Node& in) {
 		m_sizeLimit = in["m_sizeLimit"].as<int>();
 	if (in["m_sorghumSize"])
 		m_sorghumSize = in["m_sorghumSize"].as<float>();
+	if (in["m_instanced"])
+		m_instanced = in["m_instanced"].as<bool>();
 
 	m_matrices.clear();
 	if (in["m_matrices"]) {
@@ -99,18 +103,21 @@ Entity SorghumField::InstantiateField() const
 		EVOENGINE_ERROR("No matrices generated!");
 		return {};
 	}
+	if (m_instanced) return InstantiateInstancedField();
 
 	const auto sorghumLayer = Application::GetLayer<SorghumLayer>();
 	const auto scene = sorghumLayer->GetScene();
 	if (sorghumLayer) {
 		const auto fieldAsset = std::dynamic_pointer_cast<SorghumField>(GetSelf());
 		const auto field = scene->CreateEntity("Field");
-		// Create sorghums here.
+		// Create sorghums here. Meshes of all plants are generated together afterward.
 		int size = 0;
+		std::vector<Entity> sorghumEntities;
 		for (auto& newSorghum : fieldAsset->m_matrices) {
 			const auto sorghumDescriptor = newSorghum.first.Get<SorghumStateGenerator>();
 			if (!sorghumDescriptor) continue;
-			Entity sorghumEntity = sorghumDescriptor->CreateEntity(size);
+			Entity sorghumEntity = scene->CreateEntity(sorghumDescriptor->GetTitle());
+			sorghumEntities.emplace_back(sorghumEntity);
 			auto sorghumTransform = scene->GetDataComponent<Transform>(sorghumEntity);
 			sorghumTransform.m_value = newSorghum.second;
 			sorghumTransform.SetScale(glm::vec3(m_sorghumSize));
@@ -120,13 +127,13 @@ Entity SorghumField::InstantiateField() const
 			const auto sorghum = scene->GetOrSetPrivateComponent<Sorghum>(sorghumEntity).lock();
 			sorghum->m_sorghumDescriptor = sorghumDescriptor;
 			const auto sorghumState = ProjectManager::CreateTemporaryAsset<SorghumState>();
-			sorghumDescriptor->Apply(sorghumState, 0);
+			sorghumDescriptor->Apply(sorghumState, size);
 			sorghum->m_sorghumState = sorghumState;
 			size++;
 			if (size >= m_sizeLimit)
 				break;
 		}
-
+		sorghumLayer->GenerateMeshForSorghums(sorghumEntities, sorghumLayer->m_sorghumMeshGeneratorSettings);
 		
 		TransformGraph::CalculateTransformGraphForDescendants(scene,
 			field);
@@ -138,3 +145,77 @@ Entity SorghumField::InstantiateField() const
 	}
 }
 
+Entity SorghumField::InstantiateInstancedField() const
+{
+	if (m_matrices.empty()) {
+		EVOENGINE_ERROR("No matrices generated!");
+		return {};
+	}
+	const auto sorghumLayer = Application::GetLayer<SorghumLayer>();
+	if (!sorghumLayer) {
+		EVOENGINE_ERROR("No sorghum layer!");
+		return {};
+	}
+	const auto scene = sorghumLayer->GetScene();
+	auto& geometryCache = sorghumLayer->m_geometryCache;
+	const auto& meshGeneratorSettings = sorghumLayer->m_sorghumMeshGeneratorSettings;
+	//Instances are grouped by descriptor, variant and level of detail. Every group becomes one entity per organ.
+	std::unordered_map<Handle, std::vector<std::vector<std::vector<ParticleInfo>>>> groups;
+	std::vector<std::shared_ptr<SorghumStateGenerator>> sorghumStateGenerators;
+	int size = 0;
+	for (const auto& newSorghum : m_matrices) {
+		const auto sorghumStateGenerator = newSorghum.first.Get<SorghumStateGenerator>();
+		if (!sorghumStateGenerator) continue;
+		const auto& prototypes = geometryCache.GetPrototypes(sorghumStateGenerator, meshGeneratorSettings);
+		auto& group = groups[sorghumStateGenerator->GetHandle()];
+		if (group.empty()) {
+			sorghumStateGenerators.emplace_back(sorghumStateGenerator);
+			group.resize(prototypes.size());
+			for (auto& lods : group) lods.resize(prototypes.front().m_lods.size());
+		}
+		Transform transform{};
+		transform.m_value = newSorghum.second;
+		transform.SetScale(glm::vec3(m_sorghumSize));
+		const auto variant = static_cast<size_t>(size) * 2654435761u % prototypes.size();
+		const auto lod = geometryCache.m_settings.GetLod(glm::distance(transform.GetPosition(), geometryCache.m_settings.m_lodCenter));
+		group[variant][lod].emplace_back();
+		group[variant][lod].back().m_instanceMatrix.m_value = transform.m_value;
+		size++;
+		if (size >= m_sizeLimit)
+			break;
+	}
+
+	const auto field = scene->CreateEntity("Field");
+	const auto createInstances = [&](const std::string& name, const std::shared_ptr<Mesh>& mesh, const AssetRef& material,
+		const std::vector<ParticleInfo>& particleInfos)
+		{
+			if (!mesh || particleInfos.empty()) return;
+			const auto entity = scene->CreateEntity(name);
+			const auto particles = scene->GetOrSetPrivateComponent<Particles>(entity).lock();
+			const auto particleInfoList = ProjectManager::CreateTemporaryAsset<ParticleInfoList>();
+			particleInfoList->SetParticleInfos(particleInfos);
+			particles->m_mesh = mesh;
+			particles->m_material = material;
+			particles->m_particleInfoList = particleInfoList;
+			scene->SetParent(entity, field);
+		};
+	AssetRef stemMaterial;
+	stemMaterial = geometryCache.GetStemMaterial();
+	for (const auto& sorghumStateGenerator : sorghumStateGenerators) {
+		const auto& prototypes = geometryCache.GetPrototypes(sorghumStateGenerator, meshGeneratorSettings);
+		const auto& group = groups.at(sorghumStateGenerator->GetHandle());
+		for (int variant = 0; variant < prototypes.size(); variant++) {
+			const auto& prototype = prototypes[variant];
+			std::vector<ParticleInfo> allLods;
+			for (int lod = 0; lod < prototype.m_lods.size(); lod++) {
+				const auto& particleInfos = group[variant][lod];
+				allLods.insert(allLods.end(), particleInfos.begin(), particleInfos.end());
+				createInstances("Stem Instances", prototype.m_lods[lod].m_stemMesh, stemMaterial, particleInfos);
+				createInstances("Leaf Instances", prototype.m_lods[lod].m_leafMesh, sorghumLayer->m_leafMaterial, particleInfos);
+			}
+			createInstances("Panicle Instances", prototype.m_panicleMesh, sorghumLayer->m_panicleMaterial, allLods);
+		}
+	}
+	TransformGraph::CalculateTransformGraphForDescendants(scene, field);
+	return field;
+}
@@ -0,0 +1,161 @@
+#include "SorghumGeometryCache.hpp"
+
+#include "SorghumLayer.hpp"
+#include "SorghumStateGenerator.hpp"
+#include "Jobs.hpp"
+
+using namespace EcoSysLab;
+
+bool SorghumGeometryCacheSettings::OnInspect(const std::shared_ptr<EditorLayer>& editorLayer)
+{
+	bool changed = false;
+	if (ImGui::TreeNode("Geometry cache settings"))
+	{
+		if (ImGui::DragInt("Variants per descriptor", &m_variantCount, 1, 1, 256)) changed = true;
+		if (ImGui::DragInt("LOD count", &m_lodCount, 1, 1, 6)) changed = true;
+		if (ImGui::DragFloat("LOD distance", &m_lodDistance, 0.1f, 0.1f, 1000.0f)) changed = true;
+		if (ImGui::DragFloat3("LOD center", &m_lodCenter.x, 0.1f)) changed = true;
+		ImGui::TreePop();
+	}
+	return changed;
+}
+
+int SorghumGeometryCacheSettings::GetLod(const float distance) const
+{
+	int lod = 0;
+	float threshold = m_lodDistance;
+	while (lod + 1 < m_lodCount && distance >= threshold)
+	{
+		lod++;
+		threshold *= 2.0f;
+	}
+	return lod;
+}
+
+const std::vector<SorghumPrototype>& SorghumGeometryCache::GetPrototypes(
+	const std::shared_ptr<SorghumStateGenerator>& sorghumStateGenerator,
+	const SorghumMeshGeneratorSettings& sorghumMeshGeneratorSettings)
+{
+	const auto sorghumLayer = Application::GetLayer<SorghumLayer>();
+	const int variantCount = glm::max(1, m_settings.m_variantCount);
+	const int lodCount = glm::max(1, m_settings.m_lodCount);
+	if (variantCount != m_builtVariantCount || lodCount != m_builtLodCount
+		|| sorghumLayer->m_verticalSubdivisionLength != m_builtVerticalSubdivisionLength
+		|| sorghumLayer->m_horizontalSubdivisionStep != m_builtHorizontalSubdivisionStep
+		|| sorghumMeshGeneratorSettings.m_enablePanicle != m_builtMeshGeneratorSettings.m_enablePanicle
+		|| sorghumMeshGeneratorSettings.m_enableStem != m_builtMeshGeneratorSettings.m_enableStem
+		|| sorghumMeshGeneratorSettings.m_enableLeaves != m_builtMeshGeneratorSettings.m_enableLeaves
+		|| sorghumMeshGeneratorSettings.m_bottomFace != m_builtMeshGeneratorSettings.m_bottomFace
+		|| sorghumMeshGeneratorSettings.m_leafThickness != m_builtMeshGeneratorSettings.m_leafThickness)
+	{
+		m_prototypes.clear();
+		m_builtVariantCount = variantCount;
+		m_builtLodCount = lodCount;
+		m_builtVerticalSubdivisionLength = sorghumLayer->m_verticalSubdivisionLength;
+		m_builtHorizontalSubdivisionStep = sorghumLayer->m_horizontalSubdivisionStep;
+		m_builtMeshGeneratorSettings = sorghumMeshGeneratorSettings;
+	}
+	auto& prototypeSet = m_prototypes[sorghumStateGenerator->GetHandle()];
+	auto& prototypes = prototypeSet.m_prototypes;
+	if (!prototypes.empty() && prototypeSet.m_parameterVersion == sorghumStateGenerator->GetParameterVersion()) return prototypes;
+	prototypeSet.m_parameterVersion = sorghumStateGenerator->GetParameterVersion();
+	prototypes.clear();
+
+	//Apply and the panicle draw from the global random generator, so states and panicles are built one after another.
+	prototypes.resize(variantCount);
+	std::vector<std::pair<std::vector<Vertex>, std::vector<unsigned>>> panicleData(variantCount);
+	for (int variant = 0; variant < variantCount; variant++)
+	{
+		auto& prototype = prototypes[variant];
+		prototype.m_sorghumState = ProjectManager::CreateTemporaryAsset<SorghumState>();
+		sorghumStateGenerator->Apply(prototype.m_sorghumState, variant + 1);
+		const auto& sorghumState = prototype.m_sorghumState;
+		if (sorghumMeshGeneratorSettings.m_enablePanicle && sorghumState->m_panicle.m_seedAmount > 0 && !sorghumState->m_stem.m_spline.m_segments.empty())
+		{
+			sorghumState->m_panicle.GenerateGeometry(sorghumState->m_stem.m_spline.m_segments.back().m_position, panicleData[variant].first, panicleData[variant].second);
+		}
+	}
+
+	std::vector<std::pair<std::vector<Vertex>, std::vector<unsigned>>> stemData(variantCount * lodCount);
+	std::vector<std::pair<std::vector<Vertex>, std::vector<unsigned>>> leafData(variantCount * lodCount);
+	Jobs::RunParallelFor(variantCount * lodCount, [&](unsigned i)
+		{
+			const auto& sorghumState = prototypes[i / lodCount].m_sorghumState;
+			const int lod = i % lodCount;
+			const float verticalSubdivisionLength = m_builtVerticalSubdivisionLength * static_cast<float>(1 << lod);
+			const int horizontalSubdivisionStep = glm::min(m_builtHorizontalSubdivisionStep, glm::max(2, m_builtHorizontalSubdivisionStep >> lod));
+			if (sorghumMeshGeneratorSettings.m_enableStem)
+			{
+				sorghumState->m_stem.GenerateGeometry(stemData[i].first, stemData[i].second, verticalSubdivisionLength, horizontalSubdivisionStep);
+			}
+			if (sorghumMeshGeneratorSettings.m_enableLeaves)
+			{
+				for (const auto& leafState : sorghumState->m_leaves)
+				{
+					leafState.GenerateGeometry(leafData[i].first, leafData[i].second, false, 0.f, verticalSubdivisionLength, horizontalSubdivisionStep);
+					if (sorghumMeshGeneratorSettings.m_bottomFace)
+					{
+						leafState.GenerateGeometry(leafData[i].first, leafData[i].second, true, sorghumMeshGeneratorSettings.m_leafThickness, verticalSubdivisionLength, horizontalSubdivisionStep);
+					}
+				}
+			}
+		}
+	);
+
+	VertexAttributes attributes{};
+	attributes.m_texCoord = true;
+	const auto createMesh = [&](const std::pair<std::vector<Vertex>, std::vector<unsigned>>& data)
+		{
+			std::shared_ptr<Mesh> mesh;
+			if (data.second.empty()) return mesh;
+			mesh = ProjectManager::CreateTemporaryAsset<Mesh>();
+			mesh->SetVertices(attributes, data.first, data.second);
+			return mesh;
+		};
+	for (int variant = 0; variant < variantCount; variant++)
+	{
+		auto& prototype = prototypes[variant];
+		prototype.m_panicleMesh = createMesh(panicleData[variant]);
+		prototype.m_lods.resize(lodCount);
+		for (int lod = 0; lod < lodCount; lod++)
+		{
+			prototype.m_lods[lod].m_stemMesh = createMesh(stemData[variant * lodCount + lod]);
+			prototype.m_lods[lod].m_leafMesh = createMesh(leafData[variant * lodCount + lod]);
+		}
+	}
+	return prototypes;
+}
+
+std::shared_ptr<Material> SorghumGeometryCache::GetStemMaterial()
+{
+	if (!m_stemMaterial) m_stemMaterial = ProjectManager::CreateTemporaryAsset<Material>();
+	if (const auto sorghumLayer = Application::GetLayer<SorghumLayer>())
+	{
+		if (const auto leafMaterial = sorghumLayer->m_leafMaterial.Get<Material>()) m_stemMaterial->m_materialProperties = leafMaterial->m_materialProperties;
+	}
+	return m_stemMaterial;
+}
+
+std::shared_ptr<Material> SorghumGeometryCache::GetUntexturedLeafMaterial()
+{
+	if (!m_untexturedLeafMaterial) m_untexturedLeafMaterial = ProjectManager::CreateTemporaryAsset<Material>();
+	if (const auto sorghumLayer = Application::GetLayer<SorghumLayer>())
+	{
+		if (const auto leafMaterial = sorghumLayer->m_leafMaterial.Get<Material>()) m_untexturedLeafMaterial->m_materialProperties = leafMaterial->m_materialProperties;
+	}
+	return m_untexturedLeafMaterial;
+}
+
+void SorghumGeometryCache::Clear()
+{
+	m_prototypes.clear();
+	m_builtVariantCount = 0;
+	m_builtLodCount = 0;
+}
+
+size_t SorghumGeometryCache::GetPrototypeSize() const
+{
+	size_t retVal = 0;
+	for (const auto& [handle, prototypeSet] : m_prototypes) retVal += prototypeSet.m_prototypes.size();
+	return retVal;
+}
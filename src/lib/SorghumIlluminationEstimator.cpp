@@ -0,0 +1,307 @@
+#include "SorghumIlluminationEstimator.hpp"
+
+#include "Jobs.hpp"
+#include "Sorghum.hpp"
+#include "Times.hpp"
+
+using namespace EcoSysLab;
+
+bool SorghumIlluminationSettings::OnInspect(const std::shared_ptr<EditorLayer>& editorLayer)
+{
+	bool changed = false;
+	if (ImGui::TreeNode("CPU illumination settings"))
+	{
+		if (ImGui::DragInt("Samples per batch", &m_batchSize, 1, 1, 1024)) changed = true;
+		if (ImGui::DragInt("Min batches", &m_minBatches, 1, 1, m_maxBatches)) changed = true;
+		if (ImGui::DragInt("Max batches", &m_maxBatches, 1, m_minBatches, 1024)) changed = true;
+		if (ImGui::DragFloat("Convergence threshold", &m_convergenceThreshold, 0.001f, 0.0f, 1.0f, "%.4f")) changed = true;
+		if (ImGui::DragInt("Bounces", &m_bounces, 1, 0, 8)) changed = true;
+		if (ImGui::SliderFloat("Leaf reflectance", &m_leafReflectance, 0.0f, 1.0f)) changed = true;
+		if (ImGui::SliderFloat("Ground reflectance", &m_groundReflectance, 0.0f, 1.0f)) changed = true;
+		if (ImGui::SliderFloat("Diffuse fraction", &m_diffuseFraction, 0.0f, 1.0f)) changed = true;
+		if (ImGui::DragFloat("Push distance along normal", &m_pushDistance, 0.0001f, 0.0f, 1.0f, "%.5f")) changed = true;
+		int seed = static_cast<int>(m_seed);
+		if (ImGui::DragInt("Seed", &seed, 1, 0, INT_MAX))
+		{
+			m_seed = static_cast<unsigned>(seed);
+			changed = true;
+		}
+		ImGui::TreePop();
+	}
+	return changed;
+}
+
+void SorghumIlluminationEstimator::Clear()
+{
+	m_bvh.Clear();
+	m_positions.clear();
+	m_triangles.clear();
+	m_triangleNormals.clear();
+	m_triangleAreas.clear();
+	m_trianglePlantIndices.clear();
+	m_plants.clear();
+	m_triangleIrradiance.clear();
+	m_triangleSampleCounts.clear();
+}
+
+void SorghumIlluminationEstimator::AddMesh(const std::shared_ptr<Mesh>& mesh, const glm::mat4& transform, const unsigned plantIndex)
+{
+	const auto vertexOffset = static_cast<unsigned>(m_positions.size());
+	for (const auto& vertex : mesh->UnsafeGetVertices())
+	{
+		m_positions.emplace_back(transform * glm::vec4(vertex.m_position, 1.0f));
+	}
+	for (const auto& triangle : mesh->UnsafeGetTriangles())
+	{
+		m_triangles.emplace_back(triangle + glm::uvec3(vertexOffset));
+		m_trianglePlantIndices.emplace_back(plantIndex);
+	}
+}
+
+void SorghumIlluminationEstimator::CollectField(const std::shared_ptr<Scene>& scene)
+{
+	Clear();
+	if (const std::vector<Entity>* sorghumEntities = scene->UnsafeGetPrivateComponentOwnersList<Sorghum>())
+	{
+		for (const auto& sorghumEntity : *sorghumEntities)
+		{
+			const auto plantIndex = static_cast<unsigned>(m_plants.size());
+			m_plants.push_back({ sorghumEntity, scene->GetEntityName(sorghumEntity), scene->GetDataComponent<GlobalTransform>(sorghumEntity).GetPosition() });
+			scene->ForEachDescendant(sorghumEntity, [&](Entity child)
+				{
+					const auto transform = scene->GetDataComponent<GlobalTransform>(child).m_value;
+					if (scene->HasPrivateComponent<MeshRenderer>(child))
+					{
+						if (const auto mesh = scene->GetOrSetPrivateComponent<MeshRenderer>(child).lock()->m_mesh.Get<Mesh>())
+						{
+							AddMesh(mesh, transform, plantIndex);
+						}
+					}
+					//The panicle of a plant is drawn as one particle per seed.
+					if (scene->HasPrivateComponent<Particles>(child))
+					{
+						const auto particles = scene->GetOrSetPrivateComponent<Particles>(child).lock();
+						const auto mesh = particles->m_mesh.Get<Mesh>();
+						const auto particleInfoList = particles->m_particleInfoList.Get<ParticleInfoList>();
+						if (!mesh || !particleInfoList) return;
+						for (const auto& particleInfo : particleInfoList->PeekParticleInfoList())
+						{
+							AddMesh(mesh, transform * particleInfo.m_instanceMatrix.m_value, plantIndex);
+						}
+					}
+				}
+			);
+		}
+	}
+	//Entities made by SorghumField::InstantiateInstancedField. Organs of one plant share its instance matrix within a field.
+	if (const std::vector<Entity>* particleEntities = scene->UnsafeGetPrivateComponentOwnersList<Particles>())
+	{
+		std::map<std::pair<unsigned, std::array<float, 16>>, unsigned> instancePlantIndices;
+		for (const auto& entity : *particleEntities)
+		{
+			const auto name = scene->GetEntityName(entity);
+			if (name != "Stem Instances" && name != "Leaf Instances" && name != "Panicle Instances") continue;
+			const auto particles = scene->GetOrSetPrivateComponent<Particles>(entity).lock();
+			const auto mesh = particles->m_mesh.Get<Mesh>();
+			const auto particleInfoList = particles->m_particleInfoList.Get<ParticleInfoList>();
+			if (!mesh || !particleInfoList) continue;
+			const auto fieldIndex = scene->GetParent(entity).GetIndex();
+			const auto transform = scene->GetDataComponent<GlobalTransform>(entity).m_value;
+			for (const auto& particleInfo : particleInfoList->PeekParticleInfoList())
+			{
+				std::pair<unsigned, std::array<float, 16>> key{ fieldIndex, {} };
+				std::memcpy(key.second.data(), &particleInfo.m_instanceMatrix.m_value[0][0], sizeof(float) * 16);
+				const auto instanceTransform = transform * particleInfo.m_instanceMatrix.m_value;
+				const auto [search, inserted] = instancePlantIndices.emplace(key, static_cast<unsigned>(m_plants.size()));
+				if (inserted) m_plants.push_back({ Entity(), "Instance " + std::to_string(search->second), glm::vec3(instanceTransform[3]) });
+				AddMesh(mesh, instanceTransform, search->second);
+			}
+		}
+	}
+	m_triangleNormals.resize(m_triangles.size());
+	m_triangleAreas.resize(m_triangles.size());
+	Jobs::RunParallelFor(m_triangles.size(), [&](unsigned i)
+		{
+			const auto& triangle = m_triangles[i];
+			const auto cross = glm::cross(m_positions[triangle.y] - m_positions[triangle.x], m_positions[triangle.z] - m_positions[triangle.x]);
+			const float length = glm::length(cross);
+			m_triangleAreas[i] = length * 0.5f;
+			m_triangleNormals[i] = length > 0.0f ? cross / length : glm::vec3(0, 1, 0);
+		}
+	);
+	m_bvh.Build(m_positions, m_triangles);
+}
+
+static glm::vec3 SampleCosineHemisphere(const glm::vec3& normal, const float u1, const float u2)
+{
+	//Orthonormal basis from Duff et al. 2017.
+	const float sign = std::copysign(1.0f, normal.z);
+	const float a = -1.0f / (sign + normal.z);
+	const float b = normal.x * normal.y * a;
+	const glm::vec3 tangent = glm::vec3(1.0f + sign * normal.x * normal.x * a, sign * b, -sign * normal.x);
+	const glm::vec3 bitangent = glm::vec3(b, sign + normal.y * normal.y * a, -normal.y);
+	const float radius = glm::sqrt(u1);
+	const float phi = 2.0f * glm::pi<float>() * u2;
+	return glm::normalize(tangent * (radius * glm::cos(phi)) + bitangent * (radius * glm::sin(phi)) + normal * glm::sqrt(glm::max(0.0f, 1.0f - u1)));
+}
+
+void SorghumIlluminationEstimator::Estimate(SkyIlluminanceSnapshot snapshot)
+{
+	m_triangleIrradiance.assign(m_triangles.size(), 0.0f);
+	m_triangleSampleCounts.assign(m_triangles.size(), 0);
+	if (m_triangles.empty()) return;
+	const float startTime = Times::Now();
+	const auto settings = m_settings;
+	const auto sunDirection = glm::normalize(snapshot.GetSunDirection());
+	const float ghi = glm::max(0.0f, snapshot.GetSunIntensity());
+	//The sun disk delivers the direct part of the horizontal irradiance, below the horizon all light is treated as diffuse.
+	const float diffuseFraction = sunDirection.y > 0.0f ? glm::clamp(settings.m_diffuseFraction, 0.0f, 1.0f) : 1.0f;
+	const float directNormalIrradiance = sunDirection.y > 0.0f ? ghi * (1.0f - diffuseFraction) / glm::max(sunDirection.y, 0.05f) : 0.0f;
+	const float skyRadiance = ghi * diffuseFraction / glm::pi<float>();
+	const float groundRadiance = ghi * settings.m_groundReflectance / glm::pi<float>();
+	const int strataSide = glm::max(1, static_cast<int>(glm::sqrt(static_cast<float>(settings.m_batchSize))));
+	const int batchSize = strataSide * strataSide;
+	const int maxBatches = glm::max(1, settings.m_maxBatches);
+	const int minBatches = glm::clamp(settings.m_minBatches, 1, maxBatches);
+
+	const auto direct = [&](const glm::vec3& position, const glm::vec3& normal)
+		{
+			const float cosTheta = glm::dot(normal, sunDirection);
+			if (directNormalIrradiance <= 0.0f || cosTheta <= 0.0f) return 0.0f;
+			if (m_bvh.Occluded(position + normal * settings.m_pushDistance, sunDirection, FLT_MAX)) return 0.0f;
+			return directNormalIrradiance * cosTheta;
+		};
+
+	Jobs::RunParallelFor(m_triangles.size(), [&](unsigned triangleIndex)
+		{
+			std::mt19937 randomGenerator(settings.m_seed * 0x9E3779B9u ^ triangleIndex * 0x85EBCA6Bu);
+			std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+			const auto& triangle = m_triangles[triangleIndex];
+			const auto& v0 = m_positions[triangle.x];
+			const auto& v1 = m_positions[triangle.y];
+			const auto& v2 = m_positions[triangle.z];
+			const auto& triangleNormal = m_triangleNormals[triangleIndex];
+			std::vector<int> directionStrata(batchSize);
+			std::iota(directionStrata.begin(), directionStrata.end(), 0);
+
+			int batchCount = 0;
+			float mean = 0.0f;
+			float squaredDeviation = 0.0f;
+			while (batchCount < maxBatches)
+			{
+				//Positions and directions are stratified separately, shuffling the direction strata decorrelates the two.
+				std::shuffle(directionStrata.begin(), directionStrata.end(), randomGenerator);
+				float batchSum = 0.0f;
+				for (int sampleIndex = 0; sampleIndex < batchSize; sampleIndex++)
+				{
+					const float a = (static_cast<float>(sampleIndex % strataSide) + uniform(randomGenerator)) / strataSide;
+					const float b = (static_cast<float>(sampleIndex / strataSide) + uniform(randomGenerator)) / strataSide;
+					const float squareRootA = glm::sqrt(a);
+					auto origin = v0 * (1.0f - squareRootA) + v1 * (squareRootA * (1.0f - b)) + v2 * (squareRootA * b);
+					auto normal = triangleNormal;
+					const int directionStratum = directionStrata[sampleIndex];
+					float u1 = (static_cast<float>(directionStratum % strataSide) + uniform(randomGenerator)) / strataSide;
+					float u2 = (static_cast<float>(directionStratum / strataSide) + uniform(randomGenerator)) / strataSide;
+
+					float irradiance = direct(origin, normal);
+					//With cosine weighted directions the irradiance from a radiance L is pi * L.
+					float throughput = glm::pi<float>();
+					for (int bounce = 0; ; bounce++)
+					{
+						const auto direction = SampleCosineHemisphere(normal, u1, u2);
+						const auto rayOrigin = origin + normal * settings.m_pushDistance;
+						float distance = FLT_MAX;
+						unsigned hitTriangleIndex = 0;
+						if (!m_bvh.Intersect(rayOrigin, direction, distance, hitTriangleIndex))
+						{
+							irradiance += throughput * (direction.y >= 0.0f ? skyRadiance : groundRadiance);
+							break;
+						}
+						if (bounce >= settings.m_bounces) break;
+						origin = rayOrigin + direction * distance;
+						normal = m_triangleNormals[hitTriangleIndex];
+						if (glm::dot(normal, direction) > 0.0f) normal = -normal;
+						//Lambertian leaves, the radiance leaving the hit point is reflectance / pi times its irradiance.
+						throughput *= settings.m_leafReflectance / glm::pi<float>();
+						irradiance += throughput * direct(origin, normal);
+						throughput *= glm::pi<float>();
+						u1 = uniform(randomGenerator);
+						u2 = uniform(randomGenerator);
+					}
+					batchSum += irradiance;
+				}
+				const float batchMean = batchSum / batchSize;
+				batchCount++;
+				const float delta = batchMean - mean;
+				mean += delta / batchCount;
+				squaredDeviation += delta * (batchMean - mean);
+				if (batchCount >= minBatches && batchCount > 1)
+				{
+					const float standardError = glm::sqrt(squaredDeviation / (batchCount - 1) / batchCount);
+					if (standardError <= settings.m_convergenceThreshold * mean) break;
+				}
+			}
+			m_triangleIrradiance[triangleIndex] = mean;
+			m_triangleSampleCounts[triangleIndex] = batchCount * batchSize;
+		}
+	);
+	EVOENGINE_LOG("Illumination of " + std::to_string(m_triangles.size()) + " triangles estimated in " + std::to_string(Times::Now() - startTime)
+		+ " seconds, " + std::to_string(GetAverageSampleCount()) + " samples per triangle on average.");
+}
+
+size_t SorghumIlluminationEstimator::GetTriangleSize() const
+{
+	return m_triangles.size();
+}
+
+size_t SorghumIlluminationEstimator::GetPlantSize() const
+{
+	return m_plants.size();
+}
+
+const std::vector<float>& SorghumIlluminationEstimator::GetTriangleIrradiance() const
+{
+	return m_triangleIrradiance;
+}
+
+std::vector<float> SorghumIlluminationEstimator::GetPlantIntercepted() const
+{
+	std::vector<float> retVal(m_plants.size(), 0.0f);
+	for (size_t i = 0; i < m_triangleIrradiance.size(); i++)
+	{
+		retVal[m_trianglePlantIndices[i]] += m_triangleIrradiance[i] * m_triangleAreas[i];
+	}
+	return retVal;
+}
+
+float SorghumIlluminationEstimator::GetAverageSampleCount() const
+{
+	if (m_triangleSampleCounts.empty()) return 0.0f;
+	double sum = 0.0;
+	for (const auto& count : m_triangleSampleCounts) sum += count;
+	return static_cast<float>(sum / m_triangleSampleCounts.size());
+}
+
+void SorghumIlluminationEstimator::ExportCSV(const std::shared_ptr<Scene>& scene, const std::filesystem::path& path) const
+{
+	std::ofstream of;
+	of.open(path, std::ofstream::out | std::ofstream::trunc);
+	if (!of.is_open())
+	{
+		EVOENGINE_ERROR("Can't open file " + path.string());
+		return;
+	}
+	std::vector<float> plantAreas(m_plants.size(), 0.0f);
+	for (size_t i = 0; i < m_triangleAreas.size(); i++) plantAreas[m_trianglePlantIndices[i]] += m_triangleAreas[i];
+	const auto plantIntercepted = GetPlantIntercepted();
+	of << "Index,Name,X,Y,Z,Area,Intercepted,MeanIrradiance\n";
+	for (size_t i = 0; i < m_plants.size(); i++)
+	{
+		const auto& plant = m_plants[i];
+		const auto position = scene->IsEntityValid(plant.m_entity) ? scene->GetDataComponent<GlobalTransform>(plant.m_entity).GetPosition() : plant.m_position;
+		const auto name = scene->IsEntityValid(plant.m_entity) ? scene->GetEntityName(plant.m_entity) : plant.m_name;
+		of << i << "," << name << "," << position.x << "," << position.y << "," << position.z << "," << plantAreas[i] << ","
+			<< plantIntercepted[i] << "," << (plantAreas[i] > 0.0f ? plantIntercepted[i] / plantAreas[i] : 0.0f) << "\n";
+	}
+	of.close();
+}
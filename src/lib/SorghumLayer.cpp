@@ -120,19 +120,43 @@ void SorghumLayer::OnCreate() {
 
 void SorghumLayer::GenerateMeshForAllSorghums(const SorghumMeshGeneratorSettings& sorghumMeshGeneratorSettings) const
 {
-	std::vector<Entity> plants;
 	const auto scene = GetScene();
-	if (const std::vector<Entity>* sorghumEntities =
-		scene->UnsafeGetPrivateComponentOwnersList<Sorghum>(); sorghumEntities && !sorghumEntities->empty())
+	const std::vector<Entity>* sorghumEntities = scene->UnsafeGetPrivateComponentOwnersList<Sorghum>();
+	if (!sorghumEntities || sorghumEntities->empty()) return;
+	GenerateMeshForSorghums(*sorghumEntities, sorghumMeshGeneratorSettings);
+}
+
+void SorghumLayer::GenerateMeshForSorghums(const std::vector<Entity>& sorghumEntities, const SorghumMeshGeneratorSettings& sorghumMeshGeneratorSettings) const
+{
+	const auto scene = GetScene();
+	//Buffers of all plants are built in parallel first, meshes and entities are created on the main thread afterward.
+	std::vector<std::shared_ptr<Sorghum>> sorghums;
+	std::vector<std::shared_ptr<SorghumState>> sorghumStates;
+	for (const auto& sorghumEntity : sorghumEntities)
 	{
-		for (const auto& sorghumEntity : *sorghumEntities)
-		{
-			const auto sorghum = scene->GetOrSetPrivateComponent<Sorghum>(sorghumEntity).lock();
-			sorghum->GenerateGeometryEntities(sorghumMeshGeneratorSettings);
-		}
+		const auto sorghum = scene->GetOrSetPrivateComponent<Sorghum>(sorghumEntity).lock();
+		const auto sorghumState = sorghum->m_sorghumState.Get<SorghumState>();
+		if (!sorghumState || sorghumState->m_stem.m_spline.m_segments.empty()) continue;
+		sorghums.emplace_back(sorghum);
+		sorghumStates.emplace_back(sorghumState);
+	}
+	std::vector<SorghumGeometryBuffers> geometryBuffers;
+	SorghumMeshBuilder::Build(sorghumStates, sorghumMeshGeneratorSettings, m_verticalSubdivisionLength, m_horizontalSubdivisionStep, geometryBuffers);
+	for (size_t i = 0; i < sorghums.size(); i++)
+	{
+		sorghums[i]->CreateGeometryEntities(sorghumStates[i], geometryBuffers[i], sorghumMeshGeneratorSettings);
 	}
 }
 
+void SorghumLayer::EstimateIllumination(const float time)
+{
+	SkyIlluminanceSnapshot snapshot{};
+	if (const auto skyIlluminance = m_skyIlluminance.Get<SkyIlluminance>()) snapshot = skyIlluminance->Get(time);
+	else EVOENGINE_WARNING("No sky illuminance set, using the default snapshot.");
+	m_illuminationEstimator.CollectField(GetScene());
+	m_illuminationEstimator.Estimate(snapshot);
+}
+
 void SorghumLayer::OnInspect(const std::shared_ptr<EditorLayer>& editorLayer) {
 	auto scene = GetScene();
 	if (ImGui::Begin("Sorghum Layer")) {
@@ -156,12 +180,33 @@ void SorghumLayer::OnInspect(const std::shared_ptr<EditorLayer>& editorLayer) {
 
 		ImGui::Checkbox("Enable BTF", &m_enableCompressedBTF);
 #endif
+		if (ImGui::TreeNodeEx("CPU Illumination Estimation")) {
+			editorLayer->DragAndDropButton<SkyIlluminance>(m_skyIlluminance, "Sky illuminance");
+			ImGui::DragFloat("Time", &m_illuminationTime, 0.01f);
+			m_illuminationEstimator.m_settings.OnInspect(editorLayer);
+			if (ImGui::Button("Estimate illumination")) {
+				EstimateIllumination(m_illuminationTime);
+			}
+			ImGui::Text("Plants: %d, triangles: %d", static_cast<int>(m_illuminationEstimator.GetPlantSize()),
+				static_cast<int>(m_illuminationEstimator.GetTriangleSize()));
+			ImGui::Text("Average samples per triangle: %.1f", m_illuminationEstimator.GetAverageSampleCount());
+			FileUtils::SaveFile("Export illumination", "CSV", { ".csv" },
+				[&](const std::filesystem::path& path) {
+					m_illuminationEstimator.ExportCSV(scene, path);
+				}, false);
+			ImGui::TreePop();
+		}
 		ImGui::Separator();
 		ImGui::Checkbox("Auto regenerate sorghum", &m_autoRefreshSorghums);
 		m_sorghumMeshGeneratorSettings.OnInspect(editorLayer);
 		if (ImGui::Button("Generate mesh for all sorghums")) {
 			GenerateMeshForAllSorghums(m_sorghumMeshGeneratorSettings);
 		}
+		m_geometryCache.m_settings.OnInspect(editorLayer);
+		ImGui::Text("Cached prototypes: %d", static_cast<int>(m_geometryCache.GetPrototypeSize()));
+		if (ImGui::Button("Clear geometry cache")) {
+			m_geometryCache.Clear();
+		}
 		if (ImGui::DragFloat("Vertical subdivision max unit length",
 			&m_verticalSubdivisionLength, 0.001f, 0.001f,
 			1.0f, "%.4f")) {
@@ -0,0 +1,125 @@
+#include "SorghumMeshBuilder.hpp"
+
+#include "Jobs.hpp"
+
+using namespace EcoSysLab;
+
+void SorghumMeshBuilder::Build(const std::vector<std::shared_ptr<SorghumState>>& sorghumStates,
+	const SorghumMeshGeneratorSettings& sorghumMeshGeneratorSettings,
+	const float verticalSubdivisionLength, const int horizontalSubdivisionStep,
+	std::vector<SorghumGeometryBuffers>& geometryBuffers)
+{
+	geometryBuffers.clear();
+	geometryBuffers.resize(sorghumStates.size());
+	//An organ is the stem or one leaf of a plant. A leaf with a bottom face writes two pieces into the same buffer.
+	struct Organ
+	{
+		size_t m_plantIndex = 0;
+		int m_leafIndex = -1;
+		size_t m_bufferIndex = 0;
+		std::vector<SorghumSplineSegment> m_segments;
+	};
+	struct Piece
+	{
+		size_t m_organIndex = 0;
+		bool m_bottomFace = false;
+		size_t m_vertexOffset = 0;
+		size_t m_indexOffset = 0;
+	};
+	std::vector<Organ> organs;
+	std::vector<SorghumMeshBuffer*> buffers;
+	for (size_t plantIndex = 0; plantIndex < sorghumStates.size(); plantIndex++)
+	{
+		const auto& sorghumState = sorghumStates[plantIndex];
+		if (!sorghumState) continue;
+		auto& plantBuffers = geometryBuffers[plantIndex];
+		if (sorghumMeshGeneratorSettings.m_enableStem && !sorghumState->m_stem.m_spline.m_segments.empty())
+		{
+			organs.emplace_back();
+			organs.back().m_plantIndex = plantIndex;
+			organs.back().m_bufferIndex = buffers.size();
+			buffers.emplace_back(&plantBuffers.m_stem);
+		}
+		if (!sorghumMeshGeneratorSettings.m_enableLeaves) continue;
+		plantBuffers.m_leaves.resize(sorghumMeshGeneratorSettings.m_leafSeparated ? sorghumState->m_leaves.size() : 1);
+		const auto mergedBufferIndex = buffers.size();
+		if (!sorghumMeshGeneratorSettings.m_leafSeparated) buffers.emplace_back(&plantBuffers.m_leaves.front());
+		for (int leafIndex = 0; leafIndex < sorghumState->m_leaves.size(); leafIndex++)
+		{
+			if (sorghumState->m_leaves[leafIndex].m_spline.m_segments.empty()) continue;
+			organs.emplace_back();
+			organs.back().m_plantIndex = plantIndex;
+			organs.back().m_leafIndex = leafIndex;
+			if (sorghumMeshGeneratorSettings.m_leafSeparated)
+			{
+				organs.back().m_bufferIndex = buffers.size();
+				buffers.emplace_back(&plantBuffers.m_leaves[leafIndex]);
+			}
+			else
+			{
+				organs.back().m_bufferIndex = mergedBufferIndex;
+			}
+		}
+	}
+
+	Jobs::RunParallelFor(organs.size(), [&](unsigned organIndex)
+		{
+			auto& organ = organs[organIndex];
+			const auto& sorghumState = sorghumStates[organ.m_plantIndex];
+			const auto& spline = organ.m_leafIndex == -1 ? sorghumState->m_stem.m_spline : sorghumState->m_leaves[organ.m_leafIndex].m_spline;
+			spline.Subdivide(verticalSubdivisionLength, organ.m_segments);
+		}
+	);
+
+	//Counting pass. Pieces are laid out in organ order, the same order the serial generators append in.
+	std::vector<Piece> pieces;
+	std::vector<std::pair<size_t, size_t>> bufferSizes(buffers.size(), { 0, 0 });
+	for (size_t organIndex = 0; organIndex < organs.size(); organIndex++)
+	{
+		const auto& organ = organs[organIndex];
+		if (organ.m_segments.empty()) continue;
+		const bool isStem = organ.m_leafIndex == -1;
+		const auto vertexCount = isStem ? SorghumStemState::GetVertexCount(organ.m_segments.size(), horizontalSubdivisionStep)
+			: SorghumLeafState::GetVertexCount(organ.m_segments.size(), horizontalSubdivisionStep);
+		const auto indexCount = isStem ? SorghumStemState::GetIndexCount(organ.m_segments.size(), horizontalSubdivisionStep)
+			: SorghumLeafState::GetIndexCount(organ.m_segments.size(), horizontalSubdivisionStep);
+		const int faceCount = !isStem && sorghumMeshGeneratorSettings.m_bottomFace ? 2 : 1;
+		auto& [vertexSize, indexSize] = bufferSizes[organ.m_bufferIndex];
+		for (int face = 0; face < faceCount; face++)
+		{
+			pieces.emplace_back();
+			auto& piece = pieces.back();
+			piece.m_organIndex = organIndex;
+			piece.m_bottomFace = face == 1;
+			piece.m_vertexOffset = vertexSize;
+			piece.m_indexOffset = indexSize;
+			vertexSize += vertexCount;
+			indexSize += indexCount;
+		}
+	}
+	Jobs::RunParallelFor(buffers.size(), [&](unsigned bufferIndex)
+		{
+			buffers[bufferIndex]->m_vertices.resize(bufferSizes[bufferIndex].first);
+			buffers[bufferIndex]->m_indices.resize(bufferSizes[bufferIndex].second);
+		}
+	);
+
+	Jobs::RunParallelFor(pieces.size(), [&](unsigned pieceIndex)
+		{
+			const auto& piece = pieces[pieceIndex];
+			const auto& organ = organs[piece.m_organIndex];
+			auto& buffer = *buffers[organ.m_bufferIndex];
+			const auto vertices = buffer.m_vertices.data() + piece.m_vertexOffset;
+			const auto indices = buffer.m_indices.data() + piece.m_indexOffset;
+			if (organ.m_leafIndex == -1)
+			{
+				SorghumStemState::GenerateGeometry(organ.m_segments, horizontalSubdivisionStep, vertices, indices, piece.m_vertexOffset);
+			}
+			else
+			{
+				sorghumStates[organ.m_plantIndex]->m_leaves[organ.m_leafIndex].GenerateGeometry(organ.m_segments, piece.m_bottomFace,
+					piece.m_bottomFace ? sorghumMeshGeneratorSettings.m_leafThickness : 0.0f, horizontalSubdivisionStep, vertices, indices, piece.m_vertexOffset);
+			}
+		}
+	);
+}
@@ -123,20 +123,50 @@ void SorghumStemState::GenerateGeometry(std::vector<Vertex>& vertices, std::vect
 {
 	if (m_spline.m_segments.empty())
 		return;
-	auto sorghumLayer = Application::GetLayer<SorghumLayer>();
+	const auto sorghumLayer = Application::GetLayer<SorghumLayer>();
 	if (!sorghumLayer)
 		return;
+	GenerateGeometry(vertices, indices, sorghumLayer->m_verticalSubdivisionLength, sorghumLayer->m_horizontalSubdivisionStep);
+}
+
+void SorghumStemState::GenerateGeometry(std::vector<Vertex>& vertices, std::vector<unsigned>& indices,
+	const float verticalSubdivisionLength, const int horizontalSubdivisionStep) const
+{
+	if (m_spline.m_segments.empty())
+		return;
 	std::vector<SorghumSplineSegment> segments;
-	m_spline.Subdivide(sorghumLayer->m_verticalSubdivisionLength, segments);
+	m_spline.Subdivide(verticalSubdivisionLength, segments);
+	if (segments.empty())
+		return;
+	const auto vertexOffset = vertices.size();
+	const auto indexOffset = indices.size();
+	vertices.resize(vertexOffset + GetVertexCount(segments.size(), horizontalSubdivisionStep));
+	indices.resize(indexOffset + GetIndexCount(segments.size(), horizontalSubdivisionStep));
+	GenerateGeometry(segments, horizontalSubdivisionStep, &vertices[vertexOffset], &indices[indexOffset], vertexOffset);
+}
 
-	const int vertexIndex = vertices.size();
+size_t SorghumStemState::GetVertexCount(const size_t segmentSize, const int horizontalSubdivisionStep)
+{
+	return segmentSize * (horizontalSubdivisionStep * 2 + 1);
+}
+
+size_t SorghumStemState::GetIndexCount(const size_t segmentSize, const int horizontalSubdivisionStep)
+{
+	if (segmentSize < 2) return 0;
+	return (segmentSize - 1) * horizontalSubdivisionStep * 2 * 6;
+}
+
+void SorghumStemState::GenerateGeometry(const std::vector<SorghumSplineSegment>& segments, const int horizontalSubdivisionStep,
+	Vertex* vertices, unsigned* indices, const size_t vertexIndex)
+{
 	Vertex archetype{};
 	glm::vec4 m_vertexColor = glm::vec4(0, 0, 0, 1);
 	archetype.m_color = m_vertexColor;
 
-	const float xStep = 1.0f / sorghumLayer->m_horizontalSubdivisionStep / 2.0f;
+	const float xStep = 1.0f / horizontalSubdivisionStep / 2.0f;
 	auto segmentSize = segments.size();
 	const float yStemStep = 0.5f / segmentSize;
+	const int vertsCount = horizontalSubdivisionStep * 2 + 1;
 	for (int i = 0; i < segmentSize; i++) {
 		auto& segment = segments.at(i);
 		if (i <= segmentSize / 3) {
@@ -149,26 +179,25 @@ void SorghumStemState::GenerateGeometry(std::vector<Vertex>& vertices, std::vect
 			archetype.m_color = glm::vec4(0, 0, 1, 1);
 		}
 		const float angleStep =
-			segment.m_theta / sorghumLayer->m_horizontalSubdivisionStep;
-		const int vertsCount = sorghumLayer->m_horizontalSubdivisionStep * 2 + 1;
+			segment.m_theta / horizontalSubdivisionStep;
 		for (int j = 0; j < vertsCount; j++) {
 			const auto position = segment.GetStemPoint(
-				(j - sorghumLayer->m_horizontalSubdivisionStep) * angleStep);
+				(j - horizontalSubdivisionStep) * angleStep);
 			archetype.m_position = glm::vec3(position.x, position.y, position.z);
 			float yPos = yStemStep * i;
 			archetype.m_texCoord = glm::vec2(j * xStep, yPos);
-			vertices.push_back(archetype);
+			*vertices++ = archetype;
 		}
 		if (i != 0) {
 			for (int j = 0; j < vertsCount - 1; j++) {
 				// Down triangle
-				indices.emplace_back(vertexIndex + ((i - 1) + 1) * vertsCount + j);
-				indices.emplace_back(vertexIndex + (i - 1) * vertsCount + j + 1);
-				indices.emplace_back(vertexIndex + (i - 1) * vertsCount + j);
+				*indices++ = vertexIndex + ((i - 1) + 1) * vertsCount + j;
+				*indices++ = vertexIndex + (i - 1) * vertsCount + j + 1;
+				*indices++ = vertexIndex + (i - 1) * vertsCount + j;
 				// Up triangle
-				indices.emplace_back(vertexIndex + (i - 1) * vertsCount + j + 1);
-				indices.emplace_back(vertexIndex + ((i - 1) + 1) * vertsCount + j);
-				indices.emplace_back(vertexIndex + ((i - 1) + 1) * vertsCount + j + 1);
+				*indices++ = vertexIndex + (i - 1) * vertsCount + j + 1;
+				*indices++ = vertexIndex + ((i - 1) + 1) * vertsCount + j;
+				*indices++ = vertexIndex + ((i - 1) + 1) * vertsCount + j + 1;
 			}
 		}
 	}
@@ -193,13 +222,42 @@ void SorghumLeafState::GenerateGeometry(std::vector<Vertex>& vertices, std::vect
 {
 	if (m_spline.m_segments.empty())
 		return;
-	auto sorghumLayer = Application::GetLayer<SorghumLayer>();
+	const auto sorghumLayer = Application::GetLayer<SorghumLayer>();
 	if (!sorghumLayer)
 		return;
+	GenerateGeometry(vertices, indices, bottomFace, thickness, sorghumLayer->m_verticalSubdivisionLength, sorghumLayer->m_horizontalSubdivisionStep);
+}
+
+void SorghumLeafState::GenerateGeometry(std::vector<Vertex>& vertices, std::vector<unsigned>& indices, bool bottomFace, float thickness,
+	const float verticalSubdivisionLength, const int horizontalSubdivisionStep) const
+{
+	if (m_spline.m_segments.empty())
+		return;
 	std::vector<SorghumSplineSegment> segments;// = m_spline.m_segments;
-	m_spline.Subdivide(sorghumLayer->m_verticalSubdivisionLength, segments);
+	m_spline.Subdivide(verticalSubdivisionLength, segments);
+	if (segments.empty())
+		return;
+	const auto vertexOffset = vertices.size();
+	const auto indexOffset = indices.size();
+	vertices.resize(vertexOffset + GetVertexCount(segments.size(), horizontalSubdivisionStep));
+	indices.resize(indexOffset + GetIndexCount(segments.size(), horizontalSubdivisionStep));
+	GenerateGeometry(segments, bottomFace, thickness, horizontalSubdivisionStep, &vertices[vertexOffset], &indices[indexOffset], vertexOffset);
+}
 
-	const int vertexIndex = vertices.size();
+size_t SorghumLeafState::GetVertexCount(const size_t segmentSize, const int horizontalSubdivisionStep)
+{
+	return segmentSize * (horizontalSubdivisionStep * 2 + 1);
+}
+
+size_t SorghumLeafState::GetIndexCount(const size_t segmentSize, const int horizontalSubdivisionStep)
+{
+	if (segmentSize < 2) return 0;
+	return (segmentSize - 1) * horizontalSubdivisionStep * 2 * 6;
+}
+
+void SorghumLeafState::GenerateGeometry(const std::vector<SorghumSplineSegment>& segments, bool bottomFace, float thickness,
+	const int horizontalSubdivisionStep, Vertex* vertices, unsigned* indices, const size_t vertexIndex) const
+{
 	Vertex archetype{};
 #pragma region Semantic mask color
 	auto index = m_index + 1;
@@ -208,50 +266,50 @@ void SorghumLeafState::GenerateGeometry(std::vector<Vertex>& vertices, std::vect
 #pragma endregion
 	archetype.m_color = vertexColor;
 	archetype.m_vertexInfo1 = m_index + 1;
-	const float xStep = 1.0f / static_cast<float>(sorghumLayer->m_horizontalSubdivisionStep) / 2.0f;
+	const float xStep = 1.0f / static_cast<float>(horizontalSubdivisionStep) / 2.0f;
 	auto segmentSize = segments.size();
 	const float yLeafStep = 0.5f / segmentSize;
+	const int vertsCount = horizontalSubdivisionStep * 2 + 1;
 
 	for (int i = 0; i < segmentSize; i++) {
 		auto& segment = segments.at(i);
 		const float angleStep =
-			segment.m_theta / static_cast<float>(sorghumLayer->m_horizontalSubdivisionStep);
-		const int vertsCount = sorghumLayer->m_horizontalSubdivisionStep * 2 + 1;
+			segment.m_theta / static_cast<float>(horizontalSubdivisionStep);
 		for (int j = 0; j < vertsCount; j++) {
 			auto position = segment.GetLeafPoint(
-				(j - sorghumLayer->m_horizontalSubdivisionStep) * angleStep);
+				(j - horizontalSubdivisionStep) * angleStep);
 			auto normal = segment.GetNormal(
-				(j - sorghumLayer->m_horizontalSubdivisionStep) * angleStep);
+				(j - horizontalSubdivisionStep) * angleStep);
 			if (i != 0 && j != 0 && j != vertsCount - 1) {
 				position -= normal * thickness;
 			}
 			archetype.m_position = glm::vec3(position.x, position.y, position.z);
 			float yPos = 0.5f + yLeafStep * i;
 			archetype.m_texCoord = glm::vec2(j * xStep, yPos);
-			vertices.push_back(archetype);
+			*vertices++ = archetype;
 		}
 		if (i != 0) {
 			for (int j = 0; j < vertsCount - 1; j++) {
 				if (bottomFace) {
 					// Down triangle
-					indices.emplace_back(vertexIndex + i * vertsCount + j);
-					indices.emplace_back(vertexIndex + (i - 1) * vertsCount + j + 1);
-					indices.emplace_back(vertexIndex + (i - 1) * vertsCount + j);
+					*indices++ = vertexIndex + i * vertsCount + j;
+					*indices++ = vertexIndex + (i - 1) * vertsCount + j + 1;
+					*indices++ = vertexIndex + (i - 1) * vertsCount + j;
 					// Up triangle
-					indices.emplace_back(vertexIndex + (i - 1) * vertsCount + j + 1);
-					indices.emplace_back(vertexIndex + i * vertsCount + j);
-					indices.emplace_back(vertexIndex + i * vertsCount + j + 1);
+					*indices++ = vertexIndex + (i - 1) * vertsCount + j + 1;
+					*indices++ = vertexIndex + i * vertsCount + j;
+					*indices++ = vertexIndex + i * vertsCount + j + 1;
 				}
 				else
 				{
 					// Down triangle
-					indices.emplace_back(vertexIndex + (i - 1) * vertsCount + j);
-					indices.emplace_back(vertexIndex + (i - 1) * vertsCount + j + 1);
-					indices.emplace_back(vertexIndex + i * vertsCount + j);
+					*indices++ = vertexIndex + (i - 1) * vertsCount + j;
+					*indices++ = vertexIndex + (i - 1) * vertsCount + j + 1;
+					*indices++ = vertexIndex + i * vertsCount + j;
 					// Up triangle
-					indices.emplace_back(vertexIndex + i * vertsCount + j + 1);
-					indices.emplace_back(vertexIndex + i * vertsCount + j);
-					indices.emplace_back(vertexIndex + (i - 1) * vertsCount + j + 1);
+					*indices++ = vertexIndex + i * vertsCount + j + 1;
+					*indices++ = vertexIndex + i * vertsCount + j;
+					*indices++ = vertexIndex + (i - 1) * vertsCount + j + 1;
 				}
 			}
 		}
@@ -201,7 +201,7 @@ bool SorghumStateGenerator::OnInspect(const std::shared_ptr<EditorLayer>& editor
 			ImGui::PopStyleColor();
 		}
 	}
-
+	if (changed) MarkParametersChanged();
 	return changed;
 }
 void SorghumStateGenerator::Serialize(YAML::Emitter& out) const {
@@ -235,6 +235,7 @@ void SorghumStateGenerator::Serialize(YAML::Emitter& out) const {
 void SorghumStateGenerator::Deserialize(const YAML::Node& in) {
 	if (in["m_version"])
 		m_version = in["m_version"].as<unsigned>();
+	MarkParametersChanged();
 
 	m_panicleSize.Load("m_panicleSize", in);
 	m_panicleSeedAmount.Load("m_panicleSeedAmount", in);
@@ -453,6 +454,14 @@ void SorghumStateGenerator::Apply(const std::shared_ptr<SorghumState>& targetSta
 	targetState->m_panicle.m_seedRadius = m_panicleSeedRadius.GetValue();
 }
 
+unsigned SorghumStateGenerator::GetParameterVersion() const {
+	return m_parameterVersion;
+}
+
+void SorghumStateGenerator::MarkParametersChanged() {
+	m_parameterVersion++;
+}
+
 void SorghumStateGenerator::OnCreate() {
 	m_panicleSize.m_mean = glm::vec3(0.0, 0.0, 0.0);
 	m_panicleSeedAmount.m_mean = 0;
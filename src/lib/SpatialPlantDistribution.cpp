@@ -52,6 +52,27 @@ void SpatialPlant::Grow(const float size)
 	m_radius = glm::sqrt(newArea * 0.5f / glm::pi<float>());
 }
 
+uint64_t SpatialPlantRandom::Hash(const uint64_t seed, const uint64_t counter0, const uint64_t counter1, const uint64_t counter2)
+{
+	//SplitMix64 finalizer applied to each counter in turn.
+	const auto mix = [](uint64_t value)
+		{
+			value += 0x9E3779B97F4A7C15ull;
+			value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+			value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+			return value ^ (value >> 31);
+		};
+	uint64_t hash = mix(seed);
+	hash = mix(hash ^ counter0);
+	hash = mix(hash ^ counter1);
+	return mix(hash ^ counter2);
+}
+
+float SpatialPlantRandom::Uniform(const uint64_t seed, const uint64_t counter0, const uint64_t counter1, const uint64_t counter2)
+{
+	return static_cast<float>(Hash(seed, counter0, counter1, counter2) >> 40) * (1.0f / 16777216.0f);
+}
+
 void SpatialPlantGridCell::RegisterParticle(const SpatialPlantHandle handle)
 {
 	m_plantHandles.emplace_back(handle);
@@ -118,9 +139,16 @@ float SpatialPlantDistribution::CalculateGrowth(
 	const SpatialPlantHandle plantHandle,
 	const std::vector<SpatialPlantHandle>& neighborPlantHandles) const
 {
-	const auto& plant = m_plants[plantHandle];
+	return CalculateGrowth(richardGrowthModelParameters, m_spatialPlantParameters, m_plants, plantHandle, neighborPlantHandles);
+}
+
+float SpatialPlantDistribution::CalculateGrowth(const SpatialPlantGlobalParameters& richardGrowthModelParameters,
+	const std::vector<SpatialPlantParameter>& spatialPlantParameters, const std::vector<SpatialPlant>& plants,
+	const int plantIndex, const std::vector<int>& neighborPlantIndices)
+{
+	const auto& plant = plants[plantIndex];
 	assert(!plant.m_recycled);
-	const auto& plantParameter = m_spatialPlantParameters[plant.m_parameterHandle];
+	const auto& plantParameter = spatialPlantParameters[plant.m_parameterHandle];
 	const float area = plant.GetArea();
 	assert(area > 0.0f);
 
@@ -129,9 +157,9 @@ float SpatialPlantDistribution::CalculateGrowth(
 	const auto f = glm::pow(area, richardGrowthModelParameters.m_a);
 
 	float areaReduction = 0.0f;
-	for (const auto& neighborPlantHandle : neighborPlantHandles)
+	for (const auto& neighborPlantIndex : neighborPlantIndices)
 	{
-		const auto& otherPlant = m_plants[neighborPlantHandle];
+		const auto& otherPlant = plants[neighborPlantIndex];
 		assert(!otherPlant.m_recycled);
 		areaReduction += otherPlant.GetArea() * otherPlant.AsymmetricalCompetition(plant, richardGrowthModelParameters.m_p);
 	}
@@ -143,12 +171,122 @@ float SpatialPlantDistribution::CalculateGrowth(
 		const float growthRateWithoutCompetition = 1.f / (richardGrowthModelParameters.m_delta - 1.f);
 		const float growthFactor = 1.f - glm::pow(remainingArea / w, richardGrowthModelParameters.m_delta - 1.f);
 		const auto retVal = kf * growthRateWithoutCompetition * growthFactor;
-		return m_spatialPlantGlobalParameters.m_simulationRate * glm::max(0.0f, retVal);
+		return richardGrowthModelParameters.m_simulationRate * glm::max(0.0f, retVal);
 	}
-	return m_spatialPlantGlobalParameters.m_simulationRate * glm::max(0.0f, kf * (glm::log(w) - glm::log(remainingArea)));
+	return richardGrowthModelParameters.m_simulationRate * glm::max(0.0f, kf * (glm::log(w) - glm::log(remainingArea)));
 }
 
-void SpatialPlantDistribution::Simulate()
+void SpatialPlantOverlapResolver::Resize(const size_t size)
+{
+	m_values.resize(size);
+	m_ids.resize(size);
+	m_neighborLists.resize(size);
+	m_states.resize(size);
+	m_ready.resize(size);
+	m_cutoffs.resize(size);
+	m_tieBreaks.resize(size);
+}
+
+void SpatialPlantOverlapResolver::Resolve(const bool forceRemoveOverlap, const uint64_t seed, const uint64_t time)
+{
+	/*
+	 * Overlaps are resolved in rounds. A plant is ready when it ranks above all undecided plants it overlaps. A ready plant
+	 * contests its undecided neighbors in index order, and every loser decides its own fate from the contests it lost.
+	 * Each round only reads the state of the previous round, so the result does not depend on scheduling.
+	 */
+	const auto size = m_states.size();
+	Jobs::RunParallelFor(size, [&](unsigned index)
+		{
+			m_tieBreaks[index] = SpatialPlantRandom::Hash(seed, m_ids[index], time, 3);
+		}
+	);
+	const auto higher = [&](const int a, const int b)
+		{
+			if (m_values[a] != m_values[b]) return m_values[a] > m_values[b];
+			if (m_tieBreaks[a] != m_tieBreaks[b]) return m_tieBreaks[a] > m_tieBreaks[b];
+			return m_ids[a] < m_ids[b];
+		};
+	const auto contest = [&](const int winner, const int loser, const uint64_t stream)
+		{
+			return SpatialPlantRandom::Uniform(seed, (m_ids[winner] << 32) | m_ids[loser], time, stream);
+		};
+	bool remaining = true;
+	while (remaining)
+	{
+		Jobs::RunParallelFor(size, [&](unsigned index)
+			{
+				m_ready[index] = 0;
+				if (m_states[index] != Undecided) return;
+				for (const auto& neighborIndex : m_neighborLists[index])
+				{
+					if (m_states[neighborIndex] == Undecided && higher(neighborIndex, index)) return;
+				}
+				m_ready[index] = 1;
+			}
+		);
+		//The winner of a contest may itself be removed, then it stops contesting the rest of its neighbors.
+		Jobs::RunParallelFor(size, [&](unsigned index)
+			{
+				if (!m_ready[index]) return;
+				m_cutoffs[index] = INT_MAX;
+				if (forceRemoveOverlap) return;
+				for (const auto& neighborIndex : m_neighborLists[index])
+				{
+					if (m_states[neighborIndex] != Undecided) continue;
+					if (m_values[neighborIndex] < contest(index, neighborIndex, 4)) continue;
+					if (m_values[index] < contest(index, neighborIndex, 5))
+					{
+						m_cutoffs[index] = neighborIndex;
+						return;
+					}
+				}
+			}
+		);
+		Jobs::RunParallelFor(size, [&](unsigned index)
+			{
+				if (m_ready[index])
+				{
+					m_states[index] = m_cutoffs[index] == INT_MAX ? Survived : Removed;
+					return;
+				}
+				if (m_states[index] != Undecided) return;
+				for (const auto& neighborIndex : m_neighborLists[index])
+				{
+					if (!m_ready[neighborIndex] || static_cast<int>(index) >= m_cutoffs[neighborIndex]) continue;
+					if (forceRemoveOverlap || m_values[index] < contest(neighborIndex, index, 4))
+					{
+						m_states[index] = Removed;
+						return;
+					}
+				}
+			}
+		);
+		remaining = false;
+		for (const auto& state : m_states)
+		{
+			if (state == Undecided)
+			{
+				remaining = true;
+				break;
+			}
+		}
+	}
+}
+
+void SpatialPlantDistribution::CollectNeighbors(const SpatialPlant& plant, const float maxRadius, std::vector<SpatialPlantHandle>& neighbors)
+{
+	neighbors.clear();
+	m_plantGrid.ForEachPlant(plant.m_position, 2.f * maxRadius + plant.m_radius, [&](SpatialPlantHandle otherPlantHandle)
+		{
+			const auto& otherPlant = m_plants[otherPlantHandle];
+			if (otherPlantHandle != plant.m_handle && !otherPlant.m_recycled && glm::distance(otherPlant.m_position, plant.m_position) < otherPlant.m_radius + plant.m_radius) {
+				neighbors.emplace_back(otherPlantHandle);
+			}
+		}
+	);
+}
+
+void SpatialPlantDistribution::UpdateGrid()
 {
 	const auto cellSize = 10.f;
 	const auto newMin = glm::vec2(-m_spatialPlantGlobalParameters.m_maxRadius);
@@ -170,57 +308,87 @@ void SpatialPlantDistribution::Simulate()
 			}
 		}
 	}
+}
+
+void SpatialPlantDistribution::Simulate()
+{
+	UpdateGrid();
 	float maxRadius = 0.0f;
 	for(const auto& parameter : m_spatialPlantParameters)
 	{
 		maxRadius = glm::max(maxRadius, parameter.m_finalRadius);
 	}
+	//Growth only reads the radii of the neighbors, so the new radii are written after all plants are evaluated.
+	std::vector<float> growSizes(m_plants.size());
 	Jobs::RunParallelFor(m_plants.size(), [&](unsigned plantIndex)
 		{
-			auto& plant = m_plants[plantIndex];
+			const auto& plant = m_plants[plantIndex];
 			if (plant.m_recycled) return;
 			std::vector<SpatialPlantHandle> neighbors{};
-			m_plantGrid.ForEachPlant(plant.m_position, 2.f * maxRadius + plant.m_radius, [&](SpatialPlantHandle otherPlantHandle)
-				{
-					const auto& otherPlant = m_plants[otherPlantHandle];
-					if (otherPlantHandle != plant.m_handle && !otherPlant.m_recycled && glm::distance(otherPlant.m_position, plant.m_position) < otherPlant.m_radius + plant.m_radius) {
-						neighbors.emplace_back(otherPlantHandle);
-					}
-				}
-			);
-			const auto growSize = CalculateGrowth(m_spatialPlantGlobalParameters, plant.m_handle, neighbors);
-			plant.Grow(growSize);
+			CollectNeighbors(plant, maxRadius, neighbors);
+			growSizes[plantIndex] = CalculateGrowth(m_spatialPlantGlobalParameters, plant.m_handle, neighbors);
+		}
+	);
+	Jobs::RunParallelFor(m_plants.size(), [&](unsigned plantIndex)
+		{
+			auto& plant = m_plants[plantIndex];
+			if (!plant.m_recycled) plant.Grow(growSizes[plantIndex]);
 		}
 	);
 
-	std::vector<SpatialPlantHandle> oldPlants;
+	SeedPlants();
 	for (const auto& plant : m_plants)
 	{
-		if (!plant.m_recycled) oldPlants.emplace_back(plant.m_handle);
+		if(plant.m_recycled) continue;
+		if (glm::abs(plant.m_position.x) > m_spatialPlantGlobalParameters.m_maxRadius
+			|| glm::abs(plant.m_position.y) > m_spatialPlantGlobalParameters.m_maxRadius) RecyclePlant(plant.m_handle);
 	}
-	for (const auto& plantHandle : oldPlants)
-	{
-		const auto& parameter = m_spatialPlantParameters[m_plants[plantHandle].m_parameterHandle];
-		if (m_spatialPlantGlobalParameters.m_simulationRate * parameter.m_seedingPossibility * m_plants[plantHandle].GetArea() > glm::linearRand(0.0f, 1.0f)) {
-			auto direction = glm::circularRand(1.0f);
-			const auto position = m_plants[plantHandle].m_position + direction * (glm::linearRand(parameter.m_seedingRangeMin, parameter.m_seedingRangeMax) * m_plants[plantHandle].m_radius + parameter.m_seedInitialRadius);
+	ResolveOverlaps(maxRadius);
+	m_simulationTime++;
+}
+
+void SpatialPlantDistribution::SeedPlants()
+{
+	//Every plant draws its own numbers, keyed by its handle and the simulation time. New plants are added in handle order afterward.
+	const auto seed = m_spatialPlantGlobalParameters.m_seed;
+	const auto time = static_cast<uint64_t>(m_simulationTime);
+	const auto plantSize = m_plants.size();
+	std::vector<unsigned char> seeding(plantSize, 0);
+	std::vector<glm::vec2> seedPositions(plantSize);
+	Jobs::RunParallelFor(plantSize, [&](unsigned plantIndex)
+		{
+			const auto& plant = m_plants[plantIndex];
+			if (plant.m_recycled) return;
+			const auto& parameter = m_spatialPlantParameters[plant.m_parameterHandle];
+			if (m_spatialPlantGlobalParameters.m_simulationRate * parameter.m_seedingPossibility * plant.GetArea() <= SpatialPlantRandom::Uniform(seed, plantIndex, time, 0)) return;
+			const auto angle = 2.f * glm::pi<float>() * SpatialPlantRandom::Uniform(seed, plantIndex, time, 1);
+			const auto direction = glm::vec2(glm::cos(angle), glm::sin(angle));
+			const auto range = glm::mix(parameter.m_seedingRangeMin, parameter.m_seedingRangeMax, SpatialPlantRandom::Uniform(seed, plantIndex, time, 2));
+			const auto position = plant.m_position + direction * (range * plant.m_radius + parameter.m_seedInitialRadius);
 			if (glm::abs(position.x) < m_spatialPlantGlobalParameters.m_maxRadius && glm::abs(position.y) < m_spatialPlantGlobalParameters.m_maxRadius) {
-				AddPlant(m_plants[plantHandle].m_parameterHandle, parameter.m_seedInitialRadius, position);
+				seeding[plantIndex] = 1;
+				seedPositions[plantIndex] = position;
 			}
 		}
-	}
-	for (const auto& plant : m_plants)
+	);
+	for (size_t plantIndex = 0; plantIndex < plantSize; plantIndex++)
 	{
-		if(plant.m_recycled) continue;
-		if (glm::abs(plant.m_position.x) > m_spatialPlantGlobalParameters.m_maxRadius
-			|| glm::abs(plant.m_position.y) > m_spatialPlantGlobalParameters.m_maxRadius) RecyclePlant(plant.m_handle);
+		if (!seeding[plantIndex]) continue;
+		const auto parameterHandle = m_plants[plantIndex].m_parameterHandle;
+		AddPlant(parameterHandle, m_spatialPlantParameters[parameterHandle].m_seedInitialRadius, seedPositions[plantIndex]);
 	}
+}
 
+void SpatialPlantDistribution::ResolveOverlaps(const float maxRadius)
+{
+	const auto seed = m_spatialPlantGlobalParameters.m_seed;
+	const auto time = static_cast<uint64_t>(m_simulationTime);
+	const auto plantSize = m_plants.size();
 	std::vector<float> plantSizes;
 	std::vector<float> inverseStatisticalDistributions;
 	plantSizes.resize(m_spatialPlantParameters.size());
 	inverseStatisticalDistributions.resize(m_spatialPlantParameters.size());
-	for (auto& plantSize : plantSizes) plantSize = 0;
+	std::fill(plantSizes.begin(), plantSizes.end(), 0.0f);
 	float totalSize = 0.0f;
 	for (const auto& plant : m_plants)
 	{
@@ -233,70 +401,31 @@ void SpatialPlantDistribution::Simulate()
 	{
 		inverseStatisticalDistributions[i] = glm::pow(1.f - plantSizes[i] / totalSize,  m_spatialPlantGlobalParameters.m_dynamicBalanceFactor);
 	}
-	for (int i = 0; i < m_plants.size(); i++)
-	{
-		auto& plantI = m_plants[i];
-		if (plantI.m_recycled) continue;
-		std::vector<SpatialPlantHandle> neighbors{};
-		m_plantGrid.ForEachPlant(plantI.m_position, 2.f * maxRadius + plantI.m_radius, [&](SpatialPlantHandle otherPlantHandle)
-			{
-				const auto& otherPlant = m_plants[otherPlantHandle];
-				if (otherPlantHandle != plantI.m_handle && !otherPlant.m_recycled && glm::distance(otherPlant.m_position, plantI.m_position) < otherPlant.m_radius + plantI.m_radius) {
-					neighbors.emplace_back(otherPlantHandle);
-				}
-			}
-		);
-		for(const auto& j : neighbors)
+	SpatialPlantOverlapResolver resolver;
+	resolver.Resize(plantSize);
+	Jobs::RunParallelFor(plantSize, [&](unsigned plantIndex)
 		{
-			auto& plantJ = m_plants[j];
-			if (plantJ.m_recycled) continue;
-			if (glm::distance(plantI.m_position, plantJ.m_position) < plantI.m_radius + plantJ.m_radius)
+			const auto& plant = m_plants[plantIndex];
+			resolver.m_ids[plantIndex] = plantIndex;
+			if (plant.m_recycled)
 			{
-				const float relativeSizeI = plantI.m_radius / m_spatialPlantParameters[plantI.m_parameterHandle].m_finalRadius;
-				const float relativeSizeJ = plantJ.m_radius / m_spatialPlantParameters[plantJ.m_parameterHandle].m_finalRadius;
-				const float vi = 1.0f / m_spatialPlantGlobalParameters.m_simulationRate * inverseStatisticalDistributions[plantI.m_parameterHandle] * (relativeSizeI > m_spatialPlantGlobalParameters.m_spawnProtectionFactor ? 1.f : relativeSizeI);
-				const float vj = 1.0f / m_spatialPlantGlobalParameters.m_simulationRate * inverseStatisticalDistributions[plantJ.m_parameterHandle] * (relativeSizeJ > m_spatialPlantGlobalParameters.m_spawnProtectionFactor ? 1.f : relativeSizeJ);
-				const bool equalFirst = glm::linearRand(0.0f, 1.0f) > 0.5f;
-
-				if (vi > vj || (vi == vj && equalFirst))
-				{
-					if (m_spatialPlantGlobalParameters.m_forceRemoveOverlap)
-					{
-						RecyclePlant(j);
-					}
-					else {
-						if (vj < glm::linearRand(0.0f, 1.0f))
-						{
-							RecyclePlant(j);
-						}
-						else if (vi < glm::linearRand(0.0f, 1.0f))
-						{
-							RecyclePlant(i);
-						}
-					}
-				}
-				else if (vi < vj || (vi == vj && !equalFirst))
-				{
-					if (m_spatialPlantGlobalParameters.m_forceRemoveOverlap)
-					{
-						RecyclePlant(i);
-					}
-					else {
-						if (vi < glm::linearRand(0.0f, 1.0f))
-						{
-							RecyclePlant(i);
-						}
-						else if (vj < glm::linearRand(0.0f, 1.0f))
-						{
-							RecyclePlant(j);
-						}
-					}
-				}
+				resolver.m_states[plantIndex] = SpatialPlantOverlapResolver::Removed;
+				return;
 			}
-			if (plantI.m_recycled) break;
+			resolver.m_states[plantIndex] = SpatialPlantOverlapResolver::Undecided;
+			const float relativeSize = plant.m_radius / m_spatialPlantParameters[plant.m_parameterHandle].m_finalRadius;
+			resolver.m_values[plantIndex] = 1.0f / m_spatialPlantGlobalParameters.m_simulationRate * inverseStatisticalDistributions[plant.m_parameterHandle] * (relativeSize > m_spatialPlantGlobalParameters.m_spawnProtectionFactor ? 1.f : relativeSize);
+			auto& neighbors = resolver.m_neighborLists[plantIndex];
+			CollectNeighbors(plant, maxRadius, neighbors);
+			std::sort(neighbors.begin(), neighbors.end());
 		}
+	);
+	resolver.Resolve(m_spatialPlantGlobalParameters.m_forceRemoveOverlap, seed, time);
+	const auto& states = resolver.m_states;
+	for (size_t plantIndex = 0; plantIndex < plantSize; plantIndex++)
+	{
+		if (states[plantIndex] == SpatialPlantOverlapResolver::Removed && !m_plants[plantIndex].m_recycled) RecyclePlant(plantIndex);
 	}
-	m_simulationTime++;
 }
 
 SpatialPlantHandle SpatialPlantDistribution::AddPlant(const SpatialPlantParameterHandle spatialPlantParameterHandle, const float radius, const glm::vec2& position)
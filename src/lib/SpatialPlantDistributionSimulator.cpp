@@ -108,6 +108,8 @@ bool SpatialPlantDistributionSimulator::OnInspect(const std::shared_ptr<EditorLa
 		ImGui::DragFloat("Max Radius", &m_distribution.m_spatialPlantGlobalParameters.m_maxRadius, 1.f, 10.0f, 10000.0f);
 		ImGui::Checkbox("Force remove all overlap", &m_distribution.m_spatialPlantGlobalParameters.m_forceRemoveOverlap);
 		ImGui::DragFloat("Dynamic balance factor", &m_distribution.m_spatialPlantGlobalParameters.m_dynamicBalanceFactor, 0.1f, 0.0f, 3.0f);
+		int seed = static_cast<int>(m_distribution.m_spatialPlantGlobalParameters.m_seed);
+		if (ImGui::DragInt("Seed", &seed, 1, 0, INT_MAX)) m_distribution.m_spatialPlantGlobalParameters.m_seed = static_cast<unsigned>(seed);
 		ImGui::TreePop();
 	}
 
@@ -161,6 +163,31 @@ bool SpatialPlantDistributionSimulator::OnInspect(const std::shared_ptr<EditorLa
 		ImGui::TreePop();
 	}
 
+	if (ImGui::TreeNode("Landscape"))
+	{
+		ImGui::InputText("Storage path", m_landscapeStoragePath, 256);
+		ImGui::DragFloat("Tile size", &m_landscape.m_tileSize, 1.f, 10.0f, 10000.0f);
+		ImGui::DragInt2("Active min", &m_landscape.m_activeMin.x);
+		ImGui::DragInt2("Active max", &m_landscape.m_activeMax.x);
+		m_landscape.m_activeMax = glm::max(m_landscape.m_activeMin, m_landscape.m_activeMax);
+		m_landscape.m_storagePath = std::filesystem::path(m_landscapeStoragePath);
+		if (ImGui::Button("Import distribution")) m_landscape.Import(m_distribution);
+		ImGui::SameLine();
+		if (ImGui::Button("Save")) m_landscape.Save();
+		ImGui::SameLine();
+		if (ImGui::Button("Load")) m_landscape.Load();
+		ImGui::DragInt("Steps", &m_landscapeStepCount, 1, 1, 1000);
+		if (ImGui::Button("Simulate landscape"))
+		{
+			for (int i = 0; i < m_landscapeStepCount; i++) m_landscape.Simulate();
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Show active region")) m_landscape.Export(m_distribution);
+		ImGui::Text(("Resident tiles: " + std::to_string(m_landscape.GetResidentTileSize()) + " | Stored tiles: " + std::to_string(m_landscape.GetStoredTileSize()) +
+			" | Resident plants: " + std::to_string(m_landscape.GetResidentPlantSize()) + " | Simulation time: " + std::to_string(m_landscape.m_simulationTime)).c_str());
+		ImGui::TreePop();
+	}
+
 	ImGui::Checkbox("Simulate", &m_simulate);
 	static bool setParent = true;
 	static float range = 10.0f;
@@ -0,0 +1,529 @@
+#include "SpatialPlantLandscape.hpp"
+
+using namespace EcoSysLab;
+
+constexpr uint32_t SpatialPlantTileMagic = 0x544C5053; // "SPLT"
+constexpr uint32_t SpatialPlantTileVersion = 1;
+constexpr uint32_t SpatialPlantLandscapeMagic = 0x4C4C5053; // "SPLL"
+constexpr uint32_t SpatialPlantLandscapeVersion = 1;
+
+size_t SpatialPlantTile::GetPlantSize() const
+{
+	return m_ids.size();
+}
+
+void SpatialPlantTile::AddPlant(const uint64_t id, const SpatialPlantParameterHandle parameterHandle, const float radius, const glm::vec2& position)
+{
+	m_positions.emplace_back(position);
+	m_radii.emplace_back(radius);
+	m_parameterHandles.emplace_back(parameterHandle);
+	m_ids.emplace_back(id);
+}
+
+void SpatialPlantTile::RemovePlants(const std::vector<unsigned char>& removeFlags)
+{
+	assert(removeFlags.size() == GetPlantSize());
+	size_t count = 0;
+	for (size_t i = 0; i < removeFlags.size(); i++)
+	{
+		if (removeFlags[i]) continue;
+		m_positions[count] = m_positions[i];
+		m_radii[count] = m_radii[i];
+		m_parameterHandles[count] = m_parameterHandles[i];
+		m_ids[count] = m_ids[i];
+		count++;
+	}
+	m_positions.resize(count);
+	m_radii.resize(count);
+	m_parameterHandles.resize(count);
+	m_ids.resize(count);
+}
+
+void SpatialPlantTile::Clear()
+{
+	m_positions.clear();
+	m_radii.clear();
+	m_parameterHandles.clear();
+	m_ids.clear();
+}
+
+bool SpatialPlantTile::Save(const std::filesystem::path& path) const
+{
+	std::ofstream of(path, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+	if (!of.is_open())
+	{
+		EVOENGINE_ERROR("Can't open tile file " + path.string() + "!");
+		return false;
+	}
+	const uint64_t plantSize = GetPlantSize();
+	of.write(reinterpret_cast<const char*>(&SpatialPlantTileMagic), sizeof(uint32_t));
+	of.write(reinterpret_cast<const char*>(&SpatialPlantTileVersion), sizeof(uint32_t));
+	of.write(reinterpret_cast<const char*>(&m_coordinate), sizeof(glm::ivec2));
+	of.write(reinterpret_cast<const char*>(&plantSize), sizeof(uint64_t));
+	of.write(reinterpret_cast<const char*>(m_positions.data()), plantSize * sizeof(glm::vec2));
+	of.write(reinterpret_cast<const char*>(m_radii.data()), plantSize * sizeof(float));
+	of.write(reinterpret_cast<const char*>(m_parameterHandles.data()), plantSize * sizeof(SpatialPlantParameterHandle));
+	of.write(reinterpret_cast<const char*>(m_ids.data()), plantSize * sizeof(uint64_t));
+	return of.good();
+}
+
+bool SpatialPlantTile::Load(const std::filesystem::path& path)
+{
+	std::ifstream input(path, std::ifstream::in | std::ifstream::binary);
+	if (!input.is_open())
+	{
+		EVOENGINE_ERROR("Can't open tile file " + path.string() + "!");
+		return false;
+	}
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	uint64_t plantSize = 0;
+	input.read(reinterpret_cast<char*>(&magic), sizeof(uint32_t));
+	input.read(reinterpret_cast<char*>(&version), sizeof(uint32_t));
+	if (!input || magic != SpatialPlantTileMagic || version != SpatialPlantTileVersion)
+	{
+		EVOENGINE_ERROR("Wrong tile file " + path.string() + "!");
+		return false;
+	}
+	input.read(reinterpret_cast<char*>(&m_coordinate), sizeof(glm::ivec2));
+	input.read(reinterpret_cast<char*>(&plantSize), sizeof(uint64_t));
+	m_positions.resize(plantSize);
+	m_radii.resize(plantSize);
+	m_parameterHandles.resize(plantSize);
+	m_ids.resize(plantSize);
+	input.read(reinterpret_cast<char*>(m_positions.data()), plantSize * sizeof(glm::vec2));
+	input.read(reinterpret_cast<char*>(m_radii.data()), plantSize * sizeof(float));
+	input.read(reinterpret_cast<char*>(m_parameterHandles.data()), plantSize * sizeof(SpatialPlantParameterHandle));
+	input.read(reinterpret_cast<char*>(m_ids.data()), plantSize * sizeof(uint64_t));
+	if (!input)
+	{
+		EVOENGINE_ERROR("Tile file " + path.string() + " is truncated!");
+		Clear();
+		return false;
+	}
+	return true;
+}
+
+void SpatialPlantCellIndex::Build(const std::vector<SpatialPlant>& plants, const glm::vec2& min, const glm::vec2& max, const float cellSize)
+{
+	m_min = min;
+	m_cellSize = cellSize;
+	m_resolution = glm::max(glm::ivec2(glm::ceil((max - min) / cellSize)), glm::ivec2(1));
+	const auto cellCount = static_cast<size_t>(m_resolution.x) * m_resolution.y;
+	m_cellStarts.assign(cellCount + 1, 0);
+	std::vector<unsigned> cellIndices(plants.size());
+	for (size_t i = 0; i < plants.size(); i++)
+	{
+		const auto coordinate = glm::clamp(glm::ivec2(glm::floor((plants[i].m_position - m_min) / m_cellSize)), glm::ivec2(0), m_resolution - 1);
+		cellIndices[i] = coordinate.x * m_resolution.y + coordinate.y;
+		m_cellStarts[cellIndices[i] + 1]++;
+	}
+	for (size_t i = 0; i < cellCount; i++) m_cellStarts[i + 1] += m_cellStarts[i];
+	std::vector<unsigned> cursors(m_cellStarts.begin(), m_cellStarts.end() - 1);
+	m_plantIndices.resize(plants.size());
+	for (size_t i = 0; i < plants.size(); i++)
+	{
+		m_plantIndices[cursors[cellIndices[i]]++] = static_cast<unsigned>(i);
+	}
+}
+
+uint64_t SpatialPlantLandscape::GetTileKey(const glm::ivec2& coordinate)
+{
+	return static_cast<uint64_t>(static_cast<uint32_t>(coordinate.x)) << 32 | static_cast<uint32_t>(coordinate.y);
+}
+
+glm::ivec2 SpatialPlantLandscape::GetTileCoordinate(const glm::vec2& position) const
+{
+	return glm::ivec2(glm::floor(position / m_tileSize));
+}
+
+bool SpatialPlantLandscape::IsActive(const glm::ivec2& coordinate) const
+{
+	return coordinate.x >= m_activeMin.x && coordinate.y >= m_activeMin.y && coordinate.x <= m_activeMax.x && coordinate.y <= m_activeMax.y;
+}
+
+std::filesystem::path SpatialPlantLandscape::GetTilePath(const glm::ivec2& coordinate) const
+{
+	return m_storagePath / ("tile_" + std::to_string(coordinate.x) + "_" + std::to_string(coordinate.y) + ".bin");
+}
+
+SpatialPlantTile& SpatialPlantLandscape::RefTile(const glm::ivec2& coordinate)
+{
+	const auto key = GetTileKey(coordinate);
+	const auto search = m_tiles.find(key);
+	if (search != m_tiles.end()) return search->second;
+	auto& tile = m_tiles[key];
+	tile.m_coordinate = coordinate;
+	if (m_storedTiles.find(key) != m_storedTiles.end() && !tile.Load(GetTilePath(coordinate)))
+	{
+		tile.m_coordinate = coordinate;
+	}
+	return tile;
+}
+
+void SpatialPlantLandscape::CollectPlants(const SpatialPlantTile& tile, const float haloWidth, std::vector<SpatialPlant>& plants, std::vector<uint64_t>& ids) const
+{
+	//Plants of the tile come first, followed by the plants of the neighbor tiles that lie within the halo.
+	plants.clear();
+	ids.clear();
+	const auto haloMin = glm::vec2(tile.m_coordinate) * m_tileSize - haloWidth;
+	const auto haloMax = glm::vec2(tile.m_coordinate + 1) * m_tileSize + haloWidth;
+	const auto append = [&](const SpatialPlantTile& source, const bool halo)
+		{
+			for (size_t i = 0; i < source.GetPlantSize(); i++)
+			{
+				const auto& position = source.m_positions[i];
+				if (halo && (position.x < haloMin.x || position.y < haloMin.y || position.x >= haloMax.x || position.y >= haloMax.y)) continue;
+				plants.emplace_back();
+				auto& plant = plants.back();
+				plant.m_handle = static_cast<SpatialPlantHandle>(plants.size() - 1);
+				plant.m_parameterHandle = source.m_parameterHandles[i];
+				plant.m_position = position;
+				plant.m_radius = source.m_radii[i];
+				ids.emplace_back(source.m_ids[i]);
+			}
+		};
+	append(tile, false);
+	for (int dx = -1; dx <= 1; dx++)
+	{
+		for (int dy = -1; dy <= 1; dy++)
+		{
+			if (dx == 0 && dy == 0) continue;
+			const auto search = m_tiles.find(GetTileKey(tile.m_coordinate + glm::ivec2(dx, dy)));
+			if (search != m_tiles.end()) append(search->second, true);
+		}
+	}
+}
+
+void SpatialPlantLandscape::EvictTiles()
+{
+	if (m_storagePath.empty()) return;
+	std::filesystem::create_directories(m_storagePath);
+	for (auto it = m_tiles.begin(); it != m_tiles.end();)
+	{
+		const auto& coordinate = it->second.m_coordinate;
+		if (coordinate.x >= m_activeMin.x - 1 && coordinate.y >= m_activeMin.y - 1 && coordinate.x <= m_activeMax.x + 1 && coordinate.y <= m_activeMax.y + 1)
+		{
+			++it;
+			continue;
+		}
+		if (!it->second.Save(GetTilePath(coordinate)))
+		{
+			++it;
+			continue;
+		}
+		m_storedTiles.emplace(it->first);
+		it = m_tiles.erase(it);
+	}
+}
+
+uint64_t SpatialPlantLandscape::AddPlant(const SpatialPlantParameterHandle spatialPlantParameterHandle, const float radius, const glm::vec2& position)
+{
+	assert(spatialPlantParameterHandle >= 0 && spatialPlantParameterHandle < m_spatialPlantParameters.size());
+	const auto id = m_nextPlantId++;
+	RefTile(GetTileCoordinate(position)).AddPlant(id, spatialPlantParameterHandle, radius, position);
+	return id;
+}
+
+void SpatialPlantLandscape::Import(const SpatialPlantDistribution& distribution)
+{
+	Clear();
+	m_spatialPlantParameters = distribution.m_spatialPlantParameters;
+	m_spatialPlantGlobalParameters = distribution.m_spatialPlantGlobalParameters;
+	m_simulationTime = distribution.m_simulationTime;
+	for (const auto& plant : distribution.m_plants)
+	{
+		if (plant.m_recycled) continue;
+		AddPlant(plant.m_parameterHandle, plant.m_radius, plant.m_position);
+	}
+	EvictTiles();
+}
+
+void SpatialPlantLandscape::Export(SpatialPlantDistribution& distribution) const
+{
+	distribution = {};
+	distribution.m_spatialPlantParameters = m_spatialPlantParameters;
+	distribution.m_spatialPlantGlobalParameters = m_spatialPlantGlobalParameters;
+	distribution.m_simulationTime = m_simulationTime;
+	//The distribution only keeps plants within m_maxRadius of the origin, so it is widened to cover the active region.
+	const auto activeMin = glm::abs(glm::vec2(m_activeMin) * m_tileSize);
+	const auto activeMax = glm::abs(glm::vec2(m_activeMax + 1) * m_tileSize);
+	auto& maxRadius = distribution.m_spatialPlantGlobalParameters.m_maxRadius;
+	maxRadius = glm::max(maxRadius, glm::max(glm::max(activeMin.x, activeMin.y), glm::max(activeMax.x, activeMax.y)) + 1.0f);
+	distribution.UpdateGrid();
+	for (const auto& [key, tile] : m_tiles)
+	{
+		if (!IsActive(tile.m_coordinate)) continue;
+		for (size_t i = 0; i < tile.GetPlantSize(); i++)
+		{
+			distribution.AddPlant(tile.m_parameterHandles[i], tile.m_radii[i], tile.m_positions[i]);
+		}
+	}
+}
+
+void SpatialPlantLandscape::Simulate()
+{
+	const auto seed = m_spatialPlantGlobalParameters.m_seed;
+	const auto time = static_cast<uint64_t>(m_simulationTime);
+	for (int x = m_activeMin.x - 1; x <= m_activeMax.x + 1; x++)
+	{
+		for (int y = m_activeMin.y - 1; y <= m_activeMax.y + 1; y++)
+		{
+			RefTile({ x, y });
+		}
+	}
+	std::vector<SpatialPlantTile*> activeTiles;
+	float maxRadius = 0.0f;
+	for (const auto& parameter : m_spatialPlantParameters) maxRadius = glm::max(maxRadius, parameter.m_finalRadius);
+	for (auto& [key, tile] : m_tiles)
+	{
+		for (const auto& radius : tile.m_radii) maxRadius = glm::max(maxRadius, radius);
+		if (IsActive(tile.m_coordinate)) activeTiles.emplace_back(&tile);
+	}
+	//Two plants interact when their distance is below the sum of their radii, so the halo only needs to cover the two largest radii.
+	const float haloWidth = 2.0f * maxRadius;
+	if (haloWidth > m_tileSize)
+	{
+		EVOENGINE_WARNING("Tile size is smaller than the interaction range, interactions across tiles are cut off!");
+	}
+	const float cellSize = glm::max(1.0f, maxRadius);
+
+	//Growth of every active tile reads the radii from the start of the step, including those of the halo.
+	std::vector<std::vector<float>> growSizes(activeTiles.size());
+	Jobs::RunParallelFor(activeTiles.size(), [&](unsigned tileIndex)
+		{
+			const auto& tile = *activeTiles[tileIndex];
+			std::vector<SpatialPlant> plants;
+			std::vector<uint64_t> ids;
+			CollectPlants(tile, haloWidth, plants, ids);
+			SpatialPlantCellIndex cellIndex;
+			const auto tileMin = glm::vec2(tile.m_coordinate) * m_tileSize;
+			cellIndex.Build(plants, tileMin - haloWidth, tileMin + m_tileSize + haloWidth, cellSize);
+			auto& tileGrowSizes = growSizes[tileIndex];
+			tileGrowSizes.resize(tile.GetPlantSize());
+			std::vector<int> neighbors;
+			for (size_t plantIndex = 0; plantIndex < tile.GetPlantSize(); plantIndex++)
+			{
+				const auto& plant = plants[plantIndex];
+				neighbors.clear();
+				cellIndex.ForEachPlant(plant.m_position, plant.m_radius + maxRadius, [&](const int otherPlantIndex)
+					{
+						const auto& otherPlant = plants[otherPlantIndex];
+						if (otherPlantIndex != static_cast<int>(plantIndex) && glm::distance(otherPlant.m_position, plant.m_position) < otherPlant.m_radius + plant.m_radius)
+						{
+							neighbors.emplace_back(otherPlantIndex);
+						}
+					}
+				);
+				tileGrowSizes[plantIndex] = SpatialPlantDistribution::CalculateGrowth(m_spatialPlantGlobalParameters, m_spatialPlantParameters, plants, static_cast<int>(plantIndex), neighbors);
+			}
+		}
+	);
+
+	//Seeds are drawn per plant, keyed by the plant id, then added in tile order and plant order.
+	std::vector<std::vector<std::pair<SpatialPlantParameterHandle, glm::vec2>>> seeds(activeTiles.size());
+	Jobs::RunParallelFor(activeTiles.size(), [&](unsigned tileIndex)
+		{
+			auto& tile = *activeTiles[tileIndex];
+			const auto& tileGrowSizes = growSizes[tileIndex];
+			for (size_t plantIndex = 0; plantIndex < tile.GetPlantSize(); plantIndex++)
+			{
+				SpatialPlant plant{};
+				plant.m_radius = tile.m_radii[plantIndex];
+				plant.Grow(tileGrowSizes[plantIndex]);
+				tile.m_radii[plantIndex] = plant.m_radius;
+
+				const auto id = tile.m_ids[plantIndex];
+				const auto& parameter = m_spatialPlantParameters[tile.m_parameterHandles[plantIndex]];
+				if (m_spatialPlantGlobalParameters.m_simulationRate * parameter.m_seedingPossibility * plant.GetArea() <= SpatialPlantRandom::Uniform(seed, id, time, 0)) continue;
+				const auto angle = 2.f * glm::pi<float>() * SpatialPlantRandom::Uniform(seed, id, time, 1);
+				const auto direction = glm::vec2(glm::cos(angle), glm::sin(angle));
+				const auto range = glm::mix(parameter.m_seedingRangeMin, parameter.m_seedingRangeMax, SpatialPlantRandom::Uniform(seed, id, time, 2));
+				seeds[tileIndex].emplace_back(tile.m_parameterHandles[plantIndex], tile.m_positions[plantIndex] + direction * (range * plant.m_radius + parameter.m_seedInitialRadius));
+			}
+		}
+	);
+	for (const auto& tileSeeds : seeds)
+	{
+		for (const auto& [parameterHandle, position] : tileSeeds)
+		{
+			AddPlant(parameterHandle, m_spatialPlantParameters[parameterHandle].m_seedInitialRadius, position);
+		}
+	}
+
+	//The balance between plant types is measured over the active region.
+	std::vector<float> plantSizes(m_spatialPlantParameters.size(), 0.0f);
+	std::vector<float> inverseStatisticalDistributions(m_spatialPlantParameters.size());
+	float totalSize = 0.0f;
+	for (const auto& tile : activeTiles)
+	{
+		for (size_t plantIndex = 0; plantIndex < tile->GetPlantSize(); plantIndex++)
+		{
+			const auto area = 2.f * glm::pi<float>() * tile->m_radii[plantIndex] * tile->m_radii[plantIndex];
+			plantSizes[tile->m_parameterHandles[plantIndex]] += area;
+			totalSize += area;
+		}
+	}
+	for (int i = 0; i < inverseStatisticalDistributions.size(); i++)
+	{
+		inverseStatisticalDistributions[i] = glm::pow(1.f - plantSizes[i] / totalSize, m_spatialPlantGlobalParameters.m_dynamicBalanceFactor);
+	}
+
+	//Every tile resolves the overlaps of its own plants against the halo. Fates are applied after all tiles are resolved.
+	std::vector<std::vector<unsigned char>> removeFlags(activeTiles.size());
+	SpatialPlantOverlapResolver resolver;
+	std::vector<SpatialPlant> plants;
+	std::vector<uint64_t> ids;
+	SpatialPlantCellIndex cellIndex;
+	for (size_t tileIndex = 0; tileIndex < activeTiles.size(); tileIndex++)
+	{
+		const auto& tile = *activeTiles[tileIndex];
+		CollectPlants(tile, haloWidth, plants, ids);
+		const auto tileMin = glm::vec2(tile.m_coordinate) * m_tileSize;
+		cellIndex.Build(plants, tileMin - haloWidth, tileMin + m_tileSize + haloWidth, cellSize);
+		resolver.Resize(plants.size());
+		Jobs::RunParallelFor(plants.size(), [&](unsigned plantIndex)
+			{
+				const auto& plant = plants[plantIndex];
+				resolver.m_ids[plantIndex] = ids[plantIndex];
+				resolver.m_states[plantIndex] = SpatialPlantOverlapResolver::Undecided;
+				const float relativeSize = plant.m_radius / m_spatialPlantParameters[plant.m_parameterHandle].m_finalRadius;
+				resolver.m_values[plantIndex] = 1.0f / m_spatialPlantGlobalParameters.m_simulationRate * inverseStatisticalDistributions[plant.m_parameterHandle] * (relativeSize > m_spatialPlantGlobalParameters.m_spawnProtectionFactor ? 1.f : relativeSize);
+				auto& neighbors = resolver.m_neighborLists[plantIndex];
+				neighbors.clear();
+				cellIndex.ForEachPlant(plant.m_position, plant.m_radius + maxRadius, [&](const int otherPlantIndex)
+					{
+						const auto& otherPlant = plants[otherPlantIndex];
+						if (otherPlantIndex != static_cast<int>(plantIndex) && glm::distance(otherPlant.m_position, plant.m_position) < otherPlant.m_radius + plant.m_radius)
+						{
+							neighbors.emplace_back(otherPlantIndex);
+						}
+					}
+				);
+				std::sort(neighbors.begin(), neighbors.end());
+			}
+		);
+		resolver.Resolve(m_spatialPlantGlobalParameters.m_forceRemoveOverlap, seed, time);
+		auto& tileRemoveFlags = removeFlags[tileIndex];
+		tileRemoveFlags.resize(tile.GetPlantSize());
+		for (size_t plantIndex = 0; plantIndex < tile.GetPlantSize(); plantIndex++)
+		{
+			tileRemoveFlags[plantIndex] = resolver.m_states[plantIndex] == SpatialPlantOverlapResolver::Removed;
+		}
+	}
+	for (size_t tileIndex = 0; tileIndex < activeTiles.size(); tileIndex++)
+	{
+		activeTiles[tileIndex]->RemovePlants(removeFlags[tileIndex]);
+	}
+	m_simulationTime++;
+	EvictTiles();
+}
+
+bool SpatialPlantLandscape::Save()
+{
+	if (m_storagePath.empty())
+	{
+		EVOENGINE_ERROR("No storage path for landscape!");
+		return false;
+	}
+	std::filesystem::create_directories(m_storagePath);
+	bool succeeded = true;
+	for (const auto& [key, tile] : m_tiles)
+	{
+		if (tile.Save(GetTilePath(tile.m_coordinate))) m_storedTiles.emplace(key);
+		else succeeded = false;
+	}
+	const auto path = m_storagePath / "landscape.bin";
+	std::ofstream of(path, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+	if (!of.is_open())
+	{
+		EVOENGINE_ERROR("Can't open landscape file " + path.string() + "!");
+		return false;
+	}
+	const uint64_t parameterSize = m_spatialPlantParameters.size();
+	const uint64_t storedTileSize = m_storedTiles.size();
+	of.write(reinterpret_cast<const char*>(&SpatialPlantLandscapeMagic), sizeof(uint32_t));
+	of.write(reinterpret_cast<const char*>(&SpatialPlantLandscapeVersion), sizeof(uint32_t));
+	of.write(reinterpret_cast<const char*>(&m_nextPlantId), sizeof(uint64_t));
+	of.write(reinterpret_cast<const char*>(&m_simulationTime), sizeof(int));
+	of.write(reinterpret_cast<const char*>(&m_tileSize), sizeof(float));
+	of.write(reinterpret_cast<const char*>(&m_activeMin), sizeof(glm::ivec2));
+	of.write(reinterpret_cast<const char*>(&m_activeMax), sizeof(glm::ivec2));
+	of.write(reinterpret_cast<const char*>(&m_spatialPlantGlobalParameters), sizeof(SpatialPlantGlobalParameters));
+	of.write(reinterpret_cast<const char*>(&parameterSize), sizeof(uint64_t));
+	of.write(reinterpret_cast<const char*>(m_spatialPlantParameters.data()), parameterSize * sizeof(SpatialPlantParameter));
+	of.write(reinterpret_cast<const char*>(&storedTileSize), sizeof(uint64_t));
+	for (const auto& key : m_storedTiles) of.write(reinterpret_cast<const char*>(&key), sizeof(uint64_t));
+	return of.good() && succeeded;
+}
+
+bool SpatialPlantLandscape::Load()
+{
+	const auto path = m_storagePath / "landscape.bin";
+	std::ifstream input(path, std::ifstream::in | std::ifstream::binary);
+	if (!input.is_open())
+	{
+		EVOENGINE_ERROR("Can't open landscape file " + path.string() + "!");
+		return false;
+	}
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	input.read(reinterpret_cast<char*>(&magic), sizeof(uint32_t));
+	input.read(reinterpret_cast<char*>(&version), sizeof(uint32_t));
+	if (!input || magic != SpatialPlantLandscapeMagic || version != SpatialPlantLandscapeVersion)
+	{
+		EVOENGINE_ERROR("Wrong landscape file " + path.string() + "!");
+		return false;
+	}
+	Clear();
+	uint64_t parameterSize = 0;
+	uint64_t storedTileSize = 0;
+	input.read(reinterpret_cast<char*>(&m_nextPlantId), sizeof(uint64_t));
+	input.read(reinterpret_cast<char*>(&m_simulationTime), sizeof(int));
+	input.read(reinterpret_cast<char*>(&m_tileSize), sizeof(float));
+	input.read(reinterpret_cast<char*>(&m_activeMin), sizeof(glm::ivec2));
+	input.read(reinterpret_cast<char*>(&m_activeMax), sizeof(glm::ivec2));
+	input.read(reinterpret_cast<char*>(&m_spatialPlantGlobalParameters), sizeof(SpatialPlantGlobalParameters));
+	input.read(reinterpret_cast<char*>(&parameterSize), sizeof(uint64_t));
+	m_spatialPlantParameters.resize(input ? parameterSize : 0);
+	input.read(reinterpret_cast<char*>(m_spatialPlantParameters.data()), m_spatialPlantParameters.size() * sizeof(SpatialPlantParameter));
+	input.read(reinterpret_cast<char*>(&storedTileSize), sizeof(uint64_t));
+	for (uint64_t i = 0; input && i < storedTileSize; i++)
+	{
+		uint64_t key = 0;
+		input.read(reinterpret_cast<char*>(&key), sizeof(uint64_t));
+		if (input) m_storedTiles.emplace(key);
+	}
+	if (!input)
+	{
+		EVOENGINE_ERROR("Landscape file " + path.string() + " is truncated!");
+		Clear();
+		return false;
+	}
+	return true;
+}
+
+void SpatialPlantLandscape::Clear()
+{
+	m_tiles.clear();
+	m_storedTiles.clear();
+	m_nextPlantId = 0;
+	m_simulationTime = 0;
+}
+
+size_t SpatialPlantLandscape::GetResidentTileSize() const
+{
+	return m_tiles.size();
+}
+
+size_t SpatialPlantLandscape::GetStoredTileSize() const
+{
+	return m_storedTiles.size();
+}
+
+size_t SpatialPlantLandscape::GetResidentPlantSize() const
+{
+	size_t retVal = 0;
+	for (const auto& [key, tile] : m_tiles) retVal += tile.GetPlantSize();
+	return retVal;
+}
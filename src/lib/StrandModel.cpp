@@ -255,6 +255,7 @@ void StrandModel::PackTask(const SkeletonNodeHandle nodeHandle, const StrandMode
 		internodeData.m_profile.Simulate(1,
 			[&](auto& grid, bool gridResized)
 			{
+				if (internodeData.m_boundariesUpdated) internodeData.m_profileConstraints.BuildSegmentGrids();
 				if (gridResized || internodeData.m_boundariesUpdated) grid.ApplyBoundaries(internodeData.m_profileConstraints);
 				internodeData.m_boundariesUpdated = false;
 			},
@@ -699,6 +700,7 @@ void StrandModel::CalculateStrandProfileAdjustedTransforms(const StrandModelPara
 		auto& node = m_strandModelSkeleton.RefNode(nodeHandle);
 		node.m_info.m_globalRotation = node.m_info.m_regulatedGlobalRotation;
 	}
+	m_strandModelSkeleton.MarkInfoChanged();
 }
 
 
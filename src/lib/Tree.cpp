@@ -10,6 +10,7 @@
 #include <TransformGraph.hpp>
 
 #include "Strands.hpp"
+#include "MeshExporter.hpp"
 #include "EditorLayer.hpp"
 #include "Application.hpp"
 #include "BarkDescriptor.hpp"
@@ -161,6 +162,23 @@ void Tree::Reset()
 	m_treeVisualizer.Reset(m_treeModel);
 }
 
+void SkeletalGraph::Reset()
+{
+	m_lineEntity = {};
+	m_pointEntity = {};
+	m_lineList.reset();
+	m_pointList.reset();
+	m_lineParticleInfos.clear();
+	m_pointParticleInfos.clear();
+	m_dirtyNodes.clear();
+	m_sortedIndices.clear();
+	m_subTreeFlags.clear();
+	m_skeletonVersion = -1;
+	m_infoVersion = -1;
+	m_baseNodeHandle = -1;
+	m_strandReady = false;
+}
+
 void Tree::ClearSkeletalGraph() const
 {
 	const auto scene = GetScene();
@@ -175,7 +193,102 @@ void Tree::ClearSkeletalGraph() const
 			scene->DeleteEntity(child);
 		}
 	}
+	m_skeletalGraph.Reset();
+}
 
+void BuildSkeletalGraphInstances(const SkeletalGraphNodeState& state, const SkeletalGraphSettings& skeletalGraphSettings,
+	ParticleInfo& lineParticleInfo, ParticleInfo& pointParticleInfo)
+{
+	const auto subTree = state.m_subTree;
+	auto rotation = state.m_rotation;
+	{
+		rotation *= glm::quat(glm::vec3(glm::radians(90.0f), 0.0f, 0.0f));
+		const glm::mat4 rotationTransform = glm::mat4_cast(rotation);
+		const auto direction = glm::normalize(state.m_rotation * glm::vec3(0, 0, -1));
+		lineParticleInfo.m_instanceMatrix.m_value =
+			glm::translate(state.m_position + (state.m_length / 2.0f) * direction) *
+			rotationTransform *
+			glm::scale(glm::vec3(
+				skeletalGraphSettings.m_fixedLineThickness * (subTree ? 1.25f : 1.0f),
+				state.m_length,
+				skeletalGraphSettings.m_fixedLineThickness * (subTree ? 1.25f : 1.0f)));
+		lineParticleInfo.m_instanceColor = subTree ? skeletalGraphSettings.m_lineFocusColor : skeletalGraphSettings.m_lineColor;
+	}
+	{
+		rotation *= glm::quat(glm::vec3(glm::radians(90.0f), 0.0f, 0.0f));
+		const glm::mat4 rotationTransform = glm::mat4_cast(rotation);
+		float thicknessFactor = state.m_thickness;
+		if (skeletalGraphSettings.m_fixedPointSize) thicknessFactor = skeletalGraphSettings.m_fixedPointSizeFactor;
+		auto scale = glm::vec3(skeletalGraphSettings.m_branchPointSize * thicknessFactor);
+		pointParticleInfo.m_instanceColor = skeletalGraphSettings.m_branchPointColor;
+		if (state.m_junction)
+		{
+			scale = glm::vec3(skeletalGraphSettings.m_junctionPointSize * thicknessFactor);
+			pointParticleInfo.m_instanceColor = skeletalGraphSettings.m_junctionPointColor;
+		}
+		pointParticleInfo.m_instanceMatrix.m_value =
+			glm::translate(state.m_position) *
+			rotationTransform *
+			glm::scale(scale * (subTree ? 1.25f : 1.0f));
+		if (subTree)
+		{
+			pointParticleInfo.m_instanceColor = skeletalGraphSettings.m_branchFocusColor;
+		}
+	}
+}
+
+/**
+ * Rebuild the instances of the nodes that changed since the last update, m_dirtyNodes lists them afterwards.
+ * The skeleton versions tell whether anything moved: if neither the structure nor the node infos changed, only the nodes
+ * whose focus flag flipped are rebuilt, and nothing at all if the focus stayed the same.
+ */
+template<typename SkeletonData, typename FlowData, typename NodeData>
+void UpdateSkeletalGraphInstances(const Skeleton<SkeletonData, FlowData, NodeData>& skeleton,
+	const SkeletalGraphSettings& skeletalGraphSettings, const SkeletonNodeHandle baseNodeHandle, const bool rebuildAll, SkeletalGraph& skeletalGraph)
+{
+	skeletalGraph.m_dirtyNodes.clear();
+	const auto& sortedNodeList = skeleton.PeekSortedNodeList();
+	const auto nodeSize = sortedNodeList.size();
+	const bool structureChanged = rebuildAll || skeletalGraph.m_skeletonVersion != skeleton.GetVersion() || skeletalGraph.m_subTreeFlags.size() != nodeSize;
+	const bool infoChanged = structureChanged || skeletalGraph.m_infoVersion != skeleton.GetInfoVersion();
+	if (!infoChanged && skeletalGraph.m_baseNodeHandle == baseNodeHandle) return;
+	if (structureChanged)
+	{
+		skeletalGraph.m_lineParticleInfos.resize(nodeSize);
+		skeletalGraph.m_pointParticleInfos.resize(nodeSize);
+		skeletalGraph.m_subTreeFlags.assign(nodeSize, 0);
+		skeletalGraph.m_sortedIndices.assign(skeleton.PeekRawNodes().size(), -1);
+		for (size_t i = 0; i < nodeSize; i++) skeletalGraph.m_sortedIndices[sortedNodeList[i]] = static_cast<int>(i);
+		skeletalGraph.m_skeletonVersion = skeleton.GetVersion();
+	}
+	skeletalGraph.m_infoVersion = skeleton.GetInfoVersion();
+	skeletalGraph.m_baseNodeHandle = baseNodeHandle;
+	//Parents come before their children in the sorted list, so the focus flag is inherited in one pass instead of walking to the root per node.
+	for (unsigned i = 0; i < nodeSize; i++)
+	{
+		const auto nodeHandle = sortedNodeList[i];
+		const auto parentHandle = skeleton.PeekNode(nodeHandle).GetParentHandle();
+		const unsigned char subTree = nodeHandle == baseNodeHandle
+			|| (parentHandle != -1 && skeletalGraph.m_subTreeFlags[skeletalGraph.m_sortedIndices[parentHandle]]);
+		if (infoChanged || skeletalGraph.m_subTreeFlags[i] != subTree) skeletalGraph.m_dirtyNodes.emplace_back(i);
+		skeletalGraph.m_subTreeFlags[i] = subTree;
+	}
+	Jobs::RunParallelFor(skeletalGraph.m_dirtyNodes.size(), [&](unsigned i)
+		{
+			const auto nodeIndex = skeletalGraph.m_dirtyNodes[i];
+			const auto nodeHandle = sortedNodeList[nodeIndex];
+			const auto& node = skeleton.PeekNode(nodeHandle);
+			SkeletalGraphNodeState nodeState;
+			nodeState.m_handle = nodeHandle;
+			nodeState.m_position = node.m_info.m_globalPosition;
+			nodeState.m_rotation = node.m_info.m_globalRotation;
+			nodeState.m_length = node.m_info.m_length;
+			nodeState.m_thickness = node.m_info.m_thickness;
+			nodeState.m_junction = nodeIndex == 0 || node.PeekChildHandles().size() > 1;
+			nodeState.m_subTree = skeletalGraph.m_subTreeFlags[nodeIndex] != 0;
+			BuildSkeletalGraphInstances(nodeState, skeletalGraphSettings,
+				skeletalGraph.m_lineParticleInfos[nodeIndex], skeletalGraph.m_pointParticleInfos[nodeIndex]);
+		});
 }
 
 void Tree::GenerateSkeletalGraph(
@@ -186,177 +299,54 @@ void Tree::GenerateSkeletalGraph(
 {
 	const auto scene = GetScene();
 	const auto self = GetOwner();
-	ClearSkeletalGraph();
-
-	const auto lineEntity = scene->CreateEntity("Skeletal Graph Lines");
-	scene->SetParent(lineEntity, self);
-
-	const auto pointEntity = scene->CreateEntity("Skeletal Graph Points");
-	scene->SetParent(pointEntity, self);
-
+	auto& skeletalGraph = m_skeletalGraph;
 
 	bool strandReady = false;
 	if (m_strandModel.m_strandModelSkeleton.PeekSortedNodeList().size() > 1)
 	{
 		strandReady = true;
 	}
+	bool rebuildAll = strandReady != skeletalGraph.m_strandReady || skeletalGraph.m_settings != skeletalGraphSettings;
+	if (!scene->IsEntityValid(skeletalGraph.m_lineEntity) || !scene->IsEntityValid(skeletalGraph.m_pointEntity)
+		|| scene->GetParent(skeletalGraph.m_lineEntity) != self || scene->GetParent(skeletalGraph.m_pointEntity) != self)
+	{
+		//The entities and assets are only created the first time, later updates patch the existing lists.
+		ClearSkeletalGraph();
+		skeletalGraph.m_lineEntity = scene->CreateEntity("Skeletal Graph Lines");
+		scene->SetParent(skeletalGraph.m_lineEntity, self);
+		skeletalGraph.m_pointEntity = scene->CreateEntity("Skeletal Graph Points");
+		scene->SetParent(skeletalGraph.m_pointEntity, self);
+
+		skeletalGraph.m_lineList = ProjectManager::CreateTemporaryAsset<ParticleInfoList>();
+		const auto lineMaterial = ProjectManager::CreateTemporaryAsset<Material>();
+		const auto lineParticles = scene->GetOrSetPrivateComponent<Particles>(skeletalGraph.m_lineEntity).lock();
+		lineParticles->m_material = lineMaterial;
+		lineParticles->m_particleInfoList = skeletalGraph.m_lineList;
+		lineMaterial->m_vertexColorOnly = true;
+		skeletalGraph.m_pointList = ProjectManager::CreateTemporaryAsset<ParticleInfoList>();
+		const auto pointMaterial = ProjectManager::CreateTemporaryAsset<Material>();
+		const auto pointParticles = scene->GetOrSetPrivateComponent<Particles>(skeletalGraph.m_pointEntity).lock();
+		pointParticles->m_material = pointMaterial;
+		pointParticles->m_particleInfoList = skeletalGraph.m_pointList;
+		pointMaterial->m_vertexColorOnly = true;
+		rebuildAll = true;
+	}
+	scene->GetOrSetPrivateComponent<Particles>(skeletalGraph.m_lineEntity).lock()->m_mesh = lineMeshSample;
+	scene->GetOrSetPrivateComponent<Particles>(skeletalGraph.m_pointEntity).lock()->m_mesh = pointMeshSample;
+	skeletalGraph.m_strandReady = strandReady;
+	skeletalGraph.m_settings = skeletalGraphSettings;
 
-	const auto lineList = ProjectManager::CreateTemporaryAsset<ParticleInfoList>();
-	const auto lineMaterial = ProjectManager::CreateTemporaryAsset<Material>();
-	const auto lineParticles = scene->GetOrSetPrivateComponent<Particles>(lineEntity).lock();
-	lineParticles->m_mesh = lineMeshSample;
-	lineParticles->m_material = lineMaterial;
-	lineParticles->m_particleInfoList = lineList;
-	lineMaterial->m_vertexColorOnly = true;
-	const auto pointList = ProjectManager::CreateTemporaryAsset<ParticleInfoList>();
-	const auto pointMaterial = ProjectManager::CreateTemporaryAsset<Material>();
-	const auto pointParticles = scene->GetOrSetPrivateComponent<Particles>(pointEntity).lock();
-	pointParticles->m_mesh = pointMeshSample;
-	pointParticles->m_material = pointMaterial;
-	pointParticles->m_particleInfoList = pointList;
-	pointMaterial->m_vertexColorOnly = true;
-
-	std::vector<ParticleInfo> lineParticleInfos;
-	std::vector<ParticleInfo> pointParticleInfos;
-	const int nodeSize = strandReady ? m_strandModel.m_strandModelSkeleton.PeekSortedNodeList().size() : m_treeModel.PeekShootSkeleton().PeekSortedNodeList().size();
 	if (strandReady) {
-		lineParticleInfos.resize(nodeSize);
-		pointParticleInfos.resize(nodeSize);
+		UpdateSkeletalGraphInstances(m_strandModel.m_strandModelSkeleton, skeletalGraphSettings, baseNodeHandle, rebuildAll, skeletalGraph);
 	}
 	else
 	{
-		lineParticleInfos.resize(nodeSize);
-		pointParticleInfos.resize(nodeSize);
+		UpdateSkeletalGraphInstances(m_treeModel.PeekShootSkeleton(), skeletalGraphSettings, baseNodeHandle, rebuildAll, skeletalGraph);
 	}
-	Jobs::RunParallelFor(nodeSize, [&](unsigned internodeIndex)
-		{
-			if (strandReady)
-			{
-				const auto& sortedInternodeList = m_strandModel.m_strandModelSkeleton.PeekSortedNodeList();
-				const auto internodeHandle = sortedInternodeList[internodeIndex];
-				SkeletonNodeHandle walker = internodeHandle;
-				bool subTree = false;
-				const auto& skeleton = m_strandModel.m_strandModelSkeleton;
-				const auto& node = skeleton.PeekNode(internodeHandle);
-
-				while (walker != -1)
-				{
-					if (walker == baseNodeHandle)
-					{
-						subTree = true;
-						break;
-					}
-					walker = skeleton.PeekNode(walker).GetParentHandle();
-				}
-				const glm::vec3 position = node.m_info.m_globalPosition;
-				auto rotation = node.m_info.m_globalRotation;
-				{
-
-					rotation *= glm::quat(glm::vec3(glm::radians(90.0f), 0.0f, 0.0f));
-					const glm::mat4 rotationTransform = glm::mat4_cast(rotation);
-					lineParticleInfos[internodeIndex].m_instanceMatrix.m_value =
-						glm::translate(position + (node.m_info.m_length / 2.0f) * node.m_info.GetGlobalDirection()) *
-						rotationTransform *
-						glm::scale(glm::vec3(
-							skeletalGraphSettings.m_fixedLineThickness * (subTree ? 1.25f : 1.0f),
-							node.m_info.m_length,
-							skeletalGraphSettings.m_fixedLineThickness * (subTree ? 1.25f : 1.0f)));
-
-					if (subTree)
-					{
-						lineParticleInfos[internodeIndex].m_instanceColor = skeletalGraphSettings.m_lineFocusColor;
-					}
-					else {
-						lineParticleInfos[internodeIndex].m_instanceColor = skeletalGraphSettings.m_lineColor;
-					}
-				}
-				{
-					rotation *= glm::quat(glm::vec3(glm::radians(90.0f), 0.0f, 0.0f));
-					const glm::mat4 rotationTransform = glm::mat4_cast(rotation);
-					float thicknessFactor = node.m_info.m_thickness;
-					if (skeletalGraphSettings.m_fixedPointSize) thicknessFactor = skeletalGraphSettings.m_fixedPointSizeFactor;
-					auto scale = glm::vec3(skeletalGraphSettings.m_branchPointSize * thicknessFactor);
-					pointParticleInfos[internodeIndex].m_instanceColor = skeletalGraphSettings.m_branchPointColor;
-					if (internodeIndex == 0 || node.PeekChildHandles().size() > 1)
-					{
-						scale = glm::vec3(skeletalGraphSettings.m_junctionPointSize * thicknessFactor);
-						pointParticleInfos[internodeIndex].m_instanceColor = skeletalGraphSettings.m_junctionPointColor;
-					}
-					pointParticleInfos[internodeIndex].m_instanceMatrix.m_value =
-						glm::translate(position) *
-						rotationTransform *
-						glm::scale(scale * (subTree ? 1.25f : 1.0f));
-					if (subTree)
-					{
-						pointParticleInfos[internodeIndex].m_instanceColor = skeletalGraphSettings.m_branchFocusColor;
-					}
-				}
-			}
-			else {
-				const auto& sortedInternodeList = m_treeModel.PeekShootSkeleton().PeekSortedNodeList();
-				const auto internodeHandle = sortedInternodeList[internodeIndex];
-				SkeletonNodeHandle walker = internodeHandle;
-				bool subTree = false;
-				const auto& skeleton = m_treeModel.PeekShootSkeleton();
-				const auto& node = skeleton.PeekNode(internodeHandle);
-
-				while (walker != -1)
-				{
-					if (walker == baseNodeHandle)
-					{
-						subTree = true;
-						break;
-					}
-					walker = skeleton.PeekNode(walker).GetParentHandle();
-				}
-				const glm::vec3 position = node.m_info.m_globalPosition;
-				auto rotation = node.m_info.m_globalRotation;
-				{
-
-					rotation *= glm::quat(glm::vec3(glm::radians(90.0f), 0.0f, 0.0f));
-					const glm::mat4 rotationTransform = glm::mat4_cast(rotation);
-					lineParticleInfos[internodeIndex].m_instanceMatrix.m_value =
-						glm::translate(position + (node.m_info.m_length / 2.0f) * node.m_info.GetGlobalDirection()) *
-						rotationTransform *
-						glm::scale(glm::vec3(
-							skeletalGraphSettings.m_fixedLineThickness * (subTree ? 1.25f : 1.0f),
-							node.m_info.m_length,
-							skeletalGraphSettings.m_fixedLineThickness * (subTree ? 1.25f : 1.0f)));
-
-					if (subTree)
-					{
-						lineParticleInfos[internodeIndex].m_instanceColor = skeletalGraphSettings.m_lineFocusColor;
-					}
-					else {
-						lineParticleInfos[internodeIndex].m_instanceColor = skeletalGraphSettings.m_lineColor;
-					}
-				}
-				{
-					rotation *= glm::quat(glm::vec3(glm::radians(90.0f), 0.0f, 0.0f));
-					const glm::mat4 rotationTransform = glm::mat4_cast(rotation);
-					float thicknessFactor = node.m_info.m_thickness;
-					if (skeletalGraphSettings.m_fixedPointSize) thicknessFactor = skeletalGraphSettings.m_fixedPointSizeFactor;
-					auto scale = glm::vec3(skeletalGraphSettings.m_branchPointSize * thicknessFactor);
-					pointParticleInfos[internodeIndex].m_instanceColor = skeletalGraphSettings.m_branchPointColor;
-					if (internodeIndex == 0 || node.PeekChildHandles().size() > 1)
-					{
-						scale = glm::vec3(skeletalGraphSettings.m_junctionPointSize * thicknessFactor);
-						pointParticleInfos[internodeIndex].m_instanceColor = skeletalGraphSettings.m_junctionPointColor;
-					}
-					pointParticleInfos[internodeIndex].m_instanceMatrix.m_value =
-						glm::translate(position) *
-						rotationTransform *
-						glm::scale(scale * (subTree ? 1.25f : 1.0f));
-					if (subTree)
-					{
-						pointParticleInfos[internodeIndex].m_instanceColor = skeletalGraphSettings.m_branchFocusColor;
-					}
-				}
-			}
-
-		});
-	lineList->SetParticleInfos(lineParticleInfos);
-	pointList->SetParticleInfos(pointParticleInfos);
+	//Nothing moved and nothing was refocused, the lists on the GPU are still valid. ParticleInfoList only takes whole lists.
+	if (skeletalGraph.m_dirtyNodes.empty() && !rebuildAll) return;
+	skeletalGraph.m_lineList->SetParticleInfos(skeletalGraph.m_lineParticleInfos);
+	skeletalGraph.m_pointList->SetParticleInfos(skeletalGraph.m_pointParticleInfos);
 }
 
 bool Tree::OnInspect(const std::shared_ptr<EditorLayer>& editorLayer) {
@@ -518,21 +508,18 @@ bool Tree::OnInspect(const std::shared_ptr<EditorLayer>& editorLayer) {
 						scalarMatrices.reserve(occupancyGrid.GetMarkersPerVoxel() * numVoxels);
 					}
 					int i = 0;
-					for (const auto& voxel : voxelGrid.RefData())
-					{
-						for (const auto& marker : voxel.m_markers) {
-							scalarMatrices.resize(i + 1);
-							scalarMatrices[i].m_instanceMatrix.m_value =
-								glm::translate(marker.m_position)
-								* glm::mat4_cast(glm::quat(glm::vec3(0.0f)))
-								* glm::scale(glm::vec3(voxelGrid.GetVoxelSize() * 0.2f));
-							if (marker.m_nodeHandle == -1) scalarMatrices[i].m_instanceColor = glm::vec4(1.0f, 1.0f, 1.0f, 0.75f);
-							else
-							{
-								scalarMatrices[i].m_instanceColor = glm::vec4(ecoSysLabLayer->RandomColors()[marker.m_nodeHandle], 1.0f);
-							}
-							i++;
+					for (const auto& marker : occupancyGrid.PeekMarkers()) {
+						scalarMatrices.resize(i + 1);
+						scalarMatrices[i].m_instanceMatrix.m_value =
+							glm::translate(marker.m_position)
+							* glm::mat4_cast(glm::quat(glm::vec3(0.0f)))
+							* glm::scale(glm::vec3(voxelGrid.GetVoxelSize() * 0.2f));
+						if (marker.m_nodeHandle == -1) scalarMatrices[i].m_instanceColor = glm::vec4(1.0f, 1.0f, 1.0f, 0.75f);
+						else
+						{
+							scalarMatrices[i].m_instanceColor = glm::vec4(ecoSysLabLayer->RandomColors()[marker.m_nodeHandle], 1.0f);
 						}
+						i++;
 					}
 					spaceColonizationGridParticleInfoList->SetParticleInfos(scalarMatrices);
 				}
@@ -671,13 +658,20 @@ bool Tree::OnInspect(const std::shared_ptr<EditorLayer>& editorLayer) {
 		ClearSkeletalGraph();
 	}
 
-	FileUtils::SaveFile("Export Cylindrical Mesh", "OBJ", { ".obj" }, [&](const std::filesystem::path& path) {
+	FileUtils::SaveFile("Export Cylindrical Mesh", "OBJ", { ".obj", ".ply", ".glb" }, [&](const std::filesystem::path& path) {
 		ExportOBJ(path, m_meshGeneratorSettings);
 		}, false);
 	ImGui::SameLine();
-	FileUtils::SaveFile("Export Strand Mesh", "OBJ", { ".obj" }, [&](const std::filesystem::path& path) {
+	FileUtils::SaveFile("Export Strand Mesh", "OBJ", { ".obj", ".ply", ".glb" }, [&](const std::filesystem::path& path) {
 		ExportStrandModelOBJ(path, m_strandModelMeshGeneratorSettings);
 		}, false);
+	FileUtils::SaveFile("Save Binary Skeletons", "Skeleton Archive", { ".esb" }, [&](const std::filesystem::path& path) {
+		SaveBinary(path);
+		}, false);
+	ImGui::SameLine();
+	FileUtils::OpenFile("Load Binary Skeletons", "Skeleton Archive", { ".esb" }, [&](const std::filesystem::path& path) {
+		if (LoadBinary(path)) GenerateGeometryEntities(m_meshGeneratorSettings);
+		}, false);
 
 	return changed;
 }
@@ -716,6 +710,7 @@ void Tree::OnCreate() {
 }
 
 void Tree::OnDestroy() {
+	m_skeletalGraph.Reset();
 	m_treeModel = {};
 	m_strandModel = {};
 
@@ -1111,321 +1106,93 @@ std::shared_ptr<Mesh> Tree::GenerateStrandModelBranchMesh(const StrandModelMeshG
 
 void Tree::ExportOBJ(const std::filesystem::path& path, const TreeMeshGeneratorSettings& meshGeneratorSettings)
 {
-	if (path.extension() == ".obj") {
-		try
-		{
-			std::ofstream of;
-			of.open(path.string(), std::ofstream::out | std::ofstream::trunc);
-			if (of.is_open()) {
-				std::string start = "#Forest OBJ exporter, by Bosheng Li";
-				start += "\n";
-				of.write(start.c_str(), start.size());
-				of.flush();
-				unsigned startIndex = 1;
-				if (meshGeneratorSettings.m_enableBranch) {
-					const auto branchMesh = GenerateBranchMesh(meshGeneratorSettings);
-					if (branchMesh) {
-						auto& vertices = branchMesh->UnsafeGetVertices();
-						auto& triangles = branchMesh->UnsafeGetTriangles();
-						if (!vertices.empty() && !triangles.empty()) {
-							std::string header =
-								"#Vertices: " + std::to_string(vertices.size()) +
-								", tris: " + std::to_string(triangles.size());
-							header += "\n";
-							of.write(header.c_str(), header.size());
-							of.flush();
-							std::stringstream data;
-							data << "o branch " + std::to_string(0) + "\n";
-#pragma region Data collection
-							for (auto i = 0; i < vertices.size(); i++) {
-								auto& vertexPosition = vertices.at(i).m_position;
-								auto& color = vertices.at(i).m_color;
-								data << "v " + std::to_string(vertexPosition.x) + " " +
-									std::to_string(vertexPosition.y) + " " +
-									std::to_string(vertexPosition.z) + " " +
-									std::to_string(color.x) + " " + std::to_string(color.y) + " " +
-									std::to_string(color.z) + "\n";
-							}
-							for (const auto& vertex : vertices) {
-								data << "vt " + std::to_string(vertex.m_texCoord.x) + " " +
-									std::to_string(vertex.m_texCoord.y) + "\n";
-							}
-							// data += "s off\n";
-							data << "# List of indices for faces vertices, with (x, y, z).\n";
-							for (auto i = 0; i < triangles.size(); i++) {
-								const auto triangle = triangles[i];
-								const auto f1 = triangle.x + startIndex;
-								const auto f2 = triangle.y + startIndex;
-								const auto f3 = triangle.z + startIndex;
-								data << "f " + std::to_string(f1) + "/" + std::to_string(f1) + "/" +
-									std::to_string(f1) + " " + std::to_string(f2) + "/" +
-									std::to_string(f2) + "/" + std::to_string(f2) + " " +
-									std::to_string(f3) + "/" + std::to_string(f3) + "/" +
-									std::to_string(f3) + "\n";
-							}
-#pragma endregion
-							const auto result = data.str();
-							of.write(result.c_str(), result.size());
-							of.flush();
-							startIndex += vertices.size();
-						}
-					}
-				}
-				if (meshGeneratorSettings.m_enableFoliage) {
-					const auto foliageMesh = GenerateFoliageMesh(meshGeneratorSettings);
-					if (foliageMesh) {
-
-						auto& vertices = foliageMesh->UnsafeGetVertices();
-						auto& triangles = foliageMesh->UnsafeGetTriangles();
-						if (!vertices.empty() && !triangles.empty()) {
-							std::string header =
-								"#Vertices: " + std::to_string(vertices.size()) +
-								", tris: " + std::to_string(triangles.size());
-							header += "\n";
-							of.write(header.c_str(), header.size());
-							of.flush();
-							std::stringstream data;
-							data << "o foliage " + std::to_string(0) + "\n";
-#pragma region Data collection
-							for (auto i = 0; i < vertices.size(); i++) {
-								auto& vertexPosition = vertices.at(i).m_position;
-								auto& color = vertices.at(i).m_color;
-								data << "v " + std::to_string(vertexPosition.x) + " " +
-									std::to_string(vertexPosition.y) + " " +
-									std::to_string(vertexPosition.z) + " " +
-									std::to_string(color.x) + " " + std::to_string(color.y) + " " +
-									std::to_string(color.z) + "\n";
-							}
-							for (const auto& vertex : vertices) {
-								data << "vt " + std::to_string(vertex.m_texCoord.x) + " " +
-									std::to_string(vertex.m_texCoord.y) + "\n";
-							}
-							// data += "s off\n";
-							data << "# List of indices for faces vertices, with (x, y, z).\n";
-							for (auto i = 0; i < triangles.size(); i++) {
-								const auto triangle = triangles[i];
-								const auto f1 = triangle.x + startIndex;
-								const auto f2 = triangle.y + startIndex;
-								const auto f3 = triangle.z + startIndex;
-								data << "f " + std::to_string(f1) + "/" + std::to_string(f1) + "/" +
-									std::to_string(f1) + " " + std::to_string(f2) + "/" +
-									std::to_string(f2) + "/" + std::to_string(f2) + " " +
-									std::to_string(f3) + "/" + std::to_string(f3) + "/" +
-									std::to_string(f3) + "\n";
-							}
-#pragma endregion
-							const auto result = data.str();
-							of.write(result.c_str(), result.size());
-							of.flush();
-							startIndex += vertices.size();
-						}
-					}
-				}
-				of.close();
-			}
-		}
-		catch (std::exception e)
-		{
-			EVOENGINE_ERROR("Export failed: " + std::string(e.what()));
-		}
-
+	if (!MeshExporter::IsSupported(path)) return;
+	std::vector<MeshExportChunk> chunks;
+	std::shared_ptr<Mesh> branchMesh;
+	std::shared_ptr<Mesh> foliageMesh;
+	if (meshGeneratorSettings.m_enableBranch) {
+		branchMesh = GenerateBranchMesh(meshGeneratorSettings);
+		if (branchMesh) {
+			auto& chunk = chunks.emplace_back();
+			chunk.m_name = "branch 0";
+			chunk.m_vertices = &branchMesh->UnsafeGetVertices();
+			chunk.m_triangles = &branchMesh->UnsafeGetTriangles();
+		}
+	}
+	if (meshGeneratorSettings.m_enableFoliage) {
+		foliageMesh = GenerateFoliageMesh(meshGeneratorSettings);
+		if (foliageMesh) {
+			auto& chunk = chunks.emplace_back();
+			chunk.m_name = "foliage 0";
+			chunk.m_vertices = &foliageMesh->UnsafeGetVertices();
+			chunk.m_triangles = &foliageMesh->UnsafeGetTriangles();
+		}
+	}
+	try
+	{
+		MeshExporter::Export(path, chunks);
+	}
+	catch (std::exception e)
+	{
+		EVOENGINE_ERROR("Export failed: " + std::string(e.what()));
 	}
 }
 
 void Tree::ExportStrandModelOBJ(const std::filesystem::path& path,
 	const StrandModelMeshGeneratorSettings& meshGeneratorSettings)
 {
-	if (path.extension() == ".obj") {
-		if (m_strandModel.m_strandModelSkeleton.RefRawNodes().size() != m_treeModel.PeekShootSkeleton().PeekRawNodes().size())
-		{
-			BuildStrandModel();
-		}
-		try
-		{
-			std::ofstream of;
-			of.open(path.string(), std::ofstream::out | std::ofstream::trunc);
-			if (of.is_open()) {
-				std::string start = "#Forest OBJ exporter, by Bosheng Li";
-				start += "\n";
-				of.write(start.c_str(), start.size());
-				of.flush();
-				unsigned vertexStartIndex = 1;
-				unsigned texCoordsStartIndex = 1;
-				if (meshGeneratorSettings.m_enableBranch) {
-					std::vector<Vertex> vertices;
-					std::vector<glm::vec2> texCoords;
-					std::vector<std::pair<unsigned int, unsigned int>> indices;
-					StrandModelMeshGenerator::Generate(m_strandModel, vertices, texCoords, indices, meshGeneratorSettings);
-					if (!vertices.empty() && !indices.empty()) {
-						std::string header =
-							"#Vertices: " + std::to_string(vertices.size()) +
-							", tris: " + std::to_string(indices.size());
-						header += "\n";
-						of.write(header.c_str(), header.size());
-						of.flush();
-						std::stringstream data;
-						data << "o tree " + std::to_string(0) + "\n";
-#pragma region Data collection
-						for (auto& vertex : vertices)
-						{
-							auto& vertexPosition = vertex.m_position;
-							auto& color = vertex.m_color;
-							data << "v " + std::to_string(vertexPosition.x) + " " +
-								std::to_string(vertexPosition.y) + " " +
-								std::to_string(vertexPosition.z) + " " +
-								std::to_string(color.x) + " " + std::to_string(color.y) + " " +
-								std::to_string(color.z) + "\n";
-						}
-						for (const auto& texCoord : texCoords) {
-							data << "vt " + std::to_string(texCoord.x) + " " +
-								std::to_string(texCoord.y) + "\n";
-						}
-						data << "# List of indices for faces vertices, with (x, y, z).\n";
-						for (auto i = 0; i < indices.size() / 3; i++) {
-							const auto f1 = indices.at(i * 3).first + vertexStartIndex;
-							const auto f2 = indices.at(i * 3 + 1).first + vertexStartIndex;
-							const auto f3 = indices.at(i * 3 + 2).first + vertexStartIndex;
-							const auto t1 = indices.at(i * 3).second + texCoordsStartIndex;
-							const auto t2 = indices.at(i * 3 + 1).second + texCoordsStartIndex;
-							const auto t3 = indices.at(i * 3 + 2).second + texCoordsStartIndex;
-							data << "f " + std::to_string(f1) + "/" + std::to_string(t1) + "/" + std::to_string(f1) + " "
-								+ std::to_string(f2) + "/" + std::to_string(t2) + "/" + std::to_string(f2) + " "
-								+ std::to_string(f3) + "/" + std::to_string(t3) + "/" + std::to_string(f3) + "\n";
-						}
-#pragma endregion
-						const auto result = data.str();
-						of.write(result.c_str(), result.size());
-						of.flush();
-						vertexStartIndex += vertices.size();
-						texCoordsStartIndex += texCoords.size();
-					}
-				}
-				if (meshGeneratorSettings.m_enableFoliage) {
-					if (const auto foliageMesh = GenerateStrandModelFoliageMesh(meshGeneratorSettings)) {
-						const auto& vertices = foliageMesh->UnsafeGetVertices();
-						const auto& triangles = foliageMesh->UnsafeGetTriangles();
-						if (!vertices.empty() && !triangles.empty()) {
-							std::string header =
-								"#Vertices: " + std::to_string(vertices.size()) +
-								", tris: " + std::to_string(triangles.size());
-							header += "\n";
-							of.write(header.c_str(), header.size());
-							of.flush();
-							std::stringstream data;
-							data << "o tree " + std::to_string(0) + "\n";
-#pragma region Data collection
-							for (auto& vertex : vertices)
-							{
-								auto& vertexPosition = vertex.m_position;
-								auto& color = vertex.m_color;
-								data << "v " + std::to_string(vertexPosition.x) + " " +
-									std::to_string(vertexPosition.y) + " " +
-									std::to_string(vertexPosition.z) + " " +
-									std::to_string(color.x) + " " + std::to_string(color.y) + " " +
-									std::to_string(color.z) + "\n";
-							}
-							for (const auto& vertex : vertices) {
-								data << "vt " + std::to_string(vertex.m_texCoord.x) + " " +
-									std::to_string(vertex.m_texCoord.y) + "\n";
-							}
-							// data += "s off\n";
-							data << "# List of indices for faces vertices, with (x, y, z).\n";
-							for (auto triangle : triangles)
-							{
-								const auto f1 = triangle.x + vertexStartIndex;
-								const auto f2 = triangle.y + vertexStartIndex;
-								const auto f3 = triangle.z + vertexStartIndex;
-								const auto t1 = triangle.x + texCoordsStartIndex;
-								const auto t2 = triangle.y + texCoordsStartIndex;
-								const auto t3 = triangle.z + texCoordsStartIndex;
-								data << "f " + std::to_string(f1) + "/" + std::to_string(t1) + "/" + std::to_string(f1) + " "
-									+ std::to_string(f2) + "/" + std::to_string(t2) + "/" + std::to_string(f2) + " "
-									+ std::to_string(f3) + "/" + std::to_string(t3) + "/" + std::to_string(f3) + "\n";
-							}
-#pragma endregion
-							const auto result = data.str();
-							of.write(result.c_str(), result.size());
-							of.flush();
-							vertexStartIndex += vertices.size();
-							texCoordsStartIndex += vertices.size();
-						}
-					}
-				}
-				of.close();
-			}
-		}
-		catch (std::exception e)
-		{
-			EVOENGINE_ERROR("Export failed: " + std::string(e.what()));
-		}
+	if (!MeshExporter::IsSupported(path)) return;
+	if (m_strandModel.m_strandModelSkeleton.RefRawNodes().size() != m_treeModel.PeekShootSkeleton().PeekRawNodes().size())
+	{
+		BuildStrandModel();
+	}
+	std::vector<MeshExportChunk> chunks;
+	std::vector<Vertex> vertices;
+	std::vector<glm::vec2> texCoords;
+	std::vector<std::pair<unsigned int, unsigned int>> indices;
+	std::shared_ptr<Mesh> foliageMesh;
+	if (meshGeneratorSettings.m_enableBranch) {
+		StrandModelMeshGenerator::Generate(m_strandModel, vertices, texCoords, indices, meshGeneratorSettings);
+		auto& chunk = chunks.emplace_back();
+		chunk.m_name = "tree 0";
+		chunk.m_vertices = &vertices;
+		chunk.m_texCoords = &texCoords;
+		chunk.m_vertexTexCoordIndices = &indices;
+	}
+	if (meshGeneratorSettings.m_enableFoliage) {
+		foliageMesh = GenerateStrandModelFoliageMesh(meshGeneratorSettings);
+		if (foliageMesh) {
+			auto& chunk = chunks.emplace_back();
+			chunk.m_name = "tree 0";
+			chunk.m_vertices = &foliageMesh->UnsafeGetVertices();
+			chunk.m_triangles = &foliageMesh->UnsafeGetTriangles();
+		}
+	}
+	try
+	{
+		MeshExporter::Export(path, chunks);
+	}
+	catch (std::exception e)
+	{
+		EVOENGINE_ERROR("Export failed: " + std::string(e.what()));
 	}
 }
 
 void Tree::ExportTrunkOBJ(const std::filesystem::path& path,
 	const TreeMeshGeneratorSettings& meshGeneratorSettings)
 {
-	if (path.extension() == ".obj") {
-		std::ofstream of;
-		of.open(path.string(), std::ofstream::out | std::ofstream::trunc);
-		if (of.is_open()) {
-			std::string start = "#Forest OBJ exporter, by Bosheng Li";
-			start += "\n";
-			of.write(start.c_str(), start.size());
-			of.flush();
-			unsigned startIndex = 1;
-			if (meshGeneratorSettings.m_enableBranch) {
-				std::shared_ptr<Mesh> trunkMesh = ProjectManager::CreateTemporaryAsset<Mesh>();
-				GenerateTrunkMeshes(trunkMesh, meshGeneratorSettings);
-				if (trunkMesh) {
-					auto& vertices = trunkMesh->UnsafeGetVertices();
-					auto& triangles = trunkMesh->UnsafeGetTriangles();
-					if (!vertices.empty() && !triangles.empty()) {
-						std::string header =
-							"#Vertices: " + std::to_string(vertices.size()) +
-							", tris: " + std::to_string(triangles.size());
-						header += "\n";
-						of.write(header.c_str(), header.size());
-						of.flush();
-						std::stringstream data;
-						data << std::string("o trunk") + "\n";
-#pragma region Data collection
-						for (auto i = 0; i < vertices.size(); i++) {
-							auto& vertexPosition = vertices.at(i).m_position;
-							auto& color = vertices.at(i).m_color;
-							data << "v " + std::to_string(vertexPosition.x) + " " +
-								std::to_string(vertexPosition.y) + " " +
-								std::to_string(vertexPosition.z) + " " +
-								std::to_string(color.x) + " " + std::to_string(color.y) + " " +
-								std::to_string(color.z) + "\n";
-						}
-						for (const auto& vertex : vertices) {
-							data << "vt " + std::to_string(vertex.m_texCoord.x) + " " +
-								std::to_string(vertex.m_texCoord.y) + "\n";
-						}
-						// data += "s off\n";
-						data << "# List of indices for faces vertices, with (x, y, z).\n";
-						for (auto i = 0; i < triangles.size(); i++) {
-							const auto triangle = triangles[i];
-							const auto f1 = triangle.x + startIndex;
-							const auto f2 = triangle.y + startIndex;
-							const auto f3 = triangle.z + startIndex;
-							data << "f " + std::to_string(f1) + "/" + std::to_string(f1) + "/" +
-								std::to_string(f1) + " " + std::to_string(f2) + "/" +
-								std::to_string(f2) + "/" + std::to_string(f2) + " " +
-								std::to_string(f3) + "/" + std::to_string(f3) + "/" +
-								std::to_string(f3) + "\n";
-						}
-#pragma endregion
-						const auto result = data.str();
-						of.write(result.c_str(), result.size());
-						of.flush();
-						startIndex += vertices.size();
-					}
-				}
-			}
-			of.close();
-		}
-	}
+	if (!MeshExporter::IsSupported(path)) return;
+	std::vector<MeshExportChunk> chunks;
+	std::shared_ptr<Mesh> trunkMesh;
+	if (meshGeneratorSettings.m_enableBranch) {
+		trunkMesh = ProjectManager::CreateTemporaryAsset<Mesh>();
+		GenerateTrunkMeshes(trunkMesh, meshGeneratorSettings);
+		auto& chunk = chunks.emplace_back();
+		chunk.m_name = "trunk";
+		chunk.m_vertices = &trunkMesh->UnsafeGetVertices();
+		chunk.m_triangles = &trunkMesh->UnsafeGetTriangles();
+	}
+	MeshExporter::Export(path, chunks);
 }
 
 bool Tree::TryGrow(float deltaTime, bool pruning)
@@ -1739,6 +1506,218 @@ void Tree::Serialize(YAML::Emitter& out) const
 
 
 
+void Tree::SerializeShootSkeleton(BinaryArchiveWriter& archive, const std::string& prefix, const ShootSkeleton& shootSkeleton)
+{
+	SkeletonSerializer<ShootGrowthData, ShootStemGrowthData, InternodeGrowthData>::Serialize(archive, prefix, shootSkeleton,
+		[&](BinaryArchiveWriter& dataArchive, const std::string& dataPrefix, const ShootSkeleton& skeleton)
+		{
+			dataArchive.AddValue(dataPrefix + "m_data.m_desiredMin", skeleton.m_data.m_desiredMin);
+			dataArchive.AddValue(dataPrefix + "m_data.m_desiredMax", skeleton.m_data.m_desiredMax);
+			const auto& nodes = skeleton.PeekRawNodes();
+			using Node = SkeletonNode<InternodeGrowthData>;
+			dataArchive.AddColumn<float>(dataPrefix + "m_node.m_data.m_internodeLength", nodes, [](const Node& node) { return node.m_data.m_internodeLength; });
+			dataArchive.AddColumn<int>(dataPrefix + "m_node.m_data.m_indexOfParentBud", nodes, [](const Node& node) { return node.m_data.m_indexOfParentBud; });
+			dataArchive.AddColumn<float>(dataPrefix + "m_node.m_data.m_startAge", nodes, [](const Node& node) { return node.m_data.m_startAge; });
+			dataArchive.AddColumn<float>(dataPrefix + "m_node.m_data.m_finishAge", nodes, [](const Node& node) { return node.m_data.m_finishAge; });
+			dataArchive.AddColumn<glm::quat>(dataPrefix + "m_node.m_data.m_desiredLocalRotation", nodes, [](const Node& node) { return node.m_data.m_desiredLocalRotation; });
+			dataArchive.AddColumn<glm::quat>(dataPrefix + "m_node.m_data.m_desiredGlobalRotation", nodes, [](const Node& node) { return node.m_data.m_desiredGlobalRotation; });
+			dataArchive.AddColumn<glm::vec3>(dataPrefix + "m_node.m_data.m_desiredGlobalPosition", nodes, [](const Node& node) { return node.m_data.m_desiredGlobalPosition; });
+			dataArchive.AddColumn<float>(dataPrefix + "m_node.m_data.m_sagging", nodes, [](const Node& node) { return node.m_data.m_sagging; });
+			dataArchive.AddColumn<int>(dataPrefix + "m_node.m_data.m_order", nodes, [](const Node& node) { return node.m_data.m_order; });
+			dataArchive.AddColumn<float>(dataPrefix + "m_node.m_data.m_extraMass", nodes, [](const Node& node) { return node.m_data.m_extraMass; });
+			dataArchive.AddColumn<float>(dataPrefix + "m_node.m_data.m_density", nodes, [](const Node& node) { return node.m_data.m_density; });
+			dataArchive.AddColumn<float>(dataPrefix + "m_node.m_data.m_strength", nodes, [](const Node& node) { return node.m_data.m_strength; });
+			dataArchive.AddColumn<int>(dataPrefix + "m_node.m_data.m_budCount", nodes, [](const Node& node) { return static_cast<int>(node.m_data.m_buds.size()); });
+
+			std::vector<unsigned> budType;
+			std::vector<unsigned> budStatus;
+			std::vector<glm::quat> budLocalRotation;
+			std::vector<float> budMaturity;
+			std::vector<float> budHealth;
+			std::vector<glm::mat4> budTransform;
+			for (const auto& node : nodes)
+			{
+				for (const auto& bud : node.m_data.m_buds)
+				{
+					budType.emplace_back(static_cast<unsigned>(bud.m_type));
+					budStatus.emplace_back(static_cast<unsigned>(bud.m_status));
+					budLocalRotation.emplace_back(bud.m_localRotation);
+					budMaturity.emplace_back(bud.m_reproductiveModule.m_maturity);
+					budHealth.emplace_back(bud.m_reproductiveModule.m_health);
+					budTransform.emplace_back(bud.m_reproductiveModule.m_transform);
+				}
+			}
+			dataArchive.AddArray(dataPrefix + "m_buds.m_type", budType);
+			dataArchive.AddArray(dataPrefix + "m_buds.m_status", budStatus);
+			dataArchive.AddArray(dataPrefix + "m_buds.m_localRotation", budLocalRotation);
+			dataArchive.AddArray(dataPrefix + "m_buds.m_reproductiveModule.m_maturity", budMaturity);
+			dataArchive.AddArray(dataPrefix + "m_buds.m_reproductiveModule.m_health", budHealth);
+			dataArchive.AddArray(dataPrefix + "m_buds.m_reproductiveModule.m_transform", budTransform);
+
+			dataArchive.AddColumn<int>(dataPrefix + "m_flow.m_data.m_order", skeleton.PeekRawFlows(),
+				[](const SkeletonFlow<ShootStemGrowthData>& flow) { return flow.m_data.m_order; });
+		});
+}
+
+bool Tree::DeserializeShootSkeleton(const BinaryArchiveReader& archive, const std::string& prefix, ShootSkeleton& shootSkeleton)
+{
+	return SkeletonSerializer<ShootGrowthData, ShootStemGrowthData, InternodeGrowthData>::Deserialize(archive, prefix, shootSkeleton,
+		[&](const BinaryArchiveReader& dataArchive, const std::string& dataPrefix, ShootSkeleton& skeleton)
+		{
+			dataArchive.GetValue(dataPrefix + "m_data.m_desiredMin", skeleton.m_data.m_desiredMin);
+			dataArchive.GetValue(dataPrefix + "m_data.m_desiredMax", skeleton.m_data.m_desiredMax);
+			auto& nodes = skeleton.RefRawNodes();
+			using Node = SkeletonNode<InternodeGrowthData>;
+			dataArchive.ReadColumn<float>(dataPrefix + "m_node.m_data.m_internodeLength", nodes, [](Node& node, const float value) { node.m_data.m_internodeLength = value; });
+			dataArchive.ReadColumn<int>(dataPrefix + "m_node.m_data.m_indexOfParentBud", nodes, [](Node& node, const int value) { node.m_data.m_indexOfParentBud = value; });
+			dataArchive.ReadColumn<float>(dataPrefix + "m_node.m_data.m_startAge", nodes, [](Node& node, const float value) { node.m_data.m_startAge = value; });
+			dataArchive.ReadColumn<float>(dataPrefix + "m_node.m_data.m_finishAge", nodes, [](Node& node, const float value) { node.m_data.m_finishAge = value; });
+			dataArchive.ReadColumn<glm::quat>(dataPrefix + "m_node.m_data.m_desiredLocalRotation", nodes, [](Node& node, const glm::quat& value) { node.m_data.m_desiredLocalRotation = value; });
+			dataArchive.ReadColumn<glm::quat>(dataPrefix + "m_node.m_data.m_desiredGlobalRotation", nodes, [](Node& node, const glm::quat& value) { node.m_data.m_desiredGlobalRotation = value; });
+			dataArchive.ReadColumn<glm::vec3>(dataPrefix + "m_node.m_data.m_desiredGlobalPosition", nodes, [](Node& node, const glm::vec3& value) { node.m_data.m_desiredGlobalPosition = value; });
+			dataArchive.ReadColumn<float>(dataPrefix + "m_node.m_data.m_sagging", nodes, [](Node& node, const float value) { node.m_data.m_sagging = value; });
+			dataArchive.ReadColumn<int>(dataPrefix + "m_node.m_data.m_order", nodes, [](Node& node, const int value) { node.m_data.m_order = value; });
+			dataArchive.ReadColumn<float>(dataPrefix + "m_node.m_data.m_extraMass", nodes, [](Node& node, const float value) { node.m_data.m_extraMass = value; });
+			dataArchive.ReadColumn<float>(dataPrefix + "m_node.m_data.m_density", nodes, [](Node& node, const float value) { node.m_data.m_density = value; });
+			dataArchive.ReadColumn<float>(dataPrefix + "m_node.m_data.m_strength", nodes, [](Node& node, const float value) { node.m_data.m_strength = value; });
+
+			const auto budCounts = dataArchive.GetArray<int>(dataPrefix + "m_node.m_data.m_budCount");
+			const auto budType = dataArchive.GetArray<unsigned>(dataPrefix + "m_buds.m_type");
+			const auto budStatus = dataArchive.GetArray<unsigned>(dataPrefix + "m_buds.m_status");
+			const auto budLocalRotation = dataArchive.GetArray<glm::quat>(dataPrefix + "m_buds.m_localRotation");
+			const auto budMaturity = dataArchive.GetArray<float>(dataPrefix + "m_buds.m_reproductiveModule.m_maturity");
+			const auto budHealth = dataArchive.GetArray<float>(dataPrefix + "m_buds.m_reproductiveModule.m_health");
+			const auto budTransform = dataArchive.GetArray<glm::mat4>(dataPrefix + "m_buds.m_reproductiveModule.m_transform");
+			size_t budIndex = 0;
+			for (size_t nodeIndex = 0; nodeIndex < nodes.size(); nodeIndex++)
+			{
+				auto& buds = nodes[nodeIndex].m_data.m_buds;
+				buds.clear();
+				if (nodeIndex >= budCounts.size()) continue;
+				for (int i = 0; i < budCounts[nodeIndex] && budIndex < budType.size(); i++, budIndex++)
+				{
+					buds.emplace_back();
+					auto& bud = buds.back();
+					bud.m_type = static_cast<BudType>(budType[budIndex]);
+					if (budIndex < budStatus.size()) bud.m_status = static_cast<BudStatus>(budStatus[budIndex]);
+					if (budIndex < budLocalRotation.size()) bud.m_localRotation = budLocalRotation[budIndex];
+					if (budIndex < budMaturity.size()) bud.m_reproductiveModule.m_maturity = budMaturity[budIndex];
+					if (budIndex < budHealth.size()) bud.m_reproductiveModule.m_health = budHealth[budIndex];
+					if (budIndex < budTransform.size()) bud.m_reproductiveModule.m_transform = budTransform[budIndex];
+				}
+			}
+
+			dataArchive.ReadColumn<int>(dataPrefix + "m_flow.m_data.m_order", skeleton.RefRawFlows(),
+				[](SkeletonFlow<ShootStemGrowthData>& flow, const int value) { flow.m_data.m_order = value; });
+		});
+}
+
+bool Tree::SaveBinary(const std::filesystem::path& path, const bool compress) const
+{
+	BinaryArchiveWriter archive;
+	archive.m_compress = compress;
+	SerializeShootSkeleton(archive, "m_treeModel.m_shootSkeleton.", m_treeModel.m_shootSkeleton);
+	archive.AddValue("m_treeModel.m_historySize", static_cast<int>(m_treeModel.m_history.size()));
+	for (int i = 0; i < m_treeModel.m_history.size(); i++)
+	{
+		SerializeShootSkeleton(archive, "m_treeModel.m_history." + std::to_string(i) + ".", m_treeModel.m_history[i]);
+	}
+
+	SkeletonSerializer<StrandModelSkeletonData, StrandModelFlowData, StrandModelNodeData>::Serialize(archive, "m_strandModel.m_strandModelSkeleton.",
+		m_strandModel.m_strandModelSkeleton,
+		[&](BinaryArchiveWriter& dataArchive, const std::string& dataPrefix, const StrandModelSkeleton& skeleton)
+		{
+			const auto& nodes = skeleton.PeekRawNodes();
+			using Node = SkeletonNode<StrandModelNodeData>;
+			dataArchive.AddColumn<glm::vec2>(dataPrefix + "m_node.m_data.m_offset", nodes, [](const Node& node) { return node.m_data.m_offset; });
+			dataArchive.AddColumn<float>(dataPrefix + "m_node.m_data.m_twistAngle", nodes, [](const Node& node) { return node.m_data.m_twistAngle; });
+			dataArchive.AddColumn<int>(dataPrefix + "m_node.m_data.m_split", nodes, [](const Node& node) { return node.m_data.m_split ? 1 : 0; });
+			dataArchive.AddColumn<float>(dataPrefix + "m_node.m_data.m_strandRadius", nodes, [](const Node& node) { return node.m_data.m_strandRadius; });
+			dataArchive.AddColumn<int>(dataPrefix + "m_node.m_data.m_strandCount", nodes, [](const Node& node) { return node.m_data.m_strandCount; });
+			std::vector<const StrandModelProfile<CellParticlePhysicsData>*> profiles(nodes.size());
+			for (size_t i = 0; i < nodes.size(); i++) profiles[i] = &nodes[i].m_data.m_profile;
+			StrandModelProfileSerializer<CellParticlePhysicsData>::Serialize(dataArchive, dataPrefix + "m_node.m_data.m_profile.", profiles);
+			//The particles refer to strands by handle, so the strand group is stored along with the profiles.
+			dataArchive.AddValue(dataPrefix + "m_data.m_numOfParticles", skeleton.m_data.m_numOfParticles);
+			StrandGroupSerializer<StrandModelStrandGroupData, StrandModelStrandData, StrandModelStrandSegmentData>::Serialize(dataArchive, dataPrefix + "m_data.m_strandGroup.",
+				skeleton.m_data.m_strandGroup,
+				[&](BinaryArchiveWriter& groupArchive, const std::string& groupPrefix, const StrandModelStrandGroup& strandGroup)
+				{
+					using Segment = StrandSegment<StrandModelStrandSegmentData>;
+					const auto& segments = strandGroup.PeekStrandSegments();
+					groupArchive.AddColumn<SkeletonNodeHandle>(groupPrefix + "m_strandSegments.m_data.m_nodeHandle", segments, [](const Segment& segment) { return segment.m_data.m_nodeHandle; });
+					groupArchive.AddColumn<ParticleHandle>(groupPrefix + "m_strandSegments.m_data.m_profileParticleHandle", segments, [](const Segment& segment) { return segment.m_data.m_profileParticleHandle; });
+				});
+		});
+	return archive.Write(path);
+}
+
+bool Tree::LoadBinary(const std::filesystem::path& path)
+{
+	BinaryArchiveReader archive;
+	if (!archive.Open(path)) return false;
+	if (!DeserializeShootSkeleton(archive, "m_treeModel.m_shootSkeleton.", m_treeModel.m_shootSkeleton))
+	{
+		EVOENGINE_ERROR("Missing shoot skeleton in " + path.string());
+		return false;
+	}
+	m_treeModel.m_history.clear();
+	int historySize = 0;
+	archive.GetValue("m_treeModel.m_historySize", historySize);
+	for (int i = 0; i < historySize; i++)
+	{
+		m_treeModel.m_history.emplace_back();
+		if (!DeserializeShootSkeleton(archive, "m_treeModel.m_history." + std::to_string(i) + ".", m_treeModel.m_history.back()))
+		{
+			m_treeModel.m_history.pop_back();
+			break;
+		}
+	}
+
+	SkeletonSerializer<StrandModelSkeletonData, StrandModelFlowData, StrandModelNodeData>::Deserialize(archive, "m_strandModel.m_strandModelSkeleton.",
+		m_strandModel.m_strandModelSkeleton,
+		[&](const BinaryArchiveReader& dataArchive, const std::string& dataPrefix, StrandModelSkeleton& skeleton)
+		{
+			skeleton.m_data = {};
+			auto& nodes = skeleton.RefRawNodes();
+			using Node = SkeletonNode<StrandModelNodeData>;
+			for (auto& node : nodes) node.m_data = {};
+			dataArchive.ReadColumn<glm::vec2>(dataPrefix + "m_node.m_data.m_offset", nodes, [](Node& node, const glm::vec2& value) { node.m_data.m_offset = value; });
+			dataArchive.ReadColumn<float>(dataPrefix + "m_node.m_data.m_twistAngle", nodes, [](Node& node, const float value) { node.m_data.m_twistAngle = value; });
+			dataArchive.ReadColumn<int>(dataPrefix + "m_node.m_data.m_split", nodes, [](Node& node, const int value) { node.m_data.m_split = value == 1; });
+			dataArchive.ReadColumn<float>(dataPrefix + "m_node.m_data.m_strandRadius", nodes, [](Node& node, const float value) { node.m_data.m_strandRadius = value; });
+			dataArchive.ReadColumn<int>(dataPrefix + "m_node.m_data.m_strandCount", nodes, [](Node& node, const int value) { node.m_data.m_strandCount = value; });
+			std::vector<StrandModelProfile<CellParticlePhysicsData>*> profiles(nodes.size());
+			for (size_t i = 0; i < nodes.size(); i++) profiles[i] = &nodes[i].m_data.m_profile;
+			StrandModelProfileSerializer<CellParticlePhysicsData>::Deserialize(dataArchive, dataPrefix + "m_node.m_data.m_profile.", profiles);
+			dataArchive.GetValue(dataPrefix + "m_data.m_numOfParticles", skeleton.m_data.m_numOfParticles);
+			const bool hasStrandGroup = StrandGroupSerializer<StrandModelStrandGroupData, StrandModelStrandData, StrandModelStrandSegmentData>::Deserialize(dataArchive, dataPrefix + "m_data.m_strandGroup.",
+				skeleton.m_data.m_strandGroup,
+				[&](const BinaryArchiveReader& groupArchive, const std::string& groupPrefix, StrandModelStrandGroup& strandGroup)
+				{
+					using Segment = StrandSegment<StrandModelStrandSegmentData>;
+					auto& segments = strandGroup.RefStrandSegments();
+					groupArchive.ReadColumn<SkeletonNodeHandle>(groupPrefix + "m_strandSegments.m_data.m_nodeHandle", segments, [](Segment& segment, const SkeletonNodeHandle value) { segment.m_data.m_nodeHandle = value; });
+					groupArchive.ReadColumn<ParticleHandle>(groupPrefix + "m_strandSegments.m_data.m_profileParticleHandle", segments, [](Segment& segment, const ParticleHandle value) { segment.m_data.m_profileParticleHandle = value; });
+				});
+			if (!hasStrandGroup)
+			{
+				//Archives without strands: the particles can't keep handles into an empty group, the strand model has to be regenerated.
+				for (auto& node : nodes)
+				{
+					for (auto& particle : node.m_data.m_profile.RefParticles())
+					{
+						particle.m_strandHandle = -1;
+						particle.m_strandSegmentHandle = -1;
+					}
+				}
+				EVOENGINE_WARNING("No strands in " + path.string() + ", regenerate the strand model before building strand meshes.");
+			}
+		});
+	m_treeModel.m_initialized = true;
+	return true;
+}
+
 void Tree::Deserialize(const YAML::Node& in)
 {
 	m_treeDescriptor.Load("m_treeDescriptor", in);
@@ -2623,10 +2602,34 @@ void Tree::FromLSystemString(const std::shared_ptr<LSystemString>& lSystemString
 
 void Tree::FromTreeGraph(const std::shared_ptr<TreeGraph>& treeGraph)
 {
+	if (!treeGraph || !treeGraph->m_root)
+	{
+		EVOENGINE_ERROR("Tree graph is empty!");
+		return;
+	}
+	TreeGraphArrays treeGraphArrays{};
+	treeGraphArrays.FromNodeTree(treeGraph->m_root);
+	FromTreeGraphArrays(treeGraphArrays);
 }
 
 void Tree::FromTreeGraphV2(const std::shared_ptr<TreeGraphV2>& treeGraphV2)
 {
+	if (!treeGraphV2 || !treeGraphV2->m_root)
+	{
+		EVOENGINE_ERROR("Tree graph is empty!");
+		return;
+	}
+	TreeGraphArrays treeGraphArrays{};
+	treeGraphArrays.FromNodeTree(treeGraphV2->m_root);
+	FromTreeGraphArrays(treeGraphArrays);
+}
+
+void Tree::FromTreeGraphArrays(const TreeGraphArrays& treeGraphArrays)
+{
+	if (treeGraphArrays.GetSize() == 0) return;
+	ShootSkeleton skeleton{};
+	treeGraphArrays.ToSkeleton(skeleton);
+	FromSkeleton(skeleton);
 }
 
 void Tree::GenerateTreeParts(const TreeMeshGeneratorSettings& meshGeneratorSettings, std::vector<TreePartData>& treeParts)
@@ -3055,6 +3058,20 @@ void BranchPhysicsParameters::OnInspect()
 	}
 }
 
+bool SkeletalGraphSettings::operator==(const SkeletalGraphSettings& other) const
+{
+	return m_lineThickness == other.m_lineThickness && m_fixedLineThickness == other.m_fixedLineThickness
+		&& m_branchPointSize == other.m_branchPointSize && m_junctionPointSize == other.m_junctionPointSize
+		&& m_fixedPointSize == other.m_fixedPointSize && m_fixedPointSizeFactor == other.m_fixedPointSizeFactor
+		&& m_lineColor == other.m_lineColor && m_branchPointColor == other.m_branchPointColor && m_junctionPointColor == other.m_junctionPointColor
+		&& m_lineFocusColor == other.m_lineFocusColor && m_branchFocusColor == other.m_branchFocusColor;
+}
+
+bool SkeletalGraphSettings::operator!=(const SkeletalGraphSettings& other) const
+{
+	return !(*this == other);
+}
+
 void SkeletalGraphSettings::OnInspect()
 {
 
@@ -3075,9 +3092,14 @@ void SkeletalGraphSettings::OnInspect()
 
 void Tree::PrepareController(const std::shared_ptr<ShootDescriptor>& shootDescriptor, const std::shared_ptr<Soil>& soil, const std::shared_ptr<Climate>& climate)
 {
-	shootDescriptor->PrepareController(m_shootGrowthController);
+	PrepareShootGrowthController(shootDescriptor, m_lowBranchPruning, m_crownShynessDistance, m_shootGrowthController);
+}
 
-	m_shootGrowthController.m_endToRootPruningFactor = [&](const glm::mat4& globalTransform, ClimateModel& climateModel, const ShootSkeleton& shootSkeleton, const SkeletonNode<InternodeGrowthData>& internode)
+void Tree::PrepareShootGrowthController(const std::shared_ptr<ShootDescriptor>& shootDescriptor, const float lowBranchPruning, const float crownShynessDistance, ShootGrowthController& shootGrowthController)
+{
+	shootDescriptor->PrepareController(shootGrowthController);
+	const float internodeLength = shootGrowthController.m_internodeLength;
+	shootGrowthController.m_endToRootPruningFactor = [=](const glm::mat4& globalTransform, ClimateModel& climateModel, const ShootSkeleton& shootSkeleton, const SkeletonNode<InternodeGrowthData>& internode)
 		{
 			if (shootDescriptor->m_trunkProtection && internode.m_data.m_order == 0)
 			{
@@ -3098,7 +3120,7 @@ void Tree::PrepareController(const std::shared_ptr<ShootDescriptor>& shootDescri
 			}
 			return pruningProbability;
 		};
-	m_shootGrowthController.m_rootToEndPruningFactor = [&](const glm::mat4& globalTransform, ClimateModel& climateModel, const ShootSkeleton& shootSkeleton, const SkeletonNode<InternodeGrowthData>& internode)
+	shootGrowthController.m_rootToEndPruningFactor = [=](const glm::mat4& globalTransform, ClimateModel& climateModel, const ShootSkeleton& shootSkeleton, const SkeletonNode<InternodeGrowthData>& internode)
 		{
 			if (shootDescriptor->m_trunkProtection && internode.m_data.m_order == 0)
 			{
@@ -3110,8 +3132,8 @@ void Tree::PrepareController(const std::shared_ptr<ShootDescriptor>& shootDescri
 				return 999.f;
 			}
 			const auto maxDistance = shootSkeleton.PeekNode(0).m_info.m_endDistance;
-			if (maxDistance > 5.0f * m_shootGrowthController.m_internodeLength && internode.m_data.m_order > 0 &&
-				internode.m_info.m_rootDistance / maxDistance < m_lowBranchPruning) {
+			if (maxDistance > 5.0f * internodeLength && internode.m_data.m_order > 0 &&
+				internode.m_info.m_rootDistance / maxDistance < lowBranchPruning) {
 				const auto parentHandle = internode.GetParentHandle();
 				if (parentHandle != -1) {
 					const auto& parent = shootSkeleton.PeekNode(parentHandle);
@@ -3121,16 +3143,16 @@ void Tree::PrepareController(const std::shared_ptr<ShootDescriptor>& shootDescri
 					}
 				}
 			}
-			if (m_crownShynessDistance > 0.f && internode.IsEndNode()) {
+			if (crownShynessDistance > 0.f && internode.IsEndNode()) {
 				const glm::vec3 endPosition = globalTransform * glm::vec4(internode.m_info.GetGlobalEndPosition(), 1.0f);
 				bool pruneByCrownShyness = false;
-				climateModel.m_environmentGrid.m_voxel.ForEach(endPosition, m_crownShynessDistance * 2.0f, [&](const EnvironmentVoxel& data)
+				climateModel.m_environmentGrid.m_voxel.ForEach(endPosition, crownShynessDistance * 2.0f, [&](const EnvironmentVoxel& data)
 					{
 						if (pruneByCrownShyness) return;
 						for (const auto& i : data.m_internodeVoxelRegistrations)
 						{
 							if (i.m_treeSkeletonIndex == shootSkeleton.m_data.m_index) continue;
-							if (glm::distance(endPosition, i.m_position) < m_crownShynessDistance)
+							if (glm::distance(endPosition, i.m_position) < crownShynessDistance)
 								pruneByCrownShyness = true;
 						}
 					}
@@ -0,0 +1,515 @@
+#include "TreeDatasetEngine.hpp"
+
+#include "BarkDescriptor.hpp"
+#include "FoliageDescriptor.hpp"
+#include "MeshExporter.hpp"
+#include "ShootDescriptor.hpp"
+#include "Tree.hpp"
+#include "TreeDescriptor.hpp"
+#include "Tinyply.hpp"
+
+using namespace EcoSysLab;
+
+struct TreeDatasetSample
+{
+	size_t m_taskIndex = 0;
+	std::shared_ptr<ShootDescriptor> m_shootDescriptor;
+	std::shared_ptr<FoliageDescriptor> m_foliageDescriptor;
+	std::shared_ptr<BarkDescriptor> m_barkDescriptor;
+	ShootGrowthController m_shootGrowthController{};
+	TreeModel m_treeModel{};
+	ClimateModel m_climateModel{};
+	//Seeded by the task. Samples grow concurrently, so each draws from its own generator instead of the global one.
+	std::mt19937 m_randomGenerator{};
+	bool m_finished = false;
+
+	std::vector<Vertex> m_branchVertices;
+	std::vector<unsigned int> m_branchIndices;
+	std::vector<Vertex> m_foliageVertices;
+	std::vector<unsigned int> m_foliageIndices;
+	std::vector<Vertex> m_trunkVertices;
+	std::vector<unsigned int> m_trunkIndices;
+};
+
+TreeDatasetManifest::TreeDatasetManifest(const std::filesystem::path& path)
+{
+	m_path = path;
+	if (std::filesystem::exists(m_path))
+	{
+		std::ifstream input(m_path);
+		std::string line;
+		while (std::getline(input, line))
+		{
+			const auto separator = line.find('\t');
+			if (separator == std::string::npos || separator == 0) continue;
+			m_completed.insert(line.substr(0, separator));
+		}
+	}
+	m_output.open(m_path, std::ofstream::out | std::ofstream::app);
+}
+
+bool TreeDatasetManifest::IsCompleted(const std::string& name) const
+{
+	return m_completed.find(name) != m_completed.end();
+}
+
+void TreeDatasetManifest::MarkCompleted(const std::string& name, const std::string& shardName)
+{
+	std::lock_guard lock(m_mutex);
+	m_completed.insert(name);
+	m_output << name << '\t' << shardName << '\n';
+	m_output.flush();
+}
+
+size_t TreeDatasetManifest::GetCompletedCount() const
+{
+	return m_completed.size();
+}
+
+MeshExportChunk GetDatasetMeshChunk(const std::string& name, const std::vector<Vertex>* vertices, const std::vector<unsigned int>* indices)
+{
+	MeshExportChunk chunk{};
+	chunk.m_name = name;
+	chunk.m_vertices = vertices;
+	chunk.m_indices = indices;
+	return chunk;
+}
+
+void WriteDatasetTreeInfo(const std::filesystem::path& path, const ShootSkeleton& skeleton)
+{
+	const auto& sortedInternodeList = skeleton.PeekSortedNodeList();
+	if (sortedInternodeList.size() <= 1) return;
+	float trunkHeight = 0.0f;
+	float topDiameter = 0.0f;
+	for (const auto& nodeHandle : sortedInternodeList)
+	{
+		const auto& node = skeleton.PeekNode(nodeHandle);
+		if (node.PeekChildHandles().size() > 1) {
+			trunkHeight = node.m_info.GetGlobalEndPosition().y;
+			topDiameter = node.m_info.m_thickness;
+			break;
+		}
+	}
+	const float baseDiameter = skeleton.PeekNode(0).m_info.m_thickness;
+	std::ofstream of;
+	of.open(path.string(), std::ofstream::out | std::ofstream::trunc);
+	if (!of.is_open())
+	{
+		EVOENGINE_ERROR("Failed to open " + path.string());
+		return;
+	}
+	std::stringstream data;
+	data << "TrunkHeight " << std::to_string(trunkHeight) << "\n";
+	data << "TrunkBaseDiameter " << std::to_string(baseDiameter) << "\n";
+	data << "TrunkTopDiameter " << std::to_string(topDiameter) << "\n";
+
+	data << "TreeBoundingBoxMinX " << std::to_string(skeleton.m_min.x) << "\n";
+	data << "TreeBoundingBoxMinY " << std::to_string(skeleton.m_min.y) << "\n";
+	data << "TreeBoundingBoxMinZ " << std::to_string(skeleton.m_min.z) << "\n";
+	data << "TreeBoundingBoxMaxX " << std::to_string(skeleton.m_max.x) << "\n";
+	data << "TreeBoundingBoxMaxY " << std::to_string(skeleton.m_max.y) << "\n";
+	data << "TreeBoundingBoxMaxZ " << std::to_string(skeleton.m_max.z) << "\n";
+	const auto result = data.str();
+	of.write(result.c_str(), result.size());
+}
+
+void PrepareDatasetEnvironment(TreeDatasetSample& sample, const SimulationSettings& simulationSettings)
+{
+	//Same as Climate::PrepareForGrowth, restricted to the single tree that lives in this climate.
+	auto& estimator = sample.m_climateModel.m_environmentGrid;
+	auto minBound = estimator.m_voxel.GetMinBound();
+	auto maxBound = estimator.m_voxel.GetMaxBound();
+	const auto& skeleton = sample.m_treeModel.RefShootSkeleton();
+	const auto currentMinBound = skeleton.m_min;
+	const auto currentMaxBound = skeleton.m_max;
+	if (estimator.m_voxel.GetVoxelCount() == 0 || currentMinBound.x <= minBound.x || currentMinBound.y <= minBound.y || currentMinBound.z <= minBound.z
+		|| currentMaxBound.x >= maxBound.x || currentMaxBound.y >= maxBound.y || currentMaxBound.z >= maxBound.z) {
+		minBound = glm::min(currentMinBound - glm::vec3(1.0f, 0.1f, 1.0f), minBound);
+		maxBound = glm::max(currentMaxBound + glm::vec3(1.0f), maxBound);
+		estimator.m_voxel.Initialize(estimator.m_voxelSize, minBound, maxBound);
+	}
+	estimator.m_voxel.Reset();
+	sample.m_treeModel.RegisterVoxel(glm::mat4(1.0f), sample.m_climateModel, sample.m_shootGrowthController);
+	estimator.LightPropagation(simulationSettings);
+}
+
+void GenerateDatasetFoliage(TreeDatasetSample& sample, const std::vector<Vertex>& quadVertices, const std::vector<glm::uvec3>& quadTriangles)
+{
+	const auto& skeleton = sample.m_treeModel.PeekShootSkeleton();
+	const auto treeDim = skeleton.m_max - skeleton.m_min;
+	auto& vertices = sample.m_foliageVertices;
+	auto& indices = sample.m_foliageIndices;
+	std::vector<glm::mat4> leafMatrices;
+	const TreeRandomScope randomScope(&sample.m_randomGenerator);
+	for (const auto& internodeHandle : skeleton.PeekSortedNodeList()) {
+		const auto& internodeInfo = skeleton.PeekNode(internodeHandle).m_info;
+		leafMatrices.clear();
+		sample.m_foliageDescriptor->GenerateFoliageMatrices(leafMatrices, internodeInfo, glm::length(treeDim));
+		for (const auto& matrix : leafMatrices)
+		{
+			//Both faces of the quad, the back face with reversed winding.
+			for (int side = 0; side < 2; side++) {
+				const auto offset = static_cast<unsigned>(vertices.size());
+				for (const auto& quadVertex : quadVertices) {
+					Vertex vertex = quadVertex;
+					vertex.m_position = matrix * glm::vec4(quadVertex.m_position, 1.0f);
+					vertex.m_normal = glm::normalize(glm::vec3(matrix * glm::vec4(quadVertex.m_normal, 0.0f)));
+					vertex.m_tangent = glm::normalize(glm::vec3(matrix * glm::vec4(quadVertex.m_tangent, 0.0f)));
+					vertex.m_color = internodeInfo.m_color;
+					vertices.emplace_back(vertex);
+				}
+				for (const auto& triangle : quadTriangles) {
+					if (side == 0) {
+						indices.emplace_back(triangle.x + offset);
+						indices.emplace_back(triangle.y + offset);
+						indices.emplace_back(triangle.z + offset);
+					}
+					else
+					{
+						indices.emplace_back(triangle.z + offset);
+						indices.emplace_back(triangle.y + offset);
+						indices.emplace_back(triangle.x + offset);
+					}
+				}
+			}
+		}
+	}
+}
+
+void GenerateDatasetBranchMeshes(TreeDatasetSample& sample, const TreeDatasetSettings& settings, const TreeDatasetSinkRequirements& requirements)
+{
+	const auto& skeleton = sample.m_treeModel.PeekShootSkeleton();
+	const auto barkDescriptor = sample.m_barkDescriptor;
+	const auto vertexPositionModifier = [&](glm::vec3& vertexPosition, const glm::vec3& direction, const float xFactor, const float yFactor)
+		{
+			if (barkDescriptor)
+			{
+				const float pushValue = barkDescriptor->GetValue(xFactor, yFactor);
+				vertexPosition += pushValue * direction;
+			}
+		};
+	const auto texCoordsModifier = [&](glm::vec2& texCoords, float xFactor, float distanceToRoot) {};
+	if (requirements.m_branchMesh && settings.m_meshGeneratorSettings.m_enableBranch)
+	{
+		CylindricalMeshGenerator<ShootGrowthData, ShootStemGrowthData, InternodeGrowthData>::Generate(skeleton, sample.m_branchVertices, sample.m_branchIndices,
+			settings.m_meshGeneratorSettings, vertexPositionModifier, texCoordsModifier);
+	}
+	if (requirements.m_trunkMesh)
+	{
+		std::unordered_set<SkeletonNodeHandle> trunkHandles{};
+		for (const auto& nodeHandle : skeleton.PeekSortedNodeList())
+		{
+			trunkHandles.insert(nodeHandle);
+			if (skeleton.PeekNode(nodeHandle).PeekChildHandles().size() > 1) break;
+		}
+		CylindricalMeshGenerator<ShootGrowthData, ShootStemGrowthData, InternodeGrowthData>::GeneratePartially(trunkHandles, skeleton, sample.m_trunkVertices, sample.m_trunkIndices,
+			settings.m_meshGeneratorSettings, vertexPositionModifier, texCoordsModifier);
+	}
+}
+
+std::filesystem::path TreeDatasetSampleOutput::GetOutputPath(const std::string& suffix) const
+{
+	return m_shardPath / (m_task->m_name + suffix);
+}
+
+void TreeDatasetMeshSink::CollectRequirements(TreeDatasetSinkRequirements& requirements) const
+{
+	requirements.m_branchMesh = true;
+	if (m_foliage) requirements.m_foliageMesh = true;
+}
+
+void TreeDatasetMeshSink::Write(const TreeDatasetSampleOutput& output)
+{
+	std::vector<MeshExportChunk> chunks = { GetDatasetMeshChunk("branch", output.m_branchVertices, output.m_branchIndices) };
+	if (m_foliage) chunks.emplace_back(GetDatasetMeshChunk("foliage", output.m_foliageVertices, output.m_foliageIndices));
+	MeshExporter::Export(output.GetOutputPath(".obj"), chunks);
+}
+
+void TreeDatasetTrunkMeshSink::CollectRequirements(TreeDatasetSinkRequirements& requirements) const
+{
+	requirements.m_trunkMesh = true;
+}
+
+void TreeDatasetTrunkMeshSink::Write(const TreeDatasetSampleOutput& output)
+{
+	MeshExporter::Export(output.GetOutputPath("_trunk.obj"), { GetDatasetMeshChunk("trunk", output.m_trunkVertices, output.m_trunkIndices) });
+}
+
+void TreeDatasetInfoSink::Write(const TreeDatasetSampleOutput& output)
+{
+	WriteDatasetTreeInfo(output.GetOutputPath("_info.txt"), output.m_treeModel->PeekShootSkeleton());
+}
+
+void TreeDatasetSkeletonSink::Write(const TreeDatasetSampleOutput& output)
+{
+	BinaryArchiveWriter archive;
+	archive.m_compress = m_compress;
+	Tree::SerializeShootSkeleton(archive, "m_treeModel.m_shootSkeleton.", output.m_treeModel->PeekShootSkeleton());
+	archive.AddValue("m_treeModel.m_historySize", 0);
+	archive.Write(output.GetOutputPath(".esb"));
+}
+
+void TreeDatasetPointCloudSink::CollectRequirements(TreeDatasetSinkRequirements& requirements) const
+{
+	requirements.m_branchMesh = true;
+	if (m_foliage) requirements.m_foliageMesh = true;
+}
+
+void TreeDatasetPointCloudSink::Write(const TreeDatasetSampleOutput& output)
+{
+	struct SurfaceTriangle
+	{
+		const std::vector<Vertex>* m_vertices;
+		const unsigned int* m_indices;
+		int m_typeIndex;
+	};
+	std::vector<SurfaceTriangle> triangles;
+	std::vector<float> cumulativeAreas;
+	float totalArea = 0.0f;
+	const auto addSurface = [&](const std::vector<Vertex>* vertices, const std::vector<unsigned int>* indices, const int typeIndex)
+		{
+			if (!vertices || !indices) return;
+			for (size_t i = 0; i + 2 < indices->size(); i += 3)
+			{
+				const auto& p0 = vertices->at(indices->at(i)).m_position;
+				const auto& p1 = vertices->at(indices->at(i + 1)).m_position;
+				const auto& p2 = vertices->at(indices->at(i + 2)).m_position;
+				const float area = 0.5f * glm::length(glm::cross(p1 - p0, p2 - p0));
+				if (area <= 0.0f) continue;
+				totalArea += area;
+				triangles.push_back({ vertices, &indices->at(i), typeIndex });
+				cumulativeAreas.emplace_back(totalArea);
+			}
+		};
+	addSurface(output.m_branchVertices, output.m_branchIndices, 0);
+	if (m_foliage) addSurface(output.m_foliageVertices, output.m_foliageIndices, 1);
+	if (triangles.empty() || m_pointCount <= 0) return;
+
+	//Seeded by the task, so a sample gets the same points when the run is repeated.
+	std::mt19937 generator(static_cast<unsigned>(output.m_task->m_seed));
+	std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+	std::vector<glm::vec3> points(m_pointCount);
+	std::vector<int> typeIndex(m_pointCount);
+	for (int i = 0; i < m_pointCount; i++)
+	{
+		const auto search = std::upper_bound(cumulativeAreas.begin(), cumulativeAreas.end(), uniform(generator) * totalArea);
+		const auto& triangle = triangles[glm::min(static_cast<size_t>(search - cumulativeAreas.begin()), triangles.size() - 1)];
+		const auto& p0 = triangle.m_vertices->at(triangle.m_indices[0]).m_position;
+		const auto& p1 = triangle.m_vertices->at(triangle.m_indices[1]).m_position;
+		const auto& p2 = triangle.m_vertices->at(triangle.m_indices[2]).m_position;
+		const float r0 = glm::sqrt(uniform(generator));
+		const float r1 = uniform(generator);
+		points[i] = (1.0f - r0) * p0 + r0 * (1.0f - r1) * p1 + r0 * r1 * p2;
+		typeIndex[i] = triangle.m_typeIndex;
+	}
+	//normal_distribution needs a positive deviation.
+	if (m_deviation > 0.0f)
+	{
+		std::normal_distribution<float> noise(0.0f, m_deviation);
+		for (auto& point : points) point += glm::vec3(noise(generator), noise(generator), noise(generator));
+	}
+
+	const auto path = output.GetOutputPath(".ply");
+	std::filebuf fileBuffer;
+	fileBuffer.open(path.string(), std::ios::out | std::ios::binary);
+	std::ostream outputStream(&fileBuffer);
+	if (outputStream.fail())
+	{
+		EVOENGINE_ERROR("Failed to open " + path.string());
+		return;
+	}
+	tinyply::PlyFile plyFile;
+	plyFile.add_properties_to_element(
+		"vertex", { "x", "y", "z" }, tinyply::Type::FLOAT32, points.size(),
+		reinterpret_cast<uint8_t*>(points.data()), tinyply::Type::INVALID, 0);
+	plyFile.add_properties_to_element(
+		"type_index", { "type_index" }, tinyply::Type::INT32, typeIndex.size(),
+		reinterpret_cast<uint8_t*>(typeIndex.data()), tinyply::Type::INVALID, 0);
+	plyFile.write(outputStream, true);
+}
+
+std::string TreeDatasetTimings::ToString() const
+{
+	std::stringstream data;
+	data << std::fixed << std::setprecision(2) << m_sampleCount << " samples, setup " << m_setup << "s, environment " << m_environment
+		<< "s, growth " << m_growth << "s, meshing " << m_meshing << "s, output " << m_output << "s";
+	return data.str();
+}
+
+double GetSecondsSince(const std::chrono::steady_clock::time_point& start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::string TreeDatasetEngine::GetShardName(const size_t taskIndex, const int shardSize)
+{
+	const auto shardIndex = taskIndex / static_cast<size_t>(glm::max(shardSize, 1));
+	std::string digits = std::to_string(shardIndex);
+	if (digits.size() < 5) digits.insert(0, 5 - digits.size(), '0');
+	return "shard_" + digits;
+}
+
+TreeDatasetTimings TreeDatasetEngine::Generate(const std::vector<TreeDatasetTask>& tasks, const TreeDatasetSettings& settings,
+	const std::filesystem::path& outputRoot)
+{
+	std::vector<std::shared_ptr<ITreeDatasetSink>> sinks;
+	if (settings.m_exportTreeMesh)
+	{
+		const auto meshSink = std::make_shared<TreeDatasetMeshSink>();
+		meshSink->m_foliage = settings.m_meshGeneratorSettings.m_enableFoliage;
+		sinks.emplace_back(meshSink);
+	}
+	if (settings.m_exportTrunkMesh) sinks.emplace_back(std::make_shared<TreeDatasetTrunkMeshSink>());
+	if (settings.m_exportTreeInfo) sinks.emplace_back(std::make_shared<TreeDatasetInfoSink>());
+	return Generate(tasks, settings, outputRoot, sinks);
+}
+
+TreeDatasetTimings TreeDatasetEngine::Generate(const std::vector<TreeDatasetTask>& tasks, const TreeDatasetSettings& settings,
+	const std::filesystem::path& outputRoot, const std::vector<std::shared_ptr<ITreeDatasetSink>>& sinks)
+{
+	TreeDatasetTimings timings{};
+	auto stageStart = std::chrono::steady_clock::now();
+	std::filesystem::create_directories(outputRoot);
+	TreeDatasetManifest manifest(outputRoot / "manifest.txt");
+	std::vector<size_t> pendingTaskIndices;
+	for (size_t taskIndex = 0; taskIndex < tasks.size(); taskIndex++)
+	{
+		if (!manifest.IsCompleted(tasks[taskIndex].m_name)) pendingTaskIndices.emplace_back(taskIndex);
+	}
+	EVOENGINE_LOG("Dataset: " + std::to_string(manifest.GetCompletedCount()) + " samples already finished, " + std::to_string(pendingTaskIndices.size()) + " pending.");
+	if (pendingTaskIndices.empty()) return timings;
+	TreeDatasetSinkRequirements requirements{};
+	for (const auto& sink : sinks) sink->CollectRequirements(requirements);
+	if (requirements.m_branchMesh && !settings.m_meshGeneratorSettings.m_enableBranch)
+	{
+		EVOENGINE_WARNING("Dataset: sinks need branch meshes but m_enableBranch is off, their branch output will be empty.");
+	}
+
+	//Asset loading is not thread-safe, descriptors are resolved once before any worker starts.
+	std::map<std::filesystem::path, std::shared_ptr<TreeDescriptor>> treeDescriptors;
+	for (const auto& taskIndex : pendingTaskIndices)
+	{
+		const auto& path = tasks[taskIndex].m_treeDescriptorPath;
+		if (treeDescriptors.find(path) != treeDescriptors.end()) continue;
+		std::shared_ptr<TreeDescriptor> treeDescriptor;
+		if (ProjectManager::IsInProjectFolder(path))
+		{
+			treeDescriptor = std::dynamic_pointer_cast<TreeDescriptor>(ProjectManager::GetOrCreateAsset(ProjectManager::GetPathRelativeToProject(path)));
+		}
+		if (!treeDescriptor) EVOENGINE_ERROR("Tree Descriptor doesn't exist: " + path.string());
+		treeDescriptors[path] = treeDescriptor;
+	}
+	const auto defaultShootDescriptor = ProjectManager::CreateTemporaryAsset<ShootDescriptor>();
+	const auto defaultFoliageDescriptor = ProjectManager::CreateTemporaryAsset<FoliageDescriptor>();
+	const auto quadMesh = Resources::GetResource<Mesh>("PRIMITIVE_QUAD");
+	const auto quadVertices = quadMesh->UnsafeGetVertices();
+	const auto quadTriangles = quadMesh->UnsafeGetTriangles();
+
+	const size_t concurrency = settings.m_concurrency > 0 ? settings.m_concurrency : glm::max(static_cast<size_t>(Jobs::GetWorkerSize()), static_cast<size_t>(1));
+	timings.m_setup += GetSecondsSince(stageStart);
+	for (size_t waveStart = 0; waveStart < pendingTaskIndices.size(); waveStart += concurrency)
+	{
+		stageStart = std::chrono::steady_clock::now();
+		const auto waveSize = glm::min(concurrency, pendingTaskIndices.size() - waveStart);
+		std::vector<TreeDatasetSample> samples(waveSize);
+		for (size_t i = 0; i < waveSize; i++)
+		{
+			auto& sample = samples[i];
+			sample.m_taskIndex = pendingTaskIndices[waveStart + i];
+			const auto& task = tasks[sample.m_taskIndex];
+			if (const auto& treeDescriptor = treeDescriptors.at(task.m_treeDescriptorPath))
+			{
+				sample.m_shootDescriptor = treeDescriptor->m_shootDescriptor.Get<ShootDescriptor>();
+				sample.m_foliageDescriptor = treeDescriptor->m_foliageDescriptor.Get<FoliageDescriptor>();
+				sample.m_barkDescriptor = treeDescriptor->m_barkDescriptor.Get<BarkDescriptor>();
+			}
+			else
+			{
+				sample.m_finished = true;
+				continue;
+			}
+			if (!sample.m_shootDescriptor) sample.m_shootDescriptor = defaultShootDescriptor;
+			if (!sample.m_foliageDescriptor) sample.m_foliageDescriptor = defaultFoliageDescriptor;
+			sample.m_treeModel.m_seed = task.m_seed;
+			sample.m_randomGenerator.seed(static_cast<unsigned>(task.m_seed));
+			sample.m_treeModel.m_treeGrowthSettings.m_useSpaceColonization = false;
+			Tree::PrepareShootGrowthController(sample.m_shootDescriptor, 0.f, 0.f, sample.m_shootGrowthController);
+		}
+		timings.m_setup += GetSecondsSince(stageStart);
+
+		for (int iteration = 0; iteration < settings.m_maxIterations; iteration++)
+		{
+			bool anyActive = false;
+			stageStart = std::chrono::steady_clock::now();
+			//Light propagation runs parallel internally, so the environments are prepared one after another.
+			for (auto& sample : samples)
+			{
+				if (sample.m_finished) continue;
+				anyActive = true;
+				sample.m_climateModel.m_time += settings.m_deltaTime;
+				PrepareDatasetEnvironment(sample, settings.m_simulationSettings);
+			}
+			timings.m_environment += GetSecondsSince(stageStart);
+			if (!anyActive) break;
+			stageStart = std::chrono::steady_clock::now();
+			Jobs::RunParallelFor(waveSize, [&](unsigned i)
+				{
+					auto& sample = samples[i];
+					if (sample.m_finished) return;
+					sample.m_treeModel.Grow(settings.m_deltaTime, glm::mat4(1.0f), sample.m_climateModel, sample.m_shootGrowthController, true, &sample.m_randomGenerator);
+					if (sample.m_treeModel.RefShootSkeleton().PeekSortedNodeList().size() >= settings.m_maxTreeNodeCount) sample.m_finished = true;
+				}
+			);
+			timings.m_growth += GetSecondsSince(stageStart);
+		}
+
+		stageStart = std::chrono::steady_clock::now();
+		//The cylindrical mesh generator runs parallel internally, foliage is generated one tree per worker.
+		for (auto& sample : samples)
+		{
+			if (!sample.m_shootDescriptor) continue;
+			GenerateDatasetBranchMeshes(sample, settings, requirements);
+		}
+		if (requirements.m_foliageMesh && settings.m_meshGeneratorSettings.m_enableFoliage)
+		{
+			Jobs::RunParallelFor(waveSize, [&](unsigned i)
+				{
+					auto& sample = samples[i];
+					if (!sample.m_shootDescriptor) return;
+					GenerateDatasetFoliage(sample, quadVertices, quadTriangles);
+				}
+			);
+		}
+		timings.m_meshing += GetSecondsSince(stageStart);
+
+		stageStart = std::chrono::steady_clock::now();
+		//MeshExporter formats its chunks in parallel internally, so the samples are written one after another.
+		for (auto& sample : samples)
+		{
+			if (!sample.m_shootDescriptor) continue;
+			const auto& task = tasks[sample.m_taskIndex];
+			const auto shardName = GetShardName(sample.m_taskIndex, settings.m_shardSize);
+			TreeDatasetSampleOutput output{};
+			output.m_task = &task;
+			output.m_shardPath = outputRoot / shardName;
+			output.m_treeModel = &sample.m_treeModel;
+			output.m_branchVertices = &sample.m_branchVertices;
+			output.m_branchIndices = &sample.m_branchIndices;
+			output.m_foliageVertices = &sample.m_foliageVertices;
+			output.m_foliageIndices = &sample.m_foliageIndices;
+			output.m_trunkVertices = &sample.m_trunkVertices;
+			output.m_trunkIndices = &sample.m_trunkIndices;
+			std::filesystem::create_directories(output.m_shardPath);
+			for (const auto& sink : sinks) sink->Write(output);
+			manifest.MarkCompleted(task.m_name, shardName);
+		}
+		timings.m_output += GetSecondsSince(stageStart);
+		for (const auto& sample : samples)
+		{
+			if (sample.m_shootDescriptor) timings.m_sampleCount++;
+		}
+		EVOENGINE_LOG("Dataset: " + std::to_string(manifest.GetCompletedCount()) + "/" + std::to_string(tasks.size()) + " samples finished.");
+	}
+	EVOENGINE_LOG("Dataset timings: " + timings.ToString());
+	return timings;
+}
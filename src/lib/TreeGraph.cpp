@@ -2,6 +2,95 @@
 
 using namespace EcoSysLab;
 
+void TreeGraphArrays::Clear()
+{
+    m_ids.clear();
+    m_parents.clear();
+    m_starts.clear();
+    m_positions.clear();
+    m_globalRotations.clear();
+    m_lengths.clear();
+    m_thicknesses.clear();
+    m_fromApicalBud.clear();
+    m_childCounts.clear();
+}
+
+size_t TreeGraphArrays::GetSize() const
+{
+    return m_ids.size();
+}
+
+void TreeGraphArrays::Reserve(const size_t size)
+{
+    m_ids.reserve(size);
+    m_parents.reserve(size);
+    m_starts.reserve(size);
+    m_positions.reserve(size);
+    m_globalRotations.reserve(size);
+    m_lengths.reserve(size);
+    m_thicknesses.reserve(size);
+    m_fromApicalBud.reserve(size);
+    m_childCounts.reserve(size);
+}
+
+int TreeGraphArrays::Add(const int id, const int parentIndex, const glm::vec3& start, const glm::vec3& position,
+    const glm::quat& globalRotation, const float length, const float thickness)
+{
+    const auto index = static_cast<int>(m_ids.size());
+    m_ids.emplace_back(id);
+    m_parents.emplace_back(parentIndex);
+    m_starts.emplace_back(start);
+    m_positions.emplace_back(position);
+    m_globalRotations.emplace_back(globalRotation);
+    m_lengths.emplace_back(length);
+    m_thicknesses.emplace_back(thickness);
+    m_fromApicalBud.emplace_back(parentIndex == -1 || m_childCounts[parentIndex] == 0 ? 1 : 0);
+    m_childCounts.emplace_back(0);
+    if (parentIndex != -1) m_childCounts[parentIndex]++;
+    return index;
+}
+
+void TreeGraphArrays::FromNodeTree(const std::shared_ptr<TreeGraphNode>& root)
+{
+    Clear();
+    if (!root) return;
+    std::vector<std::pair<const TreeGraphNode*, int>> queue;
+    queue.emplace_back(root.get(), -1);
+    for (size_t i = 0; i < queue.size(); i++)
+    {
+        const auto [node, parentIndex] = queue[i];
+        const auto index = Add(node->m_id, parentIndex, node->m_start, node->m_position, node->m_globalRotation, node->m_length, node->m_thickness);
+        for (const auto& child : node->m_children) queue.emplace_back(child.get(), index);
+    }
+}
+
+template<typename T>
+void ReadComponents(const YAML::Node& in, T& value)
+{
+    int index = 0;
+    for (const auto& component : in) {
+        if (index >= T::length()) break;
+        value[index] = component.as<float>();
+        index++;
+    }
+}
+
+/**
+ * Collect the entries of a map with integer keys by index in one pass. yaml-cpp looks keys up linearly, so indexing by key is quadratic.
+ */
+void CollectIndexedEntries(const YAML::Node& in, std::vector<YAML::Node>& entries)
+{
+    entries.clear();
+    if (!in.IsMap()) return;
+    const auto size = static_cast<int>(in.size());
+    for (const auto& entry : in) {
+        int index = -1;
+        if (!YAML::convert<int>::decode(entry.first, index) || index < 0 || index >= size) continue;
+        if (index >= static_cast<int>(entries.size())) entries.resize(index + 1);
+        entries[index] = entry.second;
+    }
+}
+
 void TreeGraph::Serialize(YAML::Emitter& out) const {
     out << YAML::Key << "name" << YAML::Value << m_name;
     out << YAML::Key << "layersize" << YAML::Value << m_layerSize;
@@ -122,6 +211,91 @@ void TreeGraph::Deserialize(const YAML::Node& in) {
     }
 }
 
+bool ParseTreeGraphArrays(const YAML::Node& in, TreeGraphArrays& arrays)
+{
+    arrays.Clear();
+    if (!in["layersize"] || !in["layers"]) return false;
+    const auto layerSize = in["layersize"].as<int>();
+    std::vector<YAML::Node> layers;
+    CollectIndexedEntries(in["layers"], layers);
+    if (layerSize <= 0 || layers.empty() || !layers[0].IsMap()) return false;
+    std::vector<YAML::Node> layerNodes;
+    CollectIndexedEntries(layers[0], layerNodes);
+    if (layerNodes.empty() || !layerNodes[0].IsMap()) return false;
+
+    std::unordered_map<int, int> idToIndex;
+    //Only the first node of the first layer is read, like Deserialize does.
+    {
+        const auto& rootNode = layerNodes[0];
+        glm::quat globalRotation;
+        glm::vec3 position;
+        ReadComponents(rootNode["quat"], globalRotation);
+        ReadComponents(rootNode["position"], position);
+        const auto id = rootNode["id"].as<int>();
+        idToIndex[id] = arrays.Add(id, -1, glm::vec3(0.0f), position, globalRotation, rootNode["length"].as<float>(), rootNode["thickness"].as<float>());
+    }
+    for (int layerIndex = 1; layerIndex < layerSize; layerIndex++) {
+        if (layerIndex >= layers.size() || !layers[layerIndex].IsMap())
+        {
+            EVOENGINE_ERROR("Missing layer " + std::to_string(layerIndex));
+            return false;
+        }
+        const auto& layer = layers[layerIndex];
+        const auto internodeSize = layer["internodesize"].as<int>();
+        CollectIndexedEntries(layer, layerNodes);
+        for (int nodeIndex = 0; nodeIndex < internodeSize; nodeIndex++) {
+            if (nodeIndex >= layerNodes.size() || !layerNodes[nodeIndex].IsMap())
+            {
+                EVOENGINE_ERROR("Missing node " + std::to_string(nodeIndex) + " in layer " + std::to_string(layerIndex));
+                return false;
+            }
+            const auto& node = layerNodes[nodeIndex];
+            auto parentNodeId = node["parent"].as<int>();
+            if (parentNodeId == -1) parentNodeId = 0;
+            const auto search = idToIndex.find(parentNodeId);
+            if (search == idToIndex.end())
+            {
+                EVOENGINE_ERROR("Missing parent " + std::to_string(parentNodeId));
+                return false;
+            }
+            const auto parentIndex = search->second;
+            const auto start = arrays.m_starts[parentIndex] + arrays.m_lengths[parentIndex] *
+                (glm::normalize(arrays.m_globalRotations[parentIndex]) * glm::vec3(0, 0, -1));
+            glm::quat globalRotation;
+            glm::vec3 position;
+            ReadComponents(node["quat"], globalRotation);
+            ReadComponents(node["position"], position);
+            const auto id = node["id"].as<int>();
+            idToIndex[id] = arrays.Add(id, parentIndex, start, position, globalRotation, node["length"].as<float>(), node["thickness"].as<float>());
+        }
+    }
+    return true;
+}
+
+bool TreeGraph::ParseArrays(const YAML::Node& in, TreeGraphArrays& arrays)
+{
+    try {
+        if (ParseTreeGraphArrays(in, arrays)) return true;
+    }
+    catch (const std::exception& e) {
+        EVOENGINE_ERROR(std::string("Failed to parse tree graph: ") + e.what());
+    }
+    arrays.Clear();
+    return false;
+}
+
+bool TreeGraph::ImportArrays(const std::filesystem::path& path, TreeGraphArrays& arrays)
+{
+    try {
+        return ParseArrays(YAML::LoadFile(path.string()), arrays);
+    }
+    catch (const std::exception& e) {
+        EVOENGINE_ERROR("Failed to import " + path.string() + ": " + e.what());
+    }
+    arrays.Clear();
+    return false;
+}
+
 bool TreeGraph::OnInspect(const std::shared_ptr<EditorLayer>& editorLayer)
 {
     bool changed = false;
@@ -206,6 +380,64 @@ void TreeGraphV2::Deserialize(const YAML::Node& in) {
     }
 }
 
+bool ParseTreeGraphV2Arrays(const YAML::Node& in, TreeGraphArrays& arrays)
+{
+    arrays.Clear();
+    std::vector<YAML::Node> entries;
+    CollectIndexedEntries(in, entries);
+    //Nodes are read up to the first missing id, like Deserialize does.
+    size_t nodeSize = 0;
+    while (nodeSize < entries.size() && entries[nodeSize].IsMap()) nodeSize++;
+    if (nodeSize == 0) return false;
+    arrays.Reserve(nodeSize);
+    for (int id = 0; id < static_cast<int>(nodeSize); id++) {
+        const auto& inNode = entries[id];
+        glm::vec3 position;
+        ReadComponents(inNode["position"], position);
+        const auto radius = inNode["radius"].as<float>();
+        int parentIndex = -1;
+        glm::vec3 start = glm::vec3(0.0f);
+        if (id != 0)
+        {
+            parentIndex = inNode["parent"].as<int>();
+            if (parentIndex < 0 || parentIndex >= id)
+            {
+                EVOENGINE_ERROR("Node " + std::to_string(id) + " has no valid parent");
+                return false;
+            }
+            start = arrays.m_positions[parentIndex];
+        }
+        const auto direction = glm::normalize(position - start);
+        const auto globalRotation = glm::quatLookAt(direction, glm::vec3(direction.y, direction.z, direction.x));
+        arrays.Add(id, parentIndex, start, position, globalRotation, glm::length(position - start), radius);
+    }
+    return true;
+}
+
+bool TreeGraphV2::ParseArrays(const YAML::Node& in, TreeGraphArrays& arrays)
+{
+    try {
+        if (ParseTreeGraphV2Arrays(in, arrays)) return true;
+    }
+    catch (const std::exception& e) {
+        EVOENGINE_ERROR(std::string("Failed to parse tree graph: ") + e.what());
+    }
+    arrays.Clear();
+    return false;
+}
+
+bool TreeGraphV2::ImportArrays(const std::filesystem::path& path, TreeGraphArrays& arrays)
+{
+    try {
+        return ParseArrays(YAML::LoadFile(path.string()), arrays);
+    }
+    catch (const std::exception& e) {
+        EVOENGINE_ERROR("Failed to import " + path.string() + ": " + e.what());
+    }
+    arrays.Clear();
+    return false;
+}
+
 bool TreeGraphV2::OnInspect(const std::shared_ptr<EditorLayer>& editorLayer)
 {
     bool changed = false;
@@ -37,8 +37,10 @@ bool TreeChains::buildTree(const treeio::ArrayTree &tree)
     // Create copy of the provided tree, including its structure and base properties.
     mInternalTree = tree.copy<InternalNodeData>();
     mLeafNodes.clear();
+    mNodeOrder.clear();
     mChains.clear();
     mLeafChains.clear();
+    mFlatChains = { };
 
     if (!generateUpwardPassInformation(mInternalTree))
     { std::cout << "Failed to generate upward-pass information!" << std::endl; return false; }
@@ -48,81 +50,30 @@ bool TreeChains::buildTree(const treeio::ArrayTree &tree)
     { std::cout << "Failed to generate orthonormal bases!" << std::endl; return false; }
     if (!generateNodeChains(mInternalTree, mChains, mLeafChains, mMaxChainDepth, mMaxChainGraveliusDepth))
     { std::cout << "Failed to generate node chains!" << std::endl; return false; }
+    if (!generateFlatChains(mInternalTree, mChains, mFlatChains))
+    { std::cout << "Failed to generate flat chains!" << std::endl; return false; }
 
     return true;
 }
 
-void TreeChains::cascadeUpwards(UpwardPropFunT fun)
-{
-    // Starting the algorithm from root towards the leaves:
-    auto prematureStop{ false };
-    std::stack<NodeIdT> vertexStack{ };
-    vertexStack.emplace(mInternalTree.getRootId());
-
-    while (!vertexStack.empty() && !prematureStop)
-    { // Process all vertices root to leaves.
-        const auto currentNode{ vertexStack.top() }; vertexStack.pop();
-        // Perform provided operation.
-        prematureStop = fun(mInternalTree, currentNode);
-        // Add child vertices.
-        for (const auto &cId : mInternalTree.getNodeChildren(currentNode))
-        { vertexStack.emplace(cId); }
-    }
-}
-
-void TreeChains::cascadeDownwards(DownwardPropFunT fun)
-{
-    // Starting the algorithm from leaves towards the root:
-    auto prematureStop{ false };
-    std::set<NodeIdT> currentNodes{ mLeafNodes.begin(), mLeafNodes.end() };
-    std::set<NodeIdT> newNodes{ };
-    std::set<NodeIdT> finishedNodes{ };
-
-    while (!currentNodes.empty() && !prematureStop)
-    { // Proceed in waves from the leaf nodes while storing parent vertices to the newVertices.
-        for (const auto &currentNode : currentNodes)
-        { // Process nodes in current wave.
-            // Stop loops and repeats.
-            if (finishedNodes.find(currentNode) != finishedNodes.end())
-            { continue; }
-
-            // Check all children are ready.
-            auto childrenReady{ true };
-            for (const auto &cId : mInternalTree.getNodeChildren(currentNode))
-            { if (finishedNodes.find(cId) == finishedNodes.end()) { childrenReady = false; } }
-
-            // Skip parents with non-ready children, keeping them for later processing.
-            if (!childrenReady)
-            { continue; }
-
-            // Perform requested operation.
-            prematureStop = fun(mInternalTree, currentNode);
-
-            // Schedule parent for processing.
-            if (mInternalTree.isNodeIdValid(mInternalTree.getNodeParent(currentNode)))
-            { newNodes.emplace(mInternalTree.getNodeParent(currentNode)); }
-
-            // Mark this node as finished.
-            finishedNodes.emplace(currentNode);
-        }
-        // Switch to the accumulated parent vertices and continue with the algorithm.
-        currentNodes.swap(newNodes);
-        newNodes.clear();
-    }
-}
-
 const TreeChains::InternalArrayTree &TreeChains::internalTree() const
 { return mInternalTree; }
 
 const TreeChains::NodeIdStorage &TreeChains::leafNodes() const
 { return mLeafNodes; }
 
+const TreeChains::NodeIdStorage &TreeChains::nodeOrder() const
+{ return mNodeOrder; }
+
 const TreeChains::ChainStorage &TreeChains::chains() const
 { return mChains; }
 
 const TreeChains::ChainIdxStorage &TreeChains::leafChains() const
 { return mLeafChains; }
 
+const TreeChains::FlatChains &TreeChains::flatChains() const
+{ return mFlatChains; }
+
 std::size_t TreeChains::maxChainDepth() const
 { return mMaxChainDepth; }
 
@@ -197,7 +148,7 @@ TreeChains::CompactChainStorage TreeChains::generateCompactChains(float maxLengt
             const auto &srcChildChain{ allChains[childChainIdx] };
             const auto chainLength{
                 childChainRecord.accumulatedLength +
-                srcChildChain.calculateChainLength(mInternalTree)
+                mFlatChains.lengths[childChainIdx]
             };
 
             if (chainLength <= maxLength && !srcChildChain.childChains.empty())
@@ -219,79 +170,65 @@ TreeChains::CompactChainStorage TreeChains::generateCompactChains(float maxLengt
 
 std::size_t TreeChains::removeChainsDownToDepth(std::size_t depth)
 {
-    std::size_t totalChainsMarked{ 0u };
-
+    std::vector<bool> removalRoots(mChains.size(), false);
     for (std::size_t iii = 0u; iii < mChains.size(); ++iii)
-    { // Find chains at exactly the depth and recursively remove all following.
-        if (mChains[iii].chainDepth == depth)
-        { totalChainsMarked += markChainForRemoval(mInternalTree, mChains, iii); }
+    { // Find chains at exactly the depth, all following are removed with them.
+        removalRoots[iii] = mChains[iii].chainDepth == depth;
     }
 
-    return totalChainsMarked;
+    return markChainsForRemoval(mInternalTree, mChains, removalRoots);
 }
 
 std::size_t TreeChains::removeLeafChains(std::size_t count)
 {
-    std::size_t totalChainsMarked{ 0u };
+    if (count == 0u || mChains.empty())
+    { return 0u; }
 
-    std::set<NodeChain::ChainIdxT> chainsToRemove{ };
+    std::vector<bool> removalRoots(mChains.size(), false);
     for (const auto &leafChainIdx : mLeafChains)
     { // Accumulate chains to be removed.
         auto chainToRemove{ leafChainIdx };
         for (std::size_t iii = 0u; iii < count - 1u; ++iii)
-        { // Descent given number of chains.
-            chainToRemove = mChains[chainToRemove].parentChain;
+        { // Descent given number of chains, stopping at the root chain.
+            const auto parentChain{ mFlatChains.parents[chainToRemove] };
+            if (parentChain == NodeChain::INVALID_CHAIN_IDX)
+            { break; }
+            chainToRemove = parentChain;
         }
 
-        chainsToRemove.emplace(chainToRemove);
+        removalRoots[chainToRemove] = true;
     }
 
-    // Remove all of the accumulated chains.
-    for (const auto &chainIdx : chainsToRemove)
-    { // Find chains at exactly the depth and recursively remove all following.
-        totalChainsMarked += markChainForRemoval(mInternalTree, mChains, chainIdx);
-    }
-
-    return totalChainsMarked;
+    return markChainsForRemoval(mInternalTree, mChains, removalRoots);
 }
 
 std::size_t TreeChains::removeLeafChainsGravelius(std::size_t order)
 {
-    std::size_t totalChainsMarked{ 0u };
-
-    std::set<NodeChain::ChainIdxT> chainsToRemove{ };
+    std::vector<bool> removalRoots(mChains.size(), false);
     for (const auto &leafChainIdx : mLeafChains)
     { // Accumulate chains to be removed.
         auto chainToRemove{ leafChainIdx };
         while (chainToRemove != NodeChain::INVALID_CHAIN_IDX && mChains[chainToRemove].graveliusOrder < order)
         { // Descent given number of chains.
-            chainToRemove = mChains[chainToRemove].parentChain;
+            chainToRemove = mFlatChains.parents[chainToRemove];
         }
 
         if (chainToRemove != NodeChain::INVALID_CHAIN_IDX && mChains[chainToRemove].graveliusOrder <= order)
-        { chainsToRemove.emplace(chainToRemove); }
-    }
-
-    // Remove all of the accumulated chains.
-    for (const auto &chainIdx : chainsToRemove)
-    { // Find chains at exactly the depth and recursively remove all following.
-        totalChainsMarked += markChainForRemoval(mInternalTree, mChains, chainIdx);
+        { removalRoots[chainToRemove] = true; }
     }
 
-    return totalChainsMarked;
+    return markChainsForRemoval(mInternalTree, mChains, removalRoots);
 }
 
 std::size_t TreeChains::remoChainsDownToGraveliusDepth(std::size_t depth)
 {
-    std::size_t totalChainsMarked{ 0u };
-
+    std::vector<bool> removalRoots(mChains.size(), false);
     for (std::size_t iii = 0u; iii < mChains.size(); ++iii)
-    { // Find chains at exactly the depth and recursively remove all following.
-        if (mChains[iii].graveliusDepth == depth)
-        { totalChainsMarked += markChainForRemoval(mInternalTree, mChains, iii); }
+    { // Find chains at exactly the depth, all following are removed with them.
+        removalRoots[iii] = mChains[iii].graveliusDepth == depth;
     }
 
-    return totalChainsMarked;
+    return markChainsForRemoval(mInternalTree, mChains, removalRoots);
 }
 
 bool TreeChains::applyChangesTo(treeio::ArrayTree &tree) const
@@ -342,6 +279,7 @@ bool TreeChains::generateUpwardPassInformation(InternalArrayTree &tree)
     while (!vertexStack.empty())
     { // Process all vertices root to leaves.
         const auto currentHelper{ vertexStack.top() }; vertexStack.pop();
+        mNodeOrder.push_back(currentHelper.vertex);
         // Update depth and distance of the current vertex.
         auto &currentNode{ tree.getNode(currentHelper.vertex) };
         currentNode.data().depth = currentHelper.depth;
@@ -370,73 +308,48 @@ bool TreeChains::generateUpwardPassInformation(InternalArrayTree &tree)
 
 bool TreeChains::generateDownwardPassInformation(InternalArrayTree &tree)
 {
-    // Initialize the set with leaf nodes:
-    std::set<NodeIdT> currentVertices{ mLeafNodes.begin(), mLeafNodes.end() };
-    std::set<NodeIdT> newVertices{ };
-    std::set<NodeIdT> finishedVertices{ };
-
-    while (!currentVertices.empty())
-    { // Proceed in waves from the leaf nodes while storing parent vertices to the newVertices.
-        for (const auto &currentVertex : currentVertices)
-        { // Calculate child count of this vertex.
-            auto &currentNode{ tree.getNode(currentVertex).data() };
-            if (finishedVertices.find(currentVertex) != finishedVertices.end())
-            { continue; }
-
-            std::size_t childCount{ 0u };
-            float childLength{ 0.0f };
-            std::size_t graveliusMaxChildren{ 0u };
-            std::size_t graveliusMaxChildOrder{ 1u };
-            auto foundUnfinished{ false };
-            const auto parent{ tree.getNodeParent(currentVertex) };
-
-            for (const auto &cId : tree.getNodeChildren(currentVertex))
-            { // Accumulate child counts for all child vertices and store parent for next iteration.
-                if (finishedVertices.find(cId) == finishedVertices.end())
-                { foundUnfinished = true; break; }
-                const auto &childNode{ tree.getNode(cId).data() };
-
-                childCount += childNode.totalChildCount;
-
-                const auto currentToChildLength{
-                    (childNode.pos - currentNode.pos).length()
-                };
-                childLength += childNode.totalChildLength + currentToChildLength;
+    // Reverse topological order guarantees all children are finished before their parent.
+    for (auto it = mNodeOrder.rbegin(); it != mNodeOrder.rend(); ++it)
+    { // Calculate child count of this vertex.
+        const auto currentVertex{ *it };
+        auto &currentNode{ tree.getNode(currentVertex).data() };
 
-                if (childNode.graveliusOrder > graveliusMaxChildOrder)
-                { graveliusMaxChildOrder = childNode.graveliusOrder; graveliusMaxChildren = 0u; }
-                if (childNode.graveliusOrder == graveliusMaxChildOrder)
-                { graveliusMaxChildren++; }
-            }
+        std::size_t childCount{ 0u };
+        float childLength{ 0.0f };
+        std::size_t graveliusMaxChildren{ 0u };
+        std::size_t graveliusMaxChildOrder{ 1u };
+
+        for (const auto &cId : tree.getNodeChildren(currentVertex))
+        { // Accumulate child counts for all child vertices.
+            const auto &childNode{ tree.getNode(cId).data() };
 
-            // Skip this node until we have all required children calculated.
-            if (foundUnfinished)
-            { continue; }
+            childCount += childNode.totalChildCount;
 
-            // We have all required children -> Continue with the parent node.
-            if (parent != INVALID_NODE_ID)
-            { newVertices.emplace(parent); }
+            const auto currentToChildLength{
+                (childNode.pos - currentNode.pos).length()
+            };
+            childLength += childNode.totalChildLength + currentToChildLength;
 
-            // Add one for the current vertex.
-            childCount += 1u;
-            // Store for later use:
-            currentNode.totalChildCount = childCount;
-            currentNode.totalChildLength = childLength;
+            if (childNode.graveliusOrder > graveliusMaxChildOrder)
+            { graveliusMaxChildOrder = childNode.graveliusOrder; graveliusMaxChildren = 0u; }
+            if (childNode.graveliusOrder == graveliusMaxChildOrder)
+            { graveliusMaxChildren++; }
+        }
 
-            if (graveliusMaxChildren > 1u)
-            { // We found a tributary joining.
-                currentNode.graveliusOrder = graveliusMaxChildOrder + 1u;
-            }
-            else
-            { // Continue with the same stream.
-                currentNode.graveliusOrder = graveliusMaxChildOrder;
-            }
+        // Add one for the current vertex.
+        childCount += 1u;
+        // Store for later use:
+        currentNode.totalChildCount = childCount;
+        currentNode.totalChildLength = childLength;
 
-            finishedVertices.emplace(currentVertex);
+        if (graveliusMaxChildren > 1u)
+        { // We found a tributary joining.
+            currentNode.graveliusOrder = graveliusMaxChildOrder + 1u;
+        }
+        else
+        { // Continue with the same stream.
+            currentNode.graveliusOrder = graveliusMaxChildOrder;
         }
-        // Switch to the accumulated parent vertices and continue with the algorithm.
-        currentVertices.swap(newVertices);
-        newVertices.clear();
     }
 
     return true;
@@ -619,6 +532,32 @@ bool TreeChains::generateNodeChains(const InternalArrayTree &tree,
     return true;
 }
 
+bool TreeChains::generateFlatChains(const InternalArrayTree &tree,
+    const ChainStorage &chains, FlatChains &flatChains)
+{
+    flatChains.parents.resize(chains.size());
+    flatChains.childOffsets.resize(chains.size() + 1u);
+    flatChains.lengths.resize(chains.size());
+    flatChains.children.clear();
+    flatChains.children.reserve(chains.empty() ? 0u : chains.size() - 1u);
+
+    for (std::size_t chainIdx = 0u; chainIdx < chains.size(); ++chainIdx)
+    {
+        const auto &chain{ chains[chainIdx] };
+        // Child chains are always created after their parent.
+        if (chain.parentChain != NodeChain::INVALID_CHAIN_IDX && chain.parentChain >= chainIdx)
+        { return false; }
+
+        flatChains.parents[chainIdx] = chain.parentChain;
+        flatChains.childOffsets[chainIdx] = flatChains.children.size();
+        flatChains.children.insert(flatChains.children.end(), chain.childChains.begin(), chain.childChains.end());
+        flatChains.lengths[chainIdx] = chain.calculateChainLength(tree);
+    }
+    flatChains.childOffsets[chains.size()] = flatChains.children.size();
+
+    return true;
+}
+
 TreeChains::FrenetFrame TreeChains::doubleReflectionRMF(
     const FrenetFrame &rotatedFrame, const FrenetFrame &inputFrame) const
 {
@@ -714,32 +653,30 @@ TreeChains::OrthoBasis TreeChains::calculateBasis(
     return result;
 }
 
-std::size_t TreeChains::markChainForRemoval(InternalArrayTree &tree,
-    ChainStorage &chains, const NodeChain::ChainIdxT &chainIdx) const
+std::size_t TreeChains::markChainsForRemoval(InternalArrayTree &tree,
+    ChainStorage &chains, const std::vector<bool> &removalRoots) const
 {
-    // Initialize the process with provided chain.
-    std::stack<NodeChain::ChainIdxT> chainsToRemove{ };
-    chainsToRemove.emplace(chainIdx);
-
-    std::size_t markedchains{ 0u };
-
-    while (!chainsToRemove.empty())
-    { // Repeat for all chains recursively.
-        const auto currentChainIdx{ chainsToRemove.top() }; chainsToRemove.pop();
-        auto &chain{ chains[currentChainIdx] };
-
-        // Mark for removal
-        chain.markedForRemoval = true;
-        markedchains++;
-        for (const auto &nid : chain.nodes)
-        { tree.getNode(nid).data().markedForRemoval = true; }
-
-        // Continue with child chains.
-        for (const auto &childChainIdx : chain.childChains)
-        { chainsToRemove.emplace(childChainIdx); }
+    std::size_t markedChains{ 0u };
+    std::vector<bool> removed(chains.size(), false);
+
+    for (std::size_t chainIdx = 0u; chainIdx < chains.size(); ++chainIdx)
+    { // Parents come first, so the flag only needs to be inherited from the direct parent.
+        const auto parentChain{ chains[chainIdx].parentChain };
+        removed[chainIdx] = removalRoots[chainIdx] ||
+            (parentChain != NodeChain::INVALID_CHAIN_IDX && removed[parentChain]);
+        if (!removed[chainIdx])
+        { continue; }
+
+        auto &chain{ chains[chainIdx] };
+        if (!chain.markedForRemoval)
+        { chain.markedForRemoval = true; markedChains++; }
+        // The first node of non-root chains is the branching node shared with the parent chain.
+        const auto firstOwnNode{ parentChain != NodeChain::INVALID_CHAIN_IDX && !removed[parentChain] ? 1u : 0u };
+        for (std::size_t nodeIdx = firstOwnNode; nodeIdx < chain.nodes.size(); ++nodeIdx)
+        { tree.getNode(chain.nodes[nodeIdx]).data().markedForRemoval = true; }
     }
 
-    return markedchains;
+    return markedChains;
 }
 
 } // namespace treeutil
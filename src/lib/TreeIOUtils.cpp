@@ -13,6 +13,18 @@
 
 #include <base64/base64.h>
 
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 
 namespace treeutil {
 
@@ -182,6 +194,144 @@ namespace treeutil {
         return result;
     }
 
+    MappedFile::MappedFile(const std::string &path) { open(path); }
+
+    MappedFile::~MappedFile() { close(); }
+
+    MappedFile::MappedFile(MappedFile &&other) noexcept { takeFrom(other); }
+
+    MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+        if (this != &other) {
+            close();
+            takeFrom(other);
+        }
+        return *this;
+    }
+
+    void MappedFile::takeFrom(MappedFile &other) {
+        mData = other.mData;
+        mSize = other.mSize;
+        mOpen = other.mOpen;
+        mFileHandle = other.mFileHandle;
+        mMappingHandle = other.mMappingHandle;
+        mFileDescriptor = other.mFileDescriptor;
+        other.mData = nullptr;
+        other.mSize = 0u;
+        other.mOpen = false;
+        other.mFileHandle = nullptr;
+        other.mMappingHandle = nullptr;
+        other.mFileDescriptor = -1;
+    }
+
+    bool MappedFile::open(const std::string &path) {
+        close();
+#ifdef _WIN32
+        const auto file{CreateFileW(std::filesystem::path(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr)};
+        if (file == INVALID_HANDLE_VALUE) { return false; }
+        mFileHandle = file;
+        LARGE_INTEGER fileSize{};
+        if (!GetFileSizeEx(file, &fileSize)) {
+            close();
+            return false;
+        }
+        mSize = static_cast<std::size_t>(fileSize.QuadPart);
+        if (mSize != 0u) {
+            mMappingHandle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!mMappingHandle) {
+                close();
+                return false;
+            }
+            mData = static_cast<const char *>(MapViewOfFile(mMappingHandle, FILE_MAP_READ, 0, 0, 0));
+            if (!mData) {
+                close();
+                return false;
+            }
+        }
+#else
+        mFileDescriptor = ::open(path.c_str(), O_RDONLY);
+        if (mFileDescriptor < 0) { return false; }
+        struct stat fileStat{};
+        if (fstat(mFileDescriptor, &fileStat) != 0) {
+            close();
+            return false;
+        }
+        mSize = static_cast<std::size_t>(fileStat.st_size);
+        if (mSize != 0u) {
+            const auto mapped{mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, mFileDescriptor, 0)};
+            if (mapped == MAP_FAILED) {
+                close();
+                return false;
+            }
+            madvise(mapped, mSize, MADV_SEQUENTIAL);
+            mData = static_cast<const char *>(mapped);
+        }
+#endif
+        mOpen = true;
+        return true;
+    }
+
+    void MappedFile::close() {
+#ifdef _WIN32
+        if (mData) { UnmapViewOfFile(mData); }
+        if (mMappingHandle) { CloseHandle(mMappingHandle); }
+        if (mFileHandle) { CloseHandle(mFileHandle); }
+#else
+        if (mData) { munmap(const_cast<char *>(mData), mSize); }
+        if (mFileDescriptor >= 0) { ::close(mFileDescriptor); }
+#endif
+        mData = nullptr;
+        mSize = 0u;
+        mOpen = false;
+        mFileHandle = nullptr;
+        mMappingHandle = nullptr;
+        mFileDescriptor = -1;
+    }
+
+    bool MappedFile::isOpen() const { return mOpen; }
+
+    std::string_view MappedFile::view() const { return {mData, mSize}; }
+
+    bool parseFloat(const char *&cursor, const char *end, float &value) {
+        while (cursor < end && std::isspace(static_cast<unsigned char>(*cursor))) { ++cursor; }
+        if (cursor < end && *cursor == '+') { ++cursor; }
+        const auto result{std::from_chars(cursor, end, value)};
+        if (result.ec != std::errc{}) { return false; }
+        cursor = result.ptr;
+        return true;
+    }
+
+    void parallelFor(std::size_t count, const std::function<void(std::size_t)> &func, std::size_t threadCount) {
+        if (threadCount == 0u) { threadCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1u); }
+        threadCount = std::min(threadCount, count);
+        if (threadCount <= 1u) {
+            for (std::size_t iii = 0u; iii < count; ++iii) { func(iii); }
+            return;
+        }
+
+        // Items are handed out one at a time, so uneven file sizes balance out.
+        std::atomic<std::size_t> nextIndex{0u};
+        // An exception escaping a worker would terminate, so the first one is kept and rethrown on the caller.
+        std::exception_ptr firstException{};
+        std::mutex exceptionMutex{};
+        std::vector<std::thread> threads{};
+        threads.reserve(threadCount);
+        for (std::size_t threadIdx = 0u; threadIdx < threadCount; ++threadIdx) {
+            threads.emplace_back([&]() {
+                try {
+                    for (auto index = nextIndex++; index < count; index = nextIndex++) { func(index); }
+                } catch (...) {
+                    // Stop handing out the remaining items.
+                    nextIndex = count;
+                    std::lock_guard<std::mutex> lock{exceptionMutex};
+                    if (!firstException) { firstException = std::current_exception(); }
+                }
+            });
+        }
+        for (auto &thread : threads) { thread.join(); }
+        if (firstException) { std::rethrow_exception(firstException); }
+    }
+
     std::string replaceExtension(const std::string &path, const std::string &extension) {
         const auto oldExtension{fileExtension(path)};
         return path.substr(0, path.size() - oldExtension.size()) + extension;
@@ -118,9 +118,36 @@ void TreeModel::ApplyTropism(const glm::vec3& targetDir, float tropism, glm::qua
 	rotation = glm::quatLookAt(front, up);
 }
 
+thread_local std::mt19937* g_treeRandomGenerator = nullptr;
+
+TreeRandomScope::TreeRandomScope(std::mt19937* generator)
+{
+	m_previousGenerator = g_treeRandomGenerator;
+	if (generator) g_treeRandomGenerator = generator;
+}
+
+TreeRandomScope::~TreeRandomScope()
+{
+	g_treeRandomGenerator = m_previousGenerator;
+}
+
+float TreeRandomScope::LinearRand(const float min, const float max)
+{
+	if (!g_treeRandomGenerator) return glm::linearRand(min, max);
+	return std::uniform_real_distribution<float>(min, max)(*g_treeRandomGenerator);
+}
+
+float TreeRandomScope::GaussRand(const float mean, const float deviation)
+{
+	if (!g_treeRandomGenerator) return glm::gaussRand(mean, deviation);
+	if (deviation <= 0.0f) return mean;
+	return std::normal_distribution<float>(mean, deviation)(*g_treeRandomGenerator);
+}
+
 bool TreeModel::Grow(float deltaTime, const glm::mat4& globalTransform, ClimateModel& climateModel,
-	const ShootGrowthController& shootGrowthController, const bool pruning)
+	const ShootGrowthController& shootGrowthController, const bool pruning, std::mt19937* randomGenerator)
 {
+	const TreeRandomScope randomScope(randomGenerator);
 	m_currentDeltaTime = deltaTime;
 	m_age += m_currentDeltaTime;
 	bool treeStructureChanged = false;
@@ -181,8 +208,9 @@ bool TreeModel::Grow(float deltaTime, const glm::mat4& globalTransform, ClimateM
 
 bool TreeModel::Grow(const float deltaTime, const SkeletonNodeHandle baseInternodeHandle, const glm::mat4& globalTransform, ClimateModel& climateModel,
 	const ShootGrowthController& shootGrowthController,
-	const bool pruning)
+	const bool pruning, std::mt19937* randomGenerator)
 {
+	const TreeRandomScope randomScope(randomGenerator);
 	m_currentDeltaTime = deltaTime;
 	m_age += m_currentDeltaTime;
 	bool treeStructureChanged = false;
@@ -253,7 +281,7 @@ void TreeModel::Initialize(const ShootGrowthController& shootGrowthController) {
 			apicalBud.m_status = BudStatus::Dormant;
 			apicalBud.m_localRotation = glm::vec3(
 				glm::radians(shootGrowthController.m_baseNodeApicalAngle(node)), 0.0f,
-				glm::radians(glm::linearRand(0.f, 360.f)));
+				glm::radians(TreeRandomScope::LinearRand(0.f, 360.f)));
 		}
 	}
 
@@ -287,50 +315,47 @@ void TreeModel::CalculateShootFlux(const glm::mat4& globalTransform, const Clima
 				m_treeOccupancyGrid.Resize(minBound, maxBound);
 			}
 		}
-		auto& voxelGrid = m_treeOccupancyGrid.RefGrid();
-		for (const auto& internodeHandle : sortedInternodeList)
+		//Bud directions are computed once per internode instead of once per marker.
+		std::vector<glm::vec3> positions(sortedInternodeList.size());
+		std::vector<size_t> budOffsets(sortedInternodeList.size() + 1);
+		budOffsets[0] = 0;
+		for (int i = 0; i < sortedInternodeList.size(); i++)
 		{
-			auto& internode = m_shootSkeleton.RefNode(internodeHandle);
-			auto& internodeData = internode.m_data;
-			for (auto& bud : internodeData.m_buds)
+			budOffsets[i + 1] = budOffsets[i] + m_shootSkeleton.PeekNode(sortedInternodeList[i]).m_data.m_buds.size();
+		}
+		std::vector<glm::vec3> budDirections(budOffsets.back());
+		Jobs::RunParallelFor(sortedInternodeList.size(), [&](unsigned i)
 			{
-				bud.m_markerDirection = glm::vec3(0.0f);
-				bud.m_markerCount = 0;
+				auto& internode = m_shootSkeleton.RefNode(sortedInternodeList[i]);
+				auto& internodeData = internode.m_data;
+				for (int budIndex = 0; budIndex < internodeData.m_buds.size(); budIndex++)
+				{
+					auto& bud = internodeData.m_buds[budIndex];
+					bud.m_markerDirection = glm::vec3(0.0f);
+					bud.m_markerCount = 0;
+					budDirections[budOffsets[i] + budIndex] = glm::normalize(internode.m_info.m_globalRotation * bud.m_localRotation * glm::vec3(0, 0, -1));
+				}
+				internodeData.m_lightDirection = glm::vec3(0.0f);
+				positions[i] = internodeData.m_desiredGlobalPosition;
 			}
-			internodeData.m_lightDirection = glm::vec3(0.0f);
-			const auto dotMin = glm::cos(glm::radians(m_treeOccupancyGrid.GetTheta()));
-			voxelGrid.ForEach(internodeData.m_desiredGlobalPosition, m_treeGrowthSettings.m_spaceColonizationRemovalDistanceFactor * shootGrowthController.m_internodeLength,
-				[&](TreeOccupancyGridVoxelData& voxelData)
+		);
+		const auto dotMin = glm::cos(glm::radians(m_treeOccupancyGrid.GetTheta()));
+		m_treeOccupancyGrid.Colonize(positions, sortedInternodeList,
+			m_treeGrowthSettings.m_spaceColonizationRemovalDistanceFactor * shootGrowthController.m_internodeLength,
+			m_treeGrowthSettings.m_spaceColonizationDetectionDistanceFactor * shootGrowthController.m_internodeLength,
+			[&](const unsigned nodeIndex, const glm::vec3& direction)
+			{
+				auto& buds = m_shootSkeleton.RefNode(sortedInternodeList[nodeIndex]).m_data.m_buds;
+				for (int budIndex = 0; budIndex < buds.size(); budIndex++)
 				{
-					for (auto& marker : voxelData.m_markers)
+					if (glm::dot(direction, budDirections[budOffsets[nodeIndex] + budIndex]) > dotMin)
 					{
-						const auto diff = marker.m_position - internodeData.m_desiredGlobalPosition;
-						const auto distance = glm::length(diff);
-						const auto direction = glm::normalize(diff);
-						if (distance < m_treeGrowthSettings.m_spaceColonizationDetectionDistanceFactor * shootGrowthController.m_internodeLength)
-						{
-							if (marker.m_nodeHandle != -1) continue;
-							if (distance < m_treeGrowthSettings.m_spaceColonizationRemovalDistanceFactor * shootGrowthController.m_internodeLength)
-							{
-								marker.m_nodeHandle = internodeHandle;
-							}
-							else
-							{
-								for (auto& bud : internodeData.m_buds) {
-									auto budDirection = glm::normalize(internode.m_info.m_globalRotation * bud.m_localRotation * glm::vec3(0, 0, -1));
-									if (glm::dot(direction, budDirection) > dotMin)
-									{
-										bud.m_markerDirection += direction;
-										bud.m_markerCount++;
-									}
-								}
-							}
-						}
-
+						buds[budIndex].m_markerDirection += direction;
+						buds[budIndex].m_markerCount++;
 					}
 				}
-			);
-		}
+			}
+		);
 	}
 	for (const auto& internodeHandle : sortedInternodeList) {
 		auto& internode = m_shootSkeleton.RefNode(internodeHandle);
@@ -570,6 +595,7 @@ void TreeModel::CalculateTransform(const ShootGrowthController& shootGrowthContr
 		m_shootSkeleton.m_data.m_desiredMin = glm::min(m_shootSkeleton.m_data.m_desiredMin, desiredEndPosition);
 		m_shootSkeleton.m_data.m_desiredMax = glm::max(m_shootSkeleton.m_data.m_desiredMax, desiredEndPosition);
 	}
+	m_shootSkeleton.MarkInfoChanged();
 }
 
 bool TreeModel::ElongateInternode(float extendLength, SkeletonNodeHandle internodeHandle,
@@ -607,7 +633,7 @@ bool TreeModel::ElongateInternode(float extendLength, SkeletonNodeHandle interno
 			newLateralBud.m_type = BudType::Lateral;
 			newLateralBud.m_status = BudStatus::Dormant;
 			newLateralBud.m_localRotation = glm::vec3(0.f, glm::radians(shootGrowthController.m_branchingAngle(internode)),
-				glm::linearRand(0.0f, 360.0f));
+				TreeRandomScope::LinearRand(0.0f, 360.0f));
 		}
 
 		//Allocate Fruit bud for current internode
@@ -620,7 +646,7 @@ bool TreeModel::ElongateInternode(float extendLength, SkeletonNodeHandle interno
 				newFruitBud.m_status = BudStatus::Dormant;
 				newFruitBud.m_localRotation = glm::vec3(
 					glm::radians(shootGrowthController.m_branchingAngle(internode)), 0.0f,
-					glm::radians(glm::linearRand(0.0f, 360.0f)));
+					glm::radians(TreeRandomScope::LinearRand(0.0f, 360.0f)));
 			}
 		}
 		//Allocate Leaf bud for current internode
@@ -634,7 +660,7 @@ bool TreeModel::ElongateInternode(float extendLength, SkeletonNodeHandle interno
 				newLeafBud.m_status = BudStatus::Dormant;
 				newLeafBud.m_localRotation = glm::vec3(
 					glm::radians(shootGrowthController.m_branchingAngle(internode)), 0.0f,
-					glm::radians(glm::linearRand(0.0f, 360.0f)));
+					glm::radians(TreeRandomScope::LinearRand(0.0f, 360.0f)));
 			}
 		}
 
@@ -658,7 +684,7 @@ bool TreeModel::ElongateInternode(float extendLength, SkeletonNodeHandle interno
 		newInternode.m_data.m_desiredLocalRotation =
 			glm::inverse(oldInternode.m_info.m_globalRotation) *
 			newInternode.m_info.m_globalRotation;
-		if (shootGrowthController.m_apicalBudExtinctionRate(oldInternode) < glm::linearRand(0.0f, 1.0f)) {
+		if (shootGrowthController.m_apicalBudExtinctionRate(oldInternode) < TreeRandomScope::LinearRand(0.0f, 1.0f)) {
 			//Allocate apical bud for new internode
 			newInternode.m_data.m_buds.emplace_back();
 			auto& newApicalBud = newInternode.m_data.m_buds.back();
@@ -737,7 +763,7 @@ bool TreeModel::GrowInternode(ClimateModel& climateModel, const SkeletonNodeHand
 			{
 				flushProbability *= internodeData.m_growthRate * m_currentDeltaTime * shootGrowthController.m_internodeGrowthRate;
 			}
-			if (flushProbability >= glm::linearRand(0.0f, 1.0f)) {
+			if (flushProbability >= TreeRandomScope::LinearRand(0.0f, 1.0f)) {
 				graphChanged = true;
 				//Prepare information for new internode
 				const auto desiredGlobalRotation = internodeInfo.m_globalRotation * bud.m_localRotation;
@@ -806,7 +832,7 @@ bool TreeModel::GrowReproductiveModules(ClimateModel& climateModel, const Skelet
 			}
 			else if (bud.m_status == BudStatus::Dormant) {
 				const float flushProbability = m_currentDeltaTime * shootGrowthController.m_fruitBudFlushingProbability(internode);
-				if (flushProbability >= glm::linearRand(0.0f, 1.0f))
+				if (flushProbability >= TreeRandomScope::LinearRand(0.0f, 1.0f))
 				{
 					bud.m_status = BudStatus::Flushed;
 				}
@@ -819,7 +845,7 @@ bool TreeModel::GrowReproductiveModules(ClimateModel& climateModel, const Skelet
 				bud.m_reproductiveModule.m_maturity += maturityIncrease;
 				const auto developmentVigor = bud.m_vigorSink.SubtractVigor(maturityIncrease * shootGrowthController.m_fruitVigorRequirement);
 				auto fruitSize = shootGrowthController.m_maxFruitSize * glm::sqrt(bud.m_reproductiveModule.m_maturity);
-				float angle = glm::radians(glm::linearRand(0.0f, 360.0f));
+				float angle = glm::radians(TreeRandomScope::LinearRand(0.0f, 360.0f));
 				glm::quat rotation = internodeData.m_desiredLocalRotation * bud.m_localRotation;
 				auto up = rotation * glm::vec3(0, 1, 0);
 				auto front = rotation * glm::vec3(0, 0, -1);
@@ -835,7 +861,7 @@ bool TreeModel::GrowReproductiveModules(ClimateModel& climateModel, const Skelet
 				if (bud.m_reproductiveModule.m_maturity >= 0.95f || bud.m_reproductiveModule.m_health <= 0.05f)
 				{
 					auto dropProbability = m_currentDeltaTime * shootGrowthController.m_fruitFallProbability(internode);
-					if (dropProbability >= glm::linearRand(0.0f, 1.0f))
+					if (dropProbability >= TreeRandomScope::LinearRand(0.0f, 1.0f))
 					{
 						bud.m_status = BudStatus::Died;
 						m_shootSkeleton.m_data.m_droppedFruits.emplace_back(bud.m_reproductiveModule);
@@ -849,7 +875,7 @@ bool TreeModel::GrowReproductiveModules(ClimateModel& climateModel, const Skelet
 		{
 			if (bud.m_status == BudStatus::Dormant) {
 				const float flushProbability = m_currentDeltaTime * 1.;
-				if (flushProbability >= glm::linearRand(0.0f, 1.0f))
+				if (flushProbability >= TreeRandomScope::LinearRand(0.0f, 1.0f))
 				{
 					bud.m_status = BudStatus::Died;
 				}
@@ -878,7 +904,7 @@ bool TreeModel::GrowReproductiveModules(ClimateModel& climateModel, const Skelet
 				if (bud.m_reproductiveModule.m_health <= 0.05f)
 				{
 					const auto dropProbability = m_currentDeltaTime * shootGrowthController.m_leafFallProbability(internode);
-					if (dropProbability >= glm::linearRand(0.0f, 1.0f))
+					if (dropProbability >= TreeRandomScope::LinearRand(0.0f, 1.0f))
 					{
 						bud.m_status = BudStatus::Died;
 						m_shootSkeleton.m_data.m_droppedLeaves.emplace_back(bud.m_reproductiveModule);
@@ -1177,7 +1203,7 @@ bool TreeModel::PruneInternodes(const glm::mat4& globalTransform, ClimateModel&
 			}
 		}
 		const float pruningProbability = shootGrowthController.m_rootToEndPruningFactor(globalTransform, climateModel, m_shootSkeleton, internode) * m_currentDeltaTime;
-		if (!pruning && pruningProbability > glm::linearRand(0.0f, 1.0f)) pruning = true;
+		if (!pruning && pruningProbability > TreeRandomScope::LinearRand(0.0f, 1.0f)) pruning = true;
 
 		if (pruning)
 		{
@@ -1215,7 +1241,7 @@ bool TreeModel::PruneInternodes(const glm::mat4& globalTransform, ClimateModel&
 		}
 
 		const float pruningProbability = shootGrowthController.m_endToRootPruningFactor(globalTransform, climateModel, m_shootSkeleton, internode) * m_currentDeltaTime;
-		if (!pruning && pruningProbability > glm::linearRand(0.0f, 1.0f)) pruning = true;
+		if (!pruning && pruningProbability > TreeRandomScope::LinearRand(0.0f, 1.0f)) pruning = true;
 		if (pruning)
 		{
 			PruneInternode(internodeHandle);
@@ -1276,5 +1302,6 @@ int TreeModel::CurrentIteration() const {
 void TreeModel::Reverse(int iteration) {
 	assert(iteration >= 0 && iteration < m_history.size());
 	m_shootSkeleton = m_history[iteration];
+	m_shootSkeleton.MarkInfoChanged();
 	m_history.erase((m_history.begin() + iteration), m_history.end());
 }
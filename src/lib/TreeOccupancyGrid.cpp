@@ -6,16 +6,73 @@ using namespace EcoSysLab;
 
 void TreeOccupancyGrid::ResetMarkers()
 {
-	Jobs::RunParallelFor(m_occupancyGrid.GetVoxelCount(), [&](unsigned i)
+	Jobs::RunParallelFor(m_markers.size(), [&](unsigned i)
 		{
-			auto& voxelData = m_occupancyGrid.Ref(static_cast<int>(i));
+			m_markers[i].m_nodeHandle = -1;
+		}
+	);
+}
 
-			for(auto& marker : voxelData.m_markers)
+void TreeOccupancyGrid::RebuildMarkers(const std::function<bool(unsigned voxelIndex)>& filter)
+{
+	const auto voxelCount = m_occupancyGrid.GetVoxelCount();
+	std::vector<unsigned> newMarkerSizes(voxelCount);
+	Jobs::RunParallelFor(voxelCount, [&](unsigned i)
+		{
+			newMarkerSizes[i] = filter(i) ? static_cast<unsigned>(m_markersPerVoxel) : 0;
+		}
+	);
+	std::vector<unsigned> offsets(voxelCount);
+	unsigned markerSize = 0;
+	for (int i = 0; i < voxelCount; i++)
+	{
+		offsets[i] = markerSize;
+		markerSize += m_occupancyGrid.Peek(i).m_markerSize + newMarkerSizes[i];
+	}
+	std::vector<TreeOccupancyGridMarker> markers(markerSize);
+	const auto voxelSize = m_occupancyGrid.GetVoxelSize();
+	Jobs::RunParallelFor(voxelCount, [&](unsigned i)
+		{
+			auto& voxelData = m_occupancyGrid.Ref(static_cast<int>(i));
+			auto offset = offsets[i];
+			for (auto markerIndex = voxelData.m_markerOffset; markerIndex < voxelData.m_markerOffset + voxelData.m_markerSize; markerIndex++)
 			{
-				marker.m_nodeHandle = -1;
+				markers[offset] = m_markers[markerIndex];
+				offset++;
+			}
+			if (newMarkerSizes[i] != 0)
+			{
+				//Seeded by the cell in world space, so markers don't depend on the thread or on the grid bounds.
+				const auto center = m_occupancyGrid.GetPosition(i);
+				//Hashed in unsigned arithmetic, which wraps where signed multiplication would overflow.
+				const auto cell = glm::uvec3(glm::ivec3(glm::floor(center / voxelSize)));
+				std::mt19937 randomEngine(cell.x * 73856093u ^ cell.y * 19349663u ^ cell.z * 83492791u);
+				std::uniform_real_distribution<float> distribution(-voxelSize * 0.5f, voxelSize * 0.5f);
+				for (unsigned v = 0; v < newMarkerSizes[i]; v++)
+				{
+					auto& newMarker = markers[offset];
+					newMarker.m_position = center;
+					newMarker.m_position.x += distribution(randomEngine);
+					newMarker.m_position.y += distribution(randomEngine);
+					newMarker.m_position.z += distribution(randomEngine);
+					newMarker.m_nodeHandle = -1;
+					offset++;
+				}
 			}
+			voxelData.m_markerOffset = offsets[i];
+			voxelData.m_markerSize = offset - offsets[i];
 		}
 	);
+	m_markers.swap(markers);
+}
+
+void TreeOccupancyGrid::GetVoxelRange(const glm::vec3& position, const float radius, glm::ivec3& start, glm::ivec3& end) const
+{
+	const auto actualCenter = position - m_occupancyGrid.GetMinBound();
+	const auto voxelSize = m_occupancyGrid.GetVoxelSize();
+	const auto resolution = m_occupancyGrid.GetResolution();
+	start = glm::max(glm::ivec3(glm::floor((actualCenter - glm::vec3(radius)) / voxelSize)), glm::ivec3(0));
+	end = glm::min(glm::ivec3(glm::ceil((actualCenter + glm::vec3(radius)) / voxelSize)), resolution - glm::ivec3(1));
 }
 
 float TreeOccupancyGrid::GetRemovalDistanceFactor() const
@@ -52,17 +109,8 @@ void TreeOccupancyGrid::Initialize(const glm::vec3& min, const glm::vec3& max, c
 	m_internodeLength = internodeLength;
 	m_markersPerVoxel = markersPerVoxel;
 	m_occupancyGrid.Initialize(m_removalDistanceFactor * internodeLength, min, max, {});
-	const auto voxelSize = m_occupancyGrid.GetVoxelSize();
-	Jobs::RunParallelFor(m_occupancyGrid.GetVoxelCount(), [&](unsigned i)
-		{
-			auto& voxelData = m_occupancyGrid.Ref(static_cast<int>(i));
-			for (int v = 0; v < m_markersPerVoxel; v++)
-			{
-				auto& newMarker = voxelData.m_markers.emplace_back();
-				newMarker.m_position = m_occupancyGrid.GetPosition(i) + glm::linearRand(-glm::vec3(voxelSize * 0.5f), glm::vec3(voxelSize * 0.5f));
-			}
-		}
-	);
+	m_markers.clear();
+	RebuildMarkers([&](unsigned i) { return true; });
 }
 
 void TreeOccupancyGrid::Resize(const glm::vec3& min, const glm::vec3& max)
@@ -72,20 +120,12 @@ void TreeOccupancyGrid::Resize(const glm::vec3& min, const glm::vec3& max)
 	const auto diffMax = glm::ceil((max - m_occupancyGrid.GetMaxBound() + m_detectionDistanceFactor * m_internodeLength) / voxelSize);
 	m_occupancyGrid.Resize(-diffMin, diffMax);
 	const auto newResolution = m_occupancyGrid.GetResolution();
-	Jobs::RunParallelFor(m_occupancyGrid.GetVoxelCount(), [&](unsigned i)
+	//Voxels kept from the old grid keep their markers, only the new ones are seeded.
+	RebuildMarkers([&](unsigned i)
 		{
 			const auto coordinate = m_occupancyGrid.GetCoordinate(i);
-			
-			if (coordinate.x < -diffMin.x || coordinate.y < -diffMin.y || coordinate.z < -diffMin.z
-				|| coordinate.x >= newResolution.x - diffMax.x || coordinate.y >= newResolution.y - diffMax.y || coordinate.z >= newResolution.z - diffMax.z)
-			{
-				auto& voxelData = m_occupancyGrid.Ref(static_cast<int>(i));
-				for (int v = 0; v < m_markersPerVoxel; v++)
-				{
-					auto& newMarker = voxelData.m_markers.emplace_back();
-					newMarker.m_position = m_occupancyGrid.GetPosition(i) + glm::linearRand(-glm::vec3(voxelSize * 0.5f), glm::vec3(voxelSize * 0.5f));
-				}
-			}
+			return coordinate.x < -diffMin.x || coordinate.y < -diffMin.y || coordinate.z < -diffMin.z
+				|| coordinate.x >= newResolution.x - diffMax.x || coordinate.y >= newResolution.y - diffMax.y || coordinate.z >= newResolution.z - diffMax.z;
 		}
 	);
 }
@@ -99,26 +139,16 @@ void TreeOccupancyGrid::Initialize(const VoxelGrid<TreeOccupancyGridBasicData>&
 	m_internodeLength = internodeLength;
 	m_markersPerVoxel = markersPerVoxel;
 	m_occupancyGrid.Initialize(m_removalDistanceFactor * internodeLength, min, max, {});
-	const auto voxelSize = m_occupancyGrid.GetVoxelSize();
-
-	Jobs::RunParallelFor(m_occupancyGrid.GetVoxelCount(), [&](unsigned i)
+	m_markers.clear();
+	RebuildMarkers([&](unsigned i)
 		{
 			const glm::vec3 normalizedPosition = glm::vec3(m_occupancyGrid.GetCoordinate(i)) / glm::vec3(m_occupancyGrid.GetResolution()) - glm::vec3(0.5f, 0.0f, 0.5f);
 			const auto srcGridSize = srcGrid.GetMaxBound() - srcGrid.GetMinBound();
 			const auto srcGridPosition = normalizedPosition * srcGridSize;
 
-			if((srcGrid.IsValid(srcGridPosition) && srcGrid.Peek(srcGrid.GetIndex(srcGridPosition)).m_occupied) || (normalizedPosition.y < 0.8f && glm::length(glm::vec2(normalizedPosition.x, normalizedPosition.z)) < 0.02f))
-			{
-				auto& voxelData = m_occupancyGrid.Ref(static_cast<int>(i));
-				for (int v = 0; v < m_markersPerVoxel; v++)
-				{
-					auto& newMarker = voxelData.m_markers.emplace_back();
-					newMarker.m_position = m_occupancyGrid.GetPosition(i) + glm::linearRand(-glm::vec3(voxelSize * 0.5f), glm::vec3(voxelSize * 0.5f));
-				}
-			}
+			return (srcGrid.IsValid(srcGridPosition) && srcGrid.Peek(srcGrid.GetIndex(srcGridPosition)).m_occupied) || (normalizedPosition.y < 0.8f && glm::length(glm::vec2(normalizedPosition.x, normalizedPosition.z)) < 0.02f);
 		}
 	);
-
 }
 
 void TreeOccupancyGrid::Initialize(const std::shared_ptr<RadialBoundingVolume>& srcRadialBoundingVolume,
@@ -131,19 +161,32 @@ void TreeOccupancyGrid::Initialize(const std::shared_ptr<RadialBoundingVolume>&
 	m_internodeLength = internodeLength;
 	m_markersPerVoxel = markersPerVoxel;
 	m_occupancyGrid.Initialize(m_removalDistanceFactor * internodeLength, min, max, {});
-	const auto voxelSize = m_occupancyGrid.GetVoxelSize();
+	m_markers.clear();
+	RebuildMarkers([&](unsigned i)
+		{
+			return srcRadialBoundingVolume->InVolume(m_occupancyGrid.GetPosition(i));
+		}
+	);
+}
 
-	Jobs::RunParallelFor(m_occupancyGrid.GetVoxelCount(), [&](unsigned i)
+void TreeOccupancyGrid::Initialize(const glm::vec3* points, const size_t pointCount, const glm::vec3& min, const glm::vec3& max,
+	const float internodeLength, const float removalDistanceFactor, const float theta, const float detectionDistanceFactor, const size_t markersPerVoxel)
+{
+	m_removalDistanceFactor = removalDistanceFactor;
+	m_detectionDistanceFactor = detectionDistanceFactor;
+	m_theta = theta;
+	m_internodeLength = internodeLength;
+	m_markersPerVoxel = markersPerVoxel;
+	m_occupancyGrid.Initialize(m_removalDistanceFactor * internodeLength, min, max, {});
+	m_markers.clear();
+	std::vector<unsigned char> occupied(m_occupancyGrid.GetVoxelCount(), 0);
+	for (size_t i = 0; i < pointCount; i++)
+	{
+		if (m_occupancyGrid.IsValid(points[i])) occupied[m_occupancyGrid.GetIndex(points[i])] = 1;
+	}
+	RebuildMarkers([&](unsigned i)
 		{
-			if (srcRadialBoundingVolume->InVolume(m_occupancyGrid.GetPosition(i)))
-			{
-				auto& voxelData = m_occupancyGrid.Ref(static_cast<int>(i));
-				for (int v = 0; v < m_markersPerVoxel; v++)
-				{
-					auto& newMarker = voxelData.m_markers.emplace_back();
-					newMarker.m_position = m_occupancyGrid.GetPosition(i) + glm::linearRand(-glm::vec3(voxelSize * 0.5f), glm::vec3(voxelSize * 0.5f));
-				}
-			}
+			return occupied[i] != 0;
 		}
 	);
 }
@@ -153,6 +196,11 @@ VoxelGrid<TreeOccupancyGridVoxelData>& TreeOccupancyGrid::RefGrid()
 	return m_occupancyGrid;
 }
 
+const std::vector<TreeOccupancyGridMarker>& TreeOccupancyGrid::PeekMarkers() const
+{
+	return m_markers;
+}
+
 glm::vec3 TreeOccupancyGrid::GetMin() const
 {
 	return m_occupancyGrid.GetMinBound();
@@ -170,8 +218,9 @@ void TreeOccupancyGrid::InsertObstacle(const GlobalTransform &globalTransform, c
 			const auto center = m_occupancyGrid.GetPosition(i);
 			if(cubeVolume->InVolume(globalTransform, center))
 			{
-				m_occupancyGrid.Ref(i).m_markers.clear();
+				m_occupancyGrid.Ref(i).m_markerSize = 0;
 			}
 		}
 	);
+	RebuildMarkers([&](unsigned i) { return false; });
 }
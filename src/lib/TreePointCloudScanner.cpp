@@ -276,10 +276,22 @@ bool TreePointCloudGridCaptureSettings::SampleFilter(const PointCloudSample& sam
 }
 #pragma endregion
 
-void TreePointCloudScanner::Capture(const TreeMeshGeneratorSettings& meshGeneratorSettings, const std::filesystem::path& savePath, const std::shared_ptr<PointCloudCaptureSettings>& captureSettings) const
+void TreePointCloud::Clear()
 {
-#ifdef BUILD_WITH_RAYTRACER
+	m_points.clear();
+	m_typeIndex.clear();
+	m_instanceIndex.clear();
+	m_branchIndex.clear();
+	m_internodeIndex.clear();
+	m_lineIndex.clear();
+	m_treePartIndex.clear();
+	m_treePartTypeIndex.clear();
+}
 
+bool TreePointCloudScanner::Capture(const std::shared_ptr<PointCloudCaptureSettings>& captureSettings, TreePointCloud& pointCloud) const
+{
+	pointCloud.Clear();
+#ifdef BUILD_WITH_RAYTRACER
 	const auto ecoSysLabLayer = Application::GetLayer<EcoSysLabLayer>();
 	std::shared_ptr<Soil> soil;
 	const auto soilCandidate = EcoSysLabLayer::FindSoil();
@@ -287,7 +299,7 @@ void TreePointCloudScanner::Capture(const TreeMeshGeneratorSettings& meshGenerat
 	if (!soil)
 	{
 		EVOENGINE_ERROR("No soil!");
-		return;
+		return false;
 	}
 	std::unordered_map<Handle, Handle> branchMeshRendererHandles, foliageMeshRendererHandles;
 	Bound plantBound{};
@@ -297,7 +309,7 @@ void TreePointCloudScanner::Capture(const TreeMeshGeneratorSettings& meshGenerat
 	if (treeEntities == nullptr)
 	{
 		EVOENGINE_ERROR("No trees!");
-		return;
+		return false;
 	}
 	for (const auto& treeEntity : *treeEntities) {
 		if (scene->IsEntityValid(treeEntity)) {
@@ -357,17 +369,15 @@ void TreePointCloudScanner::Capture(const TreeMeshGeneratorSettings& meshGenerat
 		Application::GetLayer<RayTracerLayer>()->m_environmentProperties,
 		pcSamples);
 
-	std::vector<glm::vec3> points;
-
-	std::vector<int> internodeIndex;
-	std::vector<int> branchIndex;
-	std::vector<int> treePartIndex;
-	std::vector<int> treePartTypeIndex;
-	std::vector<int> lineIndex;
-	std::vector<int> instanceIndex;
-	std::vector<int> typeIndex;
-
-
+	auto& points = pointCloud.m_points;
+	auto& internodeIndex = pointCloud.m_internodeIndex;
+	auto& branchIndex = pointCloud.m_branchIndex;
+	auto& treePartIndex = pointCloud.m_treePartIndex;
+	auto& treePartTypeIndex = pointCloud.m_treePartTypeIndex;
+	auto& lineIndex = pointCloud.m_lineIndex;
+	auto& instanceIndex = pointCloud.m_instanceIndex;
+	auto& typeIndex = pointCloud.m_typeIndex;
+	points.reserve(pcSamples.size());
 
 	for (const auto& sample : pcSamples) {
 		if (!sample.m_hit) continue;
@@ -447,6 +457,26 @@ void TreePointCloudScanner::Capture(const TreeMeshGeneratorSettings& meshGenerat
 			}
 		}
 	}
+	return true;
+#else
+	return false;
+#endif
+}
+
+void TreePointCloudScanner::Capture(const TreeMeshGeneratorSettings& meshGeneratorSettings, const std::filesystem::path& savePath, const std::shared_ptr<PointCloudCaptureSettings>& captureSettings) const
+{
+#ifdef BUILD_WITH_RAYTRACER
+	TreePointCloud pointCloud{};
+	if (!Capture(captureSettings, pointCloud)) return;
+	auto& points = pointCloud.m_points;
+	auto& internodeIndex = pointCloud.m_internodeIndex;
+	auto& branchIndex = pointCloud.m_branchIndex;
+	auto& treePartIndex = pointCloud.m_treePartIndex;
+	auto& treePartTypeIndex = pointCloud.m_treePartTypeIndex;
+	auto& lineIndex = pointCloud.m_lineIndex;
+	auto& instanceIndex = pointCloud.m_instanceIndex;
+	auto& typeIndex = pointCloud.m_typeIndex;
+
 	std::filebuf fb_binary;
 	fb_binary.open(savePath.string(), std::ios::out | std::ios::binary);
 	std::ostream outstream_binary(&fb_binary);
@@ -509,6 +539,9 @@ void TreePointCloudScanner::Capture(const TreeMeshGeneratorSettings& meshGenerat
 
 	if (m_pointSettings.m_treePartIndex) {
 		try {
+			const auto scene = GetScene();
+			const std::vector<Entity>* treeEntities =
+				scene->UnsafeGetPrivateComponentOwnersList<Tree>();
 			std::filesystem::path ymlPath = savePath;
 			ymlPath.replace_extension(".yml");
 			YAML::Emitter out;
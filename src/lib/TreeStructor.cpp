@@ -3,6 +3,7 @@
 #include "Graphics.hpp"
 #include "EcoSysLabLayer.hpp"
 #include "FoliageDescriptor.hpp"
+#include "MeshExporter.hpp"
 #include "rapidcsv.h"
 using namespace EcoSysLab;
 
@@ -28,39 +29,49 @@ void TreeStructor::BuildVoxelGrid()
 	for (auto& point : m_allocatedPoints) {
 		point.m_branchHandle = point.m_nodeHandle = point.m_skeletonIndex = -1;
 	}
-	for (auto& point : m_scatteredPoints) {
-		point.m_neighborScatterPoints.clear();
-		point.m_p3.clear();
-		point.m_p0.clear();
-		PointData voxel;
-		voxel.m_handle = point.m_handle;
-		voxel.m_position = point.m_position;
-		m_scatterPointsVoxelGrid.Ref(point.m_position).emplace_back(voxel);
-	}
-	for (auto& point : m_allocatedPoints) {
-		PointData voxel;
-		voxel.m_handle = point.m_handle;
-		voxel.m_position = point.m_position;
-		m_allocatedPointsVoxelGrid.Ref(point.m_position).emplace_back(voxel);
-	}
-	for (auto& predictedBranch : m_predictedBranches) {
-		predictedBranch.m_pointsToP3.clear();
-		predictedBranch.m_p3ToP0.clear();
-
-		predictedBranch.m_pointsToP0.clear();
-		predictedBranch.m_p3ToP3.clear();
-		predictedBranch.m_p0ToP0.clear();
-		predictedBranch.m_p0ToP3.clear();
-
-		BranchEndData voxel;
-		voxel.m_branchHandle = predictedBranch.m_handle;
-		voxel.m_position = predictedBranch.m_bezierCurve.m_p0;
-		voxel.m_isP0 = true;
-		m_branchEndsVoxelGrid.Ref(predictedBranch.m_bezierCurve.m_p0).emplace_back(voxel);
-		voxel.m_position = predictedBranch.m_bezierCurve.m_p3;
-		voxel.m_isP0 = false;
-		m_branchEndsVoxelGrid.Ref(predictedBranch.m_bezierCurve.m_p3).emplace_back(voxel);
-	}
+	std::vector<PointData> scatterPoints(m_scatteredPoints.size());
+	Jobs::RunParallelFor(m_scatteredPoints.size(), [&](unsigned i)
+		{
+			auto& point = m_scatteredPoints[i];
+			point.m_neighborScatterPoints.clear();
+			point.m_p3.clear();
+			point.m_p0.clear();
+			scatterPoints[i].m_handle = point.m_handle;
+			scatterPoints[i].m_position = point.m_position;
+		}
+	);
+	m_scatterPointsVoxelGrid.Build(scatterPoints);
+	std::vector<PointData> allocatedPoints(m_allocatedPoints.size());
+	Jobs::RunParallelFor(m_allocatedPoints.size(), [&](unsigned i)
+		{
+			allocatedPoints[i].m_handle = m_allocatedPoints[i].m_handle;
+			allocatedPoints[i].m_position = m_allocatedPoints[i].m_position;
+		}
+	);
+	m_allocatedPointsVoxelGrid.Build(allocatedPoints);
+	std::vector<BranchEndData> branchEnds(m_predictedBranches.size() * 2);
+	Jobs::RunParallelFor(m_predictedBranches.size(), [&](unsigned i)
+		{
+			auto& predictedBranch = m_predictedBranches[i];
+			predictedBranch.m_pointsToP3.clear();
+			predictedBranch.m_p3ToP0.clear();
+
+			predictedBranch.m_pointsToP0.clear();
+			predictedBranch.m_p3ToP3.clear();
+			predictedBranch.m_p0ToP0.clear();
+			predictedBranch.m_p0ToP3.clear();
+
+			auto& p0 = branchEnds[i * 2];
+			p0.m_branchHandle = predictedBranch.m_handle;
+			p0.m_position = predictedBranch.m_bezierCurve.m_p0;
+			p0.m_isP0 = true;
+			auto& p3 = branchEnds[i * 2 + 1];
+			p3.m_branchHandle = predictedBranch.m_handle;
+			p3.m_position = predictedBranch.m_bezierCurve.m_p3;
+			p3.m_isP0 = false;
+		}
+	);
+	m_branchEndsVoxelGrid.Build(branchEnds);
 }
 
 bool TreeStructor::DirectConnectionCheck(const BezierCurve& parentCurve, const BezierCurve& childCurve, bool reverse)
@@ -104,42 +115,10 @@ bool TreeStructor::DirectConnectionCheck(const BezierCurve& parentCurve, const B
 
 }
 
-void TreeStructor::FindPoints(const glm::vec3& position, VoxelGrid<std::vector<PointData>>& pointVoxelGrid,
-	float radius,
-	const std::function<void(const PointData& voxel)>& func)
-{
-	pointVoxelGrid.ForEach(position, radius, [&](const std::vector<PointData>& voxels) {
-		for (const auto& voxel : voxels) {
-			if (glm::distance(position, voxel.m_position) > radius) continue;
-			func(voxel);
-		}
-		});
-}
-
-bool TreeStructor::HasPoints(const glm::vec3& position, VoxelGrid<std::vector<PointData>>& pointVoxelGrid,
-	float radius)
-{
-	bool retVal = false;
-	pointVoxelGrid.ForEach(position, radius, [&](const std::vector<PointData>& voxels) {
-		if (retVal) return;
-		for (const auto& voxel : voxels) {
-			if (glm::distance(position, voxel.m_position) <= radius) retVal = true;
-		}
-		});
-	return retVal;
-}
-
-void
-TreeStructor::ForEachBranchEnd(const glm::vec3& position, VoxelGrid<std::vector<BranchEndData>>& branchEndsVoxelGrid,
-	float radius,
-	const std::function<void(const BranchEndData& voxel)>& func)
+bool TreeStructor::HasPoints(const glm::vec3& position, const PackedVoxelGrid<PointData>& pointVoxelGrid,
+	const float radius)
 {
-	branchEndsVoxelGrid.ForEach(position, radius, [&](const std::vector<BranchEndData>& branchEnds) {
-		for (const auto& branchEnd : branchEnds) {
-			if (glm::distance(position, branchEnd.m_position) > radius) continue;
-			func(branchEnd);
-		}
-		});
+	return pointVoxelGrid.Any(position, radius);
 }
 
 void TreeStructor::CalculateNodeTransforms(ReconstructionSkeleton& skeleton)
@@ -517,123 +496,29 @@ void TreeStructor::ImportGraph(const std::filesystem::path& path, float scaleFac
 
 void TreeStructor::ExportForestOBJ(const TreeMeshGeneratorSettings& meshGeneratorSettings, const std::filesystem::path& path)
 {
-	if (path.extension() == ".obj") {
-		std::ofstream of;
-		of.open(path.string(), std::ofstream::out | std::ofstream::trunc);
-		if (of.is_open()) {
-			std::string start = "#Forest OBJ exporter, by Bosheng Li";
-			start += "\n";
-			of.write(start.c_str(), start.size());
-			of.flush();
-			unsigned startIndex = 1;
-			const auto branchMeshes = GenerateForestBranchMeshes(meshGeneratorSettings);
-			if (!branchMeshes.empty()) {
-				unsigned treeIndex = 0;
-				for (auto& mesh : branchMeshes) {
-					auto& vertices = mesh->UnsafeGetVertices();
-					auto& triangles = mesh->UnsafeGetTriangles();
-					if (!vertices.empty() && !triangles.empty()) {
-						std::string header =
-							"#Vertices: " + std::to_string(vertices.size()) +
-							", tris: " + std::to_string(triangles.size());
-						header += "\n";
-						of.write(header.c_str(), header.size());
-						of.flush();
-						std::stringstream data;
-						data << "o tree " + std::to_string(treeIndex) + "\n";
-#pragma region Data collection
-						for (auto i = 0; i < vertices.size(); i++) {
-							auto& vertexPosition = vertices.at(i).m_position;
-							auto& color = vertices.at(i).m_color;
-							data << "v " + std::to_string(vertexPosition.x) + " " +
-								std::to_string(vertexPosition.y) + " " +
-								std::to_string(vertexPosition.z) + " " +
-								std::to_string(color.x) + " " + std::to_string(color.y) + " " +
-								std::to_string(color.z) + "\n";
-						}
-						for (const auto& vertex : vertices) {
-							data << "vt " + std::to_string(vertex.m_texCoord.x) + " " +
-								std::to_string(vertex.m_texCoord.y) + "\n";
-						}
-						// data += "s off\n";
-						data << "# List of indices for faces vertices, with (x, y, z).\n";
-						for (auto i = 0; i < triangles.size(); i++) {
-							const auto triangle = triangles[i];
-							const auto f1 = triangle.x + startIndex;
-							const auto f2 = triangle.y + startIndex;
-							const auto f3 = triangle.z + startIndex;
-							data << "f " + std::to_string(f1) + "/" + std::to_string(f1) + "/" +
-								std::to_string(f1) + " " + std::to_string(f2) + "/" +
-								std::to_string(f2) + "/" + std::to_string(f2) + " " +
-								std::to_string(f3) + "/" + std::to_string(f3) + "/" +
-								std::to_string(f3) + "\n";
-						}
-#pragma endregion
-						const auto result = data.str();
-						of.write(result.c_str(), result.size());
-						of.flush();
-						startIndex += vertices.size();
-						treeIndex++;
-					}
-				}
-			}
-			if (meshGeneratorSettings.m_enableFoliage) {
-				const auto foliageMeshes = GenerateFoliageMeshes();
-				if (!foliageMeshes.empty()) {
-
-					unsigned treeIndex = 0;
-					for (auto& mesh : foliageMeshes) {
-						auto& vertices = mesh->UnsafeGetVertices();
-						auto& triangles = mesh->UnsafeGetTriangles();
-						if (!vertices.empty() && !triangles.empty()) {
-							std::string header =
-								"#Vertices: " + std::to_string(vertices.size()) +
-								", tris: " + std::to_string(triangles.size());
-							header += "\n";
-							of.write(header.c_str(), header.size());
-							of.flush();
-							std::stringstream data;
-							data << "o tree " + std::to_string(treeIndex) + "\n";
-#pragma region Data collection
-							for (auto i = 0; i < vertices.size(); i++) {
-								auto& vertexPosition = vertices.at(i).m_position;
-								auto& color = vertices.at(i).m_color;
-								data << "v " + std::to_string(vertexPosition.x) + " " +
-									std::to_string(vertexPosition.y) + " " +
-									std::to_string(vertexPosition.z) + " " +
-									std::to_string(color.x) + " " + std::to_string(color.y) + " " +
-									std::to_string(color.z) + "\n";
-							}
-							for (const auto& vertex : vertices) {
-								data << "vt " + std::to_string(vertex.m_texCoord.x) + " " +
-									std::to_string(vertex.m_texCoord.y) + "\n";
-							}
-							// data += "s off\n";
-							data << "# List of indices for faces vertices, with (x, y, z).\n";
-							for (auto i = 0; i < triangles.size(); i++) {
-								const auto triangle = triangles[i];
-								const auto f1 = triangle.x + startIndex;
-								const auto f2 = triangle.y + startIndex;
-								const auto f3 = triangle.z + startIndex;
-								data << "f " + std::to_string(f1) + "/" + std::to_string(f1) + "/" +
-									std::to_string(f1) + " " + std::to_string(f2) + "/" +
-									std::to_string(f2) + "/" + std::to_string(f2) + " " +
-									std::to_string(f3) + "/" + std::to_string(f3) + "/" +
-									std::to_string(f3) + "\n";
-							}
-#pragma endregion
-							const auto result = data.str();
-							of.write(result.c_str(), result.size());
-							of.flush();
-							startIndex += vertices.size();
-							treeIndex++;
-						}
-					}
-				}
+	if (!MeshExporter::IsSupported(path)) return;
+	std::vector<MeshExportChunk> chunks;
+	const auto addChunks = [&](const std::vector<std::shared_ptr<Mesh>>& meshes)
+		{
+			unsigned treeIndex = 0;
+			for (const auto& mesh : meshes) {
+				MeshExportChunk chunk;
+				chunk.m_vertices = &mesh->UnsafeGetVertices();
+				chunk.m_triangles = &mesh->UnsafeGetTriangles();
+				if (chunk.IsEmpty()) continue;
+				chunk.m_name = "tree " + std::to_string(treeIndex);
+				chunks.emplace_back(std::move(chunk));
+				treeIndex++;
 			}
-			of.close();
-		}
-	}
+		};
+	const auto branchMeshes = GenerateForestBranchMeshes(meshGeneratorSettings);
+	addChunks(branchMeshes);
+	std::vector<std::shared_ptr<Mesh>> foliageMeshes;
+	if (meshGeneratorSettings.m_enableFoliage) {
+		foliageMeshes = GenerateFoliageMeshes();
+		addChunks(foliageMeshes);
+	}
+	MeshExporter::Export(path, chunks);
 }
 
 bool TreeStructor::OnInspect(const std::shared_ptr<EditorLayer>& editorLayer) {
@@ -749,7 +634,7 @@ bool TreeStructor::OnInspect(const std::shared_ptr<EditorLayer>& editorLayer) {
 		}
 		ImGui::Separator();
 		const auto ecoSysLabLayer = Application::GetLayer<EcoSysLabLayer>();
-		FileUtils::SaveFile("Export all forest as OBJ", "OBJ", { ".obj" }, [&](const std::filesystem::path& path) {
+		FileUtils::SaveFile("Export all forest as OBJ", "OBJ", { ".obj", ".ply", ".glb" }, [&](const std::filesystem::path& path) {
 			ExportForestOBJ(ecoSysLabLayer->m_meshGeneratorSettings, path);
 			}, false);
 
@@ -1997,21 +1882,18 @@ void TreeStructor::SpaceColonization()
 	const float detectionDistance = m_reconstructionSettings.m_spaceColonizationDetectionDistanceFactor * m_reconstructionSettings.m_internodeLength;
 
 	m_spaceColonizationVoxelGrid.Initialize(removalDistance, m_min, m_max);
-	for (auto& point : m_scatteredPoints) {
-		PointData voxel;
-		voxel.m_handle = -1;
-		voxel.m_position = point.m_position;
-		m_spaceColonizationVoxelGrid.Ref(voxel.m_position).emplace_back(voxel);
-	}
-	for (auto& point : m_allocatedPoints) {
-		PointData voxel;
-		voxel.m_handle = -1;
-		voxel.m_position = point.m_position;
-		m_spaceColonizationVoxelGrid.Ref(voxel.m_position).emplace_back(voxel);
-	}
+	std::vector<PointData> markers(m_scatteredPoints.size() + m_allocatedPoints.size());
+	Jobs::RunParallelFor(markers.size(), [&](unsigned i)
+		{
+			markers[i].m_handle = -1;
+			markers[i].m_position = i < m_scatteredPoints.size() ? m_scatteredPoints[i].m_position : m_allocatedPoints[i - m_scatteredPoints.size()].m_position;
+		}
+	);
+	m_spaceColonizationVoxelGrid.Build(markers);
 
-	VoxelGrid<std::vector<PointData>> internodeEndGrid{};
+	PackedVoxelGrid<PointData> internodeEndGrid{};
 	internodeEndGrid.Initialize(detectionDistance, m_min, m_max);
+	std::vector<PointData> internodeEnds;
 	for (int skeletonIndex = 0; skeletonIndex < m_skeletons.size(); skeletonIndex++)
 	{
 		auto& skeleton = m_skeletons[skeletonIndex];
@@ -2025,9 +1907,10 @@ void TreeStructor::SpaceColonization()
 			voxel.m_index = skeletonIndex;
 			voxel.m_position = internode.m_data.m_globalEndPosition;
 			voxel.m_direction = internode.m_info.GetGlobalDirection();
-			internodeEndGrid.Ref(voxel.m_position).emplace_back(voxel);
+			internodeEnds.emplace_back(voxel);
 		}
 	}
+	internodeEndGrid.Build(internodeEnds);
 
 	const auto dotMin = glm::cos(glm::radians(m_reconstructionSettings.m_spaceColonizationTheta));
 	bool newBranchGrown = true;
@@ -2046,62 +1929,44 @@ void TreeStructor::SpaceColonization()
 				internode.m_data.m_markerSize = 0;
 				internode.m_data.m_regrowDirection = glm::vec3(0.0f);
 				const auto internodeEndPosition = internode.m_data.m_globalEndPosition;
-				m_spaceColonizationVoxelGrid.ForEach(internodeEndPosition, removalDistance,
-					[&](std::vector<PointData>& voxels)
+				m_spaceColonizationVoxelGrid.RemoveIf(internodeEndPosition, removalDistance,
+					[&](const PointData& marker)
 					{
-						for (int i = 0; i < voxels.size(); i++)
-						{
-							auto& marker = voxels[i];
-							const auto diff = marker.m_position - internodeEndPosition;
-							const auto distance = glm::length(diff);
-							if (distance < removalDistance)
-							{
-								voxels[i] = voxels.back();
-								voxels.pop_back();
-								i--;
-							}
-						}
+						return glm::distance(marker.m_position, internodeEndPosition) < removalDistance;
 					}
 				);
 			}
 		}
 
-		//2. Allocate markers to node with perception volume.
-		for (auto& voxel : m_spaceColonizationVoxelGrid.RefData())
-		{
-			for (auto& point : voxel)
+		//2. Allocate markers to node with perception volume. Each marker only writes to itself, so markers are processed in parallel.
+		m_spaceColonizationVoxelGrid.ParallelForEachElement([&](PointData& point)
 			{
 				point.m_minDistance = FLT_MAX;
 				point.m_handle = -1;
 				point.m_index = -1;
 				point.m_direction = glm::vec3(0.0f);
 				internodeEndGrid.ForEach(point.m_position, detectionDistance,
-					[&](const std::vector<PointData>& voxels)
+					[&](const PointData& internodeEnd)
 					{
-						for (const auto& internodeEnd : voxels)
+						const auto diff = point.m_position - internodeEnd.m_position;
+						const auto distance = glm::length(diff);
+						const auto direction = glm::normalize(diff);
+						if (distance < detectionDistance
+							&& glm::dot(direction, internodeEnd.m_direction) > dotMin
+							&& distance < point.m_minDistance)
 						{
-							const auto diff = point.m_position - internodeEnd.m_position;
-							const auto distance = glm::length(diff);
-							const auto direction = glm::normalize(diff);
-							if (distance < detectionDistance
-								&& glm::dot(direction, internodeEnd.m_direction) > dotMin
-								&& distance < point.m_minDistance)
-							{
-								point.m_minDistance = distance;
-								point.m_handle = internodeEnd.m_handle;
-								point.m_index = internodeEnd.m_index;
-								point.m_direction = diff;
-							}
+							point.m_minDistance = distance;
+							point.m_handle = internodeEnd.m_handle;
+							point.m_index = internodeEnd.m_index;
+							point.m_direction = diff;
 						}
 					}
 				);
 			}
-		}
+		);
 
 		//3. Calculate new direction for each internode.
-		for (auto& voxel : m_spaceColonizationVoxelGrid.RefData())
-		{
-			for (auto& point : voxel)
+		m_spaceColonizationVoxelGrid.ForEachElement([&](const PointData& point)
 			{
 				if (point.m_handle != -1)
 				{
@@ -2110,7 +1975,7 @@ void TreeStructor::SpaceColonization()
 					internode.m_data.m_regrowDirection += point.m_direction;
 				}
 			}
-		}
+		);
 
 		//4. Grow and add new internodes to the internodeEndGrid.
 		for (int skeletonIndex = 0; skeletonIndex < m_skeletons.size(); skeletonIndex++)
@@ -2137,9 +2002,10 @@ void TreeStructor::SpaceColonization()
 				voxel.m_index = skeletonIndex;
 				voxel.m_position = newInternode.m_data.m_globalEndPosition;
 				voxel.m_direction = newInternode.m_info.GetGlobalDirection();
-				internodeEndGrid.Ref(voxel.m_position).emplace_back(voxel);
+				internodeEnds.emplace_back(voxel);
 			}
 		}
+		if (newBranchGrown) internodeEndGrid.Build(internodeEnds);
 		for (auto& skeleton : m_skeletons) {
 			skeleton.SortLists();
 			skeleton.CalculateDistance();
@@ -0,0 +1,295 @@
+#include "TriangleBVH.hpp"
+
+#include "Jobs.hpp"
+
+using namespace EcoSysLab;
+
+constexpr int BVH_BIN_COUNT = 12;
+constexpr int BVH_MAX_DEPTH = 60;
+constexpr int BVH_STACK_SIZE = 64;
+
+void TriangleBVH::Clear()
+{
+	m_nodes.clear();
+	m_triangleIndices.clear();
+	m_v0.clear();
+	m_edge1.clear();
+	m_edge2.clear();
+}
+
+size_t TriangleBVH::GetTriangleSize() const
+{
+	return m_v0.size();
+}
+
+size_t TriangleBVH::GetNodeSize() const
+{
+	return m_nodes.size();
+}
+
+void TriangleBVH::UpdateBounds(Node& node) const
+{
+	node.m_min = glm::vec3(FLT_MAX);
+	node.m_max = glm::vec3(-FLT_MAX);
+	for (unsigned i = node.m_leftOrFirst; i < node.m_leftOrFirst + node.m_count; i++)
+	{
+		const auto triangleIndex = m_triangleIndices[i];
+		const auto& v0 = m_v0[triangleIndex];
+		const auto v1 = v0 + m_edge1[triangleIndex];
+		const auto v2 = v0 + m_edge2[triangleIndex];
+		node.m_min = glm::min(node.m_min, glm::min(v0, glm::min(v1, v2)));
+		node.m_max = glm::max(node.m_max, glm::max(v0, glm::max(v1, v2)));
+	}
+}
+
+static float BoundsArea(const glm::vec3& min, const glm::vec3& max)
+{
+	const auto extent = max - min;
+	return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+}
+
+void TriangleBVH::Subdivide(const unsigned rootIndex, const std::vector<glm::vec3>& centroids)
+{
+	std::vector<std::pair<unsigned, int>> nodeStack;
+	nodeStack.emplace_back(rootIndex, 0);
+	while (!nodeStack.empty())
+	{
+		const auto [nodeIndex, depth] = nodeStack.back();
+		nodeStack.pop_back();
+		const unsigned first = m_nodes[nodeIndex].m_leftOrFirst;
+		const unsigned count = m_nodes[nodeIndex].m_count;
+		if (count <= m_maxLeafSize || depth >= BVH_MAX_DEPTH) continue;
+
+		glm::vec3 centroidMin = glm::vec3(FLT_MAX);
+		glm::vec3 centroidMax = glm::vec3(-FLT_MAX);
+		for (unsigned i = first; i < first + count; i++)
+		{
+			centroidMin = glm::min(centroidMin, centroids[m_triangleIndices[i]]);
+			centroidMax = glm::max(centroidMax, centroids[m_triangleIndices[i]]);
+		}
+		//Binned SAH, the split is placed between two bins of the centroid range on one axis.
+		int bestAxis = -1;
+		int bestSplit = 0;
+		float bestCost = static_cast<float>(count) * BoundsArea(m_nodes[nodeIndex].m_min, m_nodes[nodeIndex].m_max);
+		for (int axis = 0; axis < 3; axis++)
+		{
+			const float extent = centroidMax[axis] - centroidMin[axis];
+			if (extent <= 0.0f) continue;
+			const float scale = BVH_BIN_COUNT / extent;
+			unsigned binCounts[BVH_BIN_COUNT] = {};
+			glm::vec3 binMin[BVH_BIN_COUNT];
+			glm::vec3 binMax[BVH_BIN_COUNT];
+			for (int bin = 0; bin < BVH_BIN_COUNT; bin++)
+			{
+				binMin[bin] = glm::vec3(FLT_MAX);
+				binMax[bin] = glm::vec3(-FLT_MAX);
+			}
+			for (unsigned i = first; i < first + count; i++)
+			{
+				const auto triangleIndex = m_triangleIndices[i];
+				const int bin = glm::min(BVH_BIN_COUNT - 1, static_cast<int>((centroids[triangleIndex][axis] - centroidMin[axis]) * scale));
+				const auto& v0 = m_v0[triangleIndex];
+				const auto v1 = v0 + m_edge1[triangleIndex];
+				const auto v2 = v0 + m_edge2[triangleIndex];
+				binCounts[bin]++;
+				binMin[bin] = glm::min(binMin[bin], glm::min(v0, glm::min(v1, v2)));
+				binMax[bin] = glm::max(binMax[bin], glm::max(v0, glm::max(v1, v2)));
+			}
+			float leftArea[BVH_BIN_COUNT - 1];
+			unsigned leftCount[BVH_BIN_COUNT - 1];
+			glm::vec3 sweepMin = glm::vec3(FLT_MAX);
+			glm::vec3 sweepMax = glm::vec3(-FLT_MAX);
+			unsigned sweepCount = 0;
+			for (int bin = 0; bin < BVH_BIN_COUNT - 1; bin++)
+			{
+				sweepCount += binCounts[bin];
+				if (binCounts[bin] != 0)
+				{
+					sweepMin = glm::min(sweepMin, binMin[bin]);
+					sweepMax = glm::max(sweepMax, binMax[bin]);
+				}
+				leftCount[bin] = sweepCount;
+				leftArea[bin] = sweepCount == 0 ? 0.0f : BoundsArea(sweepMin, sweepMax);
+			}
+			sweepMin = glm::vec3(FLT_MAX);
+			sweepMax = glm::vec3(-FLT_MAX);
+			sweepCount = 0;
+			for (int bin = BVH_BIN_COUNT - 1; bin > 0; bin--)
+			{
+				sweepCount += binCounts[bin];
+				if (binCounts[bin] != 0)
+				{
+					sweepMin = glm::min(sweepMin, binMin[bin]);
+					sweepMax = glm::max(sweepMax, binMax[bin]);
+				}
+				if (sweepCount == 0 || leftCount[bin - 1] == 0) continue;
+				const float cost = static_cast<float>(leftCount[bin - 1]) * leftArea[bin - 1] + static_cast<float>(sweepCount) * BoundsArea(sweepMin, sweepMax);
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					bestAxis = axis;
+					bestSplit = bin;
+				}
+			}
+		}
+		if (bestAxis == -1) continue;
+
+		const float scale = BVH_BIN_COUNT / (centroidMax[bestAxis] - centroidMin[bestAxis]);
+		unsigned i = first;
+		unsigned j = first + count;
+		while (i < j)
+		{
+			const int bin = glm::min(BVH_BIN_COUNT - 1, static_cast<int>((centroids[m_triangleIndices[i]][bestAxis] - centroidMin[bestAxis]) * scale));
+			if (bin < bestSplit) i++;
+			else std::swap(m_triangleIndices[i], m_triangleIndices[--j]);
+		}
+		const unsigned leftCount = i - first;
+		if (leftCount == 0 || leftCount == count) continue;
+
+		const auto leftChildIndex = static_cast<unsigned>(m_nodes.size());
+		m_nodes.emplace_back();
+		m_nodes.emplace_back();
+		auto& leftChild = m_nodes[leftChildIndex];
+		leftChild.m_leftOrFirst = first;
+		leftChild.m_count = leftCount;
+		UpdateBounds(leftChild);
+		auto& rightChild = m_nodes[leftChildIndex + 1];
+		rightChild.m_leftOrFirst = i;
+		rightChild.m_count = count - leftCount;
+		UpdateBounds(rightChild);
+		m_nodes[nodeIndex].m_leftOrFirst = leftChildIndex;
+		m_nodes[nodeIndex].m_count = 0;
+		nodeStack.emplace_back(leftChildIndex, depth + 1);
+		nodeStack.emplace_back(leftChildIndex + 1, depth + 1);
+	}
+}
+
+void TriangleBVH::Build(const std::vector<glm::vec3>& positions, const std::vector<glm::uvec3>& triangles)
+{
+	Clear();
+	if (triangles.empty()) return;
+	const auto triangleSize = triangles.size();
+	m_v0.resize(triangleSize);
+	m_edge1.resize(triangleSize);
+	m_edge2.resize(triangleSize);
+	m_triangleIndices.resize(triangleSize);
+	std::vector<glm::vec3> centroids(triangleSize);
+	Jobs::RunParallelFor(triangleSize, [&](unsigned i)
+		{
+			const auto& triangle = triangles[i];
+			const auto& v0 = positions[triangle.x];
+			const auto& v1 = positions[triangle.y];
+			const auto& v2 = positions[triangle.z];
+			m_v0[i] = v0;
+			m_edge1[i] = v1 - v0;
+			m_edge2[i] = v2 - v0;
+			centroids[i] = (v0 + v1 + v2) / 3.0f;
+			m_triangleIndices[i] = i;
+		}
+	);
+	m_nodes.reserve(2 * triangleSize);
+	m_nodes.emplace_back();
+	m_nodes[0].m_leftOrFirst = 0;
+	m_nodes[0].m_count = static_cast<unsigned>(triangleSize);
+	UpdateBounds(m_nodes[0]);
+	Subdivide(0, centroids);
+}
+
+bool TriangleBVH::IntersectTriangle(const unsigned triangleIndex, const glm::vec3& origin, const glm::vec3& direction, float& distance) const
+{
+	//Moller-Trumbore, both faces of the triangle count as hits.
+	const auto& edge1 = m_edge1[triangleIndex];
+	const auto& edge2 = m_edge2[triangleIndex];
+	const auto p = glm::cross(direction, edge2);
+	const float determinant = glm::dot(edge1, p);
+	if (glm::abs(determinant) < 1e-12f) return false;
+	const float inverseDeterminant = 1.0f / determinant;
+	const auto s = origin - m_v0[triangleIndex];
+	const float u = glm::dot(s, p) * inverseDeterminant;
+	if (u < 0.0f || u > 1.0f) return false;
+	const auto q = glm::cross(s, edge1);
+	const float v = glm::dot(direction, q) * inverseDeterminant;
+	if (v < 0.0f || u + v > 1.0f) return false;
+	distance = glm::dot(edge2, q) * inverseDeterminant;
+	return distance > 0.0f;
+}
+
+float TriangleBVH::IntersectBounds(const Node& node, const glm::vec3& origin, const glm::vec3& inverseDirection, const float maxDistance)
+{
+	const auto t1 = (node.m_min - origin) * inverseDirection;
+	const auto t2 = (node.m_max - origin) * inverseDirection;
+	const auto tNear = glm::min(t1, t2);
+	const auto tFar = glm::max(t1, t2);
+	const float enter = glm::max(glm::max(tNear.x, tNear.y), tNear.z);
+	const float exit = glm::min(glm::min(tFar.x, tFar.y), tFar.z);
+	if (exit >= enter && exit > 0.0f && enter < maxDistance) return enter;
+	return FLT_MAX;
+}
+
+bool TriangleBVH::Intersect(const glm::vec3& origin, const glm::vec3& direction, float& distance, unsigned& triangleIndex) const
+{
+	if (m_nodes.empty()) return false;
+	const auto inverseDirection = 1.0f / direction;
+	bool hit = false;
+	unsigned stack[BVH_STACK_SIZE];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0)
+	{
+		const auto& node = m_nodes[stack[--stackSize]];
+		if (IntersectBounds(node, origin, inverseDirection, distance) == FLT_MAX) continue;
+		if (node.m_count != 0)
+		{
+			for (unsigned i = node.m_leftOrFirst; i < node.m_leftOrFirst + node.m_count; i++)
+			{
+				float triangleDistance;
+				if (IntersectTriangle(m_triangleIndices[i], origin, direction, triangleDistance) && triangleDistance < distance)
+				{
+					distance = triangleDistance;
+					triangleIndex = m_triangleIndices[i];
+					hit = true;
+				}
+			}
+			continue;
+		}
+		//Visit the closer child first so the far one is likely culled by the shortened distance.
+		unsigned nearIndex = node.m_leftOrFirst;
+		unsigned farIndex = node.m_leftOrFirst + 1;
+		float nearDistance = IntersectBounds(m_nodes[nearIndex], origin, inverseDirection, distance);
+		float farDistance = IntersectBounds(m_nodes[farIndex], origin, inverseDirection, distance);
+		if (nearDistance > farDistance)
+		{
+			std::swap(nearIndex, farIndex);
+			std::swap(nearDistance, farDistance);
+		}
+		if (farDistance != FLT_MAX) stack[stackSize++] = farIndex;
+		if (nearDistance != FLT_MAX) stack[stackSize++] = nearIndex;
+	}
+	return hit;
+}
+
+bool TriangleBVH::Occluded(const glm::vec3& origin, const glm::vec3& direction, const float maxDistance) const
+{
+	if (m_nodes.empty()) return false;
+	const auto inverseDirection = 1.0f / direction;
+	unsigned stack[BVH_STACK_SIZE];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0)
+	{
+		const auto& node = m_nodes[stack[--stackSize]];
+		if (IntersectBounds(node, origin, inverseDirection, maxDistance) == FLT_MAX) continue;
+		if (node.m_count != 0)
+		{
+			for (unsigned i = node.m_leftOrFirst; i < node.m_leftOrFirst + node.m_count; i++)
+			{
+				float triangleDistance;
+				if (IntersectTriangle(m_triangleIndices[i], origin, direction, triangleDistance) && triangleDistance < maxDistance) return true;
+			}
+			continue;
+		}
+		stack[stackSize++] = node.m_leftOrFirst + 1;
+		stack[stackSize++] = node.m_leftOrFirst;
+	}
+	return false;
+}
@@ -1179,57 +1179,21 @@ void VoxelSoilModel::GetSoilTextureSlideZ(bool backFacing, float z, const glm::v
 	float waterFactor, float nutrientFactor,
 	float blur_width)
 {
-	const float rangeX = glm::clamp(xyMax.x, 0.0f, 0.99f) - glm::clamp(xyMin.x, 0.0f, 0.99f);
-	const float rangeY = glm::clamp(xyMax.y, 0.0f, 0.99f) - glm::clamp(xyMin.y, 0.0f, 0.99f);
-	outputResolution.x = rangeX * m_materialTextureResolution.x;
-	outputResolution.y = rangeY * m_materialTextureResolution.y;
-
-	const float slize_z_position = GetPositionFromCoordinate(ivec3(0, 0, glm::clamp(z, 0.0f, 0.99f) * m_resolution.z)).z;
-	const float tex_dx = m_dx * static_cast<float>(m_resolution.x) / static_cast<float>(m_materialTextureResolution.x);
-	const float tex_dy = m_dx * static_cast<float>(m_resolution.y) / static_cast<float>(m_materialTextureResolution.y);
-
-	const int texCoordXStart = glm::clamp(xyMin.x, 0.0f, 0.99f) * static_cast<float>(m_materialTextureResolution.x);
-	const int texCoordYStart = glm::clamp(xyMin.y, 0.0f, 0.99f) * static_cast<float>(m_materialTextureResolution.y);
-
-	albedoData.resize(outputResolution.x * outputResolution.y);
-	normalData.resize(outputResolution.x * outputResolution.y);
-	roughnessData.resize(outputResolution.x * outputResolution.y);
-	metallicData.resize(outputResolution.x * outputResolution.y);
-
-	for (auto texCoordX = 0; texCoordX < outputResolution.x; ++texCoordX)
-	{
-		for (auto texCoordY = 0; texCoordY < outputResolution.y; ++texCoordY)
-		{
-			auto outputTex_idx = (backFacing ? outputResolution.x - texCoordX - 1 : texCoordX) + texCoordY * outputResolution.x;
-			auto texture_idx = texCoordXStart + texCoordX + (texCoordYStart + texCoordY) * m_materialTextureResolution.x;
-			int gridCoordX = texCoordXStart + texCoordX;
-			int gridCoordY = texCoordYStart + texCoordY;
-			glm::vec3 texel_position = GetPositionFromCoordinate(ivec3(gridCoordX, gridCoordY, 0), tex_dx, tex_dy, m_dx);
-			texel_position.z = slize_z_position;
-			if (!PositionInsideVolume(texel_position))
-			{
-				albedoData[outputTex_idx] = glm::vec4(0.f);
-				normalData[outputTex_idx] = glm::vec3(0, 0, 1);
-				roughnessData[outputTex_idx] = 0.8f;
-				metallicData[outputTex_idx] = 0.2f;
-			}else{
-				GetSoilTextureColorForPosition(texel_position, texture_idx, blur_width,
-					albedoData[outputTex_idx],
-					normalData[outputTex_idx],
-					roughnessData[outputTex_idx],
-					metallicData[outputTex_idx], waterFactor, nutrientFactor
-				);
-				albedoData[outputTex_idx] = glm::vec4(1.0f);
-				if(texel_position.y > m_soilSurface.m_height({ texel_position.x, texel_position.z }) + 0.01f)
-				{
-					albedoData[outputTex_idx].w = 0.0f;
-				}
-			}
-		}
-	}
+	std::vector<SoilTextureSlice> slices(1);
+	auto& slice = slices.front();
+	slice.m_alongX = false;
+	slice.m_backFacing = backFacing;
+	slice.m_depth = z;
+	slice.m_min = xyMin;
+	slice.m_max = xyMax;
+	GetSoilTextureSlides(slices, waterFactor, nutrientFactor, blur_width);
+	albedoData = std::move(slice.m_albedoData);
+	normalData = std::move(slice.m_normalData);
+	roughnessData = std::move(slice.m_roughnessData);
+	metallicData = std::move(slice.m_metallicData);
+	outputResolution = slice.m_outputResolution;
 }
 
-
 void VoxelSoilModel::GetSoilTextureSlideX(bool backFacing, float x, const glm::vec2& yzMin, const glm::vec2& yzMax, std::vector<glm::vec4> &albedoData,
 	std::vector<glm::vec3> &normalData,
 	std::vector<float> &roughnessData,
@@ -1238,54 +1202,128 @@ void VoxelSoilModel::GetSoilTextureSlideX(bool backFacing, float x, const glm::v
 	float waterFactor, float nutrientFactor,
 	float blur_width)
 {
-	const float rangeZ = glm::clamp(yzMax.x, 0.0f, 0.99f) - glm::clamp(yzMin.x, 0.0f, 0.99f);
-	const float rangeY = glm::clamp(yzMax.y, 0.0f, 0.99f) - glm::clamp(yzMin.y, 0.0f, 0.99f);
-	outputResolution.x = rangeZ * m_materialTextureResolution.x;
-	outputResolution.y = rangeY * m_materialTextureResolution.y;
-	const float slize_x_position = GetPositionFromCoordinate(ivec3(glm::clamp(x, 0.0f, 0.99f) * m_resolution.x, 0, 0)).x;
-	const float tex_dz = m_dx * static_cast<float>(m_resolution.z) / static_cast<float>(m_materialTextureResolution.x);
-	const float tex_dy = m_dx * static_cast<float>(m_resolution.y) / static_cast<float>(m_materialTextureResolution.y);
-
-	const int texCoordXStart = glm::clamp(yzMin.x, 0.0f, 0.99f) * static_cast<float>(m_materialTextureResolution.x);
-	const int texCoordYStart = glm::clamp(yzMin.y, 0.0f, 0.99f) * static_cast<float>(m_materialTextureResolution.y);
-
-	albedoData.resize(outputResolution.x * outputResolution.y);
-	normalData.resize(outputResolution.x * outputResolution.y);
-	roughnessData.resize(outputResolution.x * outputResolution.y);
-	metallicData.resize(outputResolution.x * outputResolution.y);
+	std::vector<SoilTextureSlice> slices(1);
+	auto& slice = slices.front();
+	slice.m_alongX = true;
+	slice.m_backFacing = backFacing;
+	slice.m_depth = x;
+	slice.m_min = yzMin;
+	slice.m_max = yzMax;
+	GetSoilTextureSlides(slices, waterFactor, nutrientFactor, blur_width);
+	albedoData = std::move(slice.m_albedoData);
+	normalData = std::move(slice.m_normalData);
+	roughnessData = std::move(slice.m_roughnessData);
+	metallicData = std::move(slice.m_metallicData);
+	outputResolution = slice.m_outputResolution;
+}
 
-	for (auto texCoordX = 0; texCoordX < outputResolution.x; ++texCoordX)
+void VoxelSoilModel::GetSoilTextureSlides(std::vector<SoilTextureSlice>& slices, float waterFactor, float nutrientFactor, float blur_width) const
+{
+	// everything that only depends on the texture column is computed once per column:
+	// the texel position along the column axis and the surface height above it.
+	struct SliceSetup
 	{
-		for (auto texCoordY = 0; texCoordY < outputResolution.y; ++texCoordY)
+		float m_slicePosition = 0.f;
+		int m_texCoordXStart = 0;
+		int m_texCoordYStart = 0;
+		std::vector<float> m_columnPositions;
+		std::vector<float> m_columnSurfaceHeights;
+		std::vector<float> m_rowPositions;
+	};
+	std::vector<SliceSetup> setups(slices.size());
+	std::vector<int> rowOffsets(slices.size() + 1, 0);
+	for (auto sliceIndex = 0; sliceIndex < slices.size(); ++sliceIndex)
+	{
+		auto& slice = slices[sliceIndex];
+		auto& setup = setups[sliceIndex];
+		const float rangeColumn = glm::clamp(slice.m_max.x, 0.0f, 0.99f) - glm::clamp(slice.m_min.x, 0.0f, 0.99f);
+		const float rangeY = glm::clamp(slice.m_max.y, 0.0f, 0.99f) - glm::clamp(slice.m_min.y, 0.0f, 0.99f);
+		slice.m_outputResolution.x = rangeColumn * m_materialTextureResolution.x;
+		slice.m_outputResolution.y = rangeY * m_materialTextureResolution.y;
+		const auto& outputResolution = slice.m_outputResolution;
+
+		const int columnResolution = slice.m_alongX ? m_resolution.z : m_resolution.x;
+		const float tex_dcolumn = m_dx * static_cast<float>(columnResolution) / static_cast<float>(m_materialTextureResolution.x);
+		const float tex_dy = m_dx * static_cast<float>(m_resolution.y) / static_cast<float>(m_materialTextureResolution.y);
+		setup.m_slicePosition = slice.m_alongX
+			? GetPositionFromCoordinate(ivec3(glm::clamp(slice.m_depth, 0.0f, 0.99f) * m_resolution.x, 0, 0)).x
+			: GetPositionFromCoordinate(ivec3(0, 0, glm::clamp(slice.m_depth, 0.0f, 0.99f) * m_resolution.z)).z;
+		setup.m_texCoordXStart = glm::clamp(slice.m_min.x, 0.0f, 0.99f) * static_cast<float>(m_materialTextureResolution.x);
+		setup.m_texCoordYStart = glm::clamp(slice.m_min.y, 0.0f, 0.99f) * static_cast<float>(m_materialTextureResolution.y);
+
+		setup.m_columnPositions.resize(glm::max(0, outputResolution.x));
+		setup.m_columnSurfaceHeights.resize(glm::max(0, outputResolution.x));
+		for (auto texCoordX = 0; texCoordX < outputResolution.x; ++texCoordX)
 		{
-			auto outputTex_idx = (backFacing ? outputResolution.x - texCoordX - 1 : texCoordX) + texCoordY * outputResolution.x;
-			auto texture_idx = texCoordXStart + texCoordX + (texCoordYStart + texCoordY) * m_materialTextureResolution.x;
-			int gridCoordZ = texCoordXStart + texCoordX;
-			int gridCoordY = texCoordYStart + texCoordY;
-			glm::vec3 texel_position = GetPositionFromCoordinate(ivec3(0, gridCoordY, gridCoordZ), m_dx, tex_dy, tex_dz);
-			texel_position.x = slize_x_position;
-			if (!PositionInsideVolume(texel_position)) {
-				albedoData[outputTex_idx] = glm::vec4(0.f);
-				normalData[outputTex_idx] = glm::vec3(0, 0, 1);
-				roughnessData[outputTex_idx] = 0.8f;
-				metallicData[outputTex_idx] = 0.2f;
+			const int gridCoord = setup.m_texCoordXStart + texCoordX;
+			if (slice.m_alongX)
+			{
+				setup.m_columnPositions[texCoordX] = GetPositionFromCoordinate(ivec3(0, 0, gridCoord), m_dx, tex_dy, tex_dcolumn).z;
+				setup.m_columnSurfaceHeights[texCoordX] = m_soilSurface.m_height({ setup.m_slicePosition, setup.m_columnPositions[texCoordX] });
 			}
 			else
 			{
-				GetSoilTextureColorForPosition(texel_position, texture_idx, blur_width,
-					albedoData[outputTex_idx],
-					normalData[outputTex_idx],
-					roughnessData[outputTex_idx],
-					metallicData[outputTex_idx], waterFactor, nutrientFactor
-					);
-				albedoData[outputTex_idx] = glm::vec4(1.0f);
-				if (texel_position.y > m_soilSurface.m_height({ texel_position.x, texel_position.z }) + 0.01f)
+				setup.m_columnPositions[texCoordX] = GetPositionFromCoordinate(ivec3(gridCoord, 0, 0), tex_dcolumn, tex_dy, m_dx).x;
+				setup.m_columnSurfaceHeights[texCoordX] = m_soilSurface.m_height({ setup.m_columnPositions[texCoordX], setup.m_slicePosition });
+			}
+		}
+		setup.m_rowPositions.resize(glm::max(0, outputResolution.y));
+		for (auto texCoordY = 0; texCoordY < outputResolution.y; ++texCoordY)
+		{
+			setup.m_rowPositions[texCoordY] = GetPositionFromCoordinate(ivec3(0, setup.m_texCoordYStart + texCoordY, 0), m_dx, tex_dy, m_dx).y;
+		}
+
+		const auto texelCount = glm::max(0, outputResolution.x * outputResolution.y);
+		slice.m_albedoData.resize(texelCount);
+		slice.m_normalData.resize(texelCount);
+		slice.m_roughnessData.resize(texelCount);
+		slice.m_metallicData.resize(texelCount);
+		rowOffsets[sliceIndex + 1] = rowOffsets[sliceIndex] + glm::max(0, outputResolution.y);
+	}
+
+	const float blur_kernel_width = m_dx * m_dx * blur_width * blur_width;
+	std::vector<std::vector<float>> materialWeights(Jobs::GetWorkerSize(), std::vector<float>(m_soilLayers.size(), 0.f));
+	std::vector<std::vector<int>> materialIds(Jobs::GetWorkerSize());
+	// the rows of all slices are processed in one parallel loop.
+	Jobs::RunParallelFor(rowOffsets.back(), [&](unsigned rowIndex, unsigned threadIndex)
+		{
+			const auto sliceIndex = std::upper_bound(rowOffsets.begin(), rowOffsets.end(), static_cast<int>(rowIndex)) - rowOffsets.begin() - 1;
+			auto& slice = slices[sliceIndex];
+			const auto& setup = setups[sliceIndex];
+			const auto& outputResolution = slice.m_outputResolution;
+			const int texCoordY = rowIndex - rowOffsets[sliceIndex];
+			for (auto texCoordX = 0; texCoordX < outputResolution.x; ++texCoordX)
+			{
+				auto outputTex_idx = (slice.m_backFacing ? outputResolution.x - texCoordX - 1 : texCoordX) + texCoordY * outputResolution.x;
+				auto texture_idx = setup.m_texCoordXStart + texCoordX + (setup.m_texCoordYStart + texCoordY) * m_materialTextureResolution.x;
+				const glm::vec3 texel_position = slice.m_alongX
+					? glm::vec3(setup.m_slicePosition, setup.m_rowPositions[texCoordY], setup.m_columnPositions[texCoordX])
+					: glm::vec3(setup.m_columnPositions[texCoordX], setup.m_rowPositions[texCoordY], setup.m_slicePosition);
+				if (!PositionInsideVolume(texel_position))
+				{
+					slice.m_albedoData[outputTex_idx] = glm::vec4(0.f);
+					slice.m_normalData[outputTex_idx] = glm::vec3(0, 0, 1);
+					slice.m_roughnessData[outputTex_idx] = 0.8f;
+					slice.m_metallicData[outputTex_idx] = 0.2f;
+				}
+				else
 				{
-					albedoData[outputTex_idx].w = 0.0f;
+					BlendSoilTexture(texel_position, texture_idx, blur_kernel_width,
+						slice.m_albedoData[outputTex_idx],
+						slice.m_normalData[outputTex_idx],
+						slice.m_roughnessData[outputTex_idx],
+						slice.m_metallicData[outputTex_idx], waterFactor, nutrientFactor,
+						materialWeights[threadIndex], materialIds[threadIndex]
+					);
+					slice.m_albedoData[outputTex_idx] = glm::vec4(1.0f);
+					if (texel_position.y > setup.m_columnSurfaceHeights[texCoordX] + 0.01f)
+					{
+						slice.m_albedoData[outputTex_idx].w = 0.0f;
+					}
 				}
 			}
 		}
-	}
+	);
 }
 
 
@@ -1294,11 +1332,25 @@ void EcoSysLab::VoxelSoilModel::GetSoilTextureColorForPosition(const glm::vec3&
 	float& roughness,
 	float& metallic, float waterFactor, float nutrientFactor)
 {
-	const float blur_kernel_width = m_dx*m_dx * blur_width * blur_width;
+	std::vector<float> materialWeights(m_soilLayers.size(), 0.f);
+	std::vector<int> materialIds;
+	BlendSoilTexture(position, texture_idx, m_dx * m_dx * blur_width * blur_width, albedo, normal, roughness, metallic, waterFactor, nutrientFactor, materialWeights, materialIds);
+}
+
+void EcoSysLab::VoxelSoilModel::BlendSoilTexture(const glm::vec3& position, int texture_idx, float blur_kernel_width, glm::vec4& albedo,
+	glm::vec3& normal,
+	float& roughness,
+	float& metallic, float waterFactor, float nutrientFactor, std::vector<float>& materialWeights, std::vector<int>& materialIds) const
+{
 	auto soil_voxel_base = GetCoordinateFromPosition(position);
-	std::map<int, float> contributing_materials; // we need to store the total some for each material:
+	// total weight for each contributing material, materialIds keeps track of the entries in use.
+	materialIds.clear();
+	const auto resetWeights = [&]()
+		{
+			for (const auto materialId : materialIds) materialWeights[materialId] = 0.f;
+		};
 
-												 // do some gaussian blending
+	// do some gaussian blending
 	float waterLevel = 0.0f;
 	float nutrientLevel = 0.0f;
 	for(auto i=0; i<m_blur_3x3_idx.size(); ++i) // iterate over blur kernel
@@ -1309,6 +1361,7 @@ void EcoSysLab::VoxelSoilModel::GetSoilTextureColorForPosition(const glm::vec3&
 			// fetch material
 			auto material_id = m_material_id[Index(soil_voxel)];
 			if (material_id < 0 || material_id >= m_soilLayers.size()) {
+				resetWeights();
 				albedo = glm::vec4(0.f);
 				normal = glm::vec3(0, 0, 1);
 				roughness = 0.8f;
@@ -1319,6 +1372,7 @@ void EcoSysLab::VoxelSoilModel::GetSoilTextureColorForPosition(const glm::vec3&
 			const auto& texPtr = material.m_soilMaterialTexture;
 			if(!texPtr)
 			{
+				resetWeights();
 				albedo = glm::vec4(0.f);
 				normal = glm::vec3(0, 0, 1);
 				roughness = 0.8f;
@@ -1331,48 +1385,35 @@ void EcoSysLab::VoxelSoilModel::GetSoilTextureColorForPosition(const glm::vec3&
 			// compute weight:
 			const float weight = glm::exp(- dist*dist / blur_kernel_width);
 
-			if( contributing_materials.find(material_id) == contributing_materials.end())
-				contributing_materials[material_id] = 0;
+			if (std::find(materialIds.begin(), materialIds.end(), material_id) == materialIds.end())
+				materialIds.emplace_back(material_id);
 
 			auto heightmap_height = texPtr->m_height_map[texture_idx];
-			contributing_materials[material_id] += weight * heightmap_height * heightmap_height;
-			//total_weight +=  weight * tex.m_height_map[texture_idx];
-
-			//output_color += tex.m_color_map[texture_idx] * weight;
+			materialWeights[material_id] += weight * heightmap_height * heightmap_height;
 
 			waterLevel += m_w[Index(soil_voxel)] * waterFactor * weight;
 			nutrientLevel += m_n[Index(soil_voxel)] * nutrientFactor * weight;
 		}
 	}
 
-	// max texture:
-	/*
-	using pair_type = decltype(contributing_materials)::value_type;
-	auto max_mat = std::max_element(contributing_materials.begin(), contributing_materials.end(), []
-	(const pair_type & p1, const pair_type & p2)
-	{
-	return p1.second < p2.second;
-	}
-	);
-	output[texture_idx] = textures[max_mat->first]->m_color_map[texture_idx];
-	*/
-
-	// blend according to weights:
+	// blend according to weights, in ascending material order:
+	std::sort(materialIds.begin(), materialIds.end());
 	float total_weight=0;
 	albedo = glm::vec4(0.0f);
 	normal = glm::vec3(0.f);
 	metallic = 0.0f;
 	roughness = 0.0f;
-	for(auto& p : contributing_materials)
+	for(const auto materialId : materialIds)
 	{
-		auto weight = p.second * p.second;
-		auto& textures = m_soilLayers[p.first].m_mat.m_soilMaterialTexture;
+		auto weight = materialWeights[materialId] * materialWeights[materialId];
+		auto& textures = m_soilLayers[materialId].m_mat.m_soilMaterialTexture;
 		albedo += textures->m_color_map[texture_idx] * weight;
 		normal += textures->m_normal_map[texture_idx] * weight;
 		metallic += textures->m_metallic_map[texture_idx] * weight;
 		roughness += textures->m_roughness_map[texture_idx] * weight;
 		total_weight += weight;
 	}
+	resetWeights();
 	albedo /= total_weight;
 	waterLevel /= total_weight;
 	nutrientLevel /= total_weight;
@@ -1401,7 +1442,6 @@ void EcoSysLab::VoxelSoilModel::GetSoilTextureColorForPosition(const glm::vec3&
 
 
 
-
 /////////////////////////////////////////
 
 
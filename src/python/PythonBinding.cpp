@@ -1,4 +1,5 @@
 #include "pybind11/pybind11.h"
+#include "pybind11/numpy.h"
 #include "pybind11/stl/filesystem.h"
 #include "AnimationPlayer.hpp"
 #include "Application.hpp"
@@ -459,6 +460,329 @@ void rbv_space_colonization_tree_data(
 	scene->DeleteEntity(tempEntity);
 }
 
+#pragma region NumPy
+/**
+ * Move the list into a capsule so NumPy arrays can view it without a copy. The capsule frees it with the last array.
+ */
+template<typename T>
+const std::vector<T>& own_list(std::vector<T>&& list, py::capsule& owner)
+{
+	auto* owned = new std::vector<T>(std::move(list));
+	owner = py::capsule(owned, [](void* data) { delete static_cast<std::vector<T>*>(data); });
+	return *owned;
+}
+
+/**
+ * View one field of every element in place, as (n) or (n, componentCount), strided over the elements.
+ * The view is read-only since the list may be shared, e.g. with a mesh. An empty list gives an empty array that owns its storage.
+ */
+template<typename Scalar, typename T>
+py::array_t<Scalar> view_field(const std::vector<T>& list, const size_t offset, const size_t componentCount, const py::handle& owner)
+{
+	std::vector<py::ssize_t> shape = { static_cast<py::ssize_t>(list.size()) };
+	std::vector<py::ssize_t> strides = { static_cast<py::ssize_t>(sizeof(T)) };
+	if (componentCount > 1)
+	{
+		shape.emplace_back(static_cast<py::ssize_t>(componentCount));
+		strides.emplace_back(static_cast<py::ssize_t>(sizeof(Scalar)));
+	}
+	py::array_t<Scalar> retVal = list.empty() ? py::array_t<Scalar>(shape)
+		: py::array_t<Scalar>(shape, strides, reinterpret_cast<const Scalar*>(reinterpret_cast<const unsigned char*>(list.data()) + offset), owner);
+	retVal.attr("setflags")(py::arg("write") = false);
+	return retVal;
+}
+
+template<typename Scalar, typename T>
+py::array_t<Scalar> to_array(std::vector<T>&& list)
+{
+	static_assert(sizeof(T) % sizeof(Scalar) == 0);
+	py::capsule owner;
+	const auto& owned = own_list(std::move(list), owner);
+	return view_field<Scalar>(owned, 0, sizeof(T) / sizeof(Scalar), owner);
+}
+
+py::dict mesh_arrays(const std::shared_ptr<Mesh>& mesh)
+{
+	py::dict retVal;
+	if (!mesh) return retVal;
+	//The capsule keeps the mesh alive, the arrays view its vertex and triangle lists.
+	const py::capsule owner(new std::shared_ptr<Mesh>(mesh), [](void* data) { delete static_cast<std::shared_ptr<Mesh>*>(data); });
+	const auto& vertices = mesh->UnsafeGetVertices();
+	retVal["position"] = view_field<float>(vertices, offsetof(Vertex, m_position), 3, owner);
+	retVal["normal"] = view_field<float>(vertices, offsetof(Vertex, m_normal), 3, owner);
+	retVal["tex_coord"] = view_field<float>(vertices, offsetof(Vertex, m_texCoord), 2, owner);
+	retVal["triangles"] = view_field<glm::uint>(mesh->UnsafeGetTriangles(), 0, 3, owner);
+	return retVal;
+}
+
+bool check_application_status()
+{
+	const auto applicationStatus = Application::GetApplicationStatus();
+	if (applicationStatus == ApplicationStatus::NoProject)
+	{
+		EVOENGINE_ERROR("No project!");
+		return false;
+	}
+	if (applicationStatus == ApplicationStatus::OnDestroy)
+	{
+		EVOENGINE_ERROR("Application is destroyed!");
+		return false;
+	}
+	if (applicationStatus == ApplicationStatus::Uninitialized)
+	{
+		EVOENGINE_ERROR("Application not uninitialized!");
+		return false;
+	}
+	return true;
+}
+
+std::shared_ptr<Tree> get_tree(const Entity& treeEntity)
+{
+	if (!check_application_status()) return nullptr;
+	const auto scene = Application::GetActiveScene();
+	if (!scene->IsEntityValid(treeEntity) || !scene->HasPrivateComponent<Tree>(treeEntity))
+	{
+		EVOENGINE_ERROR("Entity is not a tree!");
+		return nullptr;
+	}
+	return scene->GetOrSetPrivateComponent<Tree>(treeEntity).lock();
+}
+
+/**
+ * Shoot skeleton nodes in sorted order, so a parent always comes before its children. Parents are indices into the arrays, -1 for the root.
+ */
+py::dict tree_skeleton_arrays(const Entity& treeEntity)
+{
+	py::dict retVal;
+	const auto tree = get_tree(treeEntity);
+	if (!tree) return retVal;
+	const auto& skeleton = tree->m_treeModel.PeekShootSkeleton();
+	const auto& sortedNodeList = skeleton.PeekSortedNodeList();
+	const auto nodeSize = sortedNodeList.size();
+	std::vector<int> nodeIndices(skeleton.PeekRawNodes().size(), -1);
+	for (size_t i = 0; i < nodeSize; i++) nodeIndices[sortedNodeList[i]] = static_cast<int>(i);
+
+	std::vector<int> handles(nodeSize);
+	std::vector<int> parents(nodeSize);
+	std::vector<glm::vec3> startPositions(nodeSize);
+	std::vector<glm::vec3> endPositions(nodeSize);
+	std::vector<float> thicknesses(nodeSize);
+	std::vector<float> lengths(nodeSize);
+	std::vector<float> rootDistances(nodeSize);
+	Jobs::RunParallelFor(nodeSize, [&](unsigned i)
+		{
+			const auto nodeHandle = sortedNodeList[i];
+			const auto& node = skeleton.PeekNode(nodeHandle);
+			const auto parentHandle = node.GetParentHandle();
+			handles[i] = nodeHandle;
+			parents[i] = parentHandle == -1 ? -1 : nodeIndices[parentHandle];
+			startPositions[i] = node.m_info.m_globalPosition;
+			endPositions[i] = node.m_info.GetGlobalEndPosition();
+			thicknesses[i] = node.m_info.m_thickness;
+			lengths[i] = node.m_info.m_length;
+			rootDistances[i] = node.m_info.m_rootDistance;
+		}
+	);
+	retVal["handle"] = to_array<int>(std::move(handles));
+	retVal["parent"] = to_array<int>(std::move(parents));
+	retVal["start_position"] = to_array<float>(std::move(startPositions));
+	retVal["end_position"] = to_array<float>(std::move(endPositions));
+	retVal["thickness"] = to_array<float>(std::move(thicknesses));
+	retVal["length"] = to_array<float>(std::move(lengths));
+	retVal["root_distance"] = to_array<float>(std::move(rootDistances));
+	return retVal;
+}
+
+/**
+ * Strand polylines, strand i owns the points from strand_offsets[i] to strand_offsets[i + 1].
+ */
+py::dict tree_strand_arrays(const Entity& treeEntity)
+{
+	py::dict retVal;
+	const auto tree = get_tree(treeEntity);
+	if (!tree) return retVal;
+	std::vector<glm::uint> strands;
+	std::vector<StrandPoint> points;
+	tree->m_strandModel.m_strandModelSkeleton.m_data.m_strandGroup.BuildStrands(strands, points, tree->m_strandModelParameters.m_nodeMaxCount);
+	if (!points.empty()) strands.emplace_back(points.size());
+	retVal["strand_offsets"] = to_array<glm::uint>(std::move(strands));
+	py::capsule owner;
+	const auto& ownedPoints = own_list(std::move(points), owner);
+	retVal["position"] = view_field<float>(ownedPoints, offsetof(StrandPoint, m_position), 3, owner);
+	retVal["thickness"] = view_field<float>(ownedPoints, offsetof(StrandPoint, m_thickness), 1, owner);
+	retVal["color"] = view_field<float>(ownedPoints, offsetof(StrandPoint, m_color), 4, owner);
+	return retVal;
+}
+
+/**
+ * Profile particles of the strand model nodes in sorted order, node i owns the particles from particle_offsets[i] to particle_offsets[i + 1].
+ */
+py::dict tree_strand_profile_arrays(const Entity& treeEntity)
+{
+	py::dict retVal;
+	const auto tree = get_tree(treeEntity);
+	if (!tree) return retVal;
+	const auto& skeleton = tree->m_strandModel.m_strandModelSkeleton;
+	const auto& sortedNodeList = skeleton.PeekSortedNodeList();
+	const auto nodeSize = sortedNodeList.size();
+	std::vector<glm::uint> particleOffsets(nodeSize + 1, 0);
+	for (size_t i = 0; i < nodeSize; i++)
+	{
+		particleOffsets[i + 1] = particleOffsets[i] + static_cast<glm::uint>(skeleton.PeekNode(sortedNodeList[i]).m_data.m_profile.PeekParticles().size());
+	}
+	std::vector<glm::vec2> positions(particleOffsets.back());
+	std::vector<int> strandHandles(particleOffsets.back());
+	Jobs::RunParallelFor(nodeSize, [&](unsigned i)
+		{
+			const auto& particles = skeleton.PeekNode(sortedNodeList[i]).m_data.m_profile.PeekParticles();
+			for (size_t j = 0; j < particles.size(); j++)
+			{
+				positions[particleOffsets[i] + j] = particles[j].GetPosition();
+				strandHandles[particleOffsets[i] + j] = particles[j].m_strandHandle;
+			}
+		}
+	);
+	retVal["node_handle"] = to_array<int>(std::vector<int>(sortedNodeList.begin(), sortedNodeList.end()));
+	retVal["particle_offsets"] = to_array<glm::uint>(std::move(particleOffsets));
+	retVal["position"] = to_array<float>(std::move(positions));
+	retVal["strand_handle"] = to_array<int>(std::move(strandHandles));
+	return retVal;
+}
+
+py::dict tree_mesh_arrays(const Entity& treeEntity, const TreeMeshGeneratorSettings& meshGeneratorSettings)
+{
+	py::dict retVal;
+	const auto tree = get_tree(treeEntity);
+	if (!tree) return retVal;
+	if (meshGeneratorSettings.m_enableBranch) retVal["branch"] = mesh_arrays(tree->GenerateBranchMesh(meshGeneratorSettings));
+	if (meshGeneratorSettings.m_enableFoliage) retVal["foliage"] = mesh_arrays(tree->GenerateFoliageMesh(meshGeneratorSettings));
+	return retVal;
+}
+
+/**
+ * Scan the trees in the active scene. Label arrays are only present when the point settings enable them.
+ */
+py::dict capture_tree_point_cloud(const TreePointCloudPointSettings& pointSettings, const TreePointCloudCircularCaptureSettings& captureSettings)
+{
+	py::dict retVal;
+	if (!check_application_status()) return retVal;
+	const auto scene = Application::GetActiveScene();
+	const auto scannerEntity = scene->CreateEntity("Scanner");
+	const auto scanner = scene->GetOrSetPrivateComponent<TreePointCloudScanner>(scannerEntity).lock();
+	scanner->m_pointSettings = pointSettings;
+	Application::Loop();
+	TreePointCloud pointCloud{};
+	const bool succeed = scanner->Capture(std::make_shared<TreePointCloudCircularCaptureSettings>(captureSettings), pointCloud);
+	scene->DeleteEntity(scannerEntity);
+	if (!succeed) return retVal;
+	retVal["position"] = to_array<float>(std::move(pointCloud.m_points));
+	if (pointSettings.m_typeIndex) retVal["type_index"] = to_array<int>(std::move(pointCloud.m_typeIndex));
+	if (pointSettings.m_instanceIndex) retVal["instance_index"] = to_array<int>(std::move(pointCloud.m_instanceIndex));
+	if (pointSettings.m_branchIndex) retVal["branch_index"] = to_array<int>(std::move(pointCloud.m_branchIndex));
+	if (pointSettings.m_internodeIndex) retVal["internode_index"] = to_array<int>(std::move(pointCloud.m_internodeIndex));
+	if (pointSettings.m_lineIndex) retVal["line_index"] = to_array<int>(std::move(pointCloud.m_lineIndex));
+	if (pointSettings.m_treePartIndex) retVal["tree_part_index"] = to_array<int>(std::move(pointCloud.m_treePartIndex));
+	if (pointSettings.m_treePartTypeIndex) retVal["tree_part_type_index"] = to_array<int>(std::move(pointCloud.m_treePartTypeIndex));
+	return retVal;
+}
+
+/**
+ * Grow a tree at the origin by space colonization towards an (n, 3) point array, read in place.
+ * Markers are only seeded in voxels that contain points, include trunk points if the crown starts far above the ground.
+ * @return The tree entity, kept in the scene so the array functions above can read it. Remove it with delete_entity.
+ */
+Entity point_space_colonization_tree(
+	const py::array_t<float, py::array::c_style | py::array::forcecast>& points,
+	const std::string& treeParametersPath,
+	const float deltaTime,
+	const int iterations)
+{
+	static_assert(sizeof(glm::vec3) == 3 * sizeof(float));
+	if (points.ndim() != 2 || points.shape(1) != 3)
+	{
+		EVOENGINE_ERROR("Points must be an (n, 3) array!");
+		return {};
+	}
+	if (!check_application_status()) return {};
+	const auto scene = Application::GetActiveScene();
+	const auto ecoSysLabLayer = Application::GetLayer<EcoSysLabLayer>();
+	if (!ecoSysLabLayer)
+	{
+		EVOENGINE_ERROR("Application doesn't contain EcoSysLab layer!");
+		return {};
+	}
+	std::shared_ptr<Soil> soil;
+	std::shared_ptr<Climate> climate;
+	const std::vector<Entity>* soilEntities =
+		scene->UnsafeGetPrivateComponentOwnersList<Soil>();
+	if (soilEntities && !soilEntities->empty()) {
+		soil = scene->GetOrSetPrivateComponent<Soil>(soilEntities->at(0)).lock();
+	}
+	if (!soil)
+	{
+		EVOENGINE_ERROR("No soil in scene!");
+		return {};
+	}
+	const std::vector<Entity>* climateEntities =
+		scene->UnsafeGetPrivateComponentOwnersList<Climate>();
+	if (climateEntities && !climateEntities->empty()) {
+		climate = scene->GetOrSetPrivateComponent<Climate>(climateEntities->at(0)).lock();
+	}
+	if (!climate)
+	{
+		EVOENGINE_ERROR("No climate in scene!");
+		return {};
+	}
+
+	const auto treeEntity = scene->CreateEntity("Tree");
+	const auto tree = scene->GetOrSetPrivateComponent<Tree>(treeEntity).lock();
+	tree->m_soil = soil;
+	tree->m_climate = climate;
+	std::shared_ptr<TreeDescriptor> treeDescriptor;
+	if (ProjectManager::IsInProjectFolder(treeParametersPath))
+	{
+		treeDescriptor = std::dynamic_pointer_cast<TreeDescriptor>(ProjectManager::GetOrCreateAsset(ProjectManager::GetPathRelativeToProject(treeParametersPath)));
+	}
+	else {
+		treeDescriptor = ProjectManager::CreateTemporaryAsset<TreeDescriptor>();
+	}
+	tree->m_treeDescriptor = treeDescriptor;
+
+	const auto* pointData = reinterpret_cast<const glm::vec3*>(points.data());
+	const auto pointCount = static_cast<size_t>(points.shape(0));
+	glm::vec3 min = glm::vec3(0.0f);
+	glm::vec3 max = glm::vec3(0.0f);
+	for (size_t i = 0; i < pointCount; i++)
+	{
+		min = glm::min(min, pointData[i]);
+		max = glm::max(max, pointData[i]);
+	}
+	auto& growthSettings = tree->m_treeModel.m_treeGrowthSettings;
+	tree->m_treeModel.m_treeOccupancyGrid.Initialize(pointData, pointCount, min, max,
+		treeDescriptor->m_shootDescriptor.Get<ShootDescriptor>()->m_internodeLength,
+		growthSettings.m_spaceColonizationRemovalDistanceFactor,
+		growthSettings.m_spaceColonizationTheta,
+		growthSettings.m_spaceColonizationDetectionDistanceFactor);
+	growthSettings.m_useSpaceColonization = true;
+	growthSettings.m_spaceColonizationAutoResize = false;
+
+	ecoSysLabLayer->m_simulationSettings.m_deltaTime = deltaTime;
+	Application::Loop();
+	for (int i = 0; i < iterations; i++)
+	{
+		ecoSysLabLayer->Simulate();
+	}
+	return treeEntity;
+}
+
+void delete_entity(const Entity& entity)
+{
+	if (!check_application_status()) return;
+	const auto scene = Application::GetActiveScene();
+	if (scene->IsEntityValid(entity)) scene->DeleteEntity(entity);
+}
+#pragma endregion
+
 PYBIND11_MODULE(pyecosyslab, m) {
 	py::class_<Entity>(m, "Entity")
 		.def("GetIndex", &Entity::GetIndex)
@@ -609,6 +933,14 @@ PYBIND11_MODULE(pyecosyslab, m) {
 	m.def("voxel_space_colonization_tree_data", &voxel_space_colonization_tree_data, "voxel_space_colonization_tree_data");
 	m.def("rbv_space_colonization_tree_data", &rbv_space_colonization_tree_data, "rbv_space_colonization_tree_data");
 	m.def("rbv_to_obj", &rbv_to_obj, "rbv_to_obj");
+
+	m.def("point_space_colonization_tree", &point_space_colonization_tree, "point_space_colonization_tree");
+	m.def("delete_entity", &delete_entity, "delete_entity");
+	m.def("tree_skeleton_arrays", &tree_skeleton_arrays, "tree_skeleton_arrays");
+	m.def("tree_strand_arrays", &tree_strand_arrays, "tree_strand_arrays");
+	m.def("tree_strand_profile_arrays", &tree_strand_profile_arrays, "tree_strand_profile_arrays");
+	m.def("tree_mesh_arrays", &tree_mesh_arrays, "tree_mesh_arrays");
+	m.def("capture_tree_point_cloud", &capture_tree_point_cloud, "capture_tree_point_cloud");
 	
 
 	py::class_<DatasetGenerator>(m, "DatasetGenerator")